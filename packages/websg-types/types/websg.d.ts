@@ -160,6 +160,96 @@ declare namespace WebSG {
      * });
      */
     constructor(props: ColliderProps);
+
+    /**
+     * Sweeps this collider's shape from each origin along its direction with a single call to the host, and
+     * writes where it first hit something into the hits buffer. Only box, sphere and capsule colliders can be cast.
+     * Returns the number of shapes that hit something. See {@link WebSG.World.castRays} for the layout of hits.
+     * @param origins - The x, y, z start position of each shape.
+     * @param directions - The x, y, z direction of each shape, distances are in multiples of its length.
+     * @param hits - Filled with a 36 byte hit per shape. The hit position is the shape's position when it hit.
+     * @param options - Also accepts a Float32Array of x, y, z, w rotations, one per shape.
+     */
+    cast(
+      origins: Float32Array,
+      directions: Float32Array,
+      hits: ArrayBuffer,
+      options?: PhysicsQueryOptions & { rotations?: Float32Array }
+    ): number;
+
+    /**
+     * Finds the nodes whose colliders overlap this collider's shape at each position with a single call to the
+     * host. Only box, sphere and capsule colliders can be tested and only nodes created by the script are reported.
+     * Returns the total number of overlaps. When that's more than nodeIds.length, the rest weren't written.
+     * @param positions - The x, y, z position of each shape.
+     * @param counts - Set to the number of node ids written for each shape.
+     * @param nodeIds - Filled with the ids of the overlapping nodes, shape by shape. Pass them to the batched
+     * transform methods like {@link WebSG.World.getNodeTranslations}.
+     * @param options - Also accepts a Float32Array of x, y, z, w rotations, one per shape.
+     * @example
+     * const positions = new Float32Array([0, 1, 0, 5, 1, 0]);
+     * const counts = new Uint32Array(2);
+     * const nodeIds = new Uint32Array(64);
+     * const total = trigger.overlap(positions, counts, nodeIds);
+     */
+    overlap(
+      positions: Float32Array,
+      counts: Uint32Array,
+      nodeIds: Uint32Array,
+      options?: PhysicsQueryOptions & { rotations?: Float32Array }
+    ): number;
+  }
+
+  /**
+   * Options for {@link WebSG.World.castRays} and the {@link WebSG.Collider} queries.
+   */
+  interface PhysicsQueryOptions {
+    /**
+     * How far to look for hits, in multiples of each direction's length. Defaults to Infinity.
+     */
+    maxDistance?: number;
+    /**
+     * Colliders of this node are ignored, e.g. the node a line of sight check starts from.
+     */
+    exclude?: Node;
+  }
+
+  /**
+   * Options for {@link WebSG.World.createCollisionListener}. A listener created with options is filtered by the
+   * host, so scripts only pay for the collisions they care about, and its collisions carry contact data.
+   */
+  interface CollisionListenerOptions {
+    /**
+     * Only collisions involving at least one of these nodes are reported.
+     */
+    nodes?: Node[] | Uint32Array;
+    /**
+     * Only collisions involving a collider that is a member of one of these groups (a bitmask) are reported.
+     */
+    collisionGroups?: number;
+    /**
+     * How many collisions can be pending at once. Once full, the oldest collision is dropped. Defaults to 256.
+     */
+    capacity?: number;
+  }
+
+  /**
+   * Options for {@link WebSG.World.createSpatialIndex}.
+   */
+  interface SpatialIndexOptions {
+    /**
+     * "tree" (the default) is a dynamic AABB tree that suits nodes spread unevenly over large areas. "grid" is a
+     * loose uniform grid that is cheaper to update when most nodes move every frame in a bounded area.
+     */
+    type?: "grid" | "tree";
+    /**
+     * Grid only: the size of a grid cell. Works best around the typical query radius. Defaults to 4.
+     */
+    cellSize?: number;
+    /**
+     * Tree only: how far a node can move before its leaf is reinserted. Defaults to 0.5.
+     */
+    margin?: number;
   }
 
   type InteractableType = 1 | 2;
@@ -869,6 +959,11 @@ declare namespace WebSG {
      * @param component the component type to get.
      */
     getComponent(component: ComponentStore): Component | undefined;
+    /**
+     * The index of this node's data in every {@link WebSG.ComponentStore | ComponentStore } prop array.
+     * Multiply by the prop's size to get the offset of the first element for vector props.
+     */
+    readonly componentStoreIndex: number;
   }
 
   /**
@@ -941,6 +1036,18 @@ declare namespace WebSG {
      * Whether the collision started or ended this frame.
      */
     started: boolean;
+    /**
+     * Filtered listeners only: the world space contact point. Zero for ended collisions and sensors.
+     */
+    position?: [number, number, number];
+    /**
+     * Filtered listeners only: the contact normal, pointing from nodeA to nodeB.
+     */
+    normal?: [number, number, number];
+    /**
+     * Filtered listeners only: the total impulse applied to resolve the contact this frame.
+     */
+    impulse?: number;
   }
 
   /**
@@ -967,12 +1074,86 @@ declare namespace WebSG {
      * Returns an iterator for the collisions that occurred since the last call to .collisions().
      */
     collisions(): CollisionIterator;
+    /**
+     * Moves as many pending collisions as fit into buffer without creating any objects and returns how many were
+     * written. Collisions that don't fit stay pending.
+     *
+     * Each collision is 40 bytes: u32 nodeA id, u32 nodeB id, i32 started, then f32 position x, y, z,
+     * normal x, y, z and impulse.
+     * @example
+     * const buffer = new ArrayBuffer(40 * 64);
+     * const ids = new Uint32Array(buffer);
+     * const values = new Float32Array(buffer);
+     * const count = listener.readContacts(buffer);
+     * for (let i = 0; i < count; i++) {
+     *   if (ids[i * 10 + 2] && values[i * 10 + 9] > 10) breakGlass(ids[i * 10 + 1]);
+     * }
+     */
+    readContacts(buffer: ArrayBuffer): number;
+    /**
+     * The number of collisions dropped because the listener's capacity was exceeded.
+     */
+    readonly droppedCount: number;
     /**
      * Disposes of the collision listener and stops listening to collisions.
      */
     dispose(): void;
   }
 
+  /**
+   * A SpatialIndex keeps nodes sorted by their world position in native code, for proximity checks that would
+   * otherwise compare every pair of nodes in JS. Positions are only read when nodes are added and on
+   * {@link WebSG.SpatialIndex.update | .update()}.
+   *
+   * Queries return an array of nodes, or write node ids into `out` and return the number of results when a
+   * Uint32Array is passed. Results that don't fit in `out` are counted but not written.
+   * @experimental This API is experimental and may change or be removed in a future release.
+   */
+  class SpatialIndex {
+    /**
+     * The number of nodes in the index.
+     */
+    readonly size: number;
+    /**
+     * Adds nodes to the index at their current world position. Adding a node that is already indexed updates it.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param radius The nodes' bounding radius, either one for all nodes or a Float32Array with one per node.
+     * Defaults to 0.
+     */
+    add(nodes: Node[] | Uint32Array, radius?: number | Float32Array): undefined;
+    /**
+     * Removes nodes from the index. Disposed nodes should be removed before the next update.
+     */
+    remove(nodes: Node[] | Uint32Array): undefined;
+    /**
+     * Reads the current world positions of every node in the index, or only of the given nodes when the script
+     * knows which ones moved. Nodes that only moved a little don't change the index's structure.
+     */
+    update(nodes?: Node[] | Uint32Array): undefined;
+    /**
+     * Finds the nodes whose bounding sphere is within radius of a position.
+     * @param position A node (its world position) or an [x, y, z] position.
+     */
+    queryRadius(position: Node | ArrayLike<number>, radius: number): Node[];
+    queryRadius(position: Node | ArrayLike<number>, radius: number, out: Uint32Array): number;
+    /**
+     * Finds the k nodes nearest to a position, nearest first. Querying from an indexed node includes the node itself.
+     * @param position A node (its world position) or an [x, y, z] position.
+     */
+    queryNearest(position: Node | ArrayLike<number>, k: number): Node[];
+    queryNearest(position: Node | ArrayLike<number>, k: number, out: Uint32Array): number;
+    /**
+     * Finds the nodes whose bounding sphere intersects a view frustum.
+     * @param viewProjection A column major view projection matrix.
+     */
+    queryFrustum(viewProjection: ArrayLike<number>): Node[];
+    queryFrustum(viewProjection: ArrayLike<number>, out: Uint32Array): number;
+    /**
+     * Removes every node and frees the index's memory.
+     */
+    dispose(): undefined;
+  }
+
   /**
    * A Quaternion class with x, y, z, and w components. The class provides methods to set the components of the quaternion using an array-like syntax.
    */
@@ -2187,12 +2368,95 @@ declare namespace WebSG {
     readonly length: number;
   }
 
-  class ComponentStore {}
+  class ComponentStore {
+    /**
+     * Returns a typed array that shares memory with the store for the given prop. Values are indexed by
+     * {@link WebSG.Node.componentStoreIndex | node.componentStoreIndex } and vector props store their
+     * elements back to back, so reading or writing them does not allocate component objects.
+     * Returns undefined if the component has no prop with this name.
+     * @param propName The name of the prop.
+     * @example
+     * const Spin = world.findComponentStoreByName("Spin");
+     * const speed = Spin.getPropArray("speed");
+     * speed[node.componentStoreIndex] = 2;
+     */
+    getPropArray(propName: string): Float32Array | Int32Array | Uint32Array | undefined;
+  }
 
+  /**
+   * A node's instance of a component. Props are read and written through to the
+   * {@link WebSG.ComponentStore | ComponentStore }. Array props with a size greater than one, such as an
+   * f32 prop of size 16, are typed arrays that share memory with the store.
+   */
   class Component {
     [propName: string]: unknown;
   }
 
+  /**
+   * Type representing the ways a query item's components can be matched.
+   */
+  type QueryModifier = "all" | "none" | "any";
+
+  /**
+   * Query modifier constants.
+   */
+  const QueryModifier: {
+    All: "all";
+    None: "none";
+    Any: "any";
+  };
+
+  /**
+   * A query list item that matches nodes with all, none or any of the given components.
+   */
+  interface QueryItem {
+    /**
+     * How the components are matched. Defaults to {@link WebSG.QueryModifier | QueryModifier.All }.
+     */
+    modifier?: QueryModifier;
+    /**
+     * The component stores to match.
+     */
+    components: ComponentStore[];
+  }
+
+  /**
+   * A list of query items. Bare component stores are matched as if they were in a single "all" item.
+   */
+  type QueryList = (ComponentStore | QueryItem)[];
+
+  /**
+   * An iterator for the nodes matched by a query.
+   */
+  class QueryIterator {
+    /**
+     * Returns the next node in the iterator.
+     */
+    next(): { value: Node; done: boolean };
+    [Symbol.iterator](): QueryIterator;
+  }
+
+  /**
+   * A live set of nodes matching a {@link WebSG.QueryList | QueryList }. Iterating a query returns the nodes
+   * that currently match it.
+   * @example
+   * const query = world.createQuery([Spin, { modifier: WebSG.QueryModifier.None, components: [Frozen] }]);
+   * for (const node of query) {
+   *   node.rotation.y += dt;
+   * }
+   */
+  class Query {
+    /**
+     * Returns the nodes that started matching the query since the last call to entered().
+     */
+    entered(): QueryIterator;
+    /**
+     * Returns the nodes that stopped matching the query since the last call to exited().
+     */
+    exited(): QueryIterator;
+    [Symbol.iterator](): QueryIterator;
+  }
+
   /**
    * Class representing a 3D world composed of {@link WebSG.Scene | scenes}, {@link WebSG.Node | nodes},
    * {@link WebSG.Mesh | meshes}, {@link WebSG.Material | materials}, and other properties defined by
@@ -2363,6 +2627,166 @@ declare namespace WebSG {
      */
     findNodeByName(name: string): Node | undefined;
 
+    /**
+     * Reads the translations of many {@link WebSG.Node | nodes } in a single call. Values are packed
+     * as [x, y, z] per node in the same order as `nodes`.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param out A Float32Array with a length of `nodes.length * 3`.
+     * @returns The `out` array.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    getNodeTranslations(nodes: Node[] | Uint32Array, out: Float32Array): Float32Array;
+
+    /**
+     * Sets the translations of many {@link WebSG.Node | nodes } in a single call.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param translations A Float32Array with a length of `nodes.length * 3`.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    setNodeTranslations(nodes: Node[] | Uint32Array, translations: Float32Array): undefined;
+
+    /**
+     * Reads the rotations of many {@link WebSG.Node | nodes } in a single call. Values are packed
+     * as [x, y, z, w] quaternions per node in the same order as `nodes`.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param out A Float32Array with a length of `nodes.length * 4`.
+     * @returns The `out` array.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    getNodeRotations(nodes: Node[] | Uint32Array, out: Float32Array): Float32Array;
+
+    /**
+     * Sets the rotations of many {@link WebSG.Node | nodes } in a single call.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param rotations A Float32Array with a length of `nodes.length * 4`.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    setNodeRotations(nodes: Node[] | Uint32Array, rotations: Float32Array): undefined;
+
+    /**
+     * Reads the scales of many {@link WebSG.Node | nodes } in a single call. Values are packed
+     * as [x, y, z] per node in the same order as `nodes`.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param out A Float32Array with a length of `nodes.length * 3`.
+     * @returns The `out` array.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    getNodeScales(nodes: Node[] | Uint32Array, out: Float32Array): Float32Array;
+
+    /**
+     * Sets the scales of many {@link WebSG.Node | nodes } in a single call.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param scales A Float32Array with a length of `nodes.length * 3`.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    setNodeScales(nodes: Node[] | Uint32Array, scales: Float32Array): undefined;
+
+    /**
+     * Reads the local matrices of many {@link WebSG.Node | nodes } in a single call. Values are packed
+     * as 16 column-major floats per node in the same order as `nodes`.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param out A Float32Array with a length of `nodes.length * 16`.
+     * @returns The `out` array.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    getNodeMatrices(nodes: Node[] | Uint32Array, out: Float32Array): Float32Array;
+
+    /**
+     * Sets the local matrices of many {@link WebSG.Node | nodes } in a single call.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param matrices A Float32Array with a length of `nodes.length * 16`.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    setNodeMatrices(nodes: Node[] | Uint32Array, matrices: Float32Array): undefined;
+
+    /**
+     * Reads the world matrices of many {@link WebSG.Node | nodes } in a single call. Values are packed
+     * as 16 column-major floats per node in the same order as `nodes`.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param out A Float32Array with a length of `nodes.length * 16`.
+     * @returns The `out` array.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    getNodeWorldMatrices(nodes: Node[] | Uint32Array, out: Float32Array): Float32Array;
+
+    /**
+     * Sets the world matrices of many {@link WebSG.Node | nodes } in a single call. Each matrix is
+     * converted to the node's local space and decomposed into its translation, rotation and scale.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param worldMatrices A Float32Array with a length of `nodes.length * 16`.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    setNodeWorldMatrices(nodes: Node[] | Uint32Array, worldMatrices: Float32Array): undefined;
+
+    /**
+     * Gets the linear velocities of many nodes' {@link WebSG.PhysicsBody | physics bodies } in a single call.
+     * Every node must have a physics body.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param out A Float32Array with a length of `nodes.length * 3`.
+     * @returns The `out` array.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    getNodeLinearVelocities(nodes: Node[] | Uint32Array, out: Float32Array): Float32Array;
+
+    /**
+     * Sets the linear velocities of many nodes' physics bodies in a single call, waking them up.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param velocities A Float32Array with a length of `nodes.length * 3`.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    setNodeLinearVelocities(nodes: Node[] | Uint32Array, velocities: Float32Array): undefined;
+
+    /**
+     * Gets the angular velocities of many nodes' physics bodies in a single call.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param out A Float32Array with a length of `nodes.length * 3`.
+     * @returns The `out` array.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    getNodeAngularVelocities(nodes: Node[] | Uint32Array, out: Float32Array): Float32Array;
+
+    /**
+     * Sets the angular velocities of many nodes' physics bodies in a single call, waking them up.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param velocities A Float32Array with a length of `nodes.length * 3`.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    setNodeAngularVelocities(nodes: Node[] | Uint32Array, velocities: Float32Array): undefined;
+
+    /**
+     * Applies a force to each of the nodes' physics bodies for the next physics step. Call it every frame
+     * for a continuous force.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param forces A Float32Array with a length of `nodes.length * 3`.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    applyNodeForces(nodes: Node[] | Uint32Array, forces: Float32Array): undefined;
+
+    /**
+     * Applies an impulse to each of the nodes' physics bodies, like {@link WebSG.PhysicsBody.applyImpulse}.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param impulses A Float32Array with a length of `nodes.length * 3`.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    applyNodeImpulses(nodes: Node[] | Uint32Array, impulses: Float32Array): undefined;
+
+    /**
+     * Gets whether each of the nodes' physics bodies is sleeping, 1 for sleeping and 0 for awake.
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param out A Uint32Array with a length of `nodes.length`.
+     * @returns The `out` array.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    getNodeSleeping(nodes: Node[] | Uint32Array, out: Uint32Array): Uint32Array;
+
+    /**
+     * Puts each of the nodes' physics bodies to sleep (1) or wakes them up (0).
+     * @param nodes An array of nodes or a Uint32Array of node ids.
+     * @param sleeping A Uint32Array with a length of `nodes.length`.
+     * @experimental This API is experimental and may change or be removed in a future release.
+     */
+    setNodeSleeping(nodes: Node[] | Uint32Array, sleeping: Uint32Array): undefined;
+
     /**
      * Creates a new {@link WebSG.Scene | Scene } with the given properties.
      * @param props Optional properties to set on the new scene.
@@ -2427,8 +2851,52 @@ declare namespace WebSG {
     /**
      * Creates a new {@link WebSG.CollisionListener | CollisionListener } for listening to
      * collisions between nodes with colliders set on them.
+     * @param options - Filters collisions on the host and adds contact data, see {@link WebSG.CollisionListenerOptions}.
+     */
+    createCollisionListener(options?: CollisionListenerOptions): CollisionListener;
+
+    /**
+     * Casts a batch of rays with a single call to the host and writes the first hit of each ray into the hits
+     * buffer. Returns the number of rays that hit something.
+     *
+     * Each hit is 36 bytes: a u32 node id (0 when the collider doesn't belong to a node created by the script),
+     * a u32 that is 1 for a hit and 0 for a miss, then f32 distance, position x, y, z and normal x, y, z.
+     * @param origins - The x, y, z origin of each ray.
+     * @param directions - The x, y, z direction of each ray, distances are in multiples of its length.
+     * @param hits - At least 36 bytes per ray.
+     * @param options - Query options.
+     * @example
+     * const hits = new ArrayBuffer(36 * enemies.length);
+     * const hitNodeIds = new Uint32Array(hits);
+     * const hitValues = new Float32Array(hits);
+     * world.castRays(origins, directions, hits, { maxDistance: 50, exclude: player });
+     * for (let i = 0; i < enemies.length; i++) {
+     *   const canSee = hitNodeIds[i * 9 + 1] === 0 || hitValues[i * 9 + 2] > distances[i];
+     * }
+     */
+    castRays(
+      origins: Float32Array,
+      directions: Float32Array,
+      hits: ArrayBuffer,
+      options?: PhysicsQueryOptions
+    ): number;
+
+    /**
+     * Creates a new {@link WebSG.SpatialIndex | SpatialIndex } for radius, k-nearest and frustum queries over nodes.
+     * @param options - Optional index type and tuning, see {@link WebSG.SpatialIndexOptions}.
+     * @example
+     * const index = world.createSpatialIndex();
+     * index.add(players);
+     * world.onupdate = () => {
+     *   index.update();
+     *   for (const player of players) {
+     *     for (const other of index.queryRadius(player, 2)) {
+     *       if (other !== player) greet(player, other);
+     *     }
+     *   }
+     * };
      */
-    createCollisionListener(): CollisionListener;
+    createSpatialIndex(options?: SpatialIndexOptions): SpatialIndex;
 
     /**
      * Returns the maximum number of components per type that can be stored in the world.
@@ -2449,6 +2917,13 @@ declare namespace WebSG {
      */
     findComponentStoreByName(name: string): ComponentStore | undefined;
 
+    /**
+     * Creates a {@link WebSG.Query | Query } for the nodes matching the given query list.
+     * @param queryList The component stores and query items to match.
+     * @throws If the query list is empty or contains something other than component stores and query items.
+     */
+    createQuery(queryList: QueryList): Query;
+
     /**
      * Stops any ongoing orbiting operation.
      */
@@ -2496,9 +2971,154 @@ declare namespace WebSGNetworking {
     get isLocal(): boolean;
     get translation(): WebSG.Vector3;
     get rotation(): WebSG.Quaternion;
+    /**
+     * Bytes sent to this peer that the transport hasn't sent yet. A growing backlog means the peer's connection
+     * can't keep up and the script should send less to it.
+     */
+    get backlog(): number;
+    /**
+     * The smoothed round trip time to this peer in milliseconds, 0 until it has been measured.
+     */
+    get rtt(): number;
     send(message: string | ArrayBuffer, reliable: boolean): undefined;
+    /**
+     * Queues a message to be sent to this peer at the end of the current frame.
+     * See {@link WebSGNetworking.Network.queue | Network.queue }.
+     */
+    queue(message: string | ArrayBuffer, reliable?: boolean | NetworkChannel, key?: number): undefined;
+  }
+
+  interface NetworkChannelOptions {
+    /**
+     * Whether messages are sent reliably and in order. Defaults to true.
+     */
+    reliable?: boolean;
+    /**
+     * Messages on channels with a higher priority are sent first. Defaults to 0, the priority of messages queued
+     * without a channel.
+     */
+    priority?: number;
+    /**
+     * The number of bytes the channel sends per frame, 0 for no limit. Defaults to 0.
+     */
+    budget?: number;
+    /**
+     * The {@link WebSGNetworking.Peer.backlog | backlog} in bytes above which messages to a peer are held back,
+     * 0 for no limit. Broadcasts aren't held back. Defaults to 0.
+     */
+    maxBacklog?: number;
+    /**
+     * The number of bytes that can be queued on the channel, including messages held back by earlier frames,
+     * 0 for no limit. Queueing a message that doesn't fit throws a RangeError. Defaults to 1MiB.
+     */
+    maxQueuedByteLength?: number;
   }
 
+  /**
+   * A class of queued messages with its own priority, send budget and backpressure, defined with
+   * {@link WebSGNetworking.Network.defineChannel | defineChannel}. Messages over the budget or to a backed up peer
+   * stay queued for the next frame on reliable channels and are dropped on unreliable ones.
+   */
+  class NetworkChannel {
+    get reliable(): boolean;
+    get priority(): number;
+    /**
+     * The number of bytes the channel sends per frame, 0 for no limit. The first message of a frame is always sent.
+     */
+    budget: number;
+    /**
+     * The peer backlog in bytes above which messages to that peer are held back, 0 for no limit.
+     */
+    maxBacklog: number;
+    /**
+     * The number of bytes that can be queued on the channel, 0 for no limit.
+     */
+    maxQueuedByteLength: number;
+    /**
+     * Bytes queued on the channel and not sent yet, including messages held back by earlier frames.
+     */
+    get queuedByteLength(): number;
+    /**
+     * Bytes sent by the last flush.
+     */
+    get sentByteLength(): number;
+    /**
+     * Messages held back by the last flush.
+     */
+    get deferredCount(): number;
+    /**
+     * Messages dropped since the channel was defined, by an unreliable channel or because the channel's queue was
+     * full.
+     */
+    get droppedCount(): number;
+  }
+
+  /**
+   * The poses of every peer in the world, read with {@link WebSGNetworking.Network.getPeerPoses | getPeerPoses}.
+   * The same object is returned by every call and is overwritten by the next one.
+   */
+  class PeerPoses {
+    /**
+     * The number of peers in the world.
+     */
+    get count(): number;
+    /**
+     * The peers' translations, 3 elements per peer. The array is reused while the number of peers doesn't change.
+     */
+    get translations(): Float32Array;
+    /**
+     * The peers' rotations, 4 elements per peer. The array is reused while the number of peers doesn't change.
+     */
+    get rotations(): Float32Array;
+    /**
+     * Returns the peer whose pose is at index.
+     */
+    getPeer(index: number): Peer;
+  }
+
+  /**
+   * A binary message layout compiled once with {@link WebSGNetworking.Network.defineSchema | defineSchema}.
+   * Messages are packed in field order, little endian and without padding, so every message is byteLength bytes.
+   */
+  class MessageSchema {
+    get byteLength(): number;
+    /**
+     * Encodes the message's fields into a new ArrayBuffer.
+     */
+    encode(message: { [name: string]: any }): ArrayBuffer;
+    /**
+     * Encodes the message's fields into an existing buffer, so that several messages can be packed together.
+     * @returns The number of bytes written, always byteLength.
+     */
+    encodeInto(message: { [name: string]: any }, buffer: ArrayBuffer, byteOffset?: number): number;
+    /**
+     * Decodes a message into a new object. vec3 and quat fields decode to arrays and node fields to the node with
+     * the encoded network id, or null.
+     */
+    decode(buffer: ArrayBuffer, byteOffset?: number): { [name: string]: any };
+    /**
+     * Decodes a message into an existing object. vec3 and quat fields are written into the arrays, typed arrays
+     * or vectors the object already has, so nothing is allocated for them.
+     */
+    decodeInto<T extends object>(buffer: ArrayBuffer, message: T, byteOffset?: number): T;
+  }
+
+  type MessageSchemaField =
+    | {
+        name: string;
+        type: "bool" | "u8" | "u16" | "u32" | "i8" | "i16" | "i32" | "node";
+      }
+    | {
+        name: string;
+        type: "f32" | "vec3" | "quat";
+        /**
+         * Quantizes each element to 8 or 16 bits between min and max. quat fields default to [-1, 1].
+         */
+        bits?: 8 | 16;
+        min?: number;
+        max?: number;
+      };
+
   class NetworkMessage {
     peer: Peer;
     data: ArrayBuffer | string;
@@ -2517,6 +3137,43 @@ declare namespace WebSGNetworking {
     [Symbol.iterator](): NetworkMessageIterator;
   }
 
+  /**
+   * A batch of network messages copied into a single arena by
+   * {@link WebSGNetworking.NetworkListener.receiveBatch | receiveBatch }. The batch reads from the arena, so it
+   * is only valid until the arena is passed to receiveBatch again.
+   */
+  class NetworkMessageBatch {
+    /**
+     * The arena the messages were copied into.
+     */
+    readonly arena: ArrayBuffer;
+    /**
+     * The number of messages in the batch.
+     */
+    readonly count: number;
+    /**
+     * The header table at the start of the arena. Each message has 4 entries: peer index, byte offset of the
+     * payload in the arena, byte length of the payload and 1 if the message is binary.
+     */
+    readonly headers: Uint32Array;
+    /**
+     * Returns the peer that sent the message at the given index.
+     */
+    getPeer(index: number): Peer;
+    /**
+     * Returns true if the message at the given index is binary.
+     */
+    isBinary(index: number): boolean;
+    /**
+     * Returns a view of the payload of the message at the given index in the arena.
+     */
+    getData(index: number): Uint8Array;
+    /**
+     * Returns the payload of the message at the given index decoded as a string.
+     */
+    getText(index: number): string;
+  }
+
   /**
    * A listener for receiving network messages. The {@link WebSGNetworking.NetworkListener.receive | receive }
    * method should be called once per frame to drain the listener's internal message queue. When done with the
@@ -2532,6 +3189,21 @@ declare namespace WebSGNetworking {
      */
     receive(buffer?: ArrayBuffer): NetworkMessageIterator;
 
+    /**
+     * Copies as many queued messages as fit into the arena with a single call to the host and returns them as a
+     * {@link WebSGNetworking.NetworkMessageBatch}. Messages that don't fit stay queued for the next call.
+     * @param arena - The buffer to copy the messages into. Throws a RangeError if the next message can't fit on its
+     * own, grow the arena to {@link WebSGNetworking.NetworkListener.nextMessageByteLength | nextMessageByteLength}
+     * and call again.
+     */
+    receiveBatch(arena: ArrayBuffer): NetworkMessageBatch;
+
+    /**
+     * The arena byte length needed by the message that didn't fit in the last receiveBatch call, 0 if every
+     * message fit.
+     */
+    readonly nextMessageByteLength: number;
+
     /**
      * Closes the listener and frees its resources.
      */
@@ -2556,6 +3228,41 @@ declare namespace WebSGNetworking {
     data: ArrayBuffer;
   }
 
+  /**
+   * A batch of replications copied into a single arena by
+   * {@link WebSGNetworking.Replicator.spawnedBatch | spawnedBatch } or
+   * {@link WebSGNetworking.Replicator.despawnedBatch | despawnedBatch }. The headers and payloads read from the
+   * arena, so they are only valid until the arena is passed to either method again.
+   */
+  class ReplicationBatch {
+    /**
+     * The arena the replications were copied into.
+     */
+    readonly arena: ArrayBuffer;
+    /**
+     * The number of replications in the batch.
+     */
+    readonly count: number;
+    /**
+     * The header table at the start of the arena. Each replication has 5 entries: node id (0 for remote spawns),
+     * network id, peer index, byte offset of the payload in the arena and byte length of the payload.
+     */
+    readonly headers: Uint32Array;
+    /**
+     * The replicated node for each replication. Nodes for remote spawns have already been created by the
+     * replicator's factory.
+     */
+    readonly nodes: WebSG.Node[];
+    /**
+     * Returns the peer that sent the replication at the given index.
+     */
+    getPeer(index: number): Peer;
+    /**
+     * Returns a view of the payload of the replication at the given index in the arena.
+     */
+    getData(index: number): Uint8Array;
+  }
+
   /**
    * An iterator for {@link WebSGNetworking.Replication | Replication }s.
    */
@@ -2590,8 +3297,59 @@ declare namespace WebSGNetworking {
      * Returns an iterator for despawned nodes.
      */
     despawned(): ReplicationIterator;
+    /**
+     * Copies as many pending spawns as fit into the arena with a single call to the host and returns them as a
+     * {@link WebSGNetworking.ReplicationBatch}. Nodes for remote spawns are created with one call to the
+     * replicator's batch factory when it has one. Spawns that don't fit stay queued for the next call.
+     * @param arena - The buffer to copy the spawns into. Throws if the next spawn can't fit on its own.
+     */
+    spawnedBatch(arena: ArrayBuffer): ReplicationBatch;
+    /**
+     * Copies as many pending despawns as fit into the arena with a single call to the host and returns them as a
+     * {@link WebSGNetworking.ReplicationBatch}.
+     * @param arena - The buffer to copy the despawns into. Throws if the next despawn can't fit on its own.
+     */
+    despawnedBatch(arena: ArrayBuffer): ReplicationBatch;
+    /**
+     * Defines the state that is continuously synchronized for nodes spawned by this replicator. Every frame, the
+     * fields that changed on locally spawned nodes are quantized, delta compressed and sent to the other peers,
+     * who apply them to their copies of the nodes. Call it once, before spawning any nodes.
+     * @param schema - The transform and component store props to synchronize.
+     * @param options - With `interpolation` set, received transforms are buffered and played back `delay` seconds
+     * (0.1 by default) behind the current time so remote nodes move smoothly between snapshots. When snapshots stop
+     * arriving, motion is extrapolated for up to `maxExtrapolation` seconds (0.25 by default). Component props are
+     * always applied as soon as they are received.
+     * @example
+     * ```js
+     * const Health = world.findComponentStoreByName("Health");
+     * replicator.defineState([
+     *   "translation",
+     *   { transform: "rotation", precision: 0.001 },
+     *   { component: Health, prop: "value" },
+     * ]);
+     * ```
+     */
+    defineState(schema: ReplicatorStateField[], options?: ReplicatorStateOptions): undefined;
   }
 
+  /**
+   * A field of a replicator's state. Strings synchronize a node transform property with its default precision.
+   * The precision is the smallest change of a float value that is sent. It defaults to 0.001, and to 0.0001 for
+   * rotations. Integer component props are always sent exactly.
+   */
+  type ReplicatorStateField =
+    | ReplicatorStateTransform
+    | { transform: ReplicatorStateTransform; precision?: number }
+    | { component: WebSG.ComponentStore; prop: string; precision?: number };
+
+  type ReplicatorStateTransform = "translation" | "rotation" | "scale";
+
+  interface ReplicatorStateOptions {
+    interpolation?: boolean | { delay?: number; maxExtrapolation?: number };
+  }
+
+  type InterestOrigin = WebSG.Node | ArrayLike<number>;
+
   /**
    * Represents the networking methods available
    * for sending and receiving data in a WebSG script.
@@ -2620,8 +3378,68 @@ declare namespace WebSGNetworking {
      * @param data - The data to be broadcasted.
      * @param reliable - Whether or not the data should be sent reliably or unreliably.
      * Defaults to true.
+     * @param origin - Where the message originates from, a node or a position. When interest is set with
+     * {@link WebSGNetworking.Network.setInterest | setInterest}, the message is only sent to the peers within its
+     * radius.
      */
-    broadcast(message: string | ArrayBuffer, reliable?: boolean): undefined;
+    broadcast(message: string | ArrayBuffer, reliable?: boolean, origin?: InterestOrigin): undefined;
+
+    /**
+     * Queues a message to be broadcast at the end of the current frame. Queued messages are packed together, so
+     * sending many small messages this way costs far fewer packets than calling broadcast for each one.
+     * @param message - The message to be broadcast. The data is copied when queued. Messages larger than 9978
+     * bytes throw a RangeError.
+     * @param reliable - Whether or not the message should be sent reliably or unreliably, or the channel to queue it
+     * on. Defaults to true. Unreliable broadcasts aren't supported and throw a TypeError, unless interest limits the
+     * message to the peers around its origin.
+     * @param key - An optional key such as a node id. A later message queued with the same key in the same frame
+     * replaces this one, keeping its place in the queue.
+     * @param origin - Where the message originates from, a node or a position. When interest is set, the message is
+     * only queued for the peers within its radius.
+     */
+    queue(
+      message: string | ArrayBuffer,
+      reliable?: boolean | NetworkChannel,
+      key?: number,
+      origin?: InterestOrigin,
+    ): undefined;
+
+    /**
+     * Defines a channel for queued messages with its own priority, send budget and backpressure.
+     */
+    defineChannel(options?: NetworkChannelOptions): NetworkChannel;
+
+    /**
+     * Sends all queued messages now instead of at the end of the frame.
+     */
+    flush(): undefined;
+
+    /**
+     * Enables interest management. Messages broadcast or queued with an origin, and replicator state, are then only
+     * sent to the peers within radius of the origin or replicated node. Peer positions are read once per frame.
+     * Entities that come back into a peer's radius are sent in full.
+     * @param options.radius - The distance within which peers are interested, must be greater than 0.
+     * @param options.cellSize - The size of the grid cells peers are bucketed into. Defaults to radius.
+     */
+    setInterest(options: { radius: number; cellSize?: number }): undefined;
+
+    /**
+     * Disables interest management, everything is broadcast to all peers again.
+     */
+    clearInterest(): undefined;
+
+    /**
+     * Compiles a binary message schema. Encoding and decoding with it runs natively, which is much faster than
+     * packing messages with DataViews in the script.
+     * @param fields - The message's fields, in the order they are packed.
+     */
+    defineSchema(fields: MessageSchemaField[]): MessageSchema;
+
+    /**
+     * Reads the translation and rotation of every peer in the world at once. Much cheaper than reading
+     * {@link WebSGNetworking.Peer.translation | peer.translation} for each peer when iterating all of them every frame.
+     */
+    getPeerPoses(): PeerPoses;
 
     /**
      * Callback for when a peer enters the world.
@@ -2638,8 +3456,11 @@ declare namespace WebSGNetworking {
     /**
      * Defines a new replicator that can be used to spawn and despawn nodes
      * @param factory - A function called whenever a new node is spawned.
+     * @param batchFactory - An optional function used by {@link WebSGNetworking.Replicator.spawnedBatch | spawnedBatch }
+     * instead of factory. It's called once per batch with the number of remote spawns and must return at least that
+     * many nodes, so they can be taken from a preallocated pool.
      */
-    defineReplicator(factory: () => WebSG.Node): Replicator;
+    defineReplicator(factory: () => WebSG.Node, batchFactory?: (count: number) => WebSG.Node[]): Replicator;
   }
 }
 
@@ -2812,11 +3633,63 @@ declare namespace Matrix {
     receive(): MatrixAPIMessage | undefined;
 
     /**
-     * Sends a Matrix API message.
-     * @param {MatrixAPIMessage} event - The Matrix API message to send.
+     * Receives as many queued Matrix API messages as fit into the arena in one call, oldest first. The returned
+     * batch reads from the arena, so it is only valid until the arena is used for the next batch.
+     * @param {ArrayBuffer} arena - The buffer to receive the messages into.
+     * @returns {MatrixEventBatch} - The received messages, empty if no message is available.
+     */
+    receiveBatch(arena: ArrayBuffer): MatrixEventBatch;
+
+    /**
+     * Sends a Matrix API message. Strings are sent as already serialized JSON.
+     * @param {MatrixAPIMessage | string} event - The Matrix API message to send.
      * @returns {undefined}
      */
-    send(event: MatrixAPIMessage): undefined;
+    send(event: MatrixAPIMessage | string): undefined;
+  }
+
+  /**
+   * MatrixEventBatch class represents Matrix API messages received with receiveBatch. The action, type and sender
+   * can be read without parsing the message.
+   */
+  class MatrixEventBatch {
+    /**
+     * The number of messages in the batch.
+     */
+    readonly count: number;
+
+    /**
+     * The arena the batch was received into.
+     */
+    readonly arena: ArrayBuffer;
+
+    /**
+     * Returns the widget API action of the message at the given index.
+     * @param {number} index - The index of the message.
+     * @returns {string | undefined}
+     */
+    getAction(index: number): string | undefined;
+
+    /**
+     * Returns the event type of the message at the given index.
+     * @param {number} index - The index of the message.
+     * @returns {string | undefined}
+     */
+    getType(index: number): string | undefined;
+
+    /**
+     * Returns the event sender of the message at the given index.
+     * @param {number} index - The index of the message.
+     * @returns {string | undefined}
+     */
+    getSender(index: number): string | undefined;
+
+    /**
+     * Parses the message at the given index.
+     * @param {number} index - The index of the message.
+     * @returns {MatrixAPIMessage}
+     */
+    getEvent(index: number): MatrixAPIMessage;
   }
 }
 
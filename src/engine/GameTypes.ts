@@ -1,4 +1,4 @@
-import { IWorld, Query } from "bitecs";
+import { IComponent, IWorld, Query } from "bitecs";
 
 import { GLTFComponentDefinition } from "./gltf/GLTF";
 import { GLTFResource } from "./gltf/gltf.game";
@@ -15,15 +15,29 @@ export interface ResourceManagerGLTFCacheEntry {
   promise: Promise<GLTFResource>;
 }
 
+export interface CollisionContact {
+  position: [number, number, number];
+  normal: [number, number, number];
+  impulse: number;
+}
+
 export interface Collision {
   nodeA: number;
   nodeB: number;
   started: boolean;
+  // Set for collisions delivered to filtered listeners.
+  contact?: CollisionContact;
 }
 
 export interface CollisionListener {
   id: number;
   collisions: Collision[];
+  // Filtered listeners keep collisions in a ring buffer of capacity, starting at head. Unbounded otherwise.
+  capacity?: number;
+  head: number;
+  droppedCount: number;
+  nodes?: Set<number>;
+  collisionGroups: number;
 }
 
 export interface ActionBarListener {
@@ -36,6 +50,36 @@ export interface NetworkListener {
   inbound: [string, ArrayBuffer, boolean][];
 }
 
+export interface ScriptQuery {
+  query: Query;
+  // Component groups from QueryModifier.Any items. bitECS can't express these so results are filtered.
+  anyComponents: IComponent[][];
+  // Not components, checked by hand when the query has no All items and its membership comes from anyQueries.
+  noneComponents: IComponent[];
+  // One query per component of the first Any group, only used when the query has no All items since an empty
+  // bitECS query never has any members.
+  anyQueries: Query[];
+  // Reused when filtering the results of queries with Any items.
+  results: number[];
+  enter: Query;
+  exit: Query;
+  // Used instead of enter / exit to track membership when the query has Any items.
+  enteredSnapshot: Set<number>;
+  exitedSnapshot: Set<number>;
+  // Changes that didn't fit in the script's buffer, kept until they are read.
+  pendingEntered?: number[];
+  pendingExited?: number[];
+}
+
+// Widget messages are encoded once when they arrive, so that receive_batch can copy them straight into the arena.
+// action is the message's action, type and sender are those of the Matrix event in its data, if it has one.
+export interface InboundMatrixWidgetMessage {
+  json: Uint8Array;
+  action: Uint8Array;
+  type: Uint8Array;
+  sender: Uint8Array;
+}
+
 export interface RemoteResourceManager {
   id: string;
   ctx: GameContext;
@@ -43,7 +87,7 @@ export interface RemoteResourceManager {
   resourceMap: Map<number, string | ArrayBuffer | RemoteResource>;
   gltfCache: Map<string, ResourceManagerGLTFCacheEntry>;
   nextQueryId: number;
-  registeredQueries: Map<number, Query>;
+  registeredQueries: Map<number, ScriptQuery>;
   maxEntities: number;
   nextComponentId: number;
   componentStoreSize: number;
@@ -59,7 +103,7 @@ export interface RemoteResourceManager {
   replicators: Map<number, Replicator>;
   nextReplicatorId: number;
   matrixListening: boolean;
-  inboundMatrixWidgetMessages: Uint8Array[];
+  inboundMatrixWidgetMessages: InboundMatrixWidgetMessage[];
   networkListeners: NetworkListener[];
   nextNetworkListenerId: number;
 }
@@ -87,6 +87,7 @@ import { AnimationComponent, BoneComponent } from "../animation/animation.game";
 import { RemoteResource } from "../resource/RemoteResourceClass";
 import { getRotationNoAlloc } from "../utils/getRotationNoAlloc";
 import { TypedArray32 } from "../utils/typedarray";
+import { getComponentStore } from "../resource/ComponentStore";
 import { addResourceRef } from "../resource/resource.game";
 
 /**
@@ -784,7 +785,7 @@ function loadGLTFComponents(loaderCtx: GLTFLoaderContext, extension: GLTFNodeCom
 
     const componentProps = extension[componentName];
 
-    const componentStore = resourceManager.componentStores.get(componentId);
+    const componentStore = getComponentStore(resourceManager, componentId);
 
     if (!componentStore) {
       console.warn(`Component store for ${componentName} not registered before gltf load. Ignoring.`);
@@ -1,4 +1,4 @@
-import { GameContext } from "../GameTypes";
+import { GameContext, InboundMatrixWidgetMessage } from "../GameTypes";
 import { defineModule, getModule, registerMessageHandler, Thread } from "../module/module.common";
 import { ScriptComponent, scriptQuery } from "../scripting/scripting.game";
 import { readString, WASMModuleContext, writeEncodedString } from "../scripting/WASMModuleContext";
@@ -21,11 +21,19 @@ export const MatrixModule = defineModule<GameContext, MatrixModuleState>({
   },
 });
 
+const emptyString = new Uint8Array(0);
+
+function encodeOptionalString(textEncoder: TextEncoder, value: unknown) {
+  return typeof value === "string" ? textEncoder.encode(value) : emptyString;
+}
+
 function onWidgetMessage(ctx: GameContext, message: WidgetMessage) {
   const { textEncoder } = getModule(ctx, MatrixModule);
 
   const scripts = scriptQuery(ctx.world);
 
+  let inboundMessage: InboundMatrixWidgetMessage | undefined;
+
   for (let i = 0; i < scripts.length; i++) {
     const script = ScriptComponent.get(scripts[i]);
 
@@ -36,13 +44,32 @@ function onWidgetMessage(ctx: GameContext, message: WidgetMessage) {
     const resourceManager = script.wasmCtx.resourceManager;
 
     if (resourceManager.matrixListening) {
-      const json = JSON.stringify(message.message);
-      const encodedMessage = textEncoder.encode(json);
-      resourceManager.inboundMatrixWidgetMessages.push(encodedMessage);
+      if (!inboundMessage) {
+        const widgetMessage = message.message;
+        const event = widgetMessage.data as { type?: unknown; sender?: unknown } | undefined;
+
+        inboundMessage = {
+          json: textEncoder.encode(JSON.stringify(widgetMessage)),
+          action: encodeOptionalString(textEncoder, widgetMessage.action),
+          type: encodeOptionalString(textEncoder, event?.type),
+          sender: encodeOptionalString(textEncoder, event?.sender),
+        };
+      }
+
+      resourceManager.inboundMatrixWidgetMessages.push(inboundMessage);
     }
   }
 }
 
+// 8 uint32s: byte offset, byte length, action offset, action length, type offset, type length, sender offset and
+// sender length.
+const MatrixEventHeaderByteLength = 32;
+
+// The JSON is followed by a NUL byte so that it can be parsed in place.
+function getMatrixEventByteLength(message: InboundMatrixWidgetMessage) {
+  return message.json.byteLength + 1 + message.action.byteLength + message.type.byteLength + message.sender.byteLength;
+}
+
 export function createMatrixWASMModule(ctx: GameContext, wasmCtx: WASMModuleContext) {
   const matrixWASMModule = {
     listen() {
@@ -86,7 +113,7 @@ export function createMatrixWASMModule(ctx: GameContext, wasmCtx: WASMModuleCont
     get_event_size() {
       const resourceManager = wasmCtx.resourceManager;
       const messages = resourceManager.inboundMatrixWidgetMessages;
-      return messages.length === 0 ? 0 : messages[messages.length - 1].byteLength + 1;
+      return messages.length === 0 ? 0 : messages[messages.length - 1].json.byteLength + 1;
     },
     receive(eventBufPtr: number, maxBufLength: number) {
       const resourceManager = wasmCtx.resourceManager;
@@ -102,17 +129,77 @@ export function createMatrixWASMModule(ctx: GameContext, wasmCtx: WASMModuleCont
           return 0;
         }
 
-        if (message.byteLength > maxBufLength) {
+        if (message.json.byteLength > maxBufLength) {
           console.error("Matrix: Error receiving event: Packet is larger than target buffer.");
           return -1;
         }
 
-        return writeEncodedString(wasmCtx, eventBufPtr, message);
+        return writeEncodedString(wasmCtx, eventBufPtr, message.json);
       } catch (error) {
         console.error("Matrix: Error receiving event: ", error);
         return -1;
       }
     },
+    receive_batch(arenaPtr: number, arenaByteLength: number) {
+      const resourceManager = wasmCtx.resourceManager;
+
+      try {
+        if (!resourceManager.matrixListening) {
+          console.error("Matrix: Cannot receive events in a closed state.");
+          return -1;
+        }
+
+        const messages = resourceManager.inboundMatrixWidgetMessages;
+
+        // Find how many queued events fit in the arena alongside their headers.
+        let count = 0;
+        let payloadByteLength = 0;
+
+        while (count < messages.length) {
+          const byteLength = getMatrixEventByteLength(messages[count]);
+
+          if ((count + 1) * MatrixEventHeaderByteLength + payloadByteLength + byteLength > arenaByteLength) {
+            break;
+          }
+
+          payloadByteLength += byteLength;
+          count++;
+        }
+
+        if (count === 0 && messages.length > 0) {
+          console.error("Matrix: Error receiving events: Event is larger than the arena.");
+          return -1;
+        }
+
+        const U8Heap = wasmCtx.U8Heap;
+        const U32Heap = wasmCtx.U32Heap;
+        let offset = count * MatrixEventHeaderByteLength;
+
+        const writeString = (header: number, value: Uint8Array) => {
+          U32Heap[header] = offset;
+          U32Heap[header + 1] = value.byteLength;
+          U8Heap.set(value, arenaPtr + offset);
+          offset += value.byteLength;
+        };
+
+        for (let i = 0; i < count; i++) {
+          const message = messages[i];
+          const header = (arenaPtr + i * MatrixEventHeaderByteLength) / 4;
+          writeString(header, message.json);
+          U8Heap[arenaPtr + offset++] = 0;
+          writeString(header + 2, message.action);
+          writeString(header + 4, message.type);
+          writeString(header + 6, message.sender);
+        }
+
+        messages.splice(0, count);
+
+        return count;
+      } catch (error) {
+        console.error("Matrix: Error receiving events: ", error);
+        return -1;
+      }
+    },
   };
 
   const disposeMatrixWASMModule = () => {
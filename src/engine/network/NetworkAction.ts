@@ -13,6 +13,11 @@ export enum NetworkAction {
   BinaryScriptMessage,
   StringScriptMessage,
   InformXRMode,
+  ScriptMessageBatch,
+  ReplicatorState,
+  // Handled by the main thread to measure round trip times, never forwarded to the game thread.
+  Ping,
+  Pong,
 }
 
 export const UnreliableNetworkActions = [NetworkAction.UpdateChanged, NetworkAction.UpdateSnapshot];
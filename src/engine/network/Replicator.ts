@@ -14,6 +14,8 @@ export interface Replicator {
   spawned: Replication[];
   despawned: Replication[];
   eidToData: Map<number, ArrayBuffer>;
+  // State snapshots received for this replicator, in order. See replicator-state.h.
+  stateInbound: ArrayBuffer[];
 }
 
 export const createReplicator = (network: GameNetworkState, resourceManager: RemoteResourceManager) => {
@@ -26,6 +28,7 @@ export const createReplicator = (network: GameNetworkState, resourceManager: Rem
     spawned: [],
     despawned: [],
     eidToData: new Map(),
+    stateInbound: [],
   };
 
   network.prefabToReplicator.set(prefabName, replicator);
@@ -6,6 +6,7 @@ import { NetworkRingBuffer } from "./RingBuffer";
 export enum NetworkMessageType {
   // Main -> Game
   InitializeNetworkState = "InitializeNetworkState",
+  PeerStats = "peer-stats",
 
   // Game -> Main
   AddPeerId = "add-peer-id",
@@ -26,6 +27,14 @@ export interface InitializeNetworkStateMessage extends Message<NetworkMessageTyp
   outgoingUnreliableRingBuffer: NetworkRingBuffer;
 }
 
+export interface PeerStatsMessage extends Message<NetworkMessageType.PeerStats> {
+  peerIds: string[];
+  // Bytes buffered in each peer's data channel and not sent yet.
+  backlogs: number[];
+  // Smoothed round trip time to each peer in milliseconds, 0 until the first pong.
+  rtts: number[];
+}
+
 // Game -> Main
 
 export interface AddPeerIdMessage extends Message<NetworkMessageType.AddPeerId> {
@@ -12,6 +12,7 @@ import {
   NetworkMessageType,
   PeerEnteredMessage,
   PeerExitedMessage,
+  PeerStatsMessage,
   RemovePeerIdMessage,
   SetHostMessage,
 } from "./network.common";
@@ -48,6 +49,13 @@ export interface DeferredUpdate {
   quaternion: Float32Array;
 }
 
+export interface PeerNetworkStats {
+  // Bytes buffered in the peer's data channel and not sent yet.
+  backlog: number;
+  // Smoothed round trip time in milliseconds, 0 until it has been measured.
+  rtt: number;
+}
+
 export interface GameNetworkState {
   onExitWorldQueue: any[];
   incomingReliableRingBuffer: NetworkRingBuffer;
@@ -65,6 +73,7 @@ export interface GameNetworkState {
   peerIdToHistorian: Map<string, Historian>;
   peerIdToEntityId: Map<string, number>;
   peerIdToXRMode: Map<string, XRMode>;
+  peerIdToStats: Map<string, PeerNetworkStats>;
   entityIdToPeerId: Map<number, string>;
   networkIdToEntityId: Map<number, number>;
   localIdCount: number;
@@ -110,6 +119,7 @@ export const NetworkModule = defineModule<GameContext, GameNetworkState>({
       networkIdToEntityId: new Map(),
       peerIdToEntityId: new Map(),
       peerIdToXRMode: new Map(),
+      peerIdToStats: new Map(),
       entityIdToPeerId: new Map(),
       indexToPeerId: new Map(),
       peerIdCount: 0,
@@ -143,6 +153,7 @@ export const NetworkModule = defineModule<GameContext, GameNetworkState>({
       registerMessageHandler(ctx, NetworkMessageType.SetHost, onSetHost),
       registerMessageHandler(ctx, NetworkMessageType.AddPeerId, onAddPeerId),
       registerMessageHandler(ctx, NetworkMessageType.RemovePeerId, onRemovePeerId),
+      registerMessageHandler(ctx, NetworkMessageType.PeerStats, onPeerStats),
       registerMessageHandler(ctx, ThirdRoomMessageType.ExitWorld, onExitWorld),
     ];
 
@@ -201,6 +212,7 @@ export const removePeerId = (ctx: GameContext, peerId: string) => {
     }
 
     network.peers.splice(peerArrIndex, 1);
+    network.peerIdToStats.delete(peerId);
 
     ctx.sendMessage<PeerExitedMessage>(Thread.Game, { type: NetworkMessageType.PeerExited, peerIndex });
   } else {
@@ -210,6 +222,23 @@ export const removePeerId = (ctx: GameContext, peerId: string) => {
 
 const onRemovePeerId = (ctx: GameContext, message: RemovePeerIdMessage) => removePeerId(ctx, message.peerId);
 
+const onPeerStats = (ctx: GameContext, message: PeerStatsMessage) => {
+  const network = getModule(ctx, NetworkModule);
+
+  for (let i = 0; i < message.peerIds.length; i++) {
+    const peerId = message.peerIds[i];
+    let stats = network.peerIdToStats.get(peerId);
+
+    if (!stats) {
+      stats = { backlog: 0, rtt: 0 };
+      network.peerIdToStats.set(peerId, stats);
+    }
+
+    stats.backlog = message.backlogs[i];
+    stats.rtt = message.rtts[i];
+  }
+};
+
 const onExitWorld = (ctx: GameContext, message: ExitWorldMessage) => {
   const network = getModule(ctx, NetworkModule);
   network.onExitWorldQueue.push(message);
@@ -225,6 +254,7 @@ export function NetworkExitWorldQueueSystem(ctx: GameContext) {
     network.peers = [];
     network.newPeers = [];
     network.peerIdToEntityId.clear();
+    network.peerIdToStats.clear();
     network.entityIdToPeerId.clear();
     network.networkIdToEntityId.clear();
     network.localIdCount = 1;
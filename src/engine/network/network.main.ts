@@ -1,6 +1,6 @@
 import { availableRead } from "@thirdroom/ringbuffer";
 
-import { InitializeNetworkStateMessage, NetworkMessageType, SetHostMessage } from "./network.common";
+import { InitializeNetworkStateMessage, NetworkMessageType, PeerStatsMessage, SetHostMessage } from "./network.common";
 import { MainContext } from "../MainThread";
 import { AudioModule, setPeerMediaStream } from "../audio/audio.main";
 import { defineModule, getModule, Thread } from "../module/module.common";
@@ -11,7 +11,7 @@ import {
   NetworkRingBuffer,
 } from "./RingBuffer";
 import { createCursorView, readUint8 } from "../allocator/CursorView";
-import { UnreliableNetworkActions } from "./NetworkAction";
+import { NetworkAction, UnreliableNetworkActions } from "./NetworkAction";
 
 /*********
  * Types *
@@ -28,8 +28,17 @@ export interface MainNetworkState {
   outgoingUnreliableRingBuffer: NetworkRingBuffer;
   peerId?: string;
   hostId?: string;
+  // Smoothed round trip times in milliseconds, measured with pings on the reliable channel.
+  peerRTTs: Map<string, number>;
+  lastPingTime: number;
+  lastPeerStatsTime: number;
 }
 
+// Pings go through the same ordered channel as game messages, so the RTT includes time spent queued behind them.
+const PING_INTERVAL = 1000;
+const PEER_STATS_INTERVAL = 100;
+const PING_BYTE_LENGTH = 9;
+
 /******************
  * Initialization *
  *****************/
@@ -58,6 +67,9 @@ export const NetworkModule = defineModule<MainContext, MainNetworkState>({
       reliableChannels: new Map(),
       unreliableChannels: new Map(),
       incomingMessageHandlers: new Map(),
+      peerRTTs: new Map(),
+      lastPingTime: 0,
+      lastPeerStatsTime: 0,
     };
   },
   init(ctx) {},
@@ -73,9 +85,32 @@ function isPacketReliable(data: ArrayBuffer): boolean {
   return !UnreliableNetworkActions.includes(msgType);
 }
 
+function onPingMessage(network: MainNetworkState, peerId: string, data: ArrayBuffer) {
+  const view = new DataView(data);
+
+  if (view.getUint8(0) === NetworkAction.Ping) {
+    const pong = data.slice(0);
+    new DataView(pong).setUint8(0, NetworkAction.Pong);
+    const channel = network.reliableChannels.get(peerId);
+    if (channel?.readyState === "open") channel.send(pong);
+    return;
+  }
+
+  const sample = performance.now() - view.getFloat64(1);
+  const rtt = network.peerRTTs.get(peerId);
+  network.peerRTTs.set(peerId, rtt === undefined ? sample : rtt * 0.875 + sample * 0.125);
+}
+
 const onIncomingMessage =
   (ctx: MainContext, network: MainNetworkState, peerId: string) =>
   ({ data }: { data: ArrayBuffer }) => {
+    const action = new Uint8Array(data, 0, 1)[0];
+
+    if (action === NetworkAction.Ping || action === NetworkAction.Pong) {
+      onPingMessage(network, peerId, data);
+      return;
+    }
+
     const isReliable = isPacketReliable(data);
     if (isReliable) {
       if (!enqueueNetworkRingBuffer(network.incomingReliableRingBuffer, peerId, data)) {
@@ -102,6 +137,7 @@ function onPeerLeft(ctx: MainContext, peerId: string) {
 
   reliableChannels.delete(peerId);
   unreliableChannels.delete(peerId);
+  network.peerRTTs.delete(peerId);
 
   const audio = getModule(ctx, AudioModule);
   setPeerMediaStream(audio, peerId, undefined);
@@ -209,6 +245,37 @@ export function disconnect(ctx: MainContext) {
   }
 }
 
+function sendPings(network: MainNetworkState, now: number) {
+  const ping = new ArrayBuffer(PING_BYTE_LENGTH);
+  const view = new DataView(ping);
+  view.setUint8(0, NetworkAction.Ping);
+  view.setFloat64(1, now);
+
+  network.reliableChannels.forEach((channel) => {
+    if (channel.readyState === "open") channel.send(ping);
+  });
+}
+
+// Lets scripts see how far behind each peer's data channel is, so they can back off before it spikes latency.
+function sendPeerStats(ctx: MainContext, network: MainNetworkState) {
+  const peerIds: string[] = [];
+  const backlogs: number[] = [];
+  const rtts: number[] = [];
+
+  network.reliableChannels.forEach((channel, peerId) => {
+    peerIds.push(peerId);
+    backlogs.push(channel.bufferedAmount);
+    rtts.push(network.peerRTTs.get(peerId) || 0);
+  });
+
+  ctx.sendMessage<PeerStatsMessage>(Thread.Game, {
+    type: NetworkMessageType.PeerStats,
+    peerIds,
+    backlogs,
+    rtts,
+  });
+}
+
 const ringOut = { packet: new ArrayBuffer(0), peerId: "", broadcast: false };
 export function MainThreadNetworkSystem(ctx: MainContext) {
   const network = getModule(ctx, NetworkModule);
@@ -257,4 +324,16 @@ export function MainThreadNetworkSystem(ctx: MainContext) {
       peer.send(ringOut.packet);
     }
   }
+
+  const now = performance.now();
+
+  if (now - network.lastPingTime >= PING_INTERVAL) {
+    network.lastPingTime = now;
+    sendPings(network, now);
+  }
+
+  if (network.reliableChannels.size > 0 && now - network.lastPeerStatsTime >= PEER_STATS_INTERVAL) {
+    network.lastPeerStatsTime = now;
+    sendPeerStats(ctx, network);
+  }
 }
@@ -4,9 +4,12 @@ import {
   createCursorView,
   moveCursorView,
   readArrayBuffer,
+  readString,
+  scrollCursorView,
   sliceCursorView,
   writeArrayBuffer as cursorWriteArrayBuffer,
   writeInt32,
+  writeString as cursorWriteString,
   CursorView,
 } from "../allocator/CursorView";
 import { GameContext } from "../GameTypes";
@@ -15,7 +18,7 @@ import { GameNetworkState, NetworkModule } from "./network.game";
 import { NetworkAction } from "./NetworkAction";
 import { broadcastReliable, sendReliable, sendUnreliable } from "./outbound.game";
 import { writeMetadata } from "./serialization.game";
-import { writeUint32, readUint32 } from "../allocator/CursorView";
+import { writeUint32, readUint32, writeUint8, readUint8 } from "../allocator/CursorView";
 import { registerInboundMessageHandler } from "./inbound.game";
 import {
   getScriptResource,
@@ -31,10 +34,16 @@ import { getRemoteResource } from "../resource/resource.game";
 import { createDisposables } from "../utils/createDisposables";
 import { NetworkMessageType, PeerEnteredMessage, PeerExitedMessage } from "./network.common";
 import { ScriptComponent, scriptQuery } from "../scripting/scripting.game";
-import { Replication, createReplicator } from "./Replicator";
+import { Replication, createReplicator, getReplicator } from "./Replicator";
 import { Networked, Owned } from "./NetworkComponents";
 import { addPrefabComponent } from "../prefab/prefab.game";
 
+// sizeof(NetworkMessageHeader) in websg-networking.h
+const NetworkMessageHeaderByteLength = 16;
+
+// sizeof(ReplicationHeader) in websg-networking.h
+const ReplicationHeaderByteLength = 20;
+
 export const WebSGNetworkModule = defineModule<GameContext, {}>({
   name: "WebSGNetwork",
   create: () => {
@@ -48,6 +57,8 @@ export const WebSGNetworkModule = defineModule<GameContext, {}>({
     registerInboundMessageHandler(network, NetworkAction.StringScriptMessage, (ctx, v, peerId) =>
       deserializeScriptMessage(ctx, v, peerId, true)
     );
+    registerInboundMessageHandler(network, NetworkAction.ScriptMessageBatch, deserializeScriptMessageBatch);
+    registerInboundMessageHandler(network, NetworkAction.ReplicatorState, deserializeReplicatorState);
 
     return createDisposables([
       registerMessageHandler(ctx, NetworkMessageType.PeerEntered, onPeerEntered),
@@ -114,6 +125,86 @@ export function createWebSGNetworkModule(ctx: GameContext, wasmCtx: WASMModuleCo
         return -1;
       }
     },
+    network_send_batch: (headersPtr: number, messageCount: number, payloadsPtr: number, payloadsByteLength: number) => {
+      try {
+        const U32Heap = wasmCtx.U32Heap;
+        const U8Heap = wasmCtx.U8Heap;
+
+        // Group messages by target and reliability so each group goes out as a single packet.
+        scriptMessageBatches.clear();
+        let result = 0;
+
+        for (let i = 0; i < messageCount; i++) {
+          const header = headersPtr / 4 + i * 4;
+          const peerIndex = U32Heap[header];
+          const byteOffset = U32Heap[header + 1];
+          const byteLength = U32Heap[header + 2];
+          const flags = U32Heap[header + 3];
+          const binary = (flags & 0xffff) !== 0;
+          const reliable = flags >>> 16 !== 0;
+
+          if (byteOffset + byteLength > payloadsByteLength) {
+            console.error("WebSGNetworking: Queued message is out of bounds.");
+            return -1;
+          }
+
+          // Checked before anything is sent, the rest of the batch still goes out without the oversized message.
+          if (byteLength > ScriptMessageMaxByteLength) {
+            console.error(
+              `WebSGNetworking: Queued message ${i} to peer ${peerIndex} is ${byteLength} bytes, ` +
+                `larger than the ${ScriptMessageMaxByteLength} byte limit. The message was dropped.`
+            );
+            result = -1;
+            continue;
+          }
+
+          const batchKey = peerIndex * 2 + (reliable ? 1 : 0);
+          let batch = scriptMessageBatches.get(batchKey);
+
+          if (!batch) {
+            batch = { peerIndex, reliable, messages: [] };
+            scriptMessageBatches.set(batchKey, batch);
+          }
+
+          const start = payloadsPtr + byteOffset;
+          batch.messages.push([U8Heap.subarray(start, start + byteLength), binary]);
+        }
+
+        for (const { peerIndex, reliable, messages } of scriptMessageBatches.values()) {
+          let peerId: string | undefined;
+
+          if (peerIndex !== NetworkBroadcastPeerIndex) {
+            peerId = network.indexToPeerId.get(peerIndex);
+
+            if (!peerId) {
+              console.error(`WebSGNetworking: Peer ${peerIndex} does not exist.`);
+              result = -1;
+              continue;
+            }
+          } else if (!reliable) {
+            // Rejected when the message is queued, only reachable if the script's queue is corrupted.
+            console.error("WebSGNetworking: Unreliable broadcast currently not supported.");
+            result = -1;
+            continue;
+          }
+
+          for (const packet of createScriptMessageBatches(messages)) {
+            if (peerId === undefined) {
+              broadcastReliable(ctx, network, packet);
+            } else if (reliable) {
+              sendReliable(ctx, network, peerId, packet);
+            } else {
+              sendUnreliable(ctx, network, peerId, packet);
+            }
+          }
+        }
+
+        return result;
+      } catch (error) {
+        console.error("WebSGNetworking: Error sending queued packets:", error);
+        return -1;
+      }
+    },
     network_listen() {
       const id = wasmCtx.resourceManager.nextNetworkListenerId++;
 
@@ -221,6 +312,77 @@ export function createWebSGNetworkModule(ctx: GameContext, wasmCtx: WASMModuleCo
         return -1;
       }
     },
+    network_listener_receive_batch: (listenerId: number, arenaPtr: number, arenaByteLength: number) => {
+      try {
+        const listener = wasmCtx.resourceManager.networkListeners.find((l) => l.id === listenerId);
+
+        if (!listener) {
+          console.error(`WebSGNetworking: Listener ${listenerId} does not exist or has been closed.`);
+          return -1;
+        }
+
+        const inbound = listener.inbound;
+
+        // Find how many queued messages fit in the arena alongside their headers.
+        let end = 0;
+        let count = 0;
+        let payloadByteLength = 0;
+
+        while (end < inbound.length) {
+          const [peerId, buffer] = inbound[end];
+
+          if (network.peerIdToIndex.get(peerId) === undefined) {
+            // This message is from a peer that no longer exists.
+            console.warn("Discarded message from peer that no longer exists");
+            end++;
+            continue;
+          }
+
+          if ((count + 1) * NetworkMessageHeaderByteLength + payloadByteLength + buffer.byteLength > arenaByteLength) {
+            break;
+          }
+
+          count++;
+          payloadByteLength += buffer.byteLength;
+          end++;
+        }
+
+        // The script grows its arena to the returned byte length and calls again
+        if (count === 0 && end < inbound.length) {
+          inbound.splice(0, end);
+          return -(NetworkMessageHeaderByteLength + inbound[0][1].byteLength);
+        }
+
+        let headerPtr = arenaPtr;
+        let payloadPtr = arenaPtr + count * NetworkMessageHeaderByteLength;
+
+        for (let i = 0; i < end; i++) {
+          const [peerId, buffer, binary] = inbound[i];
+          const peerIndex = network.peerIdToIndex.get(peerId);
+
+          if (peerIndex === undefined) {
+            continue;
+          }
+
+          moveCursorView(wasmCtx.cursorView, headerPtr);
+          writeUint32(wasmCtx.cursorView, peerIndex);
+          writeUint32(wasmCtx.cursorView, payloadPtr - arenaPtr);
+          writeUint32(wasmCtx.cursorView, buffer.byteLength);
+          writeUint32(wasmCtx.cursorView, binary ? 1 : 0);
+          writeArrayBuffer(wasmCtx, payloadPtr, buffer);
+
+          headerPtr += NetworkMessageHeaderByteLength;
+          payloadPtr += buffer.byteLength;
+        }
+
+        inbound.splice(0, end);
+
+        return count;
+      } catch (e) {
+        console.error("Error writing packets to arena:", e);
+        return -1;
+      }
+    },
     peer_get_id_length(peerIndex: number) {
       const peerId = network.indexToPeerId.get(peerIndex);
 
@@ -290,6 +452,35 @@ export function createWebSGNetworkModule(ctx: GameContext, wasmCtx: WASMModuleCo
 
       return 0;
     },
+    network_get_peer_poses(peerIndicesPtr: number, posesPtr: number, maxCount: number) {
+      peerPoseIndices.length = 0;
+      peerPoseNodes.length = 0;
+
+      for (const peerIndex of network.indexToPeerId.keys()) {
+        const node = getPeerNode(ctx, network, peerIndex);
+
+        if (node) {
+          peerPoseIndices.push(peerIndex);
+          peerPoseNodes.push(node);
+        }
+      }
+
+      const count = Math.min(peerPoseNodes.length, maxCount);
+      const U32Heap = wasmCtx.U32Heap;
+      const F32Heap = wasmCtx.F32Heap;
+      const indices = peerIndicesPtr / 4;
+      const translations = posesPtr / 4;
+      const rotations = translations + count * 3;
+
+      for (let i = 0; i < count; i++) {
+        const node = peerPoseNodes[i];
+        U32Heap[indices + i] = peerPoseIndices[i];
+        F32Heap.set(node.position, translations + i * 3);
+        F32Heap.set(node.quaternion, rotations + i * 4);
+      }
+
+      return peerPoseNodes.length;
+    },
     peer_is_host(peerIndex: number) {
       const peerId = network.indexToPeerId.get(peerIndex);
 
@@ -310,6 +501,21 @@ export function createWebSGNetworkModule(ctx: GameContext, wasmCtx: WASMModuleCo
 
       return network.peerId === peerId ? 1 : 0;
     },
+    peer_get_stats(peerIndex: number, statsPtr: number) {
+      const peerId = network.indexToPeerId.get(peerIndex);
+
+      if (!peerId) {
+        console.error(`WebSGNetworking: Peer index ${peerIndex} does not exist.`);
+        return -1;
+      }
+
+      // NetworkPeerStats: uint32 backlog, float rtt. The local peer and peers without stats yet read as 0.
+      const stats = network.peerIdToStats.get(peerId);
+      wasmCtx.U32Heap[statsPtr / 4] = stats ? stats.backlog : 0;
+      wasmCtx.F32Heap[statsPtr / 4 + 1] = stats ? stats.rtt : 0;
+
+      return 0;
+    },
     peer_send: (peerIndex: number, packetPtr: number, byteLength: number, binary: number, reliable: number) => {
       try {
         const peerId = network.indexToPeerId.get(peerIndex);
@@ -590,6 +796,103 @@ export function createWebSGNetworkModule(ctx: GameContext, wasmCtx: WASMModuleCo
         return -1;
       }
     },
+    replicator_spawned_receive_batch: (replicatorId: number, arenaPtr: number, arenaByteLength: number) => {
+      const replicator = wasmCtx.resourceManager.replicators.get(replicatorId);
+
+      if (!replicator) {
+        console.error(`WebSGNetworking: replicator ${replicatorId} does not exist or has been closed.`);
+        return -1;
+      }
+
+      return receiveReplicationBatch(wasmCtx, replicator.spawned, arenaPtr, arenaByteLength);
+    },
+    replicator_despawned_receive_batch: (replicatorId: number, arenaPtr: number, arenaByteLength: number) => {
+      const replicator = wasmCtx.resourceManager.replicators.get(replicatorId);
+
+      if (!replicator) {
+        console.error(`WebSGNetworking: replicator ${replicatorId} does not exist or has been closed.`);
+        return -1;
+      }
+
+      return receiveReplicationBatch(wasmCtx, replicator.despawned, arenaPtr, arenaByteLength);
+    },
+    node_get_network_id: (nodeId: number) => {
+      return hasComponent(ctx.world, Networked, nodeId) ? Networked.networkId[nodeId] : 0;
+    },
+    network_get_node_id: (networkId: number) => {
+      const eid = network.networkIdToEntityId.get(networkId);
+      return eid !== undefined && getRemoteResource<RemoteNode>(ctx, eid) ? eid : 0;
+    },
+    replicator_send_state: (replicatorId: number, peerIndex: number, packetPtr: number, byteLength: number) => {
+      try {
+        const replicator = wasmCtx.resourceManager.replicators.get(replicatorId);
+
+        if (!replicator) {
+          console.error(`WebSGNetworking: replicator ${replicatorId} does not exist or has been closed.`);
+          return -1;
+        }
+
+        const packet = createReplicatorStateMessage(replicator.prefabName, readUint8Array(wasmCtx, packetPtr, byteLength));
+
+        // Snapshots are deltas against the previous one, so they must arrive reliably and in order.
+        if (peerIndex === NetworkBroadcastPeerIndex) {
+          broadcastReliable(ctx, network, packet);
+          return 0;
+        }
+
+        const peerId = network.indexToPeerId.get(peerIndex);
+
+        if (!peerId) {
+          console.error(`WebSGNetworking: Peer ${peerIndex} does not exist.`);
+          return -1;
+        }
+
+        sendReliable(ctx, network, peerId, packet);
+
+        return 0;
+      } catch (error) {
+        console.error("WebSGNetworking: Error sending replicator state:", error);
+        return -1;
+      }
+    },
+    replicator_get_state_byte_length: (replicatorId: number) => {
+      const replicator = wasmCtx.resourceManager.replicators.get(replicatorId);
+
+      if (!replicator) {
+        console.error(`WebSGNetworking: replicator ${replicatorId} does not exist or has been closed.`);
+        return -1;
+      }
+
+      return replicator.stateInbound.length > 0 ? replicator.stateInbound[0].byteLength : 0;
+    },
+    replicator_receive_state: (replicatorId: number, bufferPtr: number, maxByteLength: number) => {
+      try {
+        const replicator = wasmCtx.resourceManager.replicators.get(replicatorId);
+
+        if (!replicator) {
+          console.error(`WebSGNetworking: replicator ${replicatorId} does not exist or has been closed.`);
+          return -1;
+        }
+
+        const state = replicator.stateInbound[0];
+
+        if (!state) {
+          return 0;
+        }
+
+        if (state.byteLength > maxByteLength) {
+          console.error("WebSGNetworking: Replicator state snapshot is larger than the buffer.");
+          return -1;
+        }
+
+        replicator.stateInbound.shift();
+
+        return writeArrayBuffer(wasmCtx, bufferPtr, state);
+      } catch (error) {
+        console.error("WebSGNetworking: Error receiving replicator state:", error);
+        return -1;
+      }
+    },
     node_add_network_synchronizer: (nodeId: number, propsPtr: number) => {
       try {
         const node = getScriptResource(wasmCtx, RemoteNode, nodeId);
@@ -651,6 +954,80 @@ export function createWebSGNetworkModule(ctx: GameContext, wasmCtx: WASMModuleCo
   return [networkWASMModule, disposeNetworkModule] as const;
 }
 
+// Packs as many queued replications as fit into the arena, see websg_replicator_spawned_receive_batch.
+function receiveReplicationBatch(
+  wasmCtx: WASMModuleContext,
+  queue: Replication[],
+  arenaPtr: number,
+  arenaByteLength: number
+) {
+  try {
+    let end = 0;
+    let count = 0;
+    let payloadByteLength = 0;
+
+    while (end < queue.length) {
+      const replication = queue[end];
+
+      if (replication.peerIndex === undefined) {
+        console.warn("Discarded replication from peer that no longer exists");
+        end++;
+        continue;
+      }
+
+      const byteLength = replication.data?.byteLength || 0;
+
+      if ((count + 1) * ReplicationHeaderByteLength + payloadByteLength + byteLength > arenaByteLength) {
+        break;
+      }
+
+      count++;
+      payloadByteLength += byteLength;
+      end++;
+    }
+
+    if (count === 0 && end < queue.length) {
+      queue.splice(0, end);
+      console.error("Failed to receive replications, length exceeded arena length");
+      return -1;
+    }
+
+    let headerPtr = arenaPtr;
+    let payloadPtr = arenaPtr + count * ReplicationHeaderByteLength;
+
+    for (let i = 0; i < end; i++) {
+      const replication = queue[i];
+
+      if (replication.peerIndex === undefined) {
+        continue;
+      }
+
+      const byteLength = replication.data?.byteLength || 0;
+
+      moveCursorView(wasmCtx.cursorView, headerPtr);
+      writeUint32(wasmCtx.cursorView, replication.nodeId || 0);
+      writeUint32(wasmCtx.cursorView, replication.networkId || 0);
+      writeUint32(wasmCtx.cursorView, replication.peerIndex);
+      writeUint32(wasmCtx.cursorView, payloadPtr - arenaPtr);
+      writeUint32(wasmCtx.cursorView, byteLength);
+
+      if (replication.data) {
+        writeArrayBuffer(wasmCtx, payloadPtr, replication.data);
+      }
+
+      headerPtr += ReplicationHeaderByteLength;
+      payloadPtr += byteLength;
+    }
+
+    queue.splice(0, end);
+
+    return count;
+  } catch (e) {
+    console.error("Error receiving replications:", e);
+    return -1;
+  }
+}
+
 const messageView = createCursorView(new ArrayBuffer(10000));
 
 function createScriptMessage(ctx: GameContext, packet: ArrayBuffer, binary: boolean) {
@@ -664,6 +1041,87 @@ function serializeScriptMessage(v: CursorView, packet: ArrayBuffer) {
   cursorWriteArrayBuffer(v, packet);
 }
 
+// Must match NETWORK_BROADCAST_PEER_INDEX in websg-networking.h
+const NetworkBroadcastPeerIndex = 0xffffffff;
+
+// Script message batches are split so that each packet fits in messageView and the network ring buffers.
+const ScriptMessageBatchMaxByteLength = 10000;
+
+// Message type, elapsed time and input tick written by writeMetadata.
+const ScriptMessageBatchMetadataByteLength =
+  Uint8Array.BYTES_PER_ELEMENT + Float64Array.BYTES_PER_ELEMENT + Uint32Array.BYTES_PER_ELEMENT;
+
+// Message count, then for each message its binary flag, byte length and payload.
+const ScriptMessageBatchHeaderByteLength = Uint32Array.BYTES_PER_ELEMENT;
+const ScriptMessageBatchEntryByteLength = Uint8Array.BYTES_PER_ELEMENT + Uint32Array.BYTES_PER_ELEMENT;
+
+// Largest payload that fits in a packet on its own. Must match NETWORK_MAX_MESSAGE_BYTE_LENGTH in
+// websg-networking.h.
+const ScriptMessageMaxByteLength =
+  ScriptMessageBatchMaxByteLength -
+  ScriptMessageBatchMetadataByteLength -
+  ScriptMessageBatchHeaderByteLength -
+  ScriptMessageBatchEntryByteLength;
+
+interface ScriptMessageBatch {
+  peerIndex: number;
+  reliable: boolean;
+  messages: [Uint8Array, boolean][];
+}
+
+const scriptMessageBatches = new Map<number, ScriptMessageBatch>();
+
+// Reused by network_get_peer_poses.
+const peerPoseIndices: number[] = [];
+const peerPoseNodes: RemoteNode[] = [];
+
+function createScriptMessageBatches(messages: [Uint8Array, boolean][]) {
+  const packets: ArrayBuffer[] = [];
+  let start = 0;
+
+  while (start < messages.length) {
+    writeMetadata(messageView, NetworkAction.ScriptMessageBatch);
+    const countCursor = messageView.cursor;
+    scrollCursorView(messageView, ScriptMessageBatchHeaderByteLength);
+
+    let end = start;
+
+    while (end < messages.length) {
+      const [payload, binary] = messages[end];
+      const byteLength = ScriptMessageBatchEntryByteLength + payload.byteLength;
+
+      // Messages larger than ScriptMessageMaxByteLength are rejected by network_send_batch, so every message fits
+      // in an empty packet.
+      if (end > start && messageView.cursor + byteLength > ScriptMessageBatchMaxByteLength) {
+        break;
+      }
+
+      writeUint8(messageView, binary ? 1 : 0);
+      serializeScriptMessage(messageView, payload);
+      end++;
+    }
+
+    const cursor = messageView.cursor;
+    moveCursorView(messageView, countCursor);
+    writeUint32(messageView, end - start);
+    moveCursorView(messageView, cursor);
+
+    packets.push(sliceCursorView(messageView));
+    start = end;
+  }
+
+  return packets;
+}
+
+function deserializeScriptMessageBatch(ctx: GameContext, v: CursorView, peerId: string) {
+  const count = readUint32(v);
+
+  for (let i = 0; i < count; i++) {
+    const binary = readUint8(v) === 1;
+    deserializeScriptMessage(ctx, v, peerId, binary);
+  }
+}
+
 function deserializeScriptMessage(ctx: GameContext, v: CursorView, peerId: string, binary: boolean) {
   const len = readUint32(v);
   const packet = readArrayBuffer(v, len);
@@ -692,6 +1150,40 @@ function deserializeScriptMessage(ctx: GameContext, v: CursorView, peerId: strin
   }
 }
 
+// writeMetadata: message type, elapsed time and input tick
+const MetadataByteLength = Uint8Array.BYTES_PER_ELEMENT + Float64Array.BYTES_PER_ELEMENT + Uint32Array.BYTES_PER_ELEMENT;
+
+// Snapshots of many objects can outgrow messageView, so state messages get their own view that grows as needed.
+let replicatorStateView = createCursorView(new ArrayBuffer(10000));
+
+function createReplicatorStateMessage(prefabName: string, packet: Uint8Array) {
+  // Prefab name (uint8 length + up to 255 bytes), byte length and snapshot
+  const byteLength = MetadataByteLength + 1 + 255 + Uint32Array.BYTES_PER_ELEMENT + packet.byteLength;
+
+  if (replicatorStateView.byteLength < byteLength) {
+    replicatorStateView = createCursorView(new ArrayBuffer(byteLength));
+  }
+
+  writeMetadata(replicatorStateView, NetworkAction.ReplicatorState);
+  cursorWriteString(replicatorStateView, prefabName);
+  writeUint32(replicatorStateView, packet.byteLength);
+  cursorWriteArrayBuffer(replicatorStateView, packet);
+  return sliceCursorView(replicatorStateView);
+}
+
+function deserializeReplicatorState(ctx: GameContext, v: CursorView) {
+  const network = getModule(ctx, NetworkModule);
+  const prefabName = readString(v);
+  const byteLength = readUint32(v);
+  const state = readArrayBuffer(v, byteLength);
+
+  const replicator = getReplicator(network, prefabName);
+
+  if (replicator) {
+    replicator.stateInbound.push(state);
+  }
+}
+
 function getPeerNode(ctx: GameContext, network: GameNetworkState, peerIndex: number) {
   const peerId = network.indexToPeerId.get(peerIndex);
 
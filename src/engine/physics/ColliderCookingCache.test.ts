@@ -0,0 +1,106 @@
+import { vec3 } from "gl-matrix";
+import { assert } from "vitest";
+
+import {
+  arrayBufferViewBytesEqual,
+  cookTrimeshShape,
+  copyArrayBufferViewBytes,
+  createColliderCookingCache,
+  getColliderCookingKey,
+  getCookedColliderShape,
+  hashArrayBufferView,
+  setCookedColliderShape,
+} from "./ColliderCookingCache";
+
+const positions = new Float32Array([0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1]);
+const indices = new Uint16Array([0, 1, 2, 0, 2, 3]);
+
+function createShape(source: Float32Array) {
+  return {
+    source: copyArrayBufferViewBytes(source),
+    vertices: source.slice(),
+    indices: Uint32Array.from(indices),
+  };
+}
+
+describe("ColliderCookingCache Tests", () => {
+  it("should hash identical data in separate buffers to the same key", () => {
+    const scale = vec3.fromValues(1, 1, 1);
+    const key = getColliderCookingKey(positions, scale);
+
+    assert.equal(getColliderCookingKey(positions.slice(), scale), key);
+    assert.notEqual(getColliderCookingKey(positions, vec3.fromValues(2, 1, 1)), key);
+    assert.notEqual(getColliderCookingKey(positions.slice(0, 9), scale), key);
+  });
+  it("should hash unaligned views by their bytes", () => {
+    const buffer = new Uint8Array(positions.byteLength + 1);
+    buffer.set(new Uint8Array(positions.buffer), 1);
+    const unaligned = new Uint8Array(buffer.buffer, 1, positions.byteLength);
+
+    assert.deepEqual(hashArrayBufferView(unaligned), hashArrayBufferView(positions));
+
+    const changed = positions.slice();
+    changed[11] = 2;
+    assert.notDeepEqual(hashArrayBufferView(changed), hashArrayBufferView(positions));
+  });
+  it("should compare aligned and unaligned views by their bytes", () => {
+    const buffer = new Uint8Array(positions.byteLength + 1);
+    buffer.set(new Uint8Array(positions.buffer), 1);
+    const unaligned = new Uint8Array(buffer.buffer, 1, positions.byteLength);
+
+    assert.ok(arrayBufferViewBytesEqual(positions, positions.slice()));
+    assert.ok(arrayBufferViewBytesEqual(unaligned, positions));
+    assert.notOk(arrayBufferViewBytesEqual(positions, positions.slice(0, 9)));
+
+    const changed = positions.slice();
+    changed[11] = 2;
+    assert.notOk(arrayBufferViewBytesEqual(changed, positions));
+  });
+  it("should cookTrimeshShape", () => {
+    const shape = cookTrimeshShape(positions, indices, vec3.fromValues(2, 3, 4));
+
+    assert.deepEqual(Array.from(shape.vertices), [0, 0, 0, 2, 0, 0, 0, 3, 0, 0, 0, 4]);
+    assert.ok(shape.indices instanceof Uint32Array);
+    assert.deepEqual(Array.from(shape.indices), [0, 1, 2, 0, 2, 3]);
+
+    const unindexed = cookTrimeshShape(positions, undefined, vec3.fromValues(1, 1, 1));
+    assert.deepEqual(Array.from(unindexed.indices), [0, 1, 2, 3]);
+  });
+  it("should share cooked shapes and evict the least recently used", () => {
+    const shapeByteLength = positions.byteLength * 2 + indices.length * 4;
+    const cache = createColliderCookingCache(shapeByteLength * 2);
+
+    const a = createShape(positions);
+    const b = createShape(positions);
+    const c = createShape(positions);
+
+    assert.equal(getCookedColliderShape(cache, "a", positions), undefined);
+    setCookedColliderShape(cache, "a", a);
+    setCookedColliderShape(cache, "b", b);
+    assert.equal(cache.byteLength, shapeByteLength * 2);
+
+    assert.equal(getCookedColliderShape(cache, "a", positions), a);
+    setCookedColliderShape(cache, "c", c);
+
+    assert.equal(cache.shapes.size, 2);
+    assert.equal(cache.byteLength, shapeByteLength * 2);
+    assert.equal(getCookedColliderShape(cache, "b", positions), undefined);
+    assert.equal(getCookedColliderShape(cache, "a", positions), a);
+    assert.equal(getCookedColliderShape(cache, "c", positions), c);
+    assert.equal(cache.hits, 3);
+    assert.equal(cache.misses, 2);
+  });
+  it("should not return a shape cooked from different data under the same key", () => {
+    const cache = createColliderCookingCache();
+    const shape = createShape(positions);
+    setCookedColliderShape(cache, "a", shape);
+
+    const colliding = positions.slice();
+    colliding[3] = 5;
+
+    assert.equal(getCookedColliderShape(cache, "a", colliding), undefined);
+    assert.equal(getCookedColliderShape(cache, "a", positions.slice()), shape);
+    assert.equal(cache.hits, 1);
+    assert.equal(cache.misses, 1);
+  });
+});
@@ -0,0 +1,207 @@
+import { vec3 } from "gl-matrix";
+
+import { scaleVec3Array } from "../common/accessor";
+
+/**
+ * Cooked convex hull collider geometry, shared by hull colliders with identical meshes.
+ *
+ * Only hulls are cached, computing a hull costs far more than hashing its points. Trimesh cooking is a copy of the
+ * vertices and Rapier builds the trimesh BVH for every collider anyway, so hashing them saves nothing.
+ *
+ * Shapes are keyed by a content hash of their positions and the scale the points were cooked at, so procedurally
+ * generated meshes with the same data hit the cache even when they are separate accessors. The hash is not
+ * collision resistant and scripts control the mesh data, so a hit is only used when the source positions match
+ * byte for byte. Cooked shapes are plain typed arrays that can be posted to another thread or stored as is.
+ *
+ * The cache is a LRU bounded by the byte length of the cooked shapes and their sources, Map iteration order is the
+ * recency order.
+ */
+export interface CookedColliderShape {
+  // Copy of the unscaled positions the shape was cooked from.
+  source: Uint8Array;
+  vertices: Float32Array;
+  indices: Uint32Array;
+}
+
+export interface ColliderCookingCache {
+  shapes: Map<string, CookedColliderShape>;
+  byteLength: number;
+  maxByteLength: number;
+  hits: number;
+  misses: number;
+}
+
+export const DEFAULT_COLLIDER_COOKING_CACHE_BYTE_LENGTH = 64 * 1024 * 1024;
+
+export function createColliderCookingCache(
+  maxByteLength = DEFAULT_COLLIDER_COOKING_CACHE_BYTE_LENGTH
+): ColliderCookingCache {
+  return {
+    shapes: new Map(),
+    byteLength: 0,
+    maxByteLength,
+    hits: 0,
+    misses: 0,
+  };
+}
+
+// Two independent 32 bit hashes of the view's bytes, hashed word by word.
+export function hashArrayBufferView(view: ArrayBufferView): [number, number] {
+  let h1 = 0x811c9dc5;
+  let h2 = 0x9747b28c;
+
+  let bytes = new Uint8Array(view.buffer, view.byteOffset, view.byteLength);
+
+  if (bytes.byteOffset % 4 !== 0) {
+    // Copy unaligned views so that they hash the same as aligned views of the same bytes
+    bytes = bytes.slice();
+  }
+
+  const wordCount = bytes.byteLength >> 2;
+
+  if (wordCount > 0) {
+    const words = new Uint32Array(bytes.buffer, bytes.byteOffset, wordCount);
+
+    for (let i = 0; i < wordCount; i++) {
+      const word = words[i];
+      h1 = Math.imul(h1 ^ word, 0x01000193);
+      h2 = Math.imul(h2 ^ word, 0x5bd1e995);
+      h2 ^= h2 >>> 15;
+    }
+  }
+
+  for (let i = wordCount << 2; i < bytes.length; i++) {
+    h1 = Math.imul(h1 ^ bytes[i], 0x01000193);
+    h2 = Math.imul(h2 ^ bytes[i], 0x5bd1e995);
+    h2 ^= h2 >>> 15;
+  }
+
+  return [h1 >>> 0, h2 >>> 0];
+}
+
+export function getColliderCookingKey(positions: ArrayBufferView, scale: ArrayLike<number>): string {
+  const [positionHash1, positionHash2] = hashArrayBufferView(positions);
+  return `${scale[0]},${scale[1]},${scale[2]}:${positions.byteLength}:${positionHash1}:${positionHash2}`;
+}
+
+export function copyArrayBufferViewBytes(view: ArrayBufferView): Uint8Array {
+  return new Uint8Array(view.buffer, view.byteOffset, view.byteLength).slice();
+}
+
+export function arrayBufferViewBytesEqual(a: ArrayBufferView, b: ArrayBufferView): boolean {
+  if (a.byteLength !== b.byteLength) {
+    return false;
+  }
+
+  const byteLength = a.byteLength;
+
+  if (a.byteOffset % 4 === 0 && b.byteOffset % 4 === 0) {
+    const wordCount = byteLength >> 2;
+    const aWords = new Uint32Array(a.buffer, a.byteOffset, wordCount);
+    const bWords = new Uint32Array(b.buffer, b.byteOffset, wordCount);
+
+    for (let i = 0; i < wordCount; i++) {
+      if (aWords[i] !== bWords[i]) {
+        return false;
+      }
+    }
+
+    const aBytes = new Uint8Array(a.buffer, a.byteOffset, byteLength);
+    const bBytes = new Uint8Array(b.buffer, b.byteOffset, byteLength);
+
+    for (let i = wordCount << 2; i < byteLength; i++) {
+      if (aBytes[i] !== bBytes[i]) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  const aBytes = new Uint8Array(a.buffer, a.byteOffset, byteLength);
+  const bBytes = new Uint8Array(b.buffer, b.byteOffset, byteLength);
+
+  for (let i = 0; i < byteLength; i++) {
+    if (aBytes[i] !== bBytes[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+function getCookedColliderShapeByteLength(shape: CookedColliderShape) {
+  return shape.source.byteLength + shape.vertices.byteLength + shape.indices.byteLength;
+}
+
+// Returns the cached shape for the key when it was cooked from the same positions.
+export function getCookedColliderShape(
+  cache: ColliderCookingCache,
+  key: string,
+  positions: ArrayBufferView
+): CookedColliderShape | undefined {
+  const shape = cache.shapes.get(key);
+
+  if (shape && arrayBufferViewBytesEqual(shape.source, positions)) {
+    // Move the shape to the back of the LRU
+    cache.shapes.delete(key);
+    cache.shapes.set(key, shape);
+    cache.hits++;
+    return shape;
+  }
+
+  cache.misses++;
+
+  return undefined;
+}
+
+export function setCookedColliderShape(cache: ColliderCookingCache, key: string, shape: CookedColliderShape) {
+  const shapeByteLength = getCookedColliderShapeByteLength(shape);
+
+  if (shapeByteLength > cache.maxByteLength) {
+    return;
+  }
+
+  const existing = cache.shapes.get(key);
+
+  if (existing) {
+    cache.byteLength -= getCookedColliderShapeByteLength(existing);
+    cache.shapes.delete(key);
+  }
+
+  for (const [oldestKey, oldest] of cache.shapes) {
+    if (cache.byteLength + shapeByteLength <= cache.maxByteLength) {
+      break;
+    }
+
+    cache.byteLength -= getCookedColliderShapeByteLength(oldest);
+    cache.shapes.delete(oldestKey);
+  }
+
+  cache.shapes.set(key, shape);
+  cache.byteLength += shapeByteLength;
+}
+
+// Scales the positions and converts the indices to the Uint32Array Rapier expects, generating them when missing.
+export function cookTrimeshShape(
+  positions: Float32Array,
+  indices: ArrayLike<number> | undefined,
+  scale: vec3
+): { vertices: Float32Array; indices: Uint32Array } {
+  const vertices = new Float32Array(positions.length);
+  scaleVec3Array(vertices, positions, scale);
+
+  let cookedIndices: Uint32Array;
+
+  if (indices) {
+    cookedIndices = indices instanceof Uint32Array ? indices.slice() : Uint32Array.from(indices);
+  } else {
+    cookedIndices = new Uint32Array(positions.length / 3);
+
+    for (let i = 0; i < cookedIndices.length; i++) {
+      cookedIndices[i] = i;
+    }
+  }
+
+  return { vertices, indices: cookedIndices };
+}
@@ -20,6 +20,15 @@ import { Player } from "../player/Player";
 import { getRotationNoAlloc } from "../utils/getRotationNoAlloc";
 import { dynamicObjectCollisionGroups, staticRigidBodyCollisionGroups } from "./CollisionGroups";
 import { updatePhysicsDebugBuffers } from "../renderer/renderer.game";
+import {
+  ColliderCookingCache,
+  cookTrimeshShape,
+  copyArrayBufferViewBytes,
+  createColliderCookingCache,
+  getColliderCookingKey,
+  getCookedColliderShape,
+  setCookedColliderShape,
+} from "./ColliderCookingCache";
 
 export type CollisionHandler = (eid1: number, eid2: number, handle1: number, handle2: number, started: boolean) => void;
 
@@ -30,8 +39,24 @@ export interface PhysicsModuleState {
   characterCollision: RAPIER.CharacterCollision;
   collisionHandlers: CollisionHandler[];
   eidTocharacterController: Map<number, RAPIER.KinematicCharacterController>;
+  colliderCookingCache: ColliderCookingCache;
+  // Static body mesh colliders waiting for a physics step with vertex budget left.
+  pendingMeshColliders: PendingMeshCollider[];
+  meshColliderVertexCount: number;
+}
+
+interface PendingMeshCollider {
+  node: RemoteNode;
+  colliderNode: RemoteNode;
+  physicsBody: RemotePhysicsBody;
+  body: RapierRigidBody;
 }
 
+// Hull and trimesh vertices cooked per physics step. Static bodies with more mesh colliders than this, like
+// procedurally generated terrain chunks, get the rest of their colliders over the following steps instead of
+// stalling a single step.
+const MeshColliderVertexBudget = 65536;
+
 export const PhysicsModule = defineModule<GameContext, PhysicsModuleState>({
   name: "physics",
   async create(_ctx, { waitForMessage }) {
@@ -49,6 +74,9 @@ export const PhysicsModule = defineModule<GameContext, PhysicsModuleState>({
       collisionHandlers: [],
       characterCollision: new RAPIER.CharacterCollision(),
       eidTocharacterController: new Map<number, RAPIER.KinematicCharacterController>(),
+      colliderCookingCache: createColliderCookingCache(),
+      pendingMeshColliders: [],
+      meshColliderVertexCount: 0,
     };
   },
   init(ctx) {},
@@ -98,6 +126,9 @@ export function PhysicsSystem(ctx: GameContext) {
   const physics = getModule(ctx, PhysicsModule);
   const { physicsWorld, handleToEid, eventQueue, collisionHandlers } = physics;
 
+  physics.meshColliderVertexCount = 0;
+  createPendingMeshColliders(physics);
+
   physicsWorld.timestep = dt;
   physicsWorld.step(eventQueue);
 
@@ -168,7 +199,13 @@ export function PhysicsSystem(ctx: GameContext) {
 
 const tempScale = vec3.create();
 
-export function createNodeColliderDescriptions(node: RemoteNode): RAPIER.ColliderDesc[] {
+// Hull descriptions whose cooked shape should be cached once the collider is created.
+const hullCookingKeys = new WeakMap<RAPIER.ColliderDesc, { key: string; source: Uint8Array }>();
+
+export function createNodeColliderDescriptions(
+  node: RemoteNode,
+  cookingCache?: ColliderCookingCache
+): RAPIER.ColliderDesc[] {
   const collider = node.collider;
 
   if (!collider) {
@@ -200,11 +237,38 @@ export function createNodeColliderDescriptions(node: RemoteNode): RAPIER.Collide
         throw new Error("No position accessor found for collider.");
       }
 
-      const positions = getAccessorArrayView(positionAccessor).slice() as Float32Array;
-      scaleVec3Array(positions, positions, tempScale);
+      const positionsView = getAccessorArrayView(positionAccessor) as Float32Array;
+      const indicesView =
+        type === ColliderType.Trimesh && primitive.indices ? getAccessorArrayView(primitive.indices) : undefined;
 
       if (type === ColliderType.Hull) {
-        const hullDesc = RAPIER.ColliderDesc.convexHull(positions);
+        const cookingKey = cookingCache && getColliderCookingKey(positionsView, tempScale);
+        const cookedShape =
+          cookingCache && cookingKey ? getCookedColliderShape(cookingCache, cookingKey, positionsView) : undefined;
+
+        let hullDesc: RAPIER.ColliderDesc | null;
+
+        if (cookedShape && cookedShape.indices.length > 0) {
+          // The hull was already computed for an identical mesh, skip the hull computation
+          hullDesc = RAPIER.ColliderDesc.convexMesh(cookedShape.vertices, cookedShape.indices);
+        } else if (cookedShape) {
+          hullDesc = RAPIER.ColliderDesc.convexHull(cookedShape.vertices);
+        } else {
+          const positions = positionsView.slice();
+          scaleVec3Array(positions, positions, tempScale);
+          hullDesc = RAPIER.ColliderDesc.convexHull(positions);
+
+          if (hullDesc && cookingCache && cookingKey) {
+            // Cache the scaled points now, they are replaced with the cooked hull in createCookedCollider
+            const source = copyArrayBufferViewBytes(positionsView);
+            setCookedColliderShape(cookingCache, cookingKey, {
+              source,
+              vertices: positions,
+              indices: new Uint32Array(0),
+            });
+            hullCookingKeys.set(hullDesc, { key: cookingKey, source });
+          }
+        }
 
         if (!hullDesc) {
           throw new Error("Failed to construct convex hull");
@@ -219,21 +283,10 @@ export function createNodeColliderDescriptions(node: RemoteNode): RAPIER.Collide
 
         descriptions.push(hullDesc);
       } else {
-        let indices: Uint32Array;
-
-        if (primitive.indices) {
-          const indicesView = getAccessorArrayView(primitive.indices);
-          indices = indicesView instanceof Uint32Array ? indicesView : new Uint32Array(indicesView);
-        } else {
-          indices = new Uint32Array(positions.length / 3);
-
-          for (let i = 0; i < indices.length; i++) {
-            indices[i] = i;
-          }
-        }
+        const trimeshShape = cookTrimeshShape(positionsView, indicesView, tempScale);
 
         // TODO: Figure out if we still need to apply the world matrix to the trimesh vertices
-        const meshDesc = RAPIER.ColliderDesc.trimesh(positions, indices);
+        const meshDesc = RAPIER.ColliderDesc.trimesh(trimeshShape.vertices, trimeshShape.indices);
 
         meshDesc.setSensor(collider.isTrigger);
 
@@ -274,6 +327,29 @@ export function createNodeColliderDescriptions(node: RemoteNode): RAPIER.Collide
   return descriptions;
 }
 
+// Creates the collider and, for hulls cooked by createNodeColliderDescriptions, caches the computed hull.
+function createCookedCollider(
+  physics: PhysicsModuleState,
+  colliderDesc: RAPIER.ColliderDesc,
+  body: RapierRigidBody
+): RAPIER.Collider {
+  const collider = physics.physicsWorld.createCollider(colliderDesc, body);
+  const cooking = hullCookingKeys.get(colliderDesc);
+
+  if (cooking) {
+    hullCookingKeys.delete(colliderDesc);
+
+    const vertices = collider.vertices();
+    const indices = collider.indices();
+
+    if (vertices && indices && vertices.length > 0 && indices.length > 0) {
+      setCookedColliderShape(physics.colliderCookingCache, cooking.key, { source: cooking.source, vertices, indices });
+    }
+  }
+
+  return collider;
+}
+
 const tempPosition = vec3.create();
 const tempRotation = quat.create();
 
@@ -293,7 +369,7 @@ export function addPhysicsBody(
   node: RemoteNode,
   physicsBody: RemotePhysicsBody
 ) {
-  const { physicsWorld, handleToEid } = physics;
+  const { physicsWorld } = physics;
 
   node.physicsBody = physicsBody;
   addComponent(world, RemotePhysicsBody, node.eid);
@@ -330,15 +406,119 @@ export function addPhysicsBody(
   node.physicsBody.body = body;
 
   if (node.collider) {
-    const colliderDescriptions = createNodeColliderDescriptions(node);
+    addNodeColliders(physics, node, node, physicsBody, body);
+  }
+
+  let curChild = node.firstChild;
+
+  while (curChild) {
+    updateMatrixWorld(curChild);
+
+    if (curChild.collider) {
+      addNodeColliders(physics, node, curChild, physicsBody, body);
+    }
+
+    curChild = curChild.nextSibling;
+  }
+}
+
+function getMeshColliderVertexCount(collider: RemoteCollider): number {
+  const mesh = collider.mesh;
+
+  if ((collider.type !== ColliderType.Hull && collider.type !== ColliderType.Trimesh) || !mesh) {
+    return 0;
+  }
+
+  let vertexCount = 0;
+
+  for (const primitive of mesh.primitives) {
+    const positionAccessor = primitive.attributes[MeshPrimitiveAttributeIndex.POSITION];
+
+    if (positionAccessor) {
+      vertexCount += positionAccessor.count;
+    }
+  }
+
+  return vertexCount;
+}
 
+// Mesh colliders on static bodies are left for a later physics step once this step's vertex budget is used up.
+function addNodeColliders(
+  physics: PhysicsModuleState,
+  node: RemoteNode,
+  colliderNode: RemoteNode,
+  physicsBody: RemotePhysicsBody,
+  body: RapierRigidBody
+) {
+  if (physicsBody.type === PhysicsBodyType.Static && colliderNode.collider) {
+    const vertexCount = getMeshColliderVertexCount(colliderNode.collider);
+
+    if (vertexCount > 0) {
+      if (physics.meshColliderVertexCount >= MeshColliderVertexBudget) {
+        physics.pendingMeshColliders.push({ node, colliderNode, physicsBody, body });
+        return;
+      }
+
+      physics.meshColliderVertexCount += vertexCount;
+    }
+  }
+
+  createNodeColliders(physics, node, colliderNode, physicsBody, body);
+}
+
+function createPendingMeshColliders(physics: PhysicsModuleState) {
+  const pendingMeshColliders = physics.pendingMeshColliders;
+  let i = 0;
+
+  while (i < pendingMeshColliders.length && physics.meshColliderVertexCount < MeshColliderVertexBudget) {
+    const { node, colliderNode, physicsBody, body } = pendingMeshColliders[i++];
+    const collider = colliderNode.collider;
+
+    // The body or collider was removed while it was waiting
+    if (!collider || node.physicsBody !== physicsBody || physics.physicsWorld.getRigidBody(body.handle) !== body) {
+      continue;
+    }
+
+    physics.meshColliderVertexCount += getMeshColliderVertexCount(collider);
+
+    try {
+      updateMatrixWorld(colliderNode);
+      createNodeColliders(physics, node, colliderNode, physicsBody, body);
+    } catch (error) {
+      console.error("Error creating deferred mesh collider:", error);
+    }
+  }
+
+  if (i > 0) {
+    pendingMeshColliders.splice(0, i);
+  }
+}
+
+// Creates the colliders of the body's node or of one of its children.
+function createNodeColliders(
+  physics: PhysicsModuleState,
+  node: RemoteNode,
+  colliderNode: RemoteNode,
+  physicsBody: RemotePhysicsBody,
+  body: RapierRigidBody
+) {
+  const { handleToEid } = physics;
+  const nodeCollider = colliderNode.collider;
+
+  if (!nodeCollider) {
+    return;
+  }
+
+  const colliderDescriptions = createNodeColliderDescriptions(colliderNode, physics.colliderCookingCache);
+
+  if (colliderNode === node) {
     for (const colliderDesc of colliderDescriptions) {
       if (physicsBody.type == PhysicsBodyType.Static) {
         colliderDesc.setCollisionGroups(staticRigidBodyCollisionGroups);
 
         const worldMatrix = node.worldMatrix;
         mat4.getTranslation(tempPosition, worldMatrix);
-        vec3.add(tempPosition, tempPosition, node.collider.offset);
+        vec3.add(tempPosition, tempPosition, nodeCollider.offset);
         getRotationNoAlloc(tempRotation, worldMatrix);
         colliderDesc.setTranslation(tempPosition[0], tempPosition[1], tempPosition[2]);
         colliderDesc.setRotation(
@@ -349,68 +529,58 @@ export function addPhysicsBody(
       } else if (physicsBody.type === PhysicsBodyType.Kinematic) {
         colliderDesc.setCollisionGroups(staticRigidBodyCollisionGroups);
 
-        const offset = node.collider.offset;
+        const offset = nodeCollider.offset;
         colliderDesc.setTranslation(offset[0], offset[1], offset[2]);
       }
 
-      if (node.collider.activeEvents) colliderDesc.setActiveEvents(node.collider.activeEvents);
-      if (node.collider.collisionGroups) colliderDesc.setCollisionGroups(node.collider.collisionGroups);
-      if (node.collider.restitution) colliderDesc.setRestitution(node.collider.restitution);
-      if (node.collider.density) colliderDesc.setDensity(node.collider.density);
+      if (nodeCollider.activeEvents) colliderDesc.setActiveEvents(nodeCollider.activeEvents);
+      if (nodeCollider.collisionGroups) colliderDesc.setCollisionGroups(nodeCollider.collisionGroups);
+      if (nodeCollider.restitution) colliderDesc.setRestitution(nodeCollider.restitution);
+      if (nodeCollider.density) colliderDesc.setDensity(nodeCollider.density);
 
       colliderDesc.setMass(physicsBody.mass || 1);
 
-      const collider = physicsWorld.createCollider(colliderDesc, body);
+      const collider = createCookedCollider(physics, colliderDesc, body);
       handleToEid.set(collider.handle, node.eid);
     }
-  }
-
-  let curChild = node.firstChild;
-
-  while (curChild) {
-    updateMatrixWorld(curChild);
 
-    if (curChild.collider) {
-      const colliderDescriptions = createNodeColliderDescriptions(curChild);
-
-      for (const colliderDesc of colliderDescriptions) {
-        if (physicsBody.type == PhysicsBodyType.Static) {
-          const worldMatrix = node.worldMatrix;
-          mat4.getTranslation(tempPosition, worldMatrix);
-          vec3.add(tempPosition, tempPosition, curChild.collider.offset);
-          getRotationNoAlloc(tempRotation, worldMatrix);
-          colliderDesc.setTranslation(tempPosition[0], tempPosition[1], tempPosition[2]);
-          colliderDesc.setRotation(
-            new RAPIER.Quaternion(tempRotation[0], tempRotation[1], tempRotation[2], tempRotation[3])
-          );
-        } else {
-          vec3.copy(tempPosition, curChild.position);
-          vec3.add(tempPosition, tempPosition, curChild.collider.offset);
-          colliderDesc.setTranslation(tempPosition[0], tempPosition[1], tempPosition[2]);
-          colliderDesc.setRotation(
-            new RAPIER.Quaternion(
-              curChild.quaternion[0],
-              curChild.quaternion[1],
-              curChild.quaternion[2],
-              curChild.quaternion[3]
-            )
-          );
-        }
+    return;
+  }
 
-        colliderDesc.setMass(physicsBody.mass || 1);
-        colliderDesc.setCollisionGroups(staticRigidBodyCollisionGroups);
+  for (const colliderDesc of colliderDescriptions) {
+    if (physicsBody.type == PhysicsBodyType.Static) {
+      const worldMatrix = node.worldMatrix;
+      mat4.getTranslation(tempPosition, worldMatrix);
+      vec3.add(tempPosition, tempPosition, nodeCollider.offset);
+      getRotationNoAlloc(tempRotation, worldMatrix);
+      colliderDesc.setTranslation(tempPosition[0], tempPosition[1], tempPosition[2]);
+      colliderDesc.setRotation(
+        new RAPIER.Quaternion(tempRotation[0], tempRotation[1], tempRotation[2], tempRotation[3])
+      );
+    } else {
+      vec3.copy(tempPosition, colliderNode.position);
+      vec3.add(tempPosition, tempPosition, nodeCollider.offset);
+      colliderDesc.setTranslation(tempPosition[0], tempPosition[1], tempPosition[2]);
+      colliderDesc.setRotation(
+        new RAPIER.Quaternion(
+          colliderNode.quaternion[0],
+          colliderNode.quaternion[1],
+          colliderNode.quaternion[2],
+          colliderNode.quaternion[3]
+        )
+      );
+    }
 
-        if (curChild.collider.activeEvents) colliderDesc.setActiveEvents(curChild.collider.activeEvents);
-        if (curChild.collider.collisionGroups) colliderDesc.setCollisionGroups(curChild.collider.collisionGroups);
-        if (curChild.collider.restitution) colliderDesc.setRestitution(curChild.collider.restitution);
-        if (curChild.collider.density) colliderDesc.setDensity(curChild.collider.density);
+    colliderDesc.setMass(physicsBody.mass || 1);
+    colliderDesc.setCollisionGroups(staticRigidBodyCollisionGroups);
 
-        const collider = physicsWorld.createCollider(colliderDesc, body);
-        handleToEid.set(collider.handle, curChild.eid);
-      }
-    }
+    if (nodeCollider.activeEvents) colliderDesc.setActiveEvents(nodeCollider.activeEvents);
+    if (nodeCollider.collisionGroups) colliderDesc.setCollisionGroups(nodeCollider.collisionGroups);
+    if (nodeCollider.restitution) colliderDesc.setRestitution(nodeCollider.restitution);
+    if (nodeCollider.density) colliderDesc.setDensity(nodeCollider.density);
 
-    curChild = curChild.nextSibling;
+    const collider = createCookedCollider(physics, colliderDesc, body);
+    handleToEid.set(collider.handle, colliderNode.eid);
   }
 }
 
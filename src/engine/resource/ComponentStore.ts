@@ -1,7 +1,7 @@
 import { addComponent, hasComponent, removeComponent } from "bitecs";
 
 import { RemoteResourceManager } from "../GameTypes";
-import { GLTFComponentPropertyStorageType } from "../gltf/GLTF";
+import { GLTFComponentDefinition, GLTFComponentPropertyStorageType } from "../gltf/GLTF";
 import { TypedArray32 } from "../utils/typedarray";
 import { ComponentPropStorageType } from "./schema";
 
@@ -24,6 +24,8 @@ export const GLTFComponentPropertyStorageTypeToEnum: Record<
 
 export interface ComponentStore {
   name: string;
+  // The script's memory, the props are views of its buffer.
+  memory: WebAssembly.Memory;
   buffer: ArrayBuffer;
   byteOffset: number;
   props: ComponentPropStore[];
@@ -49,7 +51,7 @@ function getTypedArrayForStorageType(storageType: GLTFComponentPropertyStorageTy
 export function setComponentStore(
   resourceManager: RemoteResourceManager,
   componentId: number,
-  buffer: ArrayBuffer,
+  memory: WebAssembly.Memory,
   byteOffset: number
 ) {
   const componentDefinition = resourceManager.componentDefinitions.get(componentId);
@@ -62,12 +64,14 @@ export function setComponentStore(
 
   const componentStore: ComponentStore = {
     name: componentDefinition.name,
-    buffer,
+    memory,
+    buffer: memory.buffer,
     byteOffset,
     props: [],
     propsByName: new Map(),
     add(eid) {
       addComponent(world, this, eid);
+      updateComponentStore(resourceManager, this, componentDefinition);
 
       if (!componentDefinition.props) {
         return;
@@ -102,31 +106,85 @@ export function setComponentStore(
     },
   };
 
-  if (componentDefinition.props) {
-    let curByteOffset = byteOffset;
+  createComponentPropStores(resourceManager, componentStore, componentDefinition);
 
-    for (const propDef of componentDefinition.props) {
-      let propStore: ComponentPropStore;
+  resourceManager.componentStores.set(componentId, componentStore);
+}
 
-      const typedArrayConstructor = getTypedArrayForStorageType(propDef.storageType);
+function createComponentPropStores(
+  resourceManager: RemoteResourceManager,
+  componentStore: ComponentStore,
+  componentDefinition: GLTFComponentDefinition
+) {
+  componentStore.props.length = 0;
+  componentStore.propsByName.clear();
 
-      if (propDef.size > 1) {
-        const arrPropStore = [];
+  if (!componentDefinition.props) {
+    return;
+  }
 
-        for (let i = 0; i < resourceManager.componentStoreSize; i++) {
-          arrPropStore.push(new typedArrayConstructor(buffer, curByteOffset, propDef.size));
-          curByteOffset += arrPropStore[i].byteLength;
-        }
+  const buffer = componentStore.buffer;
+  let curByteOffset = componentStore.byteOffset;
+
+  for (const propDef of componentDefinition.props) {
+    let propStore: ComponentPropStore;
 
-        propStore = arrPropStore as ComponentPropStore;
-      } else {
-        propStore = new typedArrayConstructor(buffer, curByteOffset, resourceManager.componentStoreSize);
+    const typedArrayConstructor = getTypedArrayForStorageType(propDef.storageType);
+
+    if (propDef.size > 1) {
+      const arrPropStore = [];
+
+      for (let i = 0; i < resourceManager.componentStoreSize; i++) {
+        arrPropStore.push(new typedArrayConstructor(buffer, curByteOffset, propDef.size));
+        curByteOffset += arrPropStore[i].byteLength;
       }
 
-      componentStore.props.push(propStore);
-      componentStore.propsByName.set(propDef.name, propStore);
+      propStore = arrPropStore as ComponentPropStore;
+    } else {
+      propStore = new typedArrayConstructor(buffer, curByteOffset, resourceManager.componentStoreSize);
     }
+
+    componentStore.props.push(propStore);
+    componentStore.propsByName.set(propDef.name, propStore);
   }
+}
 
-  resourceManager.componentStores.set(componentId, componentStore);
+/**
+ * Script component stores are views of the script's WebAssembly memory, which are detached when the memory
+ * grows. The stores are updated in place because bitECS uses the store object as the component.
+ */
+function updateComponentStore(
+  resourceManager: RemoteResourceManager,
+  componentStore: ComponentStore,
+  componentDefinition: GLTFComponentDefinition
+) {
+  const buffer = componentStore.memory.buffer;
+
+  if (componentStore.buffer !== buffer) {
+    componentStore.buffer = buffer;
+    createComponentPropStores(resourceManager, componentStore, componentDefinition);
+  }
+}
+
+export function rebindComponentStores(resourceManager: RemoteResourceManager) {
+  for (const [componentId, componentStore] of resourceManager.componentStores) {
+    const componentDefinition = resourceManager.componentDefinitions.get(componentId);
+
+    if (componentDefinition) {
+      updateComponentStore(resourceManager, componentStore, componentDefinition);
+    }
+  }
+}
+
+// Use instead of componentStores.get outside of the script's imports, the memory may have grown since the
+// script's heap views were last used.
+export function getComponentStore(resourceManager: RemoteResourceManager, componentId: number) {
+  const componentStore = resourceManager.componentStores.get(componentId);
+  const componentDefinition = resourceManager.componentDefinitions.get(componentId);
+
+  if (componentStore && componentDefinition) {
+    updateComponentStore(resourceManager, componentStore, componentDefinition);
+  }
+
+  return componentStore;
 }
@@ -1,4 +1,5 @@
 import {
+  createCursorView,
   CursorView,
   moveCursorView,
   readFloat32Array,
@@ -7,6 +8,7 @@ import {
   skipUint32,
 } from "../allocator/CursorView";
 import { GameContext, RemoteResourceManager } from "../GameTypes";
+import { rebindComponentStores } from "../resource/ComponentStore";
 import { IRemoteResourceClass, RemoteResourceConstructor } from "../resource/RemoteResourceClass";
 import { getRemoteResources } from "../resource/resource.game";
 import { toSharedArrayBuffer } from "../utils/arraybuffer";
@@ -21,9 +23,75 @@ export interface WASMModuleContext {
   textDecoder: TextDecoder;
   cursorView: CursorView;
   encodedJSSource?: Uint8Array;
+  jsBytecode?: Uint8Array;
+  onCompileJSSource?: (bytecode: Uint8Array) => void;
+  // QuickJS heap limit and GC threshold in bytes, 0 uses the QuickJS defaults
+  heapLimit?: number;
+  gcThreshold?: number;
   resourceManager: RemoteResourceManager;
 }
 
+/**
+ * Creates a context whose heap views follow the script's memory. Growing a WebAssembly.Memory detaches the
+ * views of its old buffer, so the views are recreated the first time they're used after the memory has grown.
+ */
+export function createWASMModuleContext(
+  resourceManager: RemoteResourceManager,
+  memory: WebAssembly.Memory
+): WASMModuleContext {
+  let heapBuffer = memory.buffer;
+  let U8Heap = new Uint8Array(heapBuffer);
+  let U32Heap = new Uint32Array(heapBuffer);
+  let I32Heap = new Int32Array(heapBuffer);
+  let F32Heap = new Float32Array(heapBuffer);
+  let cursorView = createCursorView(heapBuffer, true);
+
+  const updateHeapViews = () => {
+    if (memory.buffer === heapBuffer) {
+      return;
+    }
+
+    heapBuffer = memory.buffer;
+    U8Heap = new Uint8Array(heapBuffer);
+    U32Heap = new Uint32Array(heapBuffer);
+    I32Heap = new Int32Array(heapBuffer);
+    F32Heap = new Float32Array(heapBuffer);
+
+    const cursor = cursorView.cursor;
+    cursorView = createCursorView(heapBuffer, true);
+    cursorView.cursor = cursor;
+
+    rebindComponentStores(resourceManager);
+  };
+
+  return {
+    resourceManager,
+    memory,
+    textEncoder: new TextEncoder(),
+    textDecoder: new TextDecoder(),
+    get U8Heap() {
+      updateHeapViews();
+      return U8Heap;
+    },
+    get U32Heap() {
+      updateHeapViews();
+      return U32Heap;
+    },
+    get I32Heap() {
+      updateHeapViews();
+      return I32Heap;
+    },
+    get F32Heap() {
+      updateHeapViews();
+      return F32Heap;
+    },
+    get cursorView() {
+      updateHeapViews();
+      return cursorView;
+    },
+  };
+}
+
 export function writeString(wasmCtx: WASMModuleContext, ptr: number, value: string, maxBufLength?: number) {
   const arr = wasmCtx.textEncoder.encode(value);
 
@@ -0,0 +1,72 @@
+#!/bin/bash
+
+# Builds the scripting runtime for the host platform, linked against the C stand-in for the
+# websg, websg_networking, thirdroom and matrix import modules in ./native/host, so that it
+# can be profiled with perf, valgrind, etc.
+#
+# Also builds scripting-test, which runs the runtime's tests against the same host, and scripting-compile, which
+# compiles scripts to bytecode ahead of time.
+#
+# Usage: ./build-native.sh && ./build/native/scripting-test && ./build/native/scripting-bench
+
+cd $(dirname $0)
+
+QUICKJS_ROOT=src/js-runtime/quickjs
+QUICKJS_CONFIG_VERSION=$(cat $QUICKJS_ROOT/VERSION)
+
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:-"-O2 -g"}
+
+mkdir -p ./build/native
+
+$CC \
+  $CFLAGS \
+  -Wno-attributes \
+  -o ./build/native/scripting-bench \
+  -D_GNU_SOURCE \
+  -DCONFIG_VERSION=\"$QUICKJS_CONFIG_VERSION\" \
+  -Inative/include \
+  src/js-runtime/*.c \
+  src/js-runtime/global/*.c \
+  src/js-runtime/matrix/*.c \
+  src/js-runtime/quickjs/{quickjs,cutils,libregexp,libunicode}.c \
+  src/js-runtime/thirdroom/*.c \
+  src/js-runtime/utils/*.c \
+  src/js-runtime/websg/*.c \
+  src/js-runtime/websg-networking/*.c \
+  native/host/*.c \
+  native/bench/*.c \
+  -lm \
+  -lpthread
+
+$CC \
+  $CFLAGS \
+  -Wno-attributes \
+  -o ./build/native/scripting-test \
+  -D_GNU_SOURCE \
+  -DCONFIG_VERSION=\"$QUICKJS_CONFIG_VERSION\" \
+  -DTHIRDROOM_TEST \
+  -Inative/include \
+  src/js-runtime/*.c \
+  src/js-runtime/global/*.c \
+  src/js-runtime/matrix/*.c \
+  src/js-runtime/quickjs/{quickjs,cutils,libregexp,libunicode}.c \
+  src/js-runtime/thirdroom/*.c \
+  src/js-runtime/utils/*.c \
+  src/js-runtime/websg/*.c \
+  src/js-runtime/websg-networking/*.c \
+  native/host/*.c \
+  native/test/*.c \
+  -lm \
+  -lpthread
+
+$CC \
+  $CFLAGS \
+  -o ./build/native/scripting-compile \
+  -D_GNU_SOURCE \
+  -DCONFIG_VERSION=\"$QUICKJS_CONFIG_VERSION\" \
+  src/js-runtime/quickjs/{quickjs,cutils,libregexp,libunicode}.c \
+  src/js-runtime/utils/bytecode.c \
+  native/compile/*.c \
+  -lm \
+  -lpthread
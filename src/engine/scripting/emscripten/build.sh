@@ -5,13 +5,16 @@ cd $(dirname $0)
 QUICKJS_ROOT=src/js-runtime/quickjs
 QUICKJS_CONFIG_VERSION=$(cat $QUICKJS_ROOT/VERSION)
 
+# INITIAL_MEMORY and MAXIMUM_MEMORY must match SCRIPT_INITIAL_MEMORY and SCRIPT_MAXIMUM_MEMORY in ../scripting.game.ts.
+# Each script starts with the initial memory and can grow up to its memory budget.
 emcc \
   -O2 \
   -g \
   --no-entry \
   --emit-symbol-map \
-  -s ALLOW_MEMORY_GROWTH=0 \
-  -s INITIAL_MEMORY=67108864 \
+  -s ALLOW_MEMORY_GROWTH=1 \
+  -s INITIAL_MEMORY=16777216 \
+  -s MAXIMUM_MEMORY=268435456 \
   -s ERROR_ON_UNDEFINED_SYMBOLS=0 \
   -Wl,--import-memory \
   -o ./build/scripting-runtime.wasm \
@@ -0,0 +1,1032 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "../host/host.h"
+#include "../../src/js-runtime/quickjs/quickjs.h"
+#include "../../src/js-runtime/utils/bytecode.h"
+
+#define countof(x) (sizeof(x) / sizeof((x)[0]))
+
+/**
+ * Scripting Runtime Benchmarks
+ *
+ * Times websg_initialize, websg_load, websg_enter and websg_update against the native host on synthetic worlds.
+ * Each benchmark/world size pair runs in its own process because the runtime has no teardown export.
+ *
+ * Usage: scripting-bench [-b benchmark] [-n sizes] [-f frames] [-c] [-m heap limit]
+ *   -b  only run benchmarks whose name contains this string
+ *   -n  comma separated node counts (default 1000,10000,100000)
+ *   -f  number of websg_update frames to time (default 60)
+ *   -c  compile the script to bytecode ahead of time so websg_initialize loads bytecode instead of source
+ *   -m  QuickJS heap limit in MB (default unlimited)
+ *
+ * "heap MB" is the QuickJS heap in use after the last frame (JS_ComputeMemoryUsage).
+ *
+ * When a single benchmark and size are selected it runs in-process, which is easier to use with perf/valgrind.
+ **/
+
+extern int32_t websg_initialize();
+extern int32_t websg_load();
+extern int32_t websg_enter();
+extern int32_t websg_update(float_t dt, float_t time);
+extern int32_t websg_peer_entered(uint32_t peer_index);
+extern JSMemoryUsage *websg_get_memory_usage();
+
+typedef struct Benchmark {
+  const char *name;
+  void (*setup)(uint32_t node_count);
+  // Optional, called before every websg_update outside of the timed region.
+  void (*frame)(uint32_t node_count);
+  const char *source;
+} Benchmark;
+
+/**
+ * World Setup
+ **/
+
+static component_id_t define_spin_component() {
+  HostComponentProp props[] = {
+    { .name = "speed", .type = "f32", .storage_type = ComponentPropStorageType_f32, .size = 1 },
+    { .name = "angle", .type = "f32", .storage_type = ComponentPropStorageType_f32, .size = 1 },
+    { .name = "phases", .type = "f32", .storage_type = ComponentPropStorageType_f32, .size = 4 },
+  };
+
+  return host_define_component("Spin", props, countof(props));
+}
+
+// Every node is a direct child of the environment scene and has the Spin component.
+static void setup_flat_world(uint32_t node_count) {
+  scene_id_t scene_id = host_create_scene("Environment");
+  component_id_t spin_id = define_spin_component();
+
+  for (uint32_t i = 0; i < node_count; i++) {
+    node_id_t node_id = host_create_node(NULL);
+    host_add_child(scene_id, node_id);
+    host_add_component(node_id, spin_id);
+  }
+}
+
+// Nodes form a complete 8-ary tree with a single root in the environment scene.
+static void setup_tree_world(uint32_t node_count) {
+  scene_id_t scene_id = host_create_scene("Environment");
+  node_id_t *node_ids = malloc(sizeof(node_id_t) * node_count);
+
+  for (uint32_t i = 0; i < node_count; i++) {
+    node_ids[i] = host_create_node(NULL);
+    host_add_child(i == 0 ? scene_id : node_ids[(i - 1) / 8], node_ids[i]);
+  }
+
+  free(node_ids);
+}
+
+// Only the environment scene exists, the script creates the nodes.
+static void setup_empty_world(uint32_t node_count) {
+  host_create_scene("Environment");
+  define_spin_component();
+}
+
+#define NETWORK_PEER_COUNT 16
+#define NETWORK_MESSAGE_BYTE_LENGTH 32
+
+// Only peers exist, the script listens for the messages queued by queue_network_messages.
+static void setup_network_world(uint32_t node_count) {
+  host_create_scene("Environment");
+
+  for (uint32_t i = 0; i < NETWORK_PEER_COUNT; i++) {
+    char peer_id[32];
+    snprintf(peer_id, sizeof(peer_id), "@peer-%u:example.com", i);
+    host_add_peer(peer_id);
+  }
+}
+
+// Queues node_count / 100 small binary messages per frame, spread across the peers.
+static void queue_network_messages(uint32_t node_count) {
+  uint8_t data[NETWORK_MESSAGE_BYTE_LENGTH];
+
+  for (uint32_t i = 0; i < node_count / 100; i++) {
+    memset(data, i & 0xFF, sizeof(data));
+    host_push_network_message(i % NETWORK_PEER_COUNT, data, sizeof(data), true);
+  }
+}
+
+// Queues node_count / 100 widget messages per frame, one in ten of them a room message the script cares about.
+static void queue_matrix_events(uint32_t node_count) {
+  char json[256];
+
+  for (uint32_t i = 0; i < node_count / 100; i++) {
+    const char *type = i % 10 == 0 ? "m.room.message" : "m.room.member";
+    snprintf(
+      json,
+      sizeof(json),
+      "{\"type\":\"%s\",\"sender\":\"@peer-%u:example.com\",\"event_id\":\"$event-%u\","
+      "\"room_id\":\"!room:example.com\",\"content\":{\"body\":\"hello\",\"msgtype\":\"m.text\"}}",
+      type,
+      i % NETWORK_PEER_COUNT,
+      i
+    );
+    host_push_matrix_event(json, "send_event", type, "@peer:example.com");
+  }
+}
+
+#define NETWORK_PEER_SPACING 10.0f
+#define CROWD_PEER_COUNT 100
+
+// A crowded world for the peer pose benchmarks.
+static void setup_crowd_world(uint32_t node_count) {
+  host_create_scene("Environment");
+
+  for (uint32_t i = 0; i < CROWD_PEER_COUNT; i++) {
+    char peer_id[32];
+    snprintf(peer_id, sizeof(peer_id), "@peer-%u:example.com", i);
+    host_add_peer(peer_id);
+  }
+}
+
+// Spreads the remote peers along the x axis and enters them before the first frame, so interest queries have
+// peers to filter.
+static void enter_spread_peers(uint32_t node_count) {
+  static bool entered = false;
+
+  if (entered) {
+    return;
+  }
+
+  entered = true;
+
+  for (uint32_t i = 0; i < host.peer_count; i++) {
+    if (i == host.local_peer_index) {
+      continue;
+    }
+
+    host.peers[i].translation[0] = i * NETWORK_PEER_SPACING;
+    websg_peer_entered(i);
+  }
+}
+
+#define PEER_DRAIN_BYTE_LENGTH 2048
+
+// Enters the peers, then drains less per frame than the channel benchmark queues so their backlogs build up.
+static void drain_peer_backlogs(uint32_t node_count) {
+  enter_spread_peers(node_count);
+  host_drain_peer_backlogs(PEER_DRAIN_BYTE_LENGTH);
+}
+
+#define REPLICATION_BYTE_LENGTH 16
+
+// Queues node_count / 100 remote spawns per frame on the script's first replicator.
+static void queue_remote_spawns(uint32_t node_count) {
+  static network_id_t next_network_id = 1;
+  uint8_t data[REPLICATION_BYTE_LENGTH];
+
+  for (uint32_t replicator_id = 1; replicator_id < host.resource_count; replicator_id++) {
+    if (host.resources[replicator_id].type != HostResourceType_Replicator) {
+      continue;
+    }
+
+    for (uint32_t i = 0; i < node_count / 100; i++) {
+      memset(data, i & 0xFF, sizeof(data));
+      host_push_replication(replicator_id, true, 0, next_network_id++, i % NETWORK_PEER_COUNT, data, sizeof(data));
+    }
+
+    return;
+  }
+}
+
+// Snapshots sent by replicator state are looped back, so the script pays for both encoding and decoding them.
+static void setup_replicator_world(uint32_t node_count) {
+  setup_network_world(node_count);
+  host.loopback_replicator_state = true;
+}
+
+/**
+ * Benchmarks
+ *
+ * Every script is prefixed with `const NODE_COUNT = <size>;`.
+ **/
+
+static const Benchmark benchmarks[] = {
+  {
+    .name = "query-translation",
+    .setup = setup_flat_world,
+    .source =
+      "const Spin = world.findComponentStoreByName('Spin');\n"
+      "const query = world.createQuery([Spin]);\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (const node of query) {\n"
+      "    node.translation.y += dt;\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "bulk-translation",
+    .setup = setup_flat_world,
+    .source =
+      "const Spin = world.findComponentStoreByName('Spin');\n"
+      "const nodes = [...world.createQuery([Spin])];\n"
+      "const translations = new Float32Array(nodes.length * 3);\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  world.getNodeTranslations(nodes, translations);\n"
+      "  for (let i = 1; i < translations.length; i += 3) {\n"
+      "    translations[i] += dt;\n"
+      "  }\n"
+      "  world.setNodeTranslations(nodes, translations);\n"
+      "};\n",
+  },
+  {
+    .name = "query-component-props",
+    .setup = setup_flat_world,
+    .source =
+      "const Spin = world.findComponentStoreByName('Spin');\n"
+      "const query = world.createQuery([Spin]);\n"
+      "world.onload = () => {\n"
+      "  for (const node of query) {\n"
+      "    node.getComponent(Spin).speed = 1;\n"
+      "  }\n"
+      "};\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (const node of query) {\n"
+      "    const spin = node.getComponent(Spin);\n"
+      "    spin.angle += spin.speed * dt;\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "component-prop-arrays",
+    .setup = setup_flat_world,
+    .source =
+      "const Spin = world.findComponentStoreByName('Spin');\n"
+      "const speed = Spin.getPropArray('speed');\n"
+      "const angle = Spin.getPropArray('angle');\n"
+      "const indices = Uint32Array.from(world.createQuery([Spin]), (node) => node.componentStoreIndex);\n"
+      "world.onload = () => {\n"
+      "  for (const i of indices) {\n"
+      "    speed[i] = 1;\n"
+      "  }\n"
+      "};\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (let j = 0; j < indices.length; j++) {\n"
+      "    const i = indices[j];\n"
+      "    angle[i] += speed[i] * dt;\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "component-array-prop",
+    .setup = setup_flat_world,
+    .source =
+      "const Spin = world.findComponentStoreByName('Spin');\n"
+      "const spins = Array.from(world.createQuery([Spin]), (node) => node.getComponent(Spin));\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (const spin of spins) {\n"
+      "    const phases = spin.phases;\n"
+      "    for (let i = 0; i < phases.length; i++) {\n"
+      "      phases[i] += dt * (i + 1);\n"
+      "    }\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "scene-traversal",
+    .setup = setup_tree_world,
+    .source =
+      "function visit(node) {\n"
+      "  let sum = node.worldMatrix[12];\n"
+      "  for (const child of node.children()) {\n"
+      "    sum += visit(child);\n"
+      "  }\n"
+      "  return sum;\n"
+      "}\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  let sum = 0;\n"
+      "  for (const node of world.environment.nodes()) {\n"
+      "    sum += visit(node);\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "network-receive",
+    .setup = setup_network_world,
+    .frame = queue_network_messages,
+    .source =
+      "const listener = network.listen();\n"
+      "const buffer = new ArrayBuffer(1024);\n"
+      "let sum = 0;\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (const message of listener.receive(buffer)) {\n"
+      "    sum += new Uint8Array(message.data, 0, message.bytesWritten)[0];\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "network-receive-batch",
+    .setup = setup_network_world,
+    .frame = queue_network_messages,
+    .source =
+      "const listener = network.listen();\n"
+      "const arena = new ArrayBuffer(1024 * 1024);\n"
+      "const bytes = new Uint8Array(arena);\n"
+      "let sum = 0;\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  const batch = listener.receiveBatch(arena);\n"
+      "  const headers = batch.headers;\n"
+      "  for (let i = 0; i < batch.count; i++) {\n"
+      "    sum += bytes[headers[i * 4 + 1]];\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "network-broadcast",
+    .setup = setup_network_world,
+    .source =
+      "const message = new ArrayBuffer(32);\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (let i = 0; i < NODE_COUNT / 100; i++) {\n"
+      "    network.broadcast(message);\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "network-broadcast-interest",
+    .setup = setup_network_world,
+    .frame = enter_spread_peers,
+    .source =
+      "const message = new ArrayBuffer(32);\n"
+      "const origins = [];\n"
+      "for (let i = 0; i < 160; i++) origins.push([i, 0, 0]);\n"
+      "network.setInterest({ radius: 25 });\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (let i = 0; i < NODE_COUNT / 100; i++) {\n"
+      "    network.broadcast(message, true, origins[i % origins.length]);\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "network-queue",
+    .setup = setup_network_world,
+    .source =
+      "const message = new ArrayBuffer(32);\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (let i = 0; i < NODE_COUNT / 100; i++) {\n"
+      "    network.queue(message, true, i);\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "network-queue-channels",
+    .setup = setup_network_world,
+    .frame = drain_peer_backlogs,
+    .source =
+      "const message = new ArrayBuffer(32);\n"
+      "const state = network.defineChannel({ reliable: false, priority: 1, maxBacklog: 4096 });\n"
+      "const events = network.defineChannel({ budget: 1024 });\n"
+      "const peers = [];\n"
+      "network.onpeerentered = (peer) => { peers.push(peer); };\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  if (peers.length === 0) return;\n"
+      "  for (let i = 0; i < NODE_COUNT / 100; i++) {\n"
+      "    if (i % 10 === 0) network.queue(message, events);\n"
+      "    else peers[i % peers.length].queue(message, state, i);\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "message-dataview",
+    .setup = setup_empty_world,
+    .source =
+      "const buffer = new ArrayBuffer(35);\n"
+      "const view = new DataView(buffer);\n"
+      "const message = { kind: 0, seq: 0, position: [0, 0, 0], rotation: [0, 0, 0, 1] };\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (let i = 0; i < NODE_COUNT / 10; i++) {\n"
+      "    message.seq = i;\n"
+      "    message.position[0] = time;\n"
+      "    view.setUint8(0, message.kind);\n"
+      "    view.setUint16(1, message.seq, true);\n"
+      "    for (let j = 0; j < 3; j++) view.setFloat32(3 + j * 4, message.position[j], true);\n"
+      "    for (let j = 0; j < 4; j++) view.setFloat32(15 + j * 4, message.rotation[j], true);\n"
+      "    message.kind = view.getUint8(0);\n"
+      "    message.seq = view.getUint16(1, true);\n"
+      "    for (let j = 0; j < 3; j++) message.position[j] = view.getFloat32(3 + j * 4, true);\n"
+      "    for (let j = 0; j < 4; j++) message.rotation[j] = view.getFloat32(15 + j * 4, true);\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "message-schema",
+    .setup = setup_empty_world,
+    .source =
+      "const schema = network.defineSchema([\n"
+      "  { name: 'kind', type: 'u8' },\n"
+      "  { name: 'seq', type: 'u16' },\n"
+      "  { name: 'position', type: 'vec3' },\n"
+      "  { name: 'rotation', type: 'quat' },\n"
+      "]);\n"
+      "const buffer = new ArrayBuffer(schema.byteLength);\n"
+      "const message = { kind: 0, seq: 0, position: [0, 0, 0], rotation: [0, 0, 0, 1] };\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (let i = 0; i < NODE_COUNT / 10; i++) {\n"
+      "    message.seq = i;\n"
+      "    message.position[0] = time;\n"
+      "    schema.encodeInto(message, buffer);\n"
+      "    schema.decodeInto(buffer, message);\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "matrix-receive",
+    .setup = setup_empty_world,
+    .frame = queue_matrix_events,
+    .source =
+      "matrix.listen();\n"
+      "let messages = 0;\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  let event;\n"
+      "  while ((event = matrix.receive())) {\n"
+      "    if (event.type === 'm.room.message') messages++;\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "matrix-receive-batch",
+    .setup = setup_empty_world,
+    .frame = queue_matrix_events,
+    .source =
+      "matrix.listen();\n"
+      "const arena = new ArrayBuffer(256 * 1024);\n"
+      "let messages = 0;\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  let batch;\n"
+      "  while ((batch = matrix.receiveBatch(arena)).count > 0) {\n"
+      "    for (let i = 0; i < batch.count; i++) {\n"
+      "      if (batch.getType(i) === 'm.room.message') {\n"
+      "        const event = batch.getEvent(i);\n"
+      "        messages++;\n"
+      "      }\n"
+      "    }\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "peer-translation",
+    .setup = setup_crowd_world,
+    .frame = enter_spread_peers,
+    .source =
+      "const peers = [];\n"
+      "network.onpeerentered = (peer) => { peers.push(peer); };\n"
+      "let sum = 0;\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (let j = 0; j < NODE_COUNT / 1000; j++) {\n"
+      "    for (const peer of peers) {\n"
+      "      const translation = peer.translation;\n"
+      "      const rotation = peer.rotation;\n"
+      "      sum += translation.x + translation.y + translation.z + rotation.w;\n"
+      "    }\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "peer-poses",
+    .setup = setup_crowd_world,
+    .frame = enter_spread_peers,
+    .source =
+      "let sum = 0;\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (let j = 0; j < NODE_COUNT / 1000; j++) {\n"
+      "    const poses = network.getPeerPoses();\n"
+      "    const translations = poses.translations;\n"
+      "    const rotations = poses.rotations;\n"
+      "    for (let i = 0; i < poses.count; i++) {\n"
+      "      sum += translations[i * 3] + translations[i * 3 + 1] + translations[i * 3 + 2] + rotations[i * 4 + 3];\n"
+      "    }\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "replicator-spawn",
+    .setup = setup_network_world,
+    .frame = queue_remote_spawns,
+    .source =
+      "const scene = world.environment;\n"
+      "const replicator = network.defineReplicator(() => {\n"
+      "  const node = world.createNode();\n"
+      "  scene.addNode(node);\n"
+      "  return node;\n"
+      "});\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (const replication of replicator.spawned()) {\n"
+      "    replication.node.translation.x = new Uint8Array(replication.data)[0];\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "replicator-spawn-batch",
+    .setup = setup_network_world,
+    .frame = queue_remote_spawns,
+    .source =
+      "const scene = world.environment;\n"
+      "const createNode = () => {\n"
+      "  const node = world.createNode();\n"
+      "  scene.addNode(node);\n"
+      "  return node;\n"
+      "};\n"
+      "const pool = [];\n"
+      "const replicator = network.defineReplicator(createNode, (count) => {\n"
+      "  const nodes = pool.splice(Math.max(pool.length - count, 0), count);\n"
+      "  while (nodes.length < count) nodes.push(createNode());\n"
+      "  return nodes;\n"
+      "});\n"
+      "const arena = new ArrayBuffer(1 << 20);\n"
+      "world.onload = () => {\n"
+      "  for (let i = 0; i < NODE_COUNT / 10; i++) pool.push(createNode());\n"
+      "};\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  const batch = replicator.spawnedBatch(arena);\n"
+      "  for (let i = 0; i < batch.count; i++) {\n"
+      "    batch.nodes[i].translation.x = batch.getData(i)[0];\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "replicator-state",
+    .setup = setup_replicator_world,
+    .source =
+      "const scene = world.environment;\n"
+      "const replicator = network.defineReplicator(() => {\n"
+      "  const node = world.createNode();\n"
+      "  scene.addNode(node);\n"
+      "  return node;\n"
+      "});\n"
+      "replicator.defineState(['translation', 'rotation']);\n"
+      "const nodes = [];\n"
+      "world.onload = () => {\n"
+      "  for (let i = 0; i < NODE_COUNT / 10; i++) {\n"
+      "    nodes.push(replicator.spawn());\n"
+      "  }\n"
+      "};\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (let i = 0; i < nodes.length; i += 10) {\n"
+      "    nodes[i].translation.x = time;\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "replicator-state-interpolated",
+    .setup = setup_replicator_world,
+    .source =
+      "const scene = world.environment;\n"
+      "const replicator = network.defineReplicator(() => {\n"
+      "  const node = world.createNode();\n"
+      "  scene.addNode(node);\n"
+      "  return node;\n"
+      "});\n"
+      "replicator.defineState(['translation', 'rotation'], { interpolation: true });\n"
+      "const nodes = [];\n"
+      "world.onload = () => {\n"
+      "  for (let i = 0; i < NODE_COUNT / 10; i++) {\n"
+      "    nodes.push(replicator.spawn());\n"
+      "  }\n"
+      "};\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (let i = 0; i < nodes.length; i += 10) {\n"
+      "    nodes[i].translation.x = time;\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "line-of-sight-js",
+    .setup = setup_empty_world,
+    .source =
+      "const scene = world.environment;\n"
+      "const collider = world.createCollider({ type: 'sphere', radius: 0.5 });\n"
+      "const targets = [];\n"
+      "const RAY_COUNT = 100;\n"
+      "const origins = new Float32Array(RAY_COUNT * 3);\n"
+      "const directions = new Float32Array(RAY_COUNT * 3);\n"
+      "for (let r = 0; r < RAY_COUNT; r++) {\n"
+      "  origins[r * 3] = r;\n"
+      "  origins[r * 3 + 2] = -10;\n"
+      "  directions[r * 3 + 2] = 1;\n"
+      "}\n"
+      "world.onload = () => {\n"
+      "  for (let i = 0; i < NODE_COUNT / 100; i++) {\n"
+      "    const node = world.createNode({ translation: [i % 100, 0, Math.floor(i / 100) * 2] });\n"
+      "    node.collider = collider;\n"
+      "    node.addPhysicsBody({ type: 'static' });\n"
+      "    scene.addNode(node);\n"
+      "    targets.push(node);\n"
+      "  }\n"
+      "};\n"
+      "let positions;\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  positions = world.getNodeTranslations(targets, positions || new Float32Array(targets.length * 3));\n"
+      "  let hitCount = 0;\n"
+      "  for (let r = 0; r < RAY_COUNT; r++) {\n"
+      "    const ox = origins[r * 3], oy = origins[r * 3 + 1], oz = origins[r * 3 + 2];\n"
+      "    const dx = directions[r * 3], dy = directions[r * 3 + 1], dz = directions[r * 3 + 2];\n"
+      "    let closest = Infinity;\n"
+      "    for (let i = 0; i < targets.length; i++) {\n"
+      "      const px = ox - positions[i * 3], py = oy - positions[i * 3 + 1], pz = oz - positions[i * 3 + 2];\n"
+      "      const b = px * dx + py * dy + pz * dz;\n"
+      "      const c = px * px + py * py + pz * pz - 0.25;\n"
+      "      const d = b * b - c;\n"
+      "      if (d >= 0 && -b - Math.sqrt(d) < closest) closest = -b - Math.sqrt(d);\n"
+      "    }\n"
+      "    if (closest !== Infinity) hitCount++;\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "physics-cast-rays",
+    .setup = setup_empty_world,
+    .source =
+      "const scene = world.environment;\n"
+      "const collider = world.createCollider({ type: 'sphere', radius: 0.5 });\n"
+      "const targets = [];\n"
+      "const RAY_COUNT = 100;\n"
+      "const origins = new Float32Array(RAY_COUNT * 3);\n"
+      "const directions = new Float32Array(RAY_COUNT * 3);\n"
+      "for (let r = 0; r < RAY_COUNT; r++) {\n"
+      "  origins[r * 3] = r;\n"
+      "  origins[r * 3 + 2] = -10;\n"
+      "  directions[r * 3 + 2] = 1;\n"
+      "}\n"
+      "world.onload = () => {\n"
+      "  for (let i = 0; i < NODE_COUNT / 100; i++) {\n"
+      "    const node = world.createNode({ translation: [i % 100, 0, Math.floor(i / 100) * 2] });\n"
+      "    node.collider = collider;\n"
+      "    node.addPhysicsBody({ type: 'static' });\n"
+      "    scene.addNode(node);\n"
+      "    targets.push(node);\n"
+      "  }\n"
+      "};\n"
+      "const hits = new ArrayBuffer(RAY_COUNT * 36);\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  const hitCount = world.castRays(origins, directions, hits, { maxDistance: 1000 });\n"
+      "};\n",
+  },
+  {
+    .name = "physics-body-impulses",
+    .setup = setup_empty_world,
+    .source =
+      "const scene = world.environment;\n"
+      "const bodies = [];\n"
+      "world.onload = () => {\n"
+      "  for (let i = 0; i < NODE_COUNT / 10; i++) {\n"
+      "    const node = world.createNode({ translation: [i, 0, 0] });\n"
+      "    node.addPhysicsBody({ type: 'rigid', mass: 1 });\n"
+      "    scene.addNode(node);\n"
+      "    bodies.push(node.physicsBody);\n"
+      "  }\n"
+      "};\n"
+      "const impulse = [0, 0, 0];\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (let i = 0; i < bodies.length; i++) {\n"
+      "    impulse[0] = Math.sin(time + i) * dt;\n"
+      "    bodies[i].applyImpulse(impulse);\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "physics-body-bulk",
+    .setup = setup_empty_world,
+    .source =
+      "const scene = world.environment;\n"
+      "const nodes = [];\n"
+      "let impulses, velocities;\n"
+      "world.onload = () => {\n"
+      "  for (let i = 0; i < NODE_COUNT / 10; i++) {\n"
+      "    const node = world.createNode({ translation: [i, 0, 0] });\n"
+      "    node.addPhysicsBody({ type: 'rigid', mass: 1 });\n"
+      "    scene.addNode(node);\n"
+      "    nodes.push(node);\n"
+      "  }\n"
+      "  impulses = new Float32Array(nodes.length * 3);\n"
+      "  velocities = new Float32Array(nodes.length * 3);\n"
+      "};\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (let i = 0; i < nodes.length; i++) {\n"
+      "    impulses[i * 3] = Math.sin(time + i) * dt;\n"
+      "  }\n"
+      "  world.applyNodeImpulses(nodes, impulses);\n"
+      "  world.getNodeLinearVelocities(nodes, velocities);\n"
+      "};\n",
+  },
+  {
+    .name = "proximity-js",
+    .setup = setup_empty_world,
+    .source =
+      "const scene = world.environment;\n"
+      "const nodes = [];\n"
+      "world.onload = () => {\n"
+      "  for (let i = 0; i < NODE_COUNT / 100; i++) {\n"
+      "    const node = world.createNode({ translation: [(i * 7919) % 100, 0, (i * 104729) % 100] });\n"
+      "    scene.addNode(node);\n"
+      "    nodes.push(node);\n"
+      "  }\n"
+      "};\n"
+      "let positions;\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  positions = world.getNodeTranslations(nodes, positions || new Float32Array(nodes.length * 3));\n"
+      "  let pairs = 0;\n"
+      "  for (let i = 0; i < nodes.length; i++) {\n"
+      "    for (let j = i + 1; j < nodes.length; j++) {\n"
+      "      const dx = positions[i * 3] - positions[j * 3];\n"
+      "      const dz = positions[i * 3 + 2] - positions[j * 3 + 2];\n"
+      "      if (dx * dx + dz * dz < 4) pairs++;\n"
+      "    }\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "proximity-spatial-index",
+    .setup = setup_empty_world,
+    .source =
+      "const scene = world.environment;\n"
+      "const nodes = [];\n"
+      "const index = world.createSpatialIndex({ type: 'tree' });\n"
+      "world.onload = () => {\n"
+      "  for (let i = 0; i < NODE_COUNT / 100; i++) {\n"
+      "    const node = world.createNode({ translation: [(i * 7919) % 100, 0, (i * 104729) % 100] });\n"
+      "    scene.addNode(node);\n"
+      "    nodes.push(node);\n"
+      "  }\n"
+      "};\n"
+      "const neighbors = new Uint32Array(64);\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  if (index.size === 0) index.add(nodes);\n"
+      "  index.update();\n"
+      "  let pairs = 0;\n"
+      "  for (let i = 0; i < nodes.length; i++) {\n"
+      "    pairs += index.queryRadius(nodes[i], 2, neighbors) - 1;\n"
+      "  }\n"
+      "};\n",
+  },
+  {
+    .name = "create-nodes",
+    .setup = setup_empty_world,
+    .source =
+      "const Spin = world.findComponentStoreByName('Spin');\n"
+      "const scene = world.environment;\n"
+      "world.onload = () => {\n"
+      "  for (let i = 0; i < NODE_COUNT; i++) {\n"
+      "    const node = world.createNode({ translation: [i, 0, 0] });\n"
+      "    node.addComponent(Spin);\n"
+      "    scene.addNode(node);\n"
+      "  }\n"
+      "};\n"
+      "world.onupdate = (dt, time) => {\n"
+      "  for (const node of scene.nodes()) {\n"
+      "    node.rotation.y = time;\n"
+      "  }\n"
+      "};\n",
+  },
+};
+
+/**
+ * Harness
+ **/
+
+static double now_ms() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static int compare_double(const void *a, const void *b) {
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+// Compiles the script in a separate runtime, like an ahead of time build step would.
+static int precompile_source(const char *source) {
+  JSRuntime *rt = JS_NewRuntime();
+  JSContext *ctx = JS_NewContext(rt);
+  JSValue function = js_compile_script(ctx, source, strlen(source), "<environment-script>");
+  int ret = -1;
+
+  if (!JS_IsException(function)) {
+    size_t size;
+    uint8_t *bytecode = js_write_bytecode(ctx, function, &size);
+
+    if (bytecode != NULL) {
+      host_set_js_bytecode(bytecode, size);
+      js_free(ctx, bytecode);
+      ret = 0;
+    }
+  }
+
+  JS_FreeValue(ctx, function);
+  JS_FreeContext(ctx);
+  JS_FreeRuntime(rt);
+
+  return ret;
+}
+
+static int run_benchmark(
+  const Benchmark *benchmark,
+  uint32_t node_count,
+  uint32_t frame_count,
+  bool precompile,
+  uint32_t memory_limit
+) {
+  host_reset();
+  host.memory_limit = memory_limit;
+  benchmark->setup(node_count);
+
+  size_t source_length = strlen(benchmark->source) + 64;
+  char *source = malloc(source_length);
+  snprintf(source, source_length, "const NODE_COUNT = %u;\n%s", node_count, benchmark->source);
+  host_set_js_source(source);
+
+  if (precompile && precompile_source(source) < 0) {
+    fprintf(stderr, "%s: failed to compile script\n", benchmark->name);
+    return -1;
+  }
+
+  double start = now_ms();
+
+  if (websg_initialize() < 0) {
+    fprintf(stderr, "%s: websg_initialize failed\n", benchmark->name);
+    return -1;
+  }
+
+  double initialized = now_ms();
+
+  if (websg_load() < 0) {
+    fprintf(stderr, "%s: websg_load failed\n", benchmark->name);
+    return -1;
+  }
+
+  double loaded = now_ms();
+
+  if (websg_enter() < 0) {
+    fprintf(stderr, "%s: websg_enter failed\n", benchmark->name);
+    return -1;
+  }
+
+  double entered = now_ms();
+
+  double *frame_times = malloc(sizeof(double) * frame_count);
+  double total = 0;
+  uint64_t import_calls = 0;
+  float_t dt = 1.0f / 90.0f;
+
+  for (uint32_t i = 0; i < frame_count; i++) {
+    host_update_matrices();
+
+    if (benchmark->frame) {
+      benchmark->frame(node_count);
+    }
+
+    uint64_t frame_import_calls = host.import_calls;
+    double frame_start = now_ms();
+
+    if (websg_update(dt, dt * (i + 1)) < 0) {
+      fprintf(stderr, "%s: websg_update failed\n", benchmark->name);
+      return -1;
+    }
+
+    frame_times[i] = now_ms() - frame_start;
+    total += frame_times[i];
+    import_calls += host.import_calls - frame_import_calls;
+  }
+
+  qsort(frame_times, frame_count, sizeof(double), compare_double);
+
+  JSMemoryUsage *memory_usage = websg_get_memory_usage();
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  printf(
+    "%-28s %8u %10.2f %10.2f %10.2f %12.3f %10.3f %10.3f %14llu %10.1f %10.1f\n",
+    benchmark->name,
+    node_count,
+    initialized - start,
+    loaded - initialized,
+    entered - loaded,
+    total / frame_count,
+    frame_times[(uint32_t)(frame_count * 0.95)],
+    frame_times[frame_count - 1],
+    (unsigned long long)(import_calls / frame_count),
+    memory_usage->memory_used_size / (1024.0 * 1024.0),
+    usage.ru_maxrss / 1024.0
+  );
+  fflush(stdout);
+
+  free(frame_times);
+  free(source);
+
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  const char *filter = NULL;
+  char *sizes_arg = "1000,10000,100000";
+  uint32_t frame_count = 60;
+  bool precompile = false;
+  uint32_t memory_limit = 0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "b:n:f:cm:h")) != -1) {
+    switch (opt) {
+      case 'b':
+        filter = optarg;
+        break;
+      case 'n':
+        sizes_arg = optarg;
+        break;
+      case 'f':
+        frame_count = strtoul(optarg, NULL, 10);
+        break;
+      case 'c':
+        precompile = true;
+        break;
+      case 'm':
+        memory_limit = strtoul(optarg, NULL, 10) * 1024 * 1024;
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-b benchmark] [-n sizes] [-f frames] [-c] [-m heap limit]\n", argv[0]);
+        return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  if (frame_count == 0) {
+    fprintf(stderr, "Frame count must be greater than 0\n");
+    return 1;
+  }
+
+  uint32_t sizes[16];
+  uint32_t size_count = 0;
+  char *sizes_str = strdup(sizes_arg);
+
+  for (char *token = strtok(sizes_str, ","); token && size_count < 16; token = strtok(NULL, ",")) {
+    uint32_t size = strtoul(token, NULL, 10);
+
+    if (size == 0 || size > HOST_MAX_ENTITIES) {
+      fprintf(stderr, "Invalid node count %s (1 - %d)\n", token, HOST_MAX_ENTITIES);
+      return 1;
+    }
+
+    sizes[size_count++] = size;
+  }
+
+  free(sizes_str);
+
+  const Benchmark *selected[countof(benchmarks)];
+  uint32_t selected_count = 0;
+
+  for (uint32_t i = 0; i < countof(benchmarks); i++) {
+    if (filter == NULL || strstr(benchmarks[i].name, filter)) {
+      selected[selected_count++] = &benchmarks[i];
+    }
+  }
+
+  printf(
+    "%-28s %8s %10s %10s %10s %12s %10s %10s %14s %10s %10s\n",
+    "benchmark",
+    "nodes",
+    "init ms",
+    "load ms",
+    "enter ms",
+    "update ms",
+    "p95 ms",
+    "max ms",
+    "imports/frame",
+    "heap MB",
+    "rss MB"
+  );
+  fflush(stdout);
+
+  if (selected_count == 1 && size_count == 1) {
+    return run_benchmark(selected[0], sizes[0], frame_count, precompile, memory_limit) < 0 ? 1 : 0;
+  }
+
+  int failed = 0;
+
+  for (uint32_t i = 0; i < selected_count; i++) {
+    for (uint32_t j = 0; j < size_count; j++) {
+      pid_t pid = fork();
+
+      if (pid == 0) {
+        exit(run_benchmark(selected[i], sizes[j], frame_count, precompile, memory_limit) < 0 ? 1 : 0);
+      }
+
+      int status;
+      waitpid(pid, &status, 0);
+
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "%s (%u nodes) failed\n", selected[i]->name, sizes[j]);
+        failed = 1;
+      }
+    }
+  }
+
+  return failed;
+}
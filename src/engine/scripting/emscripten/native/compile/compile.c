@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/js-runtime/quickjs/quickjs.h"
+#include "../../src/js-runtime/utils/bytecode.h"
+
+/**
+ * Script Compiler
+ *
+ * Compiles a script to QuickJS bytecode ahead of time. Serve the output with the
+ * application/x-quickjs-bytecode content type and the game worker will load it without parsing the source.
+ * The bytecode is only valid for runtimes built from the same QuickJS version.
+ *
+ * Usage: scripting-compile <input.js> <output.qjsbc>
+ **/
+
+static char *read_file(const char *path, size_t *length) {
+  FILE *file = fopen(path, "rb");
+
+  if (file == NULL) {
+    return NULL;
+  }
+
+  // ftell fails on files that can't be seeked, like pipes.
+  long end = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+
+  if (end < 0 || fseek(file, 0, SEEK_SET) != 0) {
+    fclose(file);
+    return NULL;
+  }
+
+  *length = end;
+  char *buf = malloc(*length + 1);
+
+  if (buf == NULL) {
+    fclose(file);
+    return NULL;
+  }
+
+  if (fread(buf, 1, *length, file) != *length) {
+    free(buf);
+    fclose(file);
+    return NULL;
+  }
+
+  buf[*length] = '\0';
+  fclose(file);
+
+  return buf;
+}
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s <input.js> <output.qjsbc>\n", argv[0]);
+    return 1;
+  }
+
+  size_t source_length;
+  char *source = read_file(argv[1], &source_length);
+
+  if (source == NULL) {
+    fprintf(stderr, "Couldn't read %s\n", argv[1]);
+    return 1;
+  }
+
+  JSRuntime *rt = JS_NewRuntime();
+  JSContext *ctx = JS_NewContext(rt);
+
+  // Use the same filename as the runtime so stack traces match scripts loaded from source
+  JSValue function = js_compile_script(ctx, source, source_length, "<environment-script>");
+
+  free(source);
+
+  int ret = 1;
+
+  if (JS_IsException(function)) {
+    JSValue error = JS_GetException(ctx);
+    const char *message = JS_ToCString(ctx, error);
+    fprintf(stderr, "%s: %s\n", argv[1], message);
+    JS_FreeCString(ctx, message);
+    JS_FreeValue(ctx, error);
+  } else {
+    size_t size;
+    uint8_t *bytecode = js_write_bytecode(ctx, function, &size);
+    FILE *file = bytecode ? fopen(argv[2], "wb") : NULL;
+
+    if (file != NULL && fwrite(bytecode, 1, size, file) == size) {
+      ret = 0;
+    } else {
+      fprintf(stderr, "Couldn't write %s\n", argv[2]);
+    }
+
+    if (file != NULL) {
+      fclose(file);
+    }
+
+    js_free(ctx, bytecode);
+    JS_FreeValue(ctx, function);
+  }
+
+  JS_FreeContext(ctx);
+  JS_FreeRuntime(rt);
+
+  return ret;
+}
@@ -0,0 +1,481 @@
+#include <stdlib.h>
+#include <string.h>
+#include "./host.h"
+
+HostState host;
+
+/**
+ * Resources
+ **/
+
+uint32_t host_create_resource(HostResourceType type) {
+  // Resource ids start at 1 so that 0 can be used as "not found" like the game worker's entity ids.
+  uint32_t resource_id = host.resource_count == 0 ? 1 : host.resource_count;
+
+  if (resource_id >= host.resource_capacity) {
+    uint32_t capacity = host.resource_capacity == 0 ? 1024 : host.resource_capacity * 2;
+    host.resources = realloc(host.resources, sizeof(HostResource) * capacity);
+    memset(host.resources + host.resource_capacity, 0, sizeof(HostResource) * (capacity - host.resource_capacity));
+    host.resource_capacity = capacity;
+  }
+
+  host.resources[resource_id].type = type;
+  host.resource_count = resource_id + 1;
+
+  return resource_id;
+}
+
+HostResource *host_get_resource(uint32_t resource_id, HostResourceType type) {
+  if (resource_id == 0 || resource_id >= host.resource_count) {
+    return NULL;
+  }
+
+  HostResource *resource = &host.resources[resource_id];
+
+  if (resource->type != type) {
+    return NULL;
+  }
+
+  return resource;
+}
+
+HostNode *host_get_node(node_id_t node_id) {
+  HostResource *resource = host_get_resource(node_id, HostResourceType_Node);
+  return resource ? &resource->node : NULL;
+}
+
+HostScene *host_get_scene(scene_id_t scene_id) {
+  HostResource *resource = host_get_resource(scene_id, HostResourceType_Scene);
+  return resource ? &resource->scene : NULL;
+}
+
+HostComponent *host_get_component(component_id_t component_id) {
+  HostResource *resource = host_get_resource(component_id, HostResourceType_Component);
+  return resource ? &resource->component : NULL;
+}
+
+// Mirrors writeString in WASMModuleContext.ts, but never writes past max_length.
+int32_t host_write_string(const char *value, const char *buffer, size_t max_length) {
+  size_t length = value ? strlen(value) : 0;
+
+  if (length > max_length) {
+    return -1;
+  }
+
+  memcpy((char *)buffer, value, length);
+
+  if (length < max_length) {
+    ((char *)buffer)[length] = '\0';
+  }
+
+  return length;
+}
+
+/**
+ * Setup
+ **/
+
+void host_free_matrix_event(HostMatrixEvent *event) {
+  free(event->json);
+  free(event->action);
+  free(event->type);
+  free(event->sender);
+}
+
+void host_reset() {
+  for (uint32_t i = 1; i < host.resource_count; i++) {
+    HostResource *resource = &host.resources[i];
+
+    if (resource->type == HostResourceType_Node) {
+      free(resource->node.name);
+    } else if (resource->type == HostResourceType_Scene) {
+      free(resource->scene.name);
+    } else if (resource->type == HostResourceType_Component) {
+      free(resource->component.props);
+      free(resource->component.nodes);
+    } else if (resource->type == HostResourceType_Query) {
+      for (uint32_t j = 0; j < resource->query.term_count; j++) {
+        free(resource->query.terms[j].component_ids);
+      }
+
+      free(resource->query.terms);
+      free(resource->query.entered.members);
+      free(resource->query.exited.members);
+    } else if (resource->type == HostResourceType_NetworkListener) {
+      HostNetworkListener *listener = &resource->network_listener;
+
+      for (uint32_t j = listener->head; j < listener->count; j++) {
+        free(listener->messages[j].data);
+      }
+
+      free(listener->messages);
+    } else if (resource->type == HostResourceType_Replicator) {
+      HostReplicationQueue *queues[] = { &resource->replicator.spawned, &resource->replicator.despawned };
+
+      for (uint32_t j = 0; j < 2; j++) {
+        for (uint32_t k = queues[j]->head; k < queues[j]->count; k++) {
+          free(queues[j]->replications[k].data);
+        }
+
+        free(queues[j]->replications);
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < host.state_snapshot_count; i++) {
+    free(host.state_snapshots[i].data);
+  }
+
+  free(host.state_snapshots);
+
+  for (uint32_t i = host.matrix_event_head; i < host.matrix_event_count; i++) {
+    host_free_matrix_event(&host.matrix_events[i]);
+  }
+
+  free(host.matrix_events);
+  free(host.resources);
+  free(host.js_bytecode);
+  memset(&host, 0, sizeof(HostState));
+  host.component_store_size = HOST_MAX_ENTITIES;
+}
+
+void host_set_js_source(const char *source) {
+  host.js_source = source;
+}
+
+void host_set_js_bytecode(const uint8_t *bytecode, uint32_t size) {
+  free(host.js_bytecode);
+  host.js_bytecode = malloc(size);
+  memcpy(host.js_bytecode, bytecode, size);
+  host.js_bytecode_size = size;
+}
+
+scene_id_t host_create_scene(const char *name) {
+  scene_id_t scene_id = host_create_resource(HostResourceType_Scene);
+  HostScene *scene = host_get_scene(scene_id);
+  scene->name = name ? strdup(name) : NULL;
+
+  if (host.environment == 0) {
+    host.environment = scene_id;
+  }
+
+  return scene_id;
+}
+
+node_id_t host_create_node(const char *name) {
+  node_id_t node_id = host_create_resource(HostResourceType_Node);
+  HostNode *node = host_get_node(node_id);
+  node->name = name ? strdup(name) : NULL;
+  node->component_store_index = host.next_component_store_index++;
+  node->rotation[3] = 1.0f;
+  node->scale[0] = 1.0f;
+  node->scale[1] = 1.0f;
+  node->scale[2] = 1.0f;
+  node->local_matrix[0] = node->local_matrix[5] = node->local_matrix[10] = node->local_matrix[15] = 1.0f;
+  node->world_matrix[0] = node->world_matrix[5] = node->world_matrix[10] = node->world_matrix[15] = 1.0f;
+  node->visible = true;
+  return node_id;
+}
+
+static void host_detach_node(node_id_t node_id) {
+  HostNode *node = host_get_node(node_id);
+  uint32_t *first_child;
+  uint32_t *last_child;
+
+  if (node->parent) {
+    HostNode *parent = host_get_node(node->parent);
+    first_child = &parent->first_child;
+    last_child = &parent->last_child;
+  } else if (node->parent_scene) {
+    HostScene *scene = host_get_scene(node->parent_scene);
+    first_child = &scene->first_child;
+    last_child = &scene->last_child;
+  } else {
+    return;
+  }
+
+  uint32_t prev_id = 0;
+  uint32_t cursor = *first_child;
+
+  while (cursor && cursor != node_id) {
+    prev_id = cursor;
+    cursor = host_get_node(cursor)->next_sibling;
+  }
+
+  if (prev_id) {
+    host_get_node(prev_id)->next_sibling = node->next_sibling;
+  } else {
+    *first_child = node->next_sibling;
+  }
+
+  if (*last_child == node_id) {
+    *last_child = prev_id;
+  }
+
+  node->parent = 0;
+  node->parent_scene = 0;
+  node->next_sibling = 0;
+}
+
+// Appends the child to either a node or a scene's child list.
+int32_t host_add_child(uint32_t parent_id, node_id_t child_id) {
+  HostNode *child = host_get_node(child_id);
+
+  if (child == NULL) {
+    return -1;
+  }
+
+  uint32_t *first_child;
+  uint32_t *last_child;
+
+  HostNode *parent_node = host_get_node(parent_id);
+  HostScene *parent_scene = parent_node ? NULL : host_get_scene(parent_id);
+
+  if (parent_node) {
+    first_child = &parent_node->first_child;
+    last_child = &parent_node->last_child;
+  } else if (parent_scene) {
+    first_child = &parent_scene->first_child;
+    last_child = &parent_scene->last_child;
+  } else {
+    return -1;
+  }
+
+  host_detach_node(child_id);
+
+  if (*last_child) {
+    host_get_node(*last_child)->next_sibling = child_id;
+  } else {
+    *first_child = child_id;
+  }
+
+  *last_child = child_id;
+
+  if (parent_node) {
+    child->parent = parent_id;
+  } else {
+    child->parent_scene = parent_id;
+  }
+
+  return 0;
+}
+
+int32_t host_remove_child(uint32_t parent_id, node_id_t child_id) {
+  HostNode *child = host_get_node(child_id);
+
+  if (child == NULL || (child->parent != parent_id && child->parent_scene != parent_id)) {
+    return -1;
+  }
+
+  host_detach_node(child_id);
+
+  return 0;
+}
+
+component_id_t host_define_component(const char *name, const HostComponentProp *props, uint32_t prop_count) {
+  component_id_t component_id = host_create_resource(HostResourceType_Component);
+  HostComponent *component = host_get_component(component_id);
+  component->name = name;
+  component->props = calloc(prop_count, sizeof(HostComponentProp));
+  memcpy(component->props, props, sizeof(HostComponentProp) * prop_count);
+  component->prop_count = prop_count;
+  component->nodes = calloc(HOST_MAX_ENTITIES, sizeof(uint8_t));
+  return component_id;
+}
+
+int32_t host_add_component(node_id_t node_id, component_id_t component_id) {
+  HostNode *node = host_get_node(node_id);
+  HostComponent *component = host_get_component(component_id);
+
+  if (node == NULL || component == NULL || node->component_store_index >= HOST_MAX_ENTITIES) {
+    return -1;
+  }
+
+  component->nodes[node->component_store_index] = 1;
+
+  return 0;
+}
+
+uint32_t host_add_peer(const char *peer_id) {
+  if (host.peer_count >= HOST_MAX_PEERS) {
+    return 0;
+  }
+
+  uint32_t peer_index = host.peer_count++;
+  HostPeer *peer = &host.peers[peer_index];
+  strncpy(peer->id, peer_id, sizeof(peer->id) - 1);
+  peer->rotation[3] = 1.0f;
+  peer->connected = true;
+  return peer_index;
+}
+
+void host_push_network_message(uint32_t peer_index, const uint8_t *data, uint32_t byte_length, bool binary) {
+  for (uint32_t i = 1; i < host.resource_count; i++) {
+    if (host.resources[i].type != HostResourceType_NetworkListener) {
+      continue;
+    }
+
+    HostNetworkListener *listener = &host.resources[i].network_listener;
+
+    if (listener->count == listener->capacity) {
+      listener->capacity = listener->capacity == 0 ? 64 : listener->capacity * 2;
+      listener->messages = realloc(listener->messages, sizeof(HostNetworkMessage) * listener->capacity);
+    }
+
+    HostNetworkMessage *message = &listener->messages[listener->count++];
+    message->peer_index = peer_index;
+    message->data = malloc(byte_length);
+    memcpy(message->data, data, byte_length);
+    message->byte_length = byte_length;
+    message->binary = binary;
+  }
+}
+
+void host_drain_peer_backlogs(uint32_t byte_length) {
+  for (uint32_t i = 0; i < host.peer_count; i++) {
+    HostPeer *peer = &host.peers[i];
+    peer->backlog = peer->backlog > byte_length ? peer->backlog - byte_length : 0;
+  }
+}
+
+void host_push_matrix_event(const char *json, const char *action, const char *type, const char *sender) {
+  if (!host.matrix_listening) {
+    return;
+  }
+
+  if (host.matrix_event_head == host.matrix_event_count) {
+    host.matrix_event_head = 0;
+    host.matrix_event_count = 0;
+  }
+
+  if (host.matrix_event_count == host.matrix_event_capacity) {
+    host.matrix_event_capacity = host.matrix_event_capacity == 0 ? 64 : host.matrix_event_capacity * 2;
+    host.matrix_events = realloc(host.matrix_events, sizeof(HostMatrixEvent) * host.matrix_event_capacity);
+  }
+
+  HostMatrixEvent *event = &host.matrix_events[host.matrix_event_count++];
+  event->json = strdup(json);
+  event->byte_length = strlen(json);
+  event->action = action ? strdup(action) : NULL;
+  event->type = type ? strdup(type) : NULL;
+  event->sender = sender ? strdup(sender) : NULL;
+}
+
+void host_push_replication(
+  replicator_id_t replicator_id,
+  bool spawned,
+  node_id_t node_id,
+  network_id_t network_id,
+  uint32_t peer_index,
+  const uint8_t *data,
+  uint32_t byte_length
+) {
+  HostResource *resource = host_get_resource(replicator_id, HostResourceType_Replicator);
+
+  if (resource == NULL) {
+    return;
+  }
+
+  HostReplicationQueue *queue = spawned ? &resource->replicator.spawned : &resource->replicator.despawned;
+
+  if (queue->count == queue->capacity) {
+    queue->capacity = queue->capacity == 0 ? 64 : queue->capacity * 2;
+    queue->replications = realloc(queue->replications, sizeof(HostReplication) * queue->capacity);
+  }
+
+  HostReplication *replication = &queue->replications[queue->count++];
+  replication->node_id = node_id;
+  replication->network_id = network_id;
+  replication->peer_index = peer_index;
+  replication->data = NULL;
+
+  if (byte_length > 0) {
+    replication->data = malloc(byte_length);
+    memcpy(replication->data, data, byte_length);
+  }
+
+  replication->byte_length = byte_length;
+}
+
+void host_push_replicator_state(replicator_id_t replicator_id, const uint8_t *data, uint32_t byte_length) {
+  if (host.state_snapshot_count == host.state_snapshot_capacity) {
+    host.state_snapshot_capacity = host.state_snapshot_capacity == 0 ? 16 : host.state_snapshot_capacity * 2;
+    host.state_snapshots = realloc(host.state_snapshots, sizeof(HostStateSnapshot) * host.state_snapshot_capacity);
+  }
+
+  HostStateSnapshot *snapshot = &host.state_snapshots[host.state_snapshot_count++];
+  snapshot->replicator_id = replicator_id;
+  snapshot->data = malloc(byte_length);
+  memcpy(snapshot->data, data, byte_length);
+  snapshot->byte_length = byte_length;
+}
+
+/**
+ * Transforms
+ **/
+
+// Column-major, matching gl-matrix's mat4.fromRotationTranslationScale
+static void host_compose_matrix(HostNode *node) {
+  float_t *out = node->local_matrix;
+  float_t x = node->rotation[0], y = node->rotation[1], z = node->rotation[2], w = node->rotation[3];
+  float_t x2 = x + x, y2 = y + y, z2 = z + z;
+  float_t xx = x * x2, xy = x * y2, xz = x * z2;
+  float_t yy = y * y2, yz = y * z2, zz = z * z2;
+  float_t wx = w * x2, wy = w * y2, wz = w * z2;
+  float_t sx = node->scale[0], sy = node->scale[1], sz = node->scale[2];
+
+  out[0] = (1 - (yy + zz)) * sx;
+  out[1] = (xy + wz) * sx;
+  out[2] = (xz - wy) * sx;
+  out[3] = 0;
+  out[4] = (xy - wz) * sy;
+  out[5] = (1 - (xx + zz)) * sy;
+  out[6] = (yz + wx) * sy;
+  out[7] = 0;
+  out[8] = (xz + wy) * sz;
+  out[9] = (yz - wx) * sz;
+  out[10] = (1 - (xx + yy)) * sz;
+  out[11] = 0;
+  out[12] = node->translation[0];
+  out[13] = node->translation[1];
+  out[14] = node->translation[2];
+  out[15] = 1;
+}
+
+static void host_multiply_matrix(float_t *out, const float_t *a, const float_t *b) {
+  for (int col = 0; col < 4; col++) {
+    for (int row = 0; row < 4; row++) {
+      out[col * 4 + row] =
+        a[0 * 4 + row] * b[col * 4 + 0] +
+        a[1 * 4 + row] * b[col * 4 + 1] +
+        a[2 * 4 + row] * b[col * 4 + 2] +
+        a[3 * 4 + row] * b[col * 4 + 3];
+    }
+  }
+}
+
+static void host_update_node_matrices(node_id_t node_id, const float_t *parent_world_matrix) {
+  while (node_id) {
+    HostNode *node = host_get_node(node_id);
+
+    host_compose_matrix(node);
+
+    if (parent_world_matrix) {
+      host_multiply_matrix(node->world_matrix, parent_world_matrix, node->local_matrix);
+    } else {
+      memcpy(node->world_matrix, node->local_matrix, sizeof(float_t) * 16);
+    }
+
+    host_update_node_matrices(node->first_child, node->world_matrix);
+
+    node_id = node->next_sibling;
+  }
+}
+
+void host_update_matrices() {
+  for (uint32_t i = 1; i < host.resource_count; i++) {
+    if (host.resources[i].type == HostResourceType_Scene) {
+      host_update_node_matrices(host.resources[i].scene.first_child, NULL);
+    }
+  }
+}
@@ -0,0 +1,294 @@
+#ifndef __native_host_h
+#define __native_host_h
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../src/websg.h"
+#include "../../src/websg-networking.h"
+
+/**
+ * Native Host
+ *
+ * A C stand-in for the websg, websg_networking, thirdroom and matrix import modules that the game worker
+ * provides to the scripting runtime (see websg.ts and thirdroom.ts). It keeps just enough world state for
+ * scripts to run: a node hierarchy with transforms, scenes, component definitions, queries and peers.
+ * Everything else is accepted and ignored so that scripts exercising the full API still run.
+ **/
+
+#define HOST_MAX_ENTITIES 100000
+#define HOST_MAX_PEERS 256
+
+typedef enum HostResourceType {
+  HostResourceType_None,
+  HostResourceType_Node,
+  HostResourceType_Scene,
+  HostResourceType_Component,
+  HostResourceType_Query,
+  HostResourceType_Mesh,
+  HostResourceType_Accessor,
+  HostResourceType_Material,
+  HostResourceType_Light,
+  HostResourceType_Collider,
+  HostResourceType_UICanvas,
+  HostResourceType_UIElement,
+  HostResourceType_CollisionListener,
+  HostResourceType_NetworkListener,
+  HostResourceType_Replicator,
+  HostResourceType_ActionBarListener,
+} HostResourceType;
+
+typedef struct HostNode {
+  char *name;
+  uint32_t parent;
+  uint32_t first_child;
+  uint32_t last_child;
+  uint32_t next_sibling;
+  uint32_t parent_scene;
+  uint32_t component_store_index;
+  float_t translation[3];
+  float_t rotation[4];
+  float_t scale[3];
+  float_t local_matrix[16];
+  float_t world_matrix[16];
+  uint32_t mesh;
+  uint32_t light;
+  uint32_t collider;
+  uint32_t ui_canvas;
+  bool visible;
+  bool is_static;
+  bool physics_body;
+  bool interactable;
+  // Physics body state. Nothing is simulated, so velocities only change when they are set or an impulse is applied.
+  float_t mass;
+  float_t linear_velocity[3];
+  float_t angular_velocity[3];
+  bool sleeping;
+} HostNode;
+
+typedef struct HostScene {
+  char *name;
+  uint32_t first_child;
+  uint32_t last_child;
+} HostScene;
+
+// Physics queries treat every collider as its bounding sphere, hulls and trimeshes aren't hit at all.
+typedef struct HostCollider {
+  ColliderType type;
+  float_t bounding_radius;
+} HostCollider;
+
+typedef struct HostComponentProp {
+  const char *name;
+  const char *type;
+  const char *ref_type;
+  ComponentPropStorageType storage_type;
+  int32_t size;
+} HostComponentProp;
+
+typedef struct HostComponent {
+  const char *name;
+  HostComponentProp *props;
+  uint32_t prop_count;
+  void *store;
+  uint8_t *nodes;
+} HostComponent;
+
+typedef struct HostQueryTerm {
+  component_id_t *component_ids;
+  uint32_t component_count;
+  QueryModifier modifier;
+} HostQueryTerm;
+
+// Query membership as of the last entered() / exited() call, indexed by node id.
+typedef struct HostQuerySnapshot {
+  uint8_t *members;
+  uint32_t capacity;
+} HostQuerySnapshot;
+
+typedef struct HostQuery {
+  HostQueryTerm *terms;
+  uint32_t term_count;
+  HostQuerySnapshot entered;
+  HostQuerySnapshot exited;
+} HostQuery;
+
+typedef struct HostNetworkMessage {
+  uint32_t peer_index;
+  uint8_t *data;
+  uint32_t byte_length;
+  bool binary;
+} HostNetworkMessage;
+
+// Inbound messages are consumed from head, the queue is compacted when it empties.
+typedef struct HostNetworkListener {
+  HostNetworkMessage *messages;
+  uint32_t head;
+  uint32_t count;
+  uint32_t capacity;
+} HostNetworkListener;
+
+typedef struct HostReplication {
+  node_id_t node_id;
+  network_id_t network_id;
+  uint32_t peer_index;
+  uint8_t *data;
+  uint32_t byte_length;
+} HostReplication;
+
+// Consumed from head like HostNetworkListener.
+typedef struct HostReplicationQueue {
+  HostReplication *replications;
+  uint32_t head;
+  uint32_t count;
+  uint32_t capacity;
+} HostReplicationQueue;
+
+typedef struct HostReplicator {
+  HostReplicationQueue spawned;
+  HostReplicationQueue despawned;
+} HostReplicator;
+
+typedef struct HostStateSnapshot {
+  replicator_id_t replicator_id;
+  uint8_t *data;
+  uint32_t byte_length;
+} HostStateSnapshot;
+
+// Strings are NULL when the widget message doesn't have them.
+typedef struct HostMatrixEvent {
+  char *json;
+  uint32_t byte_length;
+  char *action;
+  char *type;
+  char *sender;
+} HostMatrixEvent;
+
+typedef struct HostPeer {
+  char id[64];
+  float_t translation[3];
+  float_t rotation[4];
+  bool connected;
+  // Bytes sent to the peer that its simulated transport hasn't drained yet, see host_drain_peer_backlogs.
+  uint32_t backlog;
+  float_t rtt;
+} HostPeer;
+
+typedef struct HostResource {
+  HostResourceType type;
+  union {
+    HostNode node;
+    HostScene scene;
+    HostCollider collider;
+    HostComponent component;
+    HostQuery query;
+    HostNetworkListener network_listener;
+    HostReplicator replicator;
+  };
+} HostResource;
+
+typedef struct HostState {
+  HostResource *resources;
+  uint32_t resource_count;
+  uint32_t resource_capacity;
+  uint32_t next_component_store_index;
+  uint32_t component_store_size;
+  scene_id_t environment;
+  const char *js_source;
+  uint8_t *js_bytecode;
+  uint32_t js_bytecode_size;
+  uint32_t memory_limit;
+  uint32_t gc_threshold;
+  HostPeer peers[HOST_MAX_PEERS];
+  uint32_t peer_count;
+  uint32_t host_peer_index;
+  uint32_t local_peer_index;
+  // When set, broadcast replicator state snapshots are queued back to the sending replicator.
+  bool loopback_replicator_state;
+  HostStateSnapshot *state_snapshots;
+  uint32_t state_snapshot_count;
+  uint32_t state_snapshot_capacity;
+  uint64_t replicator_state_bytes_sent;
+  // Widget messages, receive pops the newest like the game worker and receive_batch drains from head.
+  bool matrix_listening;
+  HostMatrixEvent *matrix_events;
+  uint32_t matrix_event_head;
+  uint32_t matrix_event_count;
+  uint32_t matrix_event_capacity;
+  uint64_t import_calls;
+} HostState;
+
+extern HostState host;
+
+#define host_count_import() (host.import_calls++)
+
+/**
+ * Setup functions used by the benchmarks and tests to build synthetic worlds before the script is initialized.
+ **/
+
+void host_reset();
+
+void host_set_js_source(const char *source);
+
+// Copies bytecode written by js_write_bytecode, websg_initialize will use it instead of the source.
+void host_set_js_bytecode(const uint8_t *bytecode, uint32_t size);
+
+scene_id_t host_create_scene(const char *name);
+
+node_id_t host_create_node(const char *name);
+
+int32_t host_add_child(uint32_t parent_id, node_id_t child_id);
+
+int32_t host_remove_child(uint32_t parent_id, node_id_t child_id);
+
+component_id_t host_define_component(const char *name, const HostComponentProp *props, uint32_t prop_count);
+
+int32_t host_add_component(node_id_t node_id, component_id_t component_id);
+
+uint32_t host_add_peer(const char *peer_id);
+
+// Queues a copy of the message on every open network listener, like deserializeScriptMessage in the game worker.
+void host_push_network_message(uint32_t peer_index, const uint8_t *data, uint32_t byte_length, bool binary);
+
+// Queues a remote spawn (node_id 0) or despawn on the replicator, like the game worker's replication handlers.
+void host_push_replication(
+  replicator_id_t replicator_id,
+  bool spawned,
+  node_id_t node_id,
+  network_id_t network_id,
+  uint32_t peer_index,
+  const uint8_t *data,
+  uint32_t byte_length
+);
+
+// Queues a replicator state snapshot on the replicator, like one received from a peer.
+void host_push_replicator_state(replicator_id_t replicator_id, const uint8_t *data, uint32_t byte_length);
+
+// Drains up to byte_length bytes from every peer's backlog, standing in for the transport sending them.
+void host_drain_peer_backlogs(uint32_t byte_length);
+
+// Queues a widget message for the script if it is listening, like onWidgetMessage in the game worker.
+void host_push_matrix_event(const char *json, const char *action, const char *type, const char *sender);
+
+void host_free_matrix_event(HostMatrixEvent *event);
+
+// Recomputes local and world matrices for every node reachable from a scene, like the engine's
+// transform system does once per frame.
+void host_update_matrices();
+
+/**
+ * Internal helpers shared by the import module implementations.
+ **/
+
+uint32_t host_create_resource(HostResourceType type);
+
+HostResource *host_get_resource(uint32_t resource_id, HostResourceType type);
+
+HostNode *host_get_node(node_id_t node_id);
+
+HostScene *host_get_scene(scene_id_t scene_id);
+
+HostComponent *host_get_component(component_id_t component_id);
+
+int32_t host_write_string(const char *value, const char *buffer, size_t max_length);
+
+#endif
@@ -0,0 +1,156 @@
+#include <stdlib.h>
+#include <string.h>
+#include "./host.h"
+#include "../../src/matrix.h"
+
+/**
+ * Native implementation of the "matrix" import module. Events are queued with host_push_matrix_event and sent
+ * events are dropped.
+ **/
+
+int32_t matrix_listen() {
+  host_count_import();
+
+  if (host.matrix_listening) {
+    return -1;
+  }
+
+  host.matrix_listening = true;
+  return 0;
+}
+
+int32_t matrix_close() {
+  host_count_import();
+
+  if (!host.matrix_listening) {
+    return -1;
+  }
+
+  for (uint32_t i = host.matrix_event_head; i < host.matrix_event_count; i++) {
+    host_free_matrix_event(&host.matrix_events[i]);
+  }
+
+  host.matrix_event_head = 0;
+  host.matrix_event_count = 0;
+  host.matrix_listening = false;
+  return 0;
+}
+
+int32_t matrix_send(const char *event, uint32_t byte_length) {
+  host_count_import();
+  return 0;
+}
+
+uint32_t matrix_get_event_size() {
+  host_count_import();
+
+  if (host.matrix_event_head == host.matrix_event_count) {
+    return 0;
+  }
+
+  return host.matrix_events[host.matrix_event_count - 1].byte_length + 1;
+}
+
+int32_t matrix_receive(const char *event, uint32_t max_byte_length) {
+  host_count_import();
+
+  if (!host.matrix_listening) {
+    return -1;
+  }
+
+  if (host.matrix_event_head == host.matrix_event_count) {
+    return 0;
+  }
+
+  HostMatrixEvent *queued = &host.matrix_events[--host.matrix_event_count];
+  int32_t byte_length = queued->byte_length;
+
+  if (queued->byte_length > max_byte_length) {
+    byte_length = -1;
+  } else {
+    memcpy((char *)event, queued->json, queued->byte_length + 1);
+  }
+
+  host_free_matrix_event(queued);
+  return byte_length;
+}
+
+static uint32_t host_matrix_string_length(const char *str) {
+  return str ? strlen(str) : 0;
+}
+
+static uint32_t host_matrix_event_byte_length(HostMatrixEvent *event) {
+  return event->byte_length + 1 + host_matrix_string_length(event->action) + host_matrix_string_length(event->type) +
+    host_matrix_string_length(event->sender);
+}
+
+static void host_matrix_write_string(
+  uint8_t *arena,
+  uint32_t *offset,
+  uint32_t *header_offset,
+  uint32_t *header_length,
+  const char *str,
+  uint32_t length
+) {
+  *header_offset = *offset;
+  *header_length = length;
+
+  if (length > 0) {
+    memcpy(arena + *offset, str, length);
+    *offset += length;
+  }
+}
+
+int32_t matrix_receive_batch(uint8_t *arena, uint32_t arena_byte_length) {
+  host_count_import();
+
+  if (!host.matrix_listening) {
+    return -1;
+  }
+
+  uint32_t queued_count = host.matrix_event_count - host.matrix_event_head;
+  uint32_t count = 0;
+  uint32_t payload_byte_length = 0;
+
+  while (count < queued_count) {
+    uint32_t byte_length = host_matrix_event_byte_length(&host.matrix_events[host.matrix_event_head + count]);
+
+    if ((count + 1) * sizeof(MatrixEventHeader) + payload_byte_length + byte_length > arena_byte_length) {
+      break;
+    }
+
+    payload_byte_length += byte_length;
+    count++;
+  }
+
+  if (count == 0 && queued_count > 0) {
+    return -1;
+  }
+
+  MatrixEventHeader *headers = (MatrixEventHeader *)arena;
+  uint32_t offset = count * sizeof(MatrixEventHeader);
+
+  for (uint32_t i = 0; i < count; i++) {
+    HostMatrixEvent *event = &host.matrix_events[host.matrix_event_head + i];
+    MatrixEventHeader *header = &headers[i];
+
+    host_matrix_write_string(arena, &offset, &header->byte_offset, &header->byte_length, event->json, event->byte_length);
+    arena[offset++] = 0;
+
+    const char *action = event->action;
+    const char *type = event->type;
+    const char *sender = event->sender;
+    host_matrix_write_string(arena, &offset, &header->action_offset, &header->action_length, action,
+      host_matrix_string_length(action));
+    host_matrix_write_string(arena, &offset, &header->type_offset, &header->type_length, type,
+      host_matrix_string_length(type));
+    host_matrix_write_string(arena, &offset, &header->sender_offset, &header->sender_length, sender,
+      host_matrix_string_length(sender));
+
+    host_free_matrix_event(event);
+  }
+
+  host.matrix_event_head += count;
+
+  return count;
+}
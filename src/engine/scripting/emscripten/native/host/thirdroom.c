@@ -0,0 +1,110 @@
+#include <string.h>
+#include "./host.h"
+#include "../../src/thirdroom.h"
+
+/**
+ * Native implementation of the "thirdroom" import module.
+ *
+ * The script source is provided by host_set_js_source and bytecode by host_set_js_bytecode. Bytecode the
+ * runtime compiles is kept like the game worker's cache, so it is used if the script is initialized again. Audio, AR and action bar imports report no data.
+ **/
+
+int32_t thirdroom_get_js_source_size() {
+  host_count_import();
+  return host.js_source ? strlen(host.js_source) + 1 : 0;
+}
+
+int32_t thirdroom_get_js_source(char *ptr) {
+  host_count_import();
+
+  if (host.js_source == NULL) {
+    return 0;
+  }
+
+  int32_t length = strlen(host.js_source);
+  memcpy(ptr, host.js_source, length + 1);
+
+  return length;
+}
+
+int32_t thirdroom_get_js_bytecode_size() {
+  host_count_import();
+  return host.js_bytecode_size;
+}
+
+int32_t thirdroom_get_js_bytecode(uint8_t *ptr) {
+  host_count_import();
+
+  if (host.js_bytecode == NULL) {
+    return 0;
+  }
+
+  memcpy(ptr, host.js_bytecode, host.js_bytecode_size);
+
+  return host.js_bytecode_size;
+}
+
+int32_t thirdroom_set_js_bytecode(uint8_t *ptr, uint32_t size) {
+  host_count_import();
+  host_set_js_bytecode(ptr, size);
+  return 0;
+}
+
+uint32_t thirdroom_get_memory_limit() {
+  host_count_import();
+  return host.memory_limit;
+}
+
+uint32_t thirdroom_get_gc_threshold() {
+  host_count_import();
+  return host.gc_threshold;
+}
+
+void thirdroom_enable_matrix_material(int enabled) {
+  host_count_import();
+}
+
+int32_t thirdroom_get_audio_data_size() {
+  host_count_import();
+  return 0;
+}
+
+int32_t thirdroom_get_audio_frequency_data(uint8_t *data) {
+  host_count_import();
+  return 0;
+}
+
+int32_t thirdroom_get_audio_time_data(uint8_t *data) {
+  host_count_import();
+  return 0;
+}
+
+int32_t thirdroom_in_ar() {
+  host_count_import();
+  return 0;
+}
+
+int32_t thirdroom_action_bar_set_items(ThirdRoomActionBarItemList *items) {
+  host_count_import();
+  return 0;
+}
+
+action_bar_listener_id_t thirdroom_action_bar_create_listener() {
+  host_count_import();
+  return host_create_resource(HostResourceType_ActionBarListener);
+}
+
+int32_t thirdroom_action_bar_listener_dispose(action_bar_listener_id_t listener_id) {
+  host_count_import();
+  return host_get_resource(listener_id, HostResourceType_ActionBarListener) ? 0 : -1;
+}
+
+int32_t thirdroom_action_bar_listener_get_next_action_length(action_bar_listener_id_t listener_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t thirdroom_action_bar_listener_get_next_action(action_bar_listener_id_t listener_id, const char *id) {
+  host_count_import();
+  return 0;
+}
@@ -0,0 +1,628 @@
+#include <stdlib.h>
+#include <string.h>
+#include "./host.h"
+
+/**
+ * Native implementation of the "websg_networking" import module.
+ *
+ * Peers are backed by HostState so that scripts can read their poses. Listeners and replicators receive whatever the
+ * benchmarks and tests queue with host_push_network_message, host_push_replication and host_push_replicator_state.
+ * Sent packets are dropped after adding to the receiving peers' backlogs.
+ **/
+
+/********
+ * Peer *
+ ********/
+
+static HostPeer *host_get_peer(uint32_t peer_index) {
+  if (peer_index >= host.peer_count || !host.peers[peer_index].connected) {
+    return NULL;
+  }
+
+  return &host.peers[peer_index];
+}
+
+int32_t websg_peer_get_id_length(uint32_t peer_index) {
+  host_count_import();
+  HostPeer *peer = host_get_peer(peer_index);
+  return peer ? strlen(peer->id) : -1;
+}
+
+int32_t websg_peer_get_id(uint32_t peer_index, const char *peer_id, size_t length) {
+  host_count_import();
+  HostPeer *peer = host_get_peer(peer_index);
+  return peer ? host_write_string(peer->id, peer_id, length) : -1;
+}
+
+float_t websg_peer_get_translation_element(uint32_t peer_index, uint32_t index) {
+  host_count_import();
+  HostPeer *peer = host_get_peer(peer_index);
+  return peer && index < 3 ? peer->translation[index] : -1;
+}
+
+int32_t websg_peer_get_translation(uint32_t peer_index, float_t *translation) {
+  host_count_import();
+  HostPeer *peer = host_get_peer(peer_index);
+
+  if (peer == NULL) {
+    return -1;
+  }
+
+  memcpy(translation, peer->translation, sizeof(float_t) * 3);
+
+  return 0;
+}
+
+float_t websg_peer_get_rotation_element(uint32_t peer_index, uint32_t index) {
+  host_count_import();
+  HostPeer *peer = host_get_peer(peer_index);
+  return peer && index < 4 ? peer->rotation[index] : -1;
+}
+
+int32_t websg_peer_get_rotation(uint32_t peer_index, float_t *rotation) {
+  host_count_import();
+  HostPeer *peer = host_get_peer(peer_index);
+
+  if (peer == NULL) {
+    return -1;
+  }
+
+  memcpy(rotation, peer->rotation, sizeof(float_t) * 4);
+
+  return 0;
+}
+
+int32_t websg_network_get_peer_poses(uint32_t *peer_indices, float_t *poses, uint32_t max_count) {
+  host_count_import();
+
+  uint32_t total = 0;
+
+  for (uint32_t i = 0; i < host.peer_count; i++) {
+    total += host.peers[i].connected ? 1 : 0;
+  }
+
+  uint32_t count = total < max_count ? total : max_count;
+  float_t *translations = poses;
+  float_t *rotations = poses + count * 3;
+  uint32_t j = 0;
+
+  for (uint32_t i = 0; i < host.peer_count && j < count; i++) {
+    HostPeer *peer = &host.peers[i];
+
+    if (!peer->connected) {
+      continue;
+    }
+
+    peer_indices[j] = i;
+    memcpy(translations + j * 3, peer->translation, sizeof(float_t) * 3);
+    memcpy(rotations + j * 4, peer->rotation, sizeof(float_t) * 4);
+    j++;
+  }
+
+  return total;
+}
+
+int32_t websg_peer_is_host(uint32_t peer_index) {
+  host_count_import();
+  return host_get_peer(peer_index) && peer_index == host.host_peer_index ? 1 : 0;
+}
+
+int32_t websg_peer_is_local(uint32_t peer_index) {
+  host_count_import();
+  return host_get_peer(peer_index) && peer_index == host.local_peer_index ? 1 : 0;
+}
+
+int32_t websg_peer_get_stats(uint32_t peer_index, NetworkPeerStats *stats) {
+  host_count_import();
+  HostPeer *peer = host_get_peer(peer_index);
+
+  if (peer == NULL) {
+    return -1;
+  }
+
+  stats->backlog = peer->backlog;
+  stats->rtt = peer->rtt;
+
+  return 0;
+}
+
+// Sent bytes pile up in the peers' backlogs until the bench drains them.
+static void host_add_peer_backlog(uint32_t peer_index, uint32_t byte_length) {
+  for (uint32_t i = 0; i < host.peer_count; i++) {
+    bool addressed = peer_index == NETWORK_BROADCAST_PEER_INDEX ? i != host.local_peer_index : i == peer_index;
+
+    if (addressed && host.peers[i].connected) {
+      host.peers[i].backlog += byte_length;
+    }
+  }
+}
+
+int32_t websg_peer_send(uint32_t peer_index, uint8_t *packet, uint32_t byte_length, uint32_t binary, uint32_t reliable) {
+  host_count_import();
+
+  if (host_get_peer(peer_index) == NULL) {
+    return -1;
+  }
+
+  host_add_peer_backlog(peer_index, byte_length);
+
+  return 0;
+}
+
+/***********
+ * Network *
+ ***********/
+
+uint32_t websg_network_get_host_peer_index() {
+  host_count_import();
+  return host.host_peer_index;
+}
+
+uint32_t websg_network_get_local_peer_index() {
+  host_count_import();
+  return host.local_peer_index;
+}
+
+int32_t websg_network_broadcast(uint8_t *packet, uint32_t byte_length, uint32_t binary, uint32_t reliable) {
+  host_count_import();
+  host_add_peer_backlog(NETWORK_BROADCAST_PEER_INDEX, byte_length);
+  return 0;
+}
+
+int32_t websg_network_send_batch(
+  NetworkOutboundMessageHeader *headers,
+  uint32_t message_count,
+  uint8_t *payloads,
+  uint32_t payloads_byte_length
+) {
+  host_count_import();
+
+  for (uint32_t i = 0; i < message_count; i++) {
+    if (
+      headers[i].byte_offset + headers[i].byte_length > payloads_byte_length ||
+      headers[i].byte_length > NETWORK_MAX_MESSAGE_BYTE_LENGTH
+    ) {
+      return -1;
+    }
+
+    host_add_peer_backlog(headers[i].peer_index, headers[i].byte_length);
+  }
+
+  return 0;
+}
+
+network_listener_id_t websg_network_listen() {
+  host_count_import();
+  return host_create_resource(HostResourceType_NetworkListener);
+}
+
+static HostNetworkListener *host_get_network_listener(network_listener_id_t listener_id) {
+  HostResource *resource = host_get_resource(listener_id, HostResourceType_NetworkListener);
+  return resource ? &resource->network_listener : NULL;
+}
+
+// Drops the listener's queue and makes it unreachable, so no more messages are pushed to it.
+int32_t websg_network_listener_close(network_listener_id_t listener_id) {
+  host_count_import();
+  HostNetworkListener *listener = host_get_network_listener(listener_id);
+
+  if (listener == NULL) {
+    return -1;
+  }
+
+  for (uint32_t i = listener->head; i < listener->count; i++) {
+    free(listener->messages[i].data);
+  }
+
+  free(listener->messages);
+  host.resources[listener_id].type = HostResourceType_None;
+
+  return 0;
+}
+
+static void host_network_listener_pop(HostNetworkListener *listener, uint32_t message_count) {
+  for (uint32_t i = 0; i < message_count; i++) {
+    free(listener->messages[listener->head++].data);
+  }
+
+  if (listener->head == listener->count) {
+    listener->head = 0;
+    listener->count = 0;
+  }
+}
+
+int32_t websg_network_listener_get_message_info(network_listener_id_t listener_id, NetworkMessageInfo *info) {
+  host_count_import();
+  HostNetworkListener *listener = host_get_network_listener(listener_id);
+
+  if (listener == NULL) {
+    return -1;
+  }
+
+  if (listener->head == listener->count) {
+    memset(info, 0, sizeof(NetworkMessageInfo));
+    return 0;
+  }
+
+  HostNetworkMessage *message = &listener->messages[listener->head];
+  info->peer_index = message->peer_index;
+  info->byte_length = message->byte_length;
+  info->binary = message->binary;
+
+  return listener->count - listener->head;
+}
+
+int32_t websg_network_listener_receive(
+  network_listener_id_t listener_id,
+  unsigned char *buffer,
+  uint32_t max_byte_length
+) {
+  host_count_import();
+  HostNetworkListener *listener = host_get_network_listener(listener_id);
+
+  if (listener == NULL) {
+    return -1;
+  }
+
+  if (listener->head == listener->count) {
+    return 0;
+  }
+
+  HostNetworkMessage *message = &listener->messages[listener->head];
+
+  if (message->byte_length > max_byte_length) {
+    return -1;
+  }
+
+  uint32_t byte_length = message->byte_length;
+  memcpy(buffer, message->data, byte_length);
+  host_network_listener_pop(listener, 1);
+
+  return byte_length;
+}
+
+int32_t websg_network_listener_receive_batch(
+  network_listener_id_t listener_id,
+  uint8_t *arena,
+  uint32_t arena_byte_length
+) {
+  host_count_import();
+  HostNetworkListener *listener = host_get_network_listener(listener_id);
+
+  if (listener == NULL) {
+    return -1;
+  }
+
+  uint32_t available = listener->count - listener->head;
+  uint32_t count = 0;
+  uint32_t payload_byte_length = 0;
+
+  while (count < available) {
+    uint32_t byte_length = listener->messages[listener->head + count].byte_length;
+    size_t required = sizeof(NetworkMessageHeader) * (count + 1) + payload_byte_length + byte_length;
+
+    if (required > arena_byte_length) {
+      break;
+    }
+
+    payload_byte_length += byte_length;
+    count++;
+  }
+
+  if (count == 0 && available > 0) {
+    return -(int32_t)(sizeof(NetworkMessageHeader) + listener->messages[listener->head].byte_length);
+  }
+
+  NetworkMessageHeader *headers = (NetworkMessageHeader *)arena;
+  uint32_t byte_offset = sizeof(NetworkMessageHeader) * count;
+
+  for (uint32_t i = 0; i < count; i++) {
+    HostNetworkMessage *message = &listener->messages[listener->head + i];
+    headers[i].peer_index = message->peer_index;
+    headers[i].byte_offset = byte_offset;
+    headers[i].byte_length = message->byte_length;
+    headers[i].binary = message->binary;
+    memcpy(arena + byte_offset, message->data, message->byte_length);
+    byte_offset += message->byte_length;
+  }
+
+  host_network_listener_pop(listener, count);
+
+  return count;
+}
+
+replicator_id_t websg_network_define_replicator() {
+  host_count_import();
+  return host_create_resource(HostResourceType_Replicator);
+}
+
+// Replications are queued by host_push_replication.
+static HostReplicationQueue *host_get_replication_queue(replicator_id_t replicator_id, bool spawned) {
+  HostResource *resource = host_get_resource(replicator_id, HostResourceType_Replicator);
+
+  if (resource == NULL) {
+    return NULL;
+  }
+
+  return spawned ? &resource->replicator.spawned : &resource->replicator.despawned;
+}
+
+static void host_replication_queue_pop(HostReplicationQueue *queue, uint32_t replication_count) {
+  for (uint32_t i = 0; i < replication_count; i++) {
+    free(queue->replications[queue->head++].data);
+  }
+
+  if (queue->head == queue->count) {
+    queue->head = 0;
+    queue->count = 0;
+  }
+}
+
+static int32_t host_replication_count(replicator_id_t replicator_id, bool spawned) {
+  host_count_import();
+  HostReplicationQueue *queue = host_get_replication_queue(replicator_id, spawned);
+  return queue ? queue->count - queue->head : -1;
+}
+
+int32_t websg_network_replicator_spawned_count(replicator_id_t replicator_id) {
+  return host_replication_count(replicator_id, true);
+}
+
+int32_t websg_network_replicator_despawned_count(replicator_id_t replicator_id) {
+  return host_replication_count(replicator_id, false);
+}
+
+static int32_t host_get_replication_info(replicator_id_t replicator_id, bool spawned, ReplicationInfo *info) {
+  host_count_import();
+  HostReplicationQueue *queue = host_get_replication_queue(replicator_id, spawned);
+
+  if (queue == NULL) {
+    return -1;
+  }
+
+  if (queue->head == queue->count) {
+    memset(info, 0, sizeof(ReplicationInfo));
+    return 0;
+  }
+
+  HostReplication *replication = &queue->replications[queue->head];
+  info->node_id = replication->node_id;
+  info->network_id = replication->network_id;
+  info->peer_index = replication->peer_index;
+  info->byte_length = replication->byte_length;
+
+  return queue->count - queue->head;
+}
+
+int32_t websg_replicator_get_spawned_message_info(replicator_id_t replicator_id, ReplicationInfo *info) {
+  return host_get_replication_info(replicator_id, true, info);
+}
+
+int32_t websg_replicator_get_despawned_message_info(replicator_id_t replicator_id, ReplicationInfo *info) {
+  return host_get_replication_info(replicator_id, false, info);
+}
+
+// Pops the next replication even when it has no payload, like the game worker.
+static uint32_t host_replication_receive(
+  replicator_id_t replicator_id,
+  bool spawned,
+  unsigned char *buffer,
+  uint32_t max_byte_length
+) {
+  host_count_import();
+  HostReplicationQueue *queue = host_get_replication_queue(replicator_id, spawned);
+
+  if (queue == NULL) {
+    return -1;
+  }
+
+  if (queue->head == queue->count) {
+    return 0;
+  }
+
+  HostReplication *replication = &queue->replications[queue->head];
+
+  if (replication->byte_length > max_byte_length) {
+    return -1;
+  }
+
+  uint32_t byte_length = replication->byte_length;
+
+  if (byte_length > 0) {
+    memcpy(buffer, replication->data, byte_length);
+  }
+
+  host_replication_queue_pop(queue, 1);
+
+  return byte_length;
+}
+
+uint32_t websg_replicator_spawn_receive(
+  replicator_id_t replicator_id,
+  unsigned char *buffer,
+  uint32_t max_byte_length
+) {
+  return host_replication_receive(replicator_id, true, buffer, max_byte_length);
+}
+
+uint32_t websg_replicator_despawn_receive(
+  replicator_id_t replicator_id,
+  unsigned char *buffer,
+  uint32_t max_byte_length
+) {
+  return host_replication_receive(replicator_id, false, buffer, max_byte_length);
+}
+
+static int32_t host_replication_receive_batch(
+  replicator_id_t replicator_id,
+  bool spawned,
+  uint8_t *arena,
+  uint32_t arena_byte_length
+) {
+  host_count_import();
+  HostReplicationQueue *queue = host_get_replication_queue(replicator_id, spawned);
+
+  if (queue == NULL) {
+    return -1;
+  }
+
+  uint32_t available = queue->count - queue->head;
+  uint32_t count = 0;
+  uint32_t payload_byte_length = 0;
+
+  while (count < available) {
+    uint32_t byte_length = queue->replications[queue->head + count].byte_length;
+    size_t required = sizeof(ReplicationHeader) * (count + 1) + payload_byte_length + byte_length;
+
+    if (required > arena_byte_length) {
+      break;
+    }
+
+    payload_byte_length += byte_length;
+    count++;
+  }
+
+  if (count == 0 && available > 0) {
+    return -1;
+  }
+
+  ReplicationHeader *headers = (ReplicationHeader *)arena;
+  uint32_t byte_offset = sizeof(ReplicationHeader) * count;
+
+  for (uint32_t i = 0; i < count; i++) {
+    HostReplication *replication = &queue->replications[queue->head + i];
+    headers[i].node_id = replication->node_id;
+    headers[i].network_id = replication->network_id;
+    headers[i].peer_index = replication->peer_index;
+    headers[i].byte_offset = byte_offset;
+    headers[i].byte_length = replication->byte_length;
+
+    if (replication->byte_length > 0) {
+      memcpy(arena + byte_offset, replication->data, replication->byte_length);
+    }
+
+    byte_offset += replication->byte_length;
+  }
+
+  host_replication_queue_pop(queue, count);
+
+  return count;
+}
+
+int32_t websg_replicator_spawned_receive_batch(
+  replicator_id_t replicator_id,
+  uint8_t *arena,
+  uint32_t arena_byte_length
+) {
+  return host_replication_receive_batch(replicator_id, true, arena, arena_byte_length);
+}
+
+int32_t websg_replicator_despawned_receive_batch(
+  replicator_id_t replicator_id,
+  uint8_t *arena,
+  uint32_t arena_byte_length
+) {
+  return host_replication_receive_batch(replicator_id, false, arena, arena_byte_length);
+}
+
+// Every node counts as networked, its network id is its node id.
+network_id_t websg_node_get_network_id(node_id_t node_id) {
+  host_count_import();
+  return host_get_node(node_id) ? node_id : 0;
+}
+
+node_id_t websg_network_get_node_id(network_id_t network_id) {
+  host_count_import();
+  return host_get_node(network_id) ? network_id : 0;
+}
+
+int32_t websg_replicator_send_state(
+  replicator_id_t replicator_id,
+  uint32_t peer_index,
+  uint8_t *packet,
+  uint32_t byte_length
+) {
+  host_count_import();
+
+  if (peer_index != NETWORK_BROADCAST_PEER_INDEX && host_get_peer(peer_index) == NULL) {
+    return -1;
+  }
+
+  host.replicator_state_bytes_sent += byte_length;
+
+  if (!host.loopback_replicator_state || peer_index != NETWORK_BROADCAST_PEER_INDEX) {
+    return 0;
+  }
+
+  host_push_replicator_state(replicator_id, packet, byte_length);
+
+  return 0;
+}
+
+static int32_t host_find_state_snapshot(replicator_id_t replicator_id) {
+  for (uint32_t i = 0; i < host.state_snapshot_count; i++) {
+    if (host.state_snapshots[i].replicator_id == replicator_id) {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+int32_t websg_replicator_get_state_byte_length(replicator_id_t replicator_id) {
+  host_count_import();
+  int32_t index = host_find_state_snapshot(replicator_id);
+  return index == -1 ? 0 : host.state_snapshots[index].byte_length;
+}
+
+int32_t websg_replicator_receive_state(replicator_id_t replicator_id, uint8_t *buffer, uint32_t max_byte_length) {
+  host_count_import();
+  int32_t index = host_find_state_snapshot(replicator_id);
+
+  if (index == -1) {
+    return 0;
+  }
+
+  HostStateSnapshot *snapshot = &host.state_snapshots[index];
+
+  if (snapshot->byte_length > max_byte_length) {
+    return -1;
+  }
+
+  uint32_t byte_length = snapshot->byte_length;
+  memcpy(buffer, snapshot->data, byte_length);
+  free(snapshot->data);
+  memmove(snapshot, snapshot + 1, sizeof(HostStateSnapshot) * (host.state_snapshot_count - index - 1));
+  host.state_snapshot_count--;
+
+  return byte_length;
+}
+
+/**
+ * Imports not modeled by the native host. They return 0 (not found, empty or no-op success).
+ **/
+
+int32_t websg_replicator_spawn_local(
+  replicator_id_t replicator_id,
+  node_id_t node_id,
+  uint8_t *packet,
+  uint32_t byte_length
+) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_replicator_despawn_local(
+  replicator_id_t replicator_id,
+  node_id_t node_id,
+  uint8_t *packet,
+  uint32_t byte_length
+) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_node_add_network_synchronizer(node_id_t node_id, NetworkSynchronizerProps *props) {
+  host_count_import();
+  return 0;
+}
@@ -0,0 +1,1982 @@
+#include <math.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include "./host.h"
+
+/**
+ * Native implementation of the "websg" import module.
+ *
+ * Node, scene, component and query imports are backed by HostState. Imports for resources the benchmarks do not
+ * exercise (materials, lights, UI, etc.) hand out ids and return default values.
+ **/
+
+/*********
+ * World *
+ *********/
+
+scene_id_t websg_world_get_environment() {
+  host_count_import();
+  return host.environment;
+}
+
+int32_t websg_world_set_environment(scene_id_t scene_id) {
+  host_count_import();
+
+  if (host_get_scene(scene_id) == NULL) {
+    return -1;
+  }
+
+  host.environment = scene_id;
+
+  return 0;
+}
+
+/***********
+ * Queries *
+ ***********/
+
+query_id_t websg_world_create_query(QueryList *query_list) {
+  host_count_import();
+
+  query_id_t query_id = host_create_resource(HostResourceType_Query);
+  HostQuery *query = &host_get_resource(query_id, HostResourceType_Query)->query;
+  query->terms = calloc(query_list->count, sizeof(HostQueryTerm));
+  query->term_count = query_list->count;
+
+  for (uint32_t i = 0; i < query_list->count; i++) {
+    QueryItem *item = &query_list->items[i];
+    HostQueryTerm *term = &query->terms[i];
+
+    for (uint32_t j = 0; j < item->component_count; j++) {
+      if (host_get_component(item->component_ids[j]) == NULL) {
+        return 0;
+      }
+    }
+
+    term->component_ids = calloc(item->component_count, sizeof(component_id_t));
+    memcpy(term->component_ids, item->component_ids, sizeof(component_id_t) * item->component_count);
+    term->component_count = item->component_count;
+    term->modifier = item->modifier;
+  }
+
+  return query_id;
+}
+
+static bool host_query_matches(HostQuery *query, HostNode *node) {
+  uint32_t index = node->component_store_index;
+
+  for (uint32_t i = 0; i < query->term_count; i++) {
+    HostQueryTerm *term = &query->terms[i];
+    uint32_t match_count = 0;
+
+    for (uint32_t j = 0; j < term->component_count; j++) {
+      HostComponent *component = host_get_component(term->component_ids[j]);
+
+      if (index < HOST_MAX_ENTITIES && component->nodes[index]) {
+        match_count++;
+      }
+    }
+
+    if (term->modifier == QueryModifier_All && match_count != term->component_count) {
+      return false;
+    } else if (term->modifier == QueryModifier_None && match_count != 0) {
+      return false;
+    } else if (term->modifier == QueryModifier_Any && match_count == 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int32_t websg_query_get_results_count(query_id_t query_id) {
+  host_count_import();
+
+  HostResource *resource = host_get_resource(query_id, HostResourceType_Query);
+
+  if (resource == NULL) {
+    return -1;
+  }
+
+  int32_t count = 0;
+
+  for (uint32_t i = 1; i < host.resource_count; i++) {
+    if (host.resources[i].type == HostResourceType_Node && host_query_matches(&resource->query, &host.resources[i].node)) {
+      count++;
+    }
+  }
+
+  return count;
+}
+
+int32_t websg_query_get_results(query_id_t query_id, node_id_t *results, uint32_t max_count) {
+  host_count_import();
+
+  HostResource *resource = host_get_resource(query_id, HostResourceType_Query);
+
+  if (resource == NULL) {
+    return -1;
+  }
+
+  uint32_t count = 0;
+
+  for (uint32_t i = 1; i < host.resource_count; i++) {
+    if (host.resources[i].type == HostResourceType_Node && host_query_matches(&resource->query, &host.resources[i].node)) {
+      if (count < max_count) {
+        results[count] = i;
+      }
+
+      count++;
+    }
+  }
+
+  return count;
+}
+
+// Diffs the current query membership against the snapshot. Nodes are entered when they match now but didn't in
+// the snapshot and exited the other way around. The snapshot is only updated once the changes have been written.
+static int32_t host_query_get_changes(
+  query_id_t query_id,
+  bool entered,
+  node_id_t *results,
+  uint32_t max_count
+) {
+  HostResource *resource = host_get_resource(query_id, HostResourceType_Query);
+
+  if (resource == NULL) {
+    return -1;
+  }
+
+  HostQuery *query = &resource->query;
+  HostQuerySnapshot *snapshot = entered ? &query->entered : &query->exited;
+
+  if (snapshot->capacity < host.resource_count) {
+    snapshot->members = realloc(snapshot->members, host.resource_capacity);
+    memset(snapshot->members + snapshot->capacity, 0, host.resource_capacity - snapshot->capacity);
+    snapshot->capacity = host.resource_capacity;
+  }
+
+  uint32_t count = 0;
+
+  for (uint32_t i = 1; i < host.resource_count; i++) {
+    bool matches =
+      host.resources[i].type == HostResourceType_Node && host_query_matches(query, &host.resources[i].node);
+
+    if (matches != (bool)snapshot->members[i] && matches == entered) {
+      if (count < max_count) {
+        results[count] = i;
+      }
+
+      count++;
+    }
+  }
+
+  if (count > max_count) {
+    return count;
+  }
+
+  for (uint32_t i = 1; i < host.resource_count; i++) {
+    snapshot->members[i] =
+      host.resources[i].type == HostResourceType_Node && host_query_matches(query, &host.resources[i].node);
+  }
+
+  return count;
+}
+
+int32_t websg_query_get_entered(query_id_t query_id, node_id_t *results, uint32_t max_count) {
+  host_count_import();
+  return host_query_get_changes(query_id, true, results, max_count);
+}
+
+int32_t websg_query_get_exited(query_id_t query_id, node_id_t *results, uint32_t max_count) {
+  host_count_import();
+  return host_query_get_changes(query_id, false, results, max_count);
+}
+
+/**************
+ * Components *
+ **************/
+
+component_id_t websg_world_find_component_definition_by_name(const char *name, uint32_t length) {
+  host_count_import();
+
+  for (uint32_t i = 1; i < host.resource_count; i++) {
+    HostResource *resource = &host.resources[i];
+
+    if (
+      resource->type == HostResourceType_Component &&
+      strlen(resource->component.name) == length &&
+      strncmp(resource->component.name, name, length) == 0
+    ) {
+      return i;
+    }
+  }
+
+  return 0;
+}
+
+uint32_t websg_component_definition_get_name_length(component_id_t component_id) {
+  host_count_import();
+  HostComponent *component = host_get_component(component_id);
+  return component ? strlen(component->name) : -1;
+}
+
+int32_t websg_component_definition_get_name(component_id_t component_id, const char *name, size_t length) {
+  host_count_import();
+  HostComponent *component = host_get_component(component_id);
+  return component ? host_write_string(component->name, name, length) : -1;
+}
+
+int32_t websg_component_definition_get_prop_count(component_id_t component_id) {
+  host_count_import();
+  HostComponent *component = host_get_component(component_id);
+  return component ? component->prop_count : -1;
+}
+
+static HostComponentProp *host_get_component_prop(component_id_t component_id, uint32_t prop_idx) {
+  HostComponent *component = host_get_component(component_id);
+
+  if (component == NULL || prop_idx >= component->prop_count) {
+    return NULL;
+  }
+
+  return &component->props[prop_idx];
+}
+
+uint32_t websg_component_definition_get_prop_name_length(component_id_t component_id, uint32_t prop_idx) {
+  host_count_import();
+  HostComponentProp *prop = host_get_component_prop(component_id, prop_idx);
+  return prop ? strlen(prop->name) : -1;
+}
+
+int32_t websg_component_definition_get_prop_name(
+  component_id_t component_id,
+  uint32_t prop_idx,
+  const char *prop_name,
+  size_t length
+) {
+  host_count_import();
+  HostComponentProp *prop = host_get_component_prop(component_id, prop_idx);
+  return prop ? host_write_string(prop->name, prop_name, length) : -1;
+}
+
+uint32_t websg_component_definition_get_prop_type_length(component_id_t component_id, uint32_t prop_idx) {
+  host_count_import();
+  HostComponentProp *prop = host_get_component_prop(component_id, prop_idx);
+  return prop ? strlen(prop->type) : -1;
+}
+
+int32_t websg_component_definition_get_prop_type(
+  component_id_t component_id,
+  uint32_t prop_idx,
+  const char *prop_type,
+  size_t length
+) {
+  host_count_import();
+  HostComponentProp *prop = host_get_component_prop(component_id, prop_idx);
+  return prop ? host_write_string(prop->type, prop_type, length) : -1;
+}
+
+uint32_t websg_component_definition_get_ref_type_length(component_id_t component_id, uint32_t prop_idx) {
+  host_count_import();
+  HostComponentProp *prop = host_get_component_prop(component_id, prop_idx);
+
+  if (prop == NULL) {
+    return -1;
+  }
+
+  return prop->ref_type ? strlen(prop->ref_type) : 0;
+}
+
+int32_t websg_component_definition_get_ref_type(
+  component_id_t component_id,
+  uint32_t prop_idx,
+  const char *ref_type,
+  size_t length
+) {
+  host_count_import();
+  HostComponentProp *prop = host_get_component_prop(component_id, prop_idx);
+
+  if (prop == NULL) {
+    return -1;
+  }
+
+  return prop->ref_type ? host_write_string(prop->ref_type, ref_type, length) : 0;
+}
+
+ComponentPropStorageType websg_component_definition_get_prop_storage_type(
+  component_id_t component_id,
+  uint32_t prop_idx
+) {
+  host_count_import();
+  HostComponentProp *prop = host_get_component_prop(component_id, prop_idx);
+  return prop ? prop->storage_type : -1;
+}
+
+int32_t websg_component_definition_get_prop_size(component_id_t component_id, uint32_t prop_idx) {
+  host_count_import();
+  HostComponentProp *prop = host_get_component_prop(component_id, prop_idx);
+  return prop ? prop->size : -1;
+}
+
+uint32_t websg_world_get_component_store_size() {
+  host_count_import();
+  return host.component_store_size;
+}
+
+int32_t websg_world_set_component_store_size(uint32_t size) {
+  host_count_import();
+
+  if (size > HOST_MAX_ENTITIES) {
+    return -1;
+  }
+
+  host.component_store_size = size;
+
+  return 0;
+}
+
+int32_t websg_world_set_component_store(component_id_t component_id, void *ptr) {
+  host_count_import();
+  HostComponent *component = host_get_component(component_id);
+
+  if (component == NULL) {
+    return -1;
+  }
+
+  component->store = ptr;
+
+  return 0;
+}
+
+void *websg_world_get_component_store(component_id_t component_id) {
+  host_count_import();
+  HostComponent *component = host_get_component(component_id);
+  return component ? component->store : NULL;
+}
+
+int32_t websg_node_add_component(node_id_t node_id, component_id_t component_id) {
+  host_count_import();
+  return host_add_component(node_id, component_id);
+}
+
+int32_t websg_node_remove_component(node_id_t node_id, component_id_t component_id) {
+  host_count_import();
+  HostNode *node = host_get_node(node_id);
+  HostComponent *component = host_get_component(component_id);
+
+  if (node == NULL || component == NULL || node->component_store_index >= HOST_MAX_ENTITIES) {
+    return -1;
+  }
+
+  component->nodes[node->component_store_index] = 0;
+
+  return 0;
+}
+
+int32_t websg_node_has_component(node_id_t node_id, component_id_t component_id) {
+  host_count_import();
+  HostNode *node = host_get_node(node_id);
+  HostComponent *component = host_get_component(component_id);
+
+  if (node == NULL || component == NULL || node->component_store_index >= HOST_MAX_ENTITIES) {
+    return 0;
+  }
+
+  return component->nodes[node->component_store_index];
+}
+
+uint32_t websg_node_get_component_store_index(node_id_t node_id) {
+  host_count_import();
+  HostNode *node = host_get_node(node_id);
+  return node ? node->component_store_index : -1;
+}
+
+int32_t websg_node_set_forward_direction(node_id_t node_id, float_t *direction) {
+  host_count_import();
+  return host_get_node(node_id) ? 0 : -1;
+}
+
+/*********
+ * Scene *
+ *********/
+
+scene_id_t websg_world_create_scene(SceneProps *props) {
+  host_count_import();
+  return host_create_scene(props->name);
+}
+
+scene_id_t websg_world_find_scene_by_name(const char *name, uint32_t length) {
+  host_count_import();
+
+  for (uint32_t i = 1; i < host.resource_count; i++) {
+    HostResource *resource = &host.resources[i];
+
+    if (
+      resource->type == HostResourceType_Scene &&
+      resource->scene.name &&
+      strlen(resource->scene.name) == length &&
+      strncmp(resource->scene.name, name, length) == 0
+    ) {
+      return i;
+    }
+  }
+
+  return 0;
+}
+
+int32_t websg_scene_add_node(scene_id_t scene_id, node_id_t node_id) {
+  host_count_import();
+  return host_get_scene(scene_id) ? host_add_child(scene_id, node_id) : -1;
+}
+
+int32_t websg_scene_remove_node(scene_id_t scene_id, node_id_t node_id) {
+  host_count_import();
+  return host_get_scene(scene_id) ? host_remove_child(scene_id, node_id) : -1;
+}
+
+static int32_t host_get_child_count(uint32_t first_child) {
+  int32_t count = 0;
+
+  for (uint32_t cursor = first_child; cursor; cursor = host_get_node(cursor)->next_sibling) {
+    count++;
+  }
+
+  return count;
+}
+
+static int32_t host_get_children(uint32_t first_child, node_id_t *children, uint32_t max_count) {
+  uint32_t count = 0;
+
+  for (uint32_t cursor = first_child; cursor && count < max_count; cursor = host_get_node(cursor)->next_sibling) {
+    children[count++] = cursor;
+  }
+
+  return count;
+}
+
+static node_id_t host_get_child(uint32_t first_child, uint32_t index) {
+  uint32_t i = 0;
+
+  for (uint32_t cursor = first_child; cursor; cursor = host_get_node(cursor)->next_sibling) {
+    if (i++ == index) {
+      return cursor;
+    }
+  }
+
+  return 0;
+}
+
+int32_t websg_scene_get_node_count(scene_id_t scene_id) {
+  host_count_import();
+  HostScene *scene = host_get_scene(scene_id);
+  return scene ? host_get_child_count(scene->first_child) : -1;
+}
+
+int32_t websg_scene_get_nodes(scene_id_t scene_id, node_id_t *nodes, uint32_t max_count) {
+  host_count_import();
+  HostScene *scene = host_get_scene(scene_id);
+  return scene ? host_get_children(scene->first_child, nodes, max_count) : -1;
+}
+
+node_id_t websg_scene_get_node(scene_id_t scene_id, uint32_t index) {
+  host_count_import();
+  HostScene *scene = host_get_scene(scene_id);
+  return scene ? host_get_child(scene->first_child, index) : 0;
+}
+
+/********
+ * Node *
+ ********/
+
+node_id_t websg_world_create_node(NodeProps *props) {
+  host_count_import();
+  node_id_t node_id = host_create_node(props->name);
+  HostNode *node = host_get_node(node_id);
+  memcpy(node->translation, props->translation, sizeof(float_t) * 3);
+  memcpy(node->rotation, props->rotation, sizeof(float_t) * 4);
+  memcpy(node->scale, props->scale, sizeof(float_t) * 3);
+  node->mesh = props->mesh;
+
+  for (uint32_t i = 0; i < props->extensions.count; i++) {
+    ExtensionItem *item = &props->extensions.items[i];
+
+    if (strcmp(item->name, "OMI_collider") == 0) {
+      node->collider = ((ExtensionNodeColliderRef *)item->extension)->collider;
+    } else if (strcmp(item->name, "MX_ui") == 0) {
+      node->ui_canvas = ((UIExtensionNodeCanvasRef *)item->extension)->canvas;
+    }
+  }
+
+  return node_id;
+}
+
+node_id_t websg_world_find_node_by_name(const char *name, uint32_t length) {
+  host_count_import();
+
+  for (uint32_t i = 1; i < host.resource_count; i++) {
+    HostResource *resource = &host.resources[i];
+
+    if (
+      resource->type == HostResourceType_Node &&
+      resource->node.name &&
+      strlen(resource->node.name) == length &&
+      strncmp(resource->node.name, name, length) == 0
+    ) {
+      return i;
+    }
+  }
+
+  return 0;
+}
+
+int32_t websg_node_add_child(node_id_t node_id, node_id_t child_id) {
+  host_count_import();
+  return host_get_node(node_id) ? host_add_child(node_id, child_id) : -1;
+}
+
+int32_t websg_node_remove_child(node_id_t node_id, node_id_t child_id) {
+  host_count_import();
+  return host_get_node(node_id) ? host_remove_child(node_id, child_id) : -1;
+}
+
+int32_t websg_node_get_child_count(node_id_t node_id) {
+  host_count_import();
+  HostNode *node = host_get_node(node_id);
+  return node ? host_get_child_count(node->first_child) : -1;
+}
+
+int32_t websg_node_get_children(node_id_t node_id, node_id_t *children, uint32_t max_count) {
+  host_count_import();
+  HostNode *node = host_get_node(node_id);
+  return node ? host_get_children(node->first_child, children, max_count) : -1;
+}
+
+node_id_t websg_node_get_child(node_id_t node_id, uint32_t index) {
+  host_count_import();
+  HostNode *node = host_get_node(node_id);
+  return node ? host_get_child(node->first_child, index) : 0;
+}
+
+node_id_t websg_node_get_parent(node_id_t node_id) {
+  host_count_import();
+  HostNode *node = host_get_node(node_id);
+  return node ? node->parent : 0;
+}
+
+scene_id_t websg_node_get_parent_scene(node_id_t node_id) {
+  host_count_import();
+  HostNode *node = host_get_node(node_id);
+  return node ? node->parent_scene : 0;
+}
+
+#define HOST_NODE_ARRAY_PROP(NAME, FIELD, LENGTH) \
+  float_t websg_node_get_##NAME##_element(node_id_t node_id, uint32_t index) { \
+    host_count_import(); \
+    HostNode *node = host_get_node(node_id); \
+    return node && index < LENGTH ? node->FIELD[index] : -1; \
+  } \
+  int32_t websg_node_get_##NAME(node_id_t node_id, float_t *NAME) { \
+    host_count_import(); \
+    HostNode *node = host_get_node(node_id); \
+    if (node == NULL) return -1; \
+    memcpy(NAME, node->FIELD, sizeof(float_t) * LENGTH); \
+    return 0; \
+  }
+
+#define HOST_NODE_MUTABLE_ARRAY_PROP(NAME, FIELD, LENGTH) \
+  HOST_NODE_ARRAY_PROP(NAME, FIELD, LENGTH) \
+  int32_t websg_node_set_##NAME##_element(node_id_t node_id, uint32_t index, float_t value) { \
+    host_count_import(); \
+    HostNode *node = host_get_node(node_id); \
+    if (node == NULL || index >= LENGTH) return -1; \
+    node->FIELD[index] = value; \
+    return 0; \
+  } \
+  int32_t websg_node_set_##NAME(node_id_t node_id, float_t *NAME) { \
+    host_count_import(); \
+    HostNode *node = host_get_node(node_id); \
+    if (node == NULL) return -1; \
+    memcpy(node->FIELD, NAME, sizeof(float_t) * LENGTH); \
+    return 0; \
+  }
+
+HOST_NODE_MUTABLE_ARRAY_PROP(translation, translation, 3)
+HOST_NODE_MUTABLE_ARRAY_PROP(rotation, rotation, 4)
+HOST_NODE_MUTABLE_ARRAY_PROP(scale, scale, 3)
+HOST_NODE_MUTABLE_ARRAY_PROP(matrix, local_matrix, 16)
+HOST_NODE_ARRAY_PROP(world_matrix, world_matrix, 16)
+
+// Bulk versions count as a single import call, like they do across the wasm boundary.
+#define HOST_NODES_ARRAY_PROP(NAME, FIELD, LENGTH) \
+  int32_t websg_nodes_get_##NAME(node_id_t *node_ids, uint32_t count, float_t *values) { \
+    host_count_import(); \
+    int32_t result = 0; \
+    for (uint32_t i = 0; i < count; i++) { \
+      HostNode *node = host_get_node(node_ids[i]); \
+      if (node == NULL) { result = -1; continue; } \
+      memcpy(values + i * LENGTH, node->FIELD, sizeof(float_t) * LENGTH); \
+    } \
+    return result; \
+  } \
+  int32_t websg_nodes_set_##NAME(node_id_t *node_ids, uint32_t count, float_t *values) { \
+    host_count_import(); \
+    int32_t result = 0; \
+    for (uint32_t i = 0; i < count; i++) { \
+      HostNode *node = host_get_node(node_ids[i]); \
+      if (node == NULL) { result = -1; continue; } \
+      memcpy(node->FIELD, values + i * LENGTH, sizeof(float_t) * LENGTH); \
+    } \
+    return result; \
+  }
+
+HOST_NODES_ARRAY_PROP(translations, translation, 3)
+HOST_NODES_ARRAY_PROP(rotations, rotation, 4)
+HOST_NODES_ARRAY_PROP(scales, scale, 3)
+HOST_NODES_ARRAY_PROP(matrices, local_matrix, 16)
+// The host recomposes matrices from TRS every frame, so written world matrices only last until the next update.
+HOST_NODES_ARRAY_PROP(world_matrices, world_matrix, 16)
+
+#define HOST_NODE_PROP(NAME, FIELD, TYPE) \
+  TYPE websg_node_get_##NAME(node_id_t node_id) { \
+    host_count_import(); \
+    HostNode *node = host_get_node(node_id); \
+    return node ? node->FIELD : 0; \
+  } \
+  int32_t websg_node_set_##NAME(node_id_t node_id, TYPE value) { \
+    host_count_import(); \
+    HostNode *node = host_get_node(node_id); \
+    if (node == NULL) return -1; \
+    node->FIELD = value; \
+    return 0; \
+  }
+
+HOST_NODE_PROP(visible, visible, uint32_t)
+HOST_NODE_PROP(is_static, is_static, uint32_t)
+HOST_NODE_PROP(mesh, mesh, mesh_id_t)
+HOST_NODE_PROP(light, light, light_id_t)
+HOST_NODE_PROP(collider, collider, collider_id_t)
+HOST_NODE_PROP(ui_canvas, ui_canvas, ui_canvas_id_t)
+
+int32_t websg_node_set_is_static_recursive(node_id_t node_id, uint32_t is_static) {
+  host_count_import();
+  HostNode *node = host_get_node(node_id);
+
+  if (node == NULL) {
+    return -1;
+  }
+
+  node->is_static = is_static;
+
+  for (uint32_t cursor = node->first_child; cursor; cursor = host_get_node(cursor)->next_sibling) {
+    websg_node_set_is_static_recursive(cursor, is_static);
+  }
+
+  return 0;
+}
+
+int32_t websg_node_dispose(node_id_t node_id) {
+  host_count_import();
+  HostNode *node = host_get_node(node_id);
+
+  if (node == NULL) {
+    return -1;
+  }
+
+  if (node->parent) {
+    host_remove_child(node->parent, node_id);
+  } else if (node->parent_scene) {
+    host_remove_child(node->parent_scene, node_id);
+  }
+
+  free(node->name);
+  host.resources[node_id].type = HostResourceType_None;
+
+  return 0;
+}
+
+int32_t websg_node_start_orbit(node_id_t node_id, CameraRigOptions *options) {
+  host_count_import();
+  return host_get_node(node_id) ? 0 : -1;
+}
+
+int32_t websg_world_stop_orbit() {
+  host_count_import();
+  return 0;
+}
+
+/****************************************
+ * Interactable, Physics and Collisions *
+ ****************************************/
+
+int32_t websg_node_add_interactable(node_id_t node_id, InteractableProps *props) {
+  host_count_import();
+  HostNode *node = host_get_node(node_id);
+
+  if (node == NULL || node->interactable) {
+    return -1;
+  }
+
+  node->interactable = true;
+
+  return 0;
+}
+
+int32_t websg_node_remove_interactable(node_id_t node_id) {
+  host_count_import();
+  HostNode *node = host_get_node(node_id);
+
+  if (node == NULL) {
+    return -1;
+  }
+
+  node->interactable = false;
+
+  return 0;
+}
+
+int32_t websg_node_has_interactable(node_id_t node_id) {
+  host_count_import();
+  HostNode *node = host_get_node(node_id);
+  return node && node->interactable ? 1 : 0;
+}
+
+int32_t websg_node_get_interactable_pressed(node_id_t node_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_node_get_interactable_held(node_id_t node_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_node_get_interactable_released(node_id_t node_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_node_add_physics_body(node_id_t node_id, PhysicsBodyProps *props) {
+  host_count_import();
+  HostNode *node = host_get_node(node_id);
+
+  if (node == NULL || node->physics_body) {
+    return -1;
+  }
+
+  node->physics_body = true;
+  node->mass = props->mass > 0 ? props->mass : 1;
+  memcpy(node->linear_velocity, props->linear_velocity, sizeof(node->linear_velocity));
+  memcpy(node->angular_velocity, props->angular_velocity, sizeof(node->angular_velocity));
+  node->sleeping = false;
+
+  return 0;
+}
+
+int32_t websg_node_remove_physics_body(node_id_t node_id) {
+  host_count_import();
+  HostNode *node = host_get_node(node_id);
+
+  if (node == NULL) {
+    return -1;
+  }
+
+  node->physics_body = false;
+
+  return 0;
+}
+
+int32_t websg_node_has_physics_body(node_id_t node_id) {
+  host_count_import();
+  HostNode *node = host_get_node(node_id);
+  return node && node->physics_body ? 1 : 0;
+}
+
+int32_t websg_physics_body_apply_impulse(node_id_t node_id, float_t *impulse) {
+  host_count_import();
+  HostNode *node = host_get_node(node_id);
+  return node && node->physics_body ? 0 : -1;
+}
+
+static int32_t host_physics_bodies_copy_vectors(
+  node_id_t *node_ids,
+  uint32_t count,
+  float_t *values,
+  size_t field_offset,
+  bool write
+) {
+  int32_t result = 0;
+
+  for (uint32_t i = 0; i < count; i++) {
+    HostNode *node = host_get_node(node_ids[i]);
+
+    if (node == NULL || !node->physics_body) {
+      result = -1;
+      continue;
+    }
+
+    float_t *field = (float_t *)((uint8_t *)node + field_offset);
+
+    if (write) {
+      memcpy(field, &values[i * 3], sizeof(float_t) * 3);
+    } else {
+      memcpy(&values[i * 3], field, sizeof(float_t) * 3);
+    }
+  }
+
+  return result;
+}
+
+int32_t websg_physics_bodies_get_linear_velocities(node_id_t *node_ids, uint32_t count, float_t *velocities) {
+  host_count_import();
+  return host_physics_bodies_copy_vectors(node_ids, count, velocities, offsetof(HostNode, linear_velocity), false);
+}
+
+int32_t websg_physics_bodies_set_linear_velocities(node_id_t *node_ids, uint32_t count, float_t *velocities) {
+  host_count_import();
+  return host_physics_bodies_copy_vectors(node_ids, count, velocities, offsetof(HostNode, linear_velocity), true);
+}
+
+int32_t websg_physics_bodies_get_angular_velocities(node_id_t *node_ids, uint32_t count, float_t *velocities) {
+  host_count_import();
+  return host_physics_bodies_copy_vectors(node_ids, count, velocities, offsetof(HostNode, angular_velocity), false);
+}
+
+int32_t websg_physics_bodies_set_angular_velocities(node_id_t *node_ids, uint32_t count, float_t *velocities) {
+  host_count_import();
+  return host_physics_bodies_copy_vectors(node_ids, count, velocities, offsetof(HostNode, angular_velocity), true);
+}
+
+// There is no physics step for forces to act on, they are only validated.
+int32_t websg_physics_bodies_apply_forces(node_id_t *node_ids, uint32_t count, float_t *forces) {
+  host_count_import();
+  int32_t result = 0;
+
+  for (uint32_t i = 0; i < count; i++) {
+    HostNode *node = host_get_node(node_ids[i]);
+
+    if (node == NULL || !node->physics_body) {
+      result = -1;
+    }
+  }
+
+  return result;
+}
+
+int32_t websg_physics_bodies_apply_impulses(node_id_t *node_ids, uint32_t count, float_t *impulses) {
+  host_count_import();
+  int32_t result = 0;
+
+  for (uint32_t i = 0; i < count; i++) {
+    HostNode *node = host_get_node(node_ids[i]);
+
+    if (node == NULL || !node->physics_body) {
+      result = -1;
+      continue;
+    }
+
+    for (int j = 0; j < 3; j++) {
+      node->linear_velocity[j] += impulses[i * 3 + j] / node->mass;
+    }
+
+    node->sleeping = false;
+  }
+
+  return result;
+}
+
+int32_t websg_physics_bodies_get_sleeping(node_id_t *node_ids, uint32_t count, uint32_t *sleeping) {
+  host_count_import();
+  int32_t result = 0;
+
+  for (uint32_t i = 0; i < count; i++) {
+    HostNode *node = host_get_node(node_ids[i]);
+
+    if (node == NULL || !node->physics_body) {
+      result = -1;
+      continue;
+    }
+
+    sleeping[i] = node->sleeping;
+  }
+
+  return result;
+}
+
+int32_t websg_physics_bodies_set_sleeping(node_id_t *node_ids, uint32_t count, uint32_t *sleeping) {
+  host_count_import();
+  int32_t result = 0;
+
+  for (uint32_t i = 0; i < count; i++) {
+    HostNode *node = host_get_node(node_ids[i]);
+
+    if (node == NULL || !node->physics_body) {
+      result = -1;
+      continue;
+    }
+
+    node->sleeping = sleeping[i] != 0;
+  }
+
+  return result;
+}
+
+/**
+ * Physics queries test every node with a physics body and a collider, there is no broadphase. Rays and shapes are
+ * swept spheres, see HostCollider.
+ **/
+
+static float_t host_get_collider_radius(collider_id_t collider_id) {
+  HostResource *resource = host_get_resource(collider_id, HostResourceType_Collider);
+  return resource ? resource->collider.bounding_radius : 0;
+}
+
+static HostCollider *host_get_query_collider(collider_id_t collider_id) {
+  HostResource *resource = host_get_resource(collider_id, HostResourceType_Collider);
+
+  if (resource == NULL) {
+    return NULL;
+  }
+
+  ColliderType type = resource->collider.type;
+
+  if (type != ColliderType_Box && type != ColliderType_Sphere && type != ColliderType_Capsule) {
+    return NULL;
+  }
+
+  return &resource->collider;
+}
+
+static int32_t host_cast_sphere(
+  const float_t *origin,
+  const float_t *direction,
+  float_t radius,
+  float_t max_distance,
+  node_id_t exclude_node_id,
+  PhysicsHit *hit
+) {
+  float_t a = direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2];
+  float_t closest = INFINITY;
+  node_id_t closest_node_id = 0;
+  const float_t *closest_center = NULL;
+
+  memset(hit, 0, sizeof(PhysicsHit));
+
+  if (a == 0) {
+    return 0;
+  }
+
+  for (uint32_t i = 1; i < host.resource_count; i++) {
+    HostResource *resource = &host.resources[i];
+
+    if (resource->type != HostResourceType_Node || i == exclude_node_id) {
+      continue;
+    }
+
+    HostNode *node = &resource->node;
+
+    if (!node->physics_body || node->collider == 0) {
+      continue;
+    }
+
+    float_t node_radius = host_get_collider_radius(node->collider);
+
+    if (node_radius == 0) {
+      continue;
+    }
+
+    float_t target_radius = node_radius + radius;
+
+    const float_t *center = node->world_matrix + 12;
+    float_t offset[3] = { origin[0] - center[0], origin[1] - center[1], origin[2] - center[2] };
+    float_t b = offset[0] * direction[0] + offset[1] * direction[1] + offset[2] * direction[2];
+    float_t c = offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2] - target_radius * target_radius;
+    float_t discriminant = b * b - a * c;
+
+    if (discriminant < 0) {
+      continue;
+    }
+
+    float_t root = sqrtf(discriminant);
+    float_t t = (-b - root) / a;
+
+    // Starting inside a collider is a hit at 0, like the game worker's solid ray casts.
+    if (t < 0) {
+      if ((-b + root) / a < 0) {
+        continue;
+      }
+
+      t = 0;
+    }
+
+    if (t <= max_distance && t < closest) {
+      closest = t;
+      closest_node_id = i;
+      closest_center = center;
+    }
+  }
+
+  if (closest_center == NULL) {
+    return 0;
+  }
+
+  hit->node_id = closest_node_id;
+  hit->hit = 1;
+  hit->distance = closest;
+
+  float_t length_squared = 0;
+
+  for (uint32_t k = 0; k < 3; k++) {
+    hit->position[k] = origin[k] + direction[k] * closest;
+    hit->normal[k] = hit->position[k] - closest_center[k];
+    length_squared += hit->normal[k] * hit->normal[k];
+  }
+
+  if (length_squared > 0) {
+    float_t inverse_length = 1 / sqrtf(length_squared);
+
+    for (uint32_t k = 0; k < 3; k++) {
+      hit->normal[k] *= inverse_length;
+    }
+  }
+
+  return 1;
+}
+
+int32_t websg_world_cast_rays(
+  const float_t *origins,
+  const float_t *directions,
+  uint32_t count,
+  float_t max_distance,
+  node_id_t exclude_node_id,
+  PhysicsHit *hits
+) {
+  host_count_import();
+  int32_t hit_count = 0;
+
+  for (uint32_t i = 0; i < count; i++) {
+    hit_count += host_cast_sphere(origins + i * 3, directions + i * 3, 0, max_distance, exclude_node_id, &hits[i]);
+  }
+
+  return hit_count;
+}
+
+int32_t websg_world_cast_shapes(
+  collider_id_t collider_id,
+  const float_t *origins,
+  const float_t *rotations,
+  const float_t *directions,
+  uint32_t count,
+  float_t max_distance,
+  node_id_t exclude_node_id,
+  PhysicsHit *hits
+) {
+  host_count_import();
+  HostCollider *collider = host_get_query_collider(collider_id);
+
+  if (collider == NULL) {
+    return -1;
+  }
+
+  int32_t hit_count = 0;
+
+  for (uint32_t i = 0; i < count; i++) {
+    hit_count += host_cast_sphere(
+      origins + i * 3,
+      directions + i * 3,
+      collider->bounding_radius,
+      max_distance,
+      exclude_node_id,
+      &hits[i]
+    );
+  }
+
+  return hit_count;
+}
+
+int32_t websg_world_overlap_shapes(
+  collider_id_t collider_id,
+  const float_t *positions,
+  const float_t *rotations,
+  uint32_t count,
+  node_id_t exclude_node_id,
+  uint32_t *overlap_counts,
+  node_id_t *node_ids,
+  uint32_t max_node_count
+) {
+  host_count_import();
+  HostCollider *collider = host_get_query_collider(collider_id);
+
+  if (collider == NULL) {
+    return -1;
+  }
+
+  uint32_t total = 0;
+
+  for (uint32_t q = 0; q < count; q++) {
+    const float_t *position = positions + q * 3;
+    overlap_counts[q] = 0;
+
+    for (uint32_t i = 1; i < host.resource_count; i++) {
+      HostResource *resource = &host.resources[i];
+
+      if (resource->type != HostResourceType_Node || i == exclude_node_id) {
+        continue;
+      }
+
+      HostNode *node = &resource->node;
+
+      if (!node->physics_body || node->collider == 0) {
+        continue;
+      }
+
+      float_t node_radius = host_get_collider_radius(node->collider);
+
+      if (node_radius == 0) {
+        continue;
+      }
+
+      float_t target_radius = node_radius + collider->bounding_radius;
+      const float_t *center = node->world_matrix + 12;
+      float_t dx = position[0] - center[0];
+      float_t dy = position[1] - center[1];
+      float_t dz = position[2] - center[2];
+
+      if (dx * dx + dy * dy + dz * dz >= target_radius * target_radius) {
+        continue;
+      }
+
+      if (total < max_node_count) {
+        node_ids[total] = i;
+        overlap_counts[q]++;
+      }
+
+      total++;
+    }
+  }
+
+  return total;
+}
+
+collision_listener_id_t websg_world_create_collision_listener() {
+  host_count_import();
+  return host_create_resource(HostResourceType_CollisionListener);
+}
+
+int32_t websg_collision_listener_dispose(collision_listener_id_t listener_id) {
+  host_count_import();
+  return host_get_resource(listener_id, HostResourceType_CollisionListener) ? 0 : -1;
+}
+
+int32_t websg_collisions_listener_get_collision_count(collision_listener_id_t listener_id) {
+  host_count_import();
+  return host_get_resource(listener_id, HostResourceType_CollisionListener) ? 0 : -1;
+}
+
+int32_t websg_collisions_listener_get_collisions(
+  collision_listener_id_t listener_id,
+  CollisionItem *collisions,
+  uint32_t max_count
+) {
+  host_count_import();
+  return host_get_resource(listener_id, HostResourceType_CollisionListener) ? 0 : -1;
+}
+
+// The native host doesn't simulate physics, so filtered listeners never receive contacts.
+collision_listener_id_t websg_world_create_filtered_collision_listener(CollisionListenerProps *props) {
+  host_count_import();
+  return host_create_resource(HostResourceType_CollisionListener);
+}
+
+int32_t websg_collision_listener_get_contacts(
+  collision_listener_id_t listener_id,
+  CollisionContact *contacts,
+  uint32_t max_count
+) {
+  host_count_import();
+  return host_get_resource(listener_id, HostResourceType_CollisionListener) ? 0 : -1;
+}
+
+int32_t websg_collision_listener_get_dropped_count(collision_listener_id_t listener_id) {
+  host_count_import();
+  return host_get_resource(listener_id, HostResourceType_CollisionListener) ? 0 : -1;
+}
+
+/*************
+ * Resources *
+ *************/
+
+mesh_id_t websg_world_create_mesh(MeshProps *props) {
+  host_count_import();
+  return host_create_resource(HostResourceType_Mesh);
+}
+
+mesh_id_t websg_world_create_box_mesh(BoxMeshProps *props) {
+  host_count_import();
+  return host_create_resource(HostResourceType_Mesh);
+}
+
+accessor_id_t websg_world_create_accessor_from(void *data, uint32_t byte_length, AccessorFromProps *props) {
+  host_count_import();
+  return host_create_resource(HostResourceType_Accessor);
+}
+
+material_id_t websg_world_create_material(MaterialProps *props) {
+  host_count_import();
+  return host_create_resource(HostResourceType_Material);
+}
+
+light_id_t websg_world_create_light(LightProps *props) {
+  host_count_import();
+  return host_create_resource(HostResourceType_Light);
+}
+
+collider_id_t websg_world_create_collider(ColliderProps *props) {
+  host_count_import();
+  collider_id_t collider_id = host_create_resource(HostResourceType_Collider);
+  HostCollider *collider = &host.resources[collider_id].collider;
+  collider->type = props->type;
+
+  if (props->type == ColliderType_Box) {
+    float_t *size = props->size;
+    collider->bounding_radius = sqrtf(size[0] * size[0] + size[1] * size[1] + size[2] * size[2]) / 2;
+  } else if (props->type == ColliderType_Sphere) {
+    collider->bounding_radius = props->radius;
+  } else if (props->type == ColliderType_Capsule) {
+    collider->bounding_radius = props->radius + props->height / 2;
+  } else if (props->type == ColliderType_Cylinder) {
+    collider->bounding_radius = sqrtf(props->radius * props->radius + props->height * props->height / 4);
+  }
+
+  return collider_id;
+}
+
+ui_canvas_id_t websg_world_create_ui_canvas(UICanvasProps *props) {
+  host_count_import();
+  return host_create_resource(HostResourceType_UICanvas);
+}
+
+ui_element_id_t websg_world_create_ui_element(UIElementProps *props) {
+  host_count_import();
+  return host_create_resource(HostResourceType_UIElement);
+}
+
+/**
+ * Imports not modeled by the native host. They return 0 (not found, empty or no-op success).
+ **/
+
+mesh_id_t websg_world_find_mesh_by_name(const char *name, uint32_t length) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_mesh_get_primitive_count(mesh_id_t mesh_id) {
+  host_count_import();
+  return 0;
+}
+
+accessor_id_t websg_mesh_get_primitive_attribute(mesh_id_t mesh_id, uint32_t index, MeshPrimitiveAttribute attribute) {
+  host_count_import();
+  return 0;
+}
+
+accessor_id_t websg_mesh_get_primitive_indices(mesh_id_t mesh_id, uint32_t index) {
+  host_count_import();
+  return 0;
+}
+
+material_id_t websg_mesh_get_primitive_material(mesh_id_t mesh_id, uint32_t index) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_mesh_set_primitive_material(mesh_id_t mesh_id, uint32_t index, material_id_t material_id) {
+  host_count_import();
+  return 0;
+}
+
+MeshPrimitiveMode websg_mesh_get_primitive_mode(mesh_id_t mesh_id, uint32_t index) {
+  host_count_import();
+  return 0;
+}
+
+MeshPrimitiveMode websg_mesh_set_primitive_draw_range(
+  mesh_id_t mesh_id,
+  uint32_t index,
+  uint32_t start,
+  uint32_t count
+) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_mesh_set_primitive_hologram_material_enabled(mesh_id_t mesh_id, uint32_t index, uint32_t enabled) {
+  host_count_import();
+  return 0;
+}
+
+accessor_id_t websg_world_find_accessor_by_name(const char *name, uint32_t length) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_accessor_update_with(accessor_id_t accessor_id, void *data, uint32_t length) {
+  host_count_import();
+  return 0;
+}
+
+material_id_t websg_world_find_material_by_name(const char *name, uint32_t length) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_material_get_base_color_factor(material_id_t material_id, float_t *base_color_factor) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_material_set_base_color_factor(material_id_t material_id, float_t *base_color_factor) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_material_get_base_color_factor_element(material_id_t material_id, uint32_t index) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_material_set_base_color_factor_element(material_id_t material_id, uint32_t index, float_t value) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_material_get_metallic_factor(material_id_t material_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_material_set_metallic_factor(material_id_t material_id, float_t metallic_factor) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_material_get_roughness_factor(material_id_t material_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_material_set_roughness_factor(material_id_t material_id, float_t roughness_factor) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_material_get_emissive_factor(material_id_t material_id, float_t *emissive_factor) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_material_set_emissive_factor(material_id_t material_id, float_t *emissive_factor) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_material_get_emissive_factor_element(material_id_t material_id, uint32_t index) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_material_set_emissive_factor_element(material_id_t material_id, uint32_t index, float_t value) {
+  host_count_import();
+  return 0;
+}
+
+texture_id_t websg_material_get_base_color_texture(material_id_t material_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_material_set_base_color_texture(material_id_t material_id, texture_id_t texture_id) {
+  host_count_import();
+  return 0;
+}
+
+texture_id_t websg_world_find_texture_by_name(const char *name, uint32_t length) {
+  host_count_import();
+  return 0;
+}
+
+image_id_t websg_world_find_image_by_name(const char *name, uint32_t length) {
+  host_count_import();
+  return 0;
+}
+
+light_id_t websg_world_find_light_by_name(const char *name, uint32_t length) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_light_get_color(light_id_t light_id, float_t *color) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_light_set_color(light_id_t light_id, float_t *color) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_light_get_color_element(light_id_t light_id, uint32_t index) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_light_set_color_element(light_id_t light_id, uint32_t index, float value) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_light_get_intensity(light_id_t light_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_light_set_intensity(light_id_t light_id, float_t intensity) {
+  host_count_import();
+  return 0;
+}
+
+collider_id_t websg_world_find_collider_by_name(const char *name, uint32_t length) {
+  host_count_import();
+  return 0;
+}
+
+light_id_t websg_world_find_ui_canvas_by_name(const char *name, uint32_t length) {
+  host_count_import();
+  return 0;
+}
+
+ui_element_id_t websg_ui_canvas_get_root(ui_canvas_id_t canvas_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_canvas_set_root(ui_canvas_id_t canvas_id, ui_element_id_t root_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_canvas_get_size(ui_canvas_id_t canvas_id, float_t *size) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_canvas_set_size(ui_canvas_id_t canvas_id, float_t *size) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_canvas_get_size_element(ui_canvas_id_t canvas_id, uint32_t index) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_canvas_set_size_element(ui_canvas_id_t canvas_id, uint32_t index, float_t value) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_canvas_get_width(ui_canvas_id_t canvas_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_canvas_set_width(ui_canvas_id_t canvas_id, float_t width) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_canvas_get_height(ui_canvas_id_t canvas_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_canvas_set_height(ui_canvas_id_t canvas_id, float_t height) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_canvas_redraw(ui_canvas_id_t canvas_id) {
+  host_count_import();
+  return 0;
+}
+
+light_id_t websg_world_find_ui_element_by_name(const char *name, uint32_t length) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_element_get_position_element(ui_element_id_t ui_element_id, uint32_t index) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_position_element(ui_element_id_t ui_element_id, uint32_t index, float_t value) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_get_position(ui_element_id_t element_id, float_t *position) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_position(ui_element_id_t element_id, float_t *position) {
+  host_count_import();
+  return 0;
+}
+
+ElementPositionType websg_ui_element_get_position_type(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_position_type(ui_element_id_t element_id, ElementPositionType position_type) {
+  host_count_import();
+  return 0;
+}
+
+FlexAlign websg_ui_element_get_align_content(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_align_content(ui_element_id_t element_id, FlexAlign align_content) {
+  host_count_import();
+  return 0;
+}
+
+FlexAlign websg_ui_element_get_align_items(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_align_items(ui_element_id_t element_id, FlexAlign align_items) {
+  host_count_import();
+  return 0;
+}
+
+FlexAlign websg_ui_element_get_align_self(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_align_self(ui_element_id_t element_id, FlexAlign align_self) {
+  host_count_import();
+  return 0;
+}
+
+FlexDirection websg_ui_element_get_flex_direction(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_flex_direction(ui_element_id_t element_id, FlexDirection flex_direction) {
+  host_count_import();
+  return 0;
+}
+
+FlexWrap websg_ui_element_get_flex_wrap(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_flex_wrap(ui_element_id_t element_id, FlexWrap flex_wrap) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_flex_basis(ui_element_id_t element_id, float_t flex_basis) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_element_get_flex_basis(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_flex_grow(ui_element_id_t element_id, float_t flex_grow) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_element_get_flex_grow(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_flex_shrink(ui_element_id_t element_id, float_t flex_shrink) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_element_get_flex_shrink(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+FlexJustify websg_ui_element_get_justify_content(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_justify_content(ui_element_id_t element_id, FlexJustify justify_content) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_width(ui_element_id_t element_id, float_t width) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_element_get_width(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_height(ui_element_id_t element_id, float_t height) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_element_get_height(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_min_width(ui_element_id_t element_id, float_t min_width) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_element_get_min_width(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_min_height(ui_element_id_t element_id, float_t min_height) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_element_get_min_height(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_max_width(ui_element_id_t element_id, float_t max_width) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_element_get_max_width(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_max_height(ui_element_id_t element_id, float_t max_height) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_element_get_max_height(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_element_get_background_color_element(ui_element_id_t ui_element_id, uint32_t index) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_background_color_element(ui_element_id_t ui_element_id, uint32_t index, float_t value) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_get_background_color(ui_element_id_t element_id, float_t *background_color) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_background_color(ui_element_id_t element_id, float_t *background_color) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_element_get_border_color_element(ui_element_id_t ui_element_id, uint32_t index) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_border_color_element(ui_element_id_t ui_element_id, uint32_t index, float_t value) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_get_border_color(ui_element_id_t element_id, float_t *border_color) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_border_color(ui_element_id_t element_id, float_t *border_color) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_element_get_padding_element(ui_element_id_t ui_element_id, uint32_t index) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_padding_element(ui_element_id_t ui_element_id, uint32_t index, float_t value) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_get_padding(ui_element_id_t element_id, float_t *padding) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_padding(ui_element_id_t element_id, float_t *padding) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_element_get_margin_element(ui_element_id_t ui_element_id, uint32_t index) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_margin_element(ui_element_id_t ui_element_id, uint32_t index, float_t value) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_get_margin(ui_element_id_t element_id, float_t *margin) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_margin(ui_element_id_t element_id, float_t *margin) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_element_get_border_width_element(ui_element_id_t ui_element_id, uint32_t index) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_border_width_element(ui_element_id_t ui_element_id, uint32_t index, float_t value) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_get_border_width(ui_element_id_t element_id, float_t *border_width) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_border_width(ui_element_id_t element_id, float_t *border_width) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_element_get_border_radius_element(ui_element_id_t ui_element_id, uint32_t index) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_border_radius_element(ui_element_id_t ui_element_id, uint32_t index, float_t value) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_get_border_radius(ui_element_id_t element_id, float_t *border_radius) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_set_border_radius(ui_element_id_t element_id, float_t *border_radius) {
+  host_count_import();
+  return 0;
+}
+
+ElementType websg_ui_element_get_element_type(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_add_child(ui_element_id_t ui_element_id, ui_element_id_t child_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_remove_child(ui_element_id_t ui_element_id, ui_element_id_t child_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_get_child_count(ui_element_id_t ui_element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_element_get_children(ui_element_id_t ui_element_id, ui_element_id_t *children, uint32_t max_count) {
+  host_count_import();
+  return 0;
+}
+
+ui_element_id_t websg_ui_element_get_child(ui_element_id_t ui_element_id, uint32_t index) {
+  host_count_import();
+  return 0;
+}
+
+ui_element_id_t websg_ui_element_get_parent(ui_element_id_t ui_element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_button_get_label_length(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_button_get_label(ui_element_id_t element_id, const char *label, size_t length) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_button_set_label(ui_element_id_t element_id, const char *label, size_t length) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_button_get_pressed(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_button_get_held(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_button_get_released(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_text_get_value_length(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_text_get_value(ui_element_id_t element_id, const char *value, size_t length) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_text_set_value(ui_element_id_t element_id, const char *value, size_t length) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_text_get_font_family_length(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_text_get_font_family(ui_element_id_t element_id, const char *font_family, size_t length) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_text_set_font_family(ui_element_id_t element_id, const char *font_family, size_t length) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_text_get_font_style_length(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_text_get_font_style(ui_element_id_t element_id, const char *font_style, size_t length) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_text_set_font_style(ui_element_id_t element_id, const char *font_style, size_t length) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_text_get_font_weight_length(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_text_get_font_weight(ui_element_id_t element_id, const char *font_weight, size_t length) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_text_set_font_weight(ui_element_id_t element_id, const char *font_style, size_t length) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_text_get_font_size(ui_element_id_t element_id) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_text_set_font_size(ui_element_id_t element_id, float_t font_size) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_text_get_color(ui_element_id_t element_id, float_t *color) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_text_set_color(ui_element_id_t element_id, float_t *color) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_ui_text_get_color_element(ui_element_id_t ui_element_id, uint32_t index) {
+  host_count_import();
+  return 0;
+}
+
+int32_t websg_ui_text_set_color_element(ui_element_id_t ui_element_id, uint32_t index, float_t value) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_get_primary_input_source_origin_element(uint32_t index) {
+  host_count_import();
+  return 0;
+}
+
+float_t websg_get_primary_input_source_direction_element(uint32_t index) {
+  host_count_import();
+  return 0;
+}
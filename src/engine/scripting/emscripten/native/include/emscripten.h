@@ -0,0 +1,11 @@
+#ifndef __native_emscripten_h
+#define __native_emscripten_h
+
+/**
+ * Native stand-in for <emscripten.h>. Only the pieces the scripting runtime uses are provided so that the
+ * same sources can be compiled with the host toolchain for profiling.
+ **/
+
+#define EMSCRIPTEN_KEEPALIVE __attribute__((used))
+
+#endif
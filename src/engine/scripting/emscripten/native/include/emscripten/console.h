@@ -0,0 +1,14 @@
+#ifndef __native_emscripten_console_h
+#define __native_emscripten_console_h
+#include <stdio.h>
+
+/**
+ * Native stand-in for <emscripten/console.h>. Console output goes to stdout/stderr.
+ **/
+
+#define emscripten_console_log(str) fprintf(stdout, "%s\n", str)
+#define emscripten_console_error(str) fprintf(stderr, "%s\n", str)
+#define emscripten_console_logf(format, ...) fprintf(stdout, format "\n", ##__VA_ARGS__)
+#define emscripten_console_errorf(format, ...) fprintf(stderr, format "\n", ##__VA_ARGS__)
+
+#endif
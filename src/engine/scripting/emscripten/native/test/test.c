@@ -0,0 +1,643 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "../host/host.h"
+
+#define countof(x) (sizeof(x) / sizeof((x)[0]))
+
+/**
+ * Scripting Runtime Tests
+ *
+ * Runs scripts against the native host and checks what they did. Each test runs in its own process because the
+ * runtime has no teardown export. Checks are evaluated in the script's global scope with test_eval_js, so they can
+ * read the script's top level declarations, and fail by throwing.
+ *
+ * Usage: scripting-test [-t test]
+ *   -t  only run tests whose name contains this string
+ **/
+
+extern int32_t websg_initialize();
+extern int32_t websg_load();
+extern int32_t websg_enter();
+extern int32_t websg_update(float_t dt, float_t time);
+extern const char *test_eval_js(const char *code);
+
+typedef struct Test {
+  const char *name;
+  const char *source;
+  int (*run)(const char *source);
+} Test;
+
+#define expect(x) \
+  do { \
+    if ((x) == -1) { \
+      fprintf(stderr, "  at %s:%d\n", __FILE__, __LINE__); \
+      return -1; \
+    } \
+  } while (0)
+
+/**
+ * Harness
+ **/
+
+// Prepended to every test script.
+static const char *test_prelude =
+  "function assert(condition, message) {\n"
+  "  if (!condition) throw new Error(message);\n"
+  "}\n"
+  "function assertElements(actual, expected, epsilon, message) {\n"
+  "  for (let i = 0; i < expected.length; i++) {\n"
+  "    if (!(Math.abs(actual[i] - expected[i]) <= epsilon)) {\n"
+  "      const elements = Array.from(expected, (_, j) => actual[j]);\n"
+  "      throw new Error(`${message}: expected [${expected}], got [${elements}]`);\n"
+  "    }\n"
+  "  }\n"
+  "}\n";
+
+static uint32_t frame = 0;
+
+static int test_start(const char *source) {
+  size_t source_length = strlen(test_prelude) + strlen(source) + 1;
+  char *script = malloc(source_length);
+  snprintf(script, source_length, "%s%s", test_prelude, source);
+  host_set_js_source(script);
+
+  if (websg_initialize() < 0 || websg_load() < 0 || websg_enter() < 0) {
+    fprintf(stderr, "  script failed to start\n");
+    return -1;
+  }
+
+  return 0;
+}
+
+static int test_update() {
+  float_t dt = 1.0f / 90.0f;
+  frame++;
+  host_update_matrices();
+
+  if (websg_update(dt, dt * frame) < 0) {
+    fprintf(stderr, "  websg_update failed on frame %u\n", frame);
+    return -1;
+  }
+
+  return 0;
+}
+
+// Runs a frame that must fail, with an uncaught error containing message. The runtime prints uncaught errors to
+// stderr, so it's captured for the frame.
+static int test_update_error(const char *message) {
+  float_t dt = 1.0f / 90.0f;
+  frame++;
+  host_update_matrices();
+
+  fflush(stderr);
+  int saved_stderr = dup(STDERR_FILENO);
+  FILE *output = tmpfile();
+  dup2(fileno(output), STDERR_FILENO);
+
+  int32_t result = websg_update(dt, dt * frame);
+
+  fflush(stderr);
+  dup2(saved_stderr, STDERR_FILENO);
+  close(saved_stderr);
+
+  char error[1024] = { 0 };
+  rewind(output);
+  size_t error_length = fread(error, 1, sizeof(error) - 1, output);
+  error[error_length] = '\0';
+  fclose(output);
+
+  if (result != -1 || strstr(error, message) == NULL) {
+    fprintf(stderr, "  expected frame %u to fail with \"%s\", got %d: %s\n", frame, message, result, error);
+    return -1;
+  }
+
+  return 0;
+}
+
+static int test_check(const char *code) {
+  const char *result = test_eval_js(code);
+
+  if (result != NULL && strncmp(result, "{\"error\"", 8) == 0) {
+    fprintf(stderr, "  %s\n  %s\n", code, result);
+    return -1;
+  }
+
+  return 0;
+}
+
+static uint32_t test_find_resource(HostResourceType type) {
+  for (uint32_t i = 1; i < host.resource_count; i++) {
+    if (host.resources[i].type == type) {
+      return i;
+    }
+  }
+
+  return 0;
+}
+
+static node_id_t test_find_node(const char *name) {
+  return websg_world_find_node_by_name(name, strlen(name));
+}
+
+/**
+ * Replicator State
+ *
+ * Snapshots are built by hand to exercise the decoder with input the encoder never produces.
+ **/
+
+#define SNAPSHOT_TYPE_DELTA 0
+#define SNAPSHOT_TYPE_KEYFRAME 1
+
+#define ENTRY_TYPE_DELTA 0
+#define ENTRY_TYPE_FULL 1
+#define ENTRY_TYPE_REMOVED 2
+
+#define REMOTE_NETWORK_ID 500
+
+typedef struct TestPacket {
+  uint8_t data[256];
+  uint32_t byte_length;
+} TestPacket;
+
+static void packet_write_u8(TestPacket *packet, uint8_t value) {
+  packet->data[packet->byte_length++] = value;
+}
+
+static void packet_write_varint(TestPacket *packet, uint32_t value) {
+  while (value >= 0x80) {
+    packet_write_u8(packet, (uint8_t)(value | 0x80));
+    value >>= 7;
+  }
+
+  packet_write_u8(packet, (uint8_t)value);
+}
+
+static void packet_begin(TestPacket *packet, uint8_t snapshot_type, uint32_t entry_count) {
+  packet->byte_length = 0;
+  packet_write_u8(packet, snapshot_type);
+
+  for (uint32_t i = 0; i < 4; i++) {
+    packet_write_u8(packet, (uint8_t)(entry_count >> (i * 8)));
+  }
+}
+
+// Values are quantized, zigzag encoded and written for each field in mask.
+static void packet_write_entry(
+  TestPacket *packet,
+  network_id_t network_id,
+  uint8_t entry_type,
+  uint32_t mask,
+  const int32_t *values,
+  uint32_t value_count
+) {
+  packet_write_varint(packet, network_id);
+  packet_write_u8(packet, entry_type);
+  packet_write_varint(packet, mask);
+
+  for (uint32_t i = 0; i < value_count; i++) {
+    packet_write_varint(packet, ((uint32_t)values[i] << 1) ^ (uint32_t)(values[i] >> 31));
+  }
+}
+
+static void setup_replicator_state_world(bool loopback) {
+  host_reset();
+  host_create_scene("Environment");
+  host_add_peer("@peer-0:example.com");
+  host_add_peer("@peer-1:example.com");
+  host.loopback_replicator_state = loopback;
+}
+
+// Spawns a remote replication for network_id, the script creates its node on the next frame.
+static void push_remote_spawn(network_id_t network_id) {
+  replicator_id_t replicator_id = test_find_resource(HostResourceType_Replicator);
+  host_push_replication(replicator_id, true, 0, network_id, 1, NULL, 0);
+}
+
+static void push_snapshot(TestPacket *packet) {
+  replicator_id_t replicator_id = test_find_resource(HostResourceType_Replicator);
+  host_push_replicator_state(replicator_id, packet->data, packet->byte_length);
+}
+
+// Nodes are named in the order they are created, so the test can find them in the host.
+static const char replicator_state_source[] =
+  "const scene = world.environment;\n"
+  "let nodeCount = 0;\n"
+  "const replicator = network.defineReplicator(() => {\n"
+  "  const node = world.createNode({ name: `node-${nodeCount++}` });\n"
+  "  scene.addNode(node);\n"
+  "  return node;\n"
+  "});\n"
+  "replicator.defineState(['translation', 'rotation']);\n"
+  "const remotes = [];\n"
+  "world.onupdate = () => {\n"
+  "  for (const replication of replicator.spawned()) {\n"
+  "    remotes.push(replication.node);\n"
+  "  }\n"
+  "};\n";
+
+// A local entity's snapshots are looped back to a remote entity with the same network id.
+static int test_replicator_state_round_trip(const char *source) {
+  setup_replicator_state_world(true);
+
+  char script[2048];
+  snprintf(
+    script,
+    sizeof(script),
+    "%s"
+    "const local = replicator.spawn();\n"
+    "local.translation.set([1, 2, 3]);\n",
+    source
+  );
+
+  expect(test_start(script));
+
+  node_id_t local_node_id = test_find_node("node-0");
+  expect(local_node_id == 0 ? -1 : 0);
+  push_remote_spawn(local_node_id);
+
+  // The remote node is spawned and the local entity is sent in full.
+  expect(test_update());
+  expect(test_check("assert(remotes.length === 1, 'remote node was not spawned')"));
+
+  expect(test_update());
+  expect(test_check("assertElements(remotes[0].translation, [1, 2, 3], 0.001, 'full translation')"));
+  expect(test_check("assertElements(remotes[0].rotation, [0, 0, 0, 1], 0.001, 'full rotation')"));
+
+  // Only the changed elements are sent as deltas.
+  expect(test_check("local.translation.x = 5; local.rotation.set([0, 0.6, 0, 0.8]);"));
+  expect(test_update());
+  expect(test_update());
+  expect(test_check("assertElements(remotes[0].translation, [5, 2, 3], 0.001, 'delta translation')"));
+  expect(test_check("assertElements(remotes[0].rotation, [0, 0.6, 0, 0.8], 0.001, 'delta rotation')"));
+
+  // Unchanged entities aren't sent at all.
+  expect(test_update());
+  expect(host.state_snapshot_count == 0 ? 0 : -1);
+
+  expect(test_check("replicator.despawn(local);"));
+  expect(test_update());
+  expect(test_update());
+
+  // The removal unbinds the remote node, later entries for the network id don't move it.
+  TestPacket packet;
+  int32_t delta[] = { 1000, 0, 0 };
+  int32_t full[] = { 9000, 9000, 9000, 0, 0, 0, 10000 };
+  packet_begin(&packet, SNAPSHOT_TYPE_DELTA, 2);
+  packet_write_entry(&packet, local_node_id, ENTRY_TYPE_DELTA, 0x1, delta, countof(delta));
+  packet_write_entry(&packet, local_node_id, ENTRY_TYPE_FULL, 0x3, full, countof(full));
+  push_snapshot(&packet);
+
+  expect(test_update());
+  expect(test_check("assertElements(remotes[0].translation, [5, 2, 3], 0.001, 'translation after removal')"));
+
+  return 0;
+}
+
+// Deltas for entities without a baseline are skipped, their values still have to be read to get to the next entry.
+static int test_replicator_state_skips_delta_without_baseline(const char *source) {
+  setup_replicator_state_world(false);
+  expect(test_start(source));
+
+  push_remote_spawn(REMOTE_NETWORK_ID);
+  push_remote_spawn(REMOTE_NETWORK_ID + 1);
+  expect(test_update());
+  expect(test_check("assert(remotes.length === 2, 'remote nodes were not spawned')"));
+
+  TestPacket packet;
+  int32_t translation_delta[] = { 2000, 0, 0 };
+  int32_t unknown_delta[] = { 1, 1, 1, 1, 1, 1, 1 };
+  int32_t full[] = { 1000, 2000, 3000, 0, 0, 0, 10000 };
+  packet_begin(&packet, SNAPSHOT_TYPE_DELTA, 3);
+  packet_write_entry(&packet, REMOTE_NETWORK_ID, ENTRY_TYPE_DELTA, 0x1, translation_delta, countof(translation_delta));
+  packet_write_entry(&packet, 900, ENTRY_TYPE_DELTA, 0x3, unknown_delta, countof(unknown_delta));
+  packet_write_entry(&packet, REMOTE_NETWORK_ID + 1, ENTRY_TYPE_FULL, 0x3, full, countof(full));
+  push_snapshot(&packet);
+
+  expect(test_update());
+  expect(test_check("assertElements(remotes[0].translation, [0, 0, 0], 0, 'skipped delta')"));
+  expect(test_check("assertElements(remotes[1].translation, [1, 2, 3], 0.001, 'full after skipped deltas')"));
+
+  // Once the entity has a baseline, deltas apply on top of it.
+  int32_t delta[] = { -500, 0, 250 };
+  packet_begin(&packet, SNAPSHOT_TYPE_DELTA, 2);
+  packet_write_entry(&packet, REMOTE_NETWORK_ID, ENTRY_TYPE_FULL, 0x3, full, countof(full));
+  packet_write_entry(&packet, REMOTE_NETWORK_ID + 1, ENTRY_TYPE_DELTA, 0x1, delta, countof(delta));
+  push_snapshot(&packet);
+
+  expect(test_update());
+  expect(test_check("assertElements(remotes[0].translation, [1, 2, 3], 0.001, 'full after delta')"));
+  expect(test_check("assertElements(remotes[1].translation, [0.5, 2, 3.25], 0.001, 'delta on baseline')"));
+
+  return 0;
+}
+
+#define MALFORMED_SNAPSHOT_ERROR "Received a malformed replicator state snapshot."
+
+static int test_replicator_state_rejects_truncated_snapshots(const char *source) {
+  setup_replicator_state_world(false);
+  expect(test_start(source));
+
+  push_remote_spawn(REMOTE_NETWORK_ID);
+  expect(test_update());
+
+  TestPacket packet;
+
+  // The network id's varint continues past the end of the snapshot.
+  packet_begin(&packet, SNAPSHOT_TYPE_DELTA, 1);
+  packet_write_u8(&packet, 0xF4);
+  packet_write_u8(&packet, 0x83);
+  push_snapshot(&packet);
+  expect(test_update_error(MALFORMED_SNAPSHOT_ERROR));
+
+  // The last value's varint is cut off.
+  int32_t translation[] = { 1000, 2000 };
+  packet_begin(&packet, SNAPSHOT_TYPE_DELTA, 1);
+  packet_write_entry(&packet, REMOTE_NETWORK_ID, ENTRY_TYPE_FULL, 0x1, translation, countof(translation));
+  packet_write_u8(&packet, 0x80);
+  push_snapshot(&packet);
+  expect(test_update_error(MALFORMED_SNAPSHOT_ERROR));
+
+  // The header claims more entries than the snapshot has.
+  int32_t full[] = { 1000, 2000, 3000, 0, 0, 0, 10000 };
+  packet_begin(&packet, SNAPSHOT_TYPE_DELTA, 2);
+  packet_write_entry(&packet, REMOTE_NETWORK_ID, ENTRY_TYPE_FULL, 0x3, full, countof(full));
+  push_snapshot(&packet);
+  expect(test_update_error(MALFORMED_SNAPSHOT_ERROR));
+
+  // The snapshot is shorter than its header.
+  packet.byte_length = 3;
+  push_snapshot(&packet);
+  expect(test_update_error(MALFORMED_SNAPSHOT_ERROR));
+
+  expect(test_check("assertElements(remotes[0].translation, [0, 0, 0], 0, 'translation after malformed snapshots')"));
+
+  // Later snapshots are still decoded.
+  packet_begin(&packet, SNAPSHOT_TYPE_DELTA, 1);
+  packet_write_entry(&packet, REMOTE_NETWORK_ID, ENTRY_TYPE_FULL, 0x3, full, countof(full));
+  push_snapshot(&packet);
+  expect(test_update());
+  expect(test_check("assertElements(remotes[0].translation, [1, 2, 3], 0.001, 'translation after recovery')"));
+
+  return 0;
+}
+
+static int test_replicator_state_rejects_unknown_fields(const char *source) {
+  setup_replicator_state_world(false);
+  expect(test_start(source));
+
+  push_remote_spawn(REMOTE_NETWORK_ID);
+  expect(test_update());
+
+  TestPacket packet;
+
+  // The schema has two fields, so only the two lowest mask bits are valid.
+  int32_t full[] = { 1000, 2000, 3000, 0, 0, 0, 10000, 1 };
+  packet_begin(&packet, SNAPSHOT_TYPE_DELTA, 1);
+  packet_write_entry(&packet, REMOTE_NETWORK_ID, ENTRY_TYPE_FULL, 0x7, full, countof(full));
+  push_snapshot(&packet);
+  expect(test_update_error(MALFORMED_SNAPSHOT_ERROR));
+
+  packet_begin(&packet, SNAPSHOT_TYPE_DELTA, 1);
+  packet_write_entry(&packet, REMOTE_NETWORK_ID, ENTRY_TYPE_DELTA, 0x80000000, NULL, 0);
+  push_snapshot(&packet);
+  expect(test_update_error(MALFORMED_SNAPSHOT_ERROR));
+
+  // Unknown entry and snapshot types are rejected too.
+  packet_begin(&packet, SNAPSHOT_TYPE_DELTA, 1);
+  packet_write_varint(&packet, REMOTE_NETWORK_ID);
+  packet_write_u8(&packet, ENTRY_TYPE_REMOVED + 1);
+  push_snapshot(&packet);
+  expect(test_update_error(MALFORMED_SNAPSHOT_ERROR));
+
+  packet_begin(&packet, SNAPSHOT_TYPE_KEYFRAME + 1, 0);
+  push_snapshot(&packet);
+  expect(test_update_error(MALFORMED_SNAPSHOT_ERROR));
+
+  expect(test_check("assertElements(remotes[0].translation, [0, 0, 0], 0, 'translation after unknown fields')"));
+
+  return 0;
+}
+
+/**
+ * Spatial Index
+ *
+ * Radius and nearest queries are compared against a brute force search over the indexed nodes after every kind of
+ * change to the index.
+ **/
+
+static const char spatial_index_source[] =
+  "const NODE_COUNT = 1500;\n"
+  "let seed = 1;\n"
+  "function random() {\n"
+  "  seed = (seed * 1103515245 + 12345) % 2147483648;\n"
+  "  return seed / 2147483648;\n"
+  "}\n"
+  "const scene = world.environment;\n"
+  "const index = world.createSpatialIndex({ type: INDEX_TYPE });\n"
+  "const nodes = [];\n"
+  "const nodeIndices = new Map();\n"
+  "const positions = [];\n"
+  "const radii = new Float32Array(NODE_COUNT);\n"
+  "const indexed = new Set();\n"
+  "for (let i = 0; i < NODE_COUNT; i++) {\n"
+  "  const node = world.createNode();\n"
+  "  scene.addNode(node);\n"
+  "  nodes.push(node);\n"
+  "  nodeIndices.set(node, i);\n"
+  "  radii[i] = i % 10 === 0 ? random() * 3 : 0;\n"
+  "}\n"
+  "function place(i, position) {\n"
+  "  positions[i] = position;\n"
+  "  nodes[i].translation.set(position);\n"
+  "}\n"
+  // Sorted along a line, the worst insertion order for an unbalanced tree.
+  "function line() {\n"
+  "  for (let i = 0; i < NODE_COUNT; i++) place(i, [i * 0.1, 0, 0]);\n"
+  "}\n"
+  // A dense cluster with a few far away outliers.
+  "function scatter(indices) {\n"
+  "  for (const i of indices) {\n"
+  "    const extent = i % 100 === 0 ? 1000 : 40;\n"
+  "    place(i, [random() * extent - extent / 2, random() * extent - extent / 2, random() * 40]);\n"
+  "  }\n"
+  "}\n"
+  "function addNodes(indices) {\n"
+  "  index.add(indices.map((i) => nodes[i]), Float32Array.from(indices, (i) => radii[i]));\n"
+  "  for (const i of indices) indexed.add(i);\n"
+  "}\n"
+  "function removeNodes(indices) {\n"
+  "  index.remove(indices.map((i) => nodes[i]));\n"
+  "  for (const i of indices) indexed.delete(i);\n"
+  "}\n"
+  "const all = nodes.map((_, i) => i);\n"
+  "const everyThird = all.filter((i) => i % 3 === 0);\n"
+  "function distance(a, b) {\n"
+  "  return Math.hypot(a[0] - b[0], a[1] - b[1], a[2] - b[2]);\n"
+  "}\n"
+  // Queries around the indexed nodes, and some far outside of them.
+  "function checkQueries(label) {\n"
+  "  assert(index.size === indexed.size, `${label}: size ${index.size}, expected ${indexed.size}`);\n"
+  "  const indices = Array.from(indexed);\n"
+  "  for (let q = 0; q < 300; q++) {\n"
+  "    const center = positions[indices[Math.floor(random() * indices.length)]];\n"
+  "    const p = q % 30 === 0\n"
+  "      ? [random() * 4000 - 2000, random() * 4000 - 2000, random() * 4000 - 2000]\n"
+  "      : center.map((v) => v + random() * 6 - 3);\n"
+  "    const r = random() * 6;\n"
+  "    const expected = new Set();\n"
+  "    const boundary = new Set();\n"
+  "    for (const i of indexed) {\n"
+  "      const gap = distance(positions[i], p) - r - radii[i];\n"
+  "      if (gap < -0.001) expected.add(i);\n"
+  "      else if (gap <= 0.001) boundary.add(i);\n"
+  "    }\n"
+  "    let found = 0;\n"
+  "    for (const node of index.queryRadius(p, r)) {\n"
+  "      const i = nodeIndices.get(node);\n"
+  "      assert(expected.has(i) || boundary.has(i), `${label}: radius query ${q} returned node ${i}`);\n"
+  "      if (expected.has(i)) found++;\n"
+  "    }\n"
+  "    assert(found === expected.size, `${label}: radius query ${q} found ${found} of ${expected.size}`);\n"
+  "    const k = 1 + (q % 16);\n"
+  "    const distances = Array.from(indexed, (i) => distance(positions[i], p)).sort((a, b) => a - b);\n"
+  "    const nearest = index.queryNearest(p, k);\n"
+  "    const count = Math.min(k, indexed.size);\n"
+  "    assert(nearest.length === count, `${label}: nearest query ${q} returned ${nearest.length} of ${count}`);\n"
+  "    for (let j = 0; j < nearest.length; j++) {\n"
+  "      const actual = distance(positions[nodeIndices.get(nearest[j])], p);\n"
+  "      const message = `${label}: nearest query ${q} result ${j} is ${actual} away, expected ${distances[j]}`;\n"
+  "      assert(Math.abs(actual - distances[j]) <= 0.001 * Math.max(1, distances[j]), message);\n"
+  "    }\n"
+  "  }\n"
+  "}\n";
+
+// layout is called before the nodes are first added.
+static int test_spatial_index(const char *source, const char *type, const char *layout) {
+  host_reset();
+  host_create_scene("Environment");
+
+  char script[8192];
+  snprintf(script, sizeof(script), "const INDEX_TYPE = '%s';\n%s%s;\n", type, source, layout);
+  expect(test_start(script));
+
+  // World matrices are only updated between frames.
+  expect(test_update());
+  expect(test_check("addNodes(all); checkQueries('add');"));
+
+  expect(test_check("scatter(all);"));
+  expect(test_update());
+  expect(test_check("index.update(); checkQueries('update all');"));
+
+  // Nodes that moved are passed to update, a few of them move across the whole cluster.
+  expect(test_check("var moved = all.filter((i) => i % 7 === 0); scatter(moved);"));
+  expect(test_update());
+  expect(test_check("index.update(moved.map((i) => nodes[i])); checkQueries('update some');"));
+
+  expect(test_check("removeNodes(everyThird); checkQueries('remove');"));
+
+  expect(test_check("scatter(everyThird);"));
+  expect(test_update());
+  expect(test_check("addNodes(everyThird); checkQueries('add again');"));
+
+  return 0;
+}
+
+// Queries in the cluster stop after a few shells of cells, queries far outside of it fall back to a scan.
+static int test_spatial_index_grid(const char *source) {
+  return test_spatial_index(source, "grid", "scatter(all)");
+}
+
+// Adding nodes in sorted order only keeps the tree balanced with rotations.
+static int test_spatial_index_tree(const char *source) {
+  return test_spatial_index(source, "tree", "line()");
+}
+
+/**
+ * Tests
+ **/
+
+static const Test tests[] = {
+  {
+    .name = "replicator-state-round-trip",
+    .source = replicator_state_source,
+    .run = test_replicator_state_round_trip,
+  },
+  {
+    .name = "replicator-state-skips-delta-without-baseline",
+    .source = replicator_state_source,
+    .run = test_replicator_state_skips_delta_without_baseline,
+  },
+  {
+    .name = "replicator-state-rejects-truncated-snapshots",
+    .source = replicator_state_source,
+    .run = test_replicator_state_rejects_truncated_snapshots,
+  },
+  {
+    .name = "replicator-state-rejects-unknown-fields",
+    .source = replicator_state_source,
+    .run = test_replicator_state_rejects_unknown_fields,
+  },
+  {
+    .name = "spatial-index-grid",
+    .source = spatial_index_source,
+    .run = test_spatial_index_grid,
+  },
+  {
+    .name = "spatial-index-tree",
+    .source = spatial_index_source,
+    .run = test_spatial_index_tree,
+  },
+};
+
+int main(int argc, char **argv) {
+  const char *filter = NULL;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "t:h")) != -1) {
+    switch (opt) {
+      case 't':
+        filter = optarg;
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-t test]\n", argv[0]);
+        return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  uint32_t passed = 0;
+  uint32_t failed = 0;
+
+  for (uint32_t i = 0; i < countof(tests); i++) {
+    const Test *test = &tests[i];
+
+    if (filter != NULL && strstr(test->name, filter) == NULL) {
+      continue;
+    }
+
+    fflush(stdout);
+    pid_t pid = fork();
+
+    if (pid == 0) {
+      exit(test->run(test->source) < 0 ? 1 : 0);
+    }
+
+    int status;
+    waitpid(pid, &status, 0);
+
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+      printf("ok    %s\n", test->name);
+      passed++;
+    } else {
+      printf("FAIL  %s\n", test->name);
+      failed++;
+    }
+  }
+
+  printf("%u passed, %u failed\n", passed, failed);
+
+  return failed > 0 ? 1 : 0;
+}
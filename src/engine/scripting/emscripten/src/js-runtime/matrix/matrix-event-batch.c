@@ -0,0 +1,269 @@
+#include <string.h>
+#include "../quickjs/cutils.h"
+#include "../quickjs/quickjs.h"
+#include "../../matrix.h"
+#include "./matrix-event-batch.h"
+
+JSClassID js_matrix_event_batch_class_id;
+
+/**
+ * Class Definition
+ **/
+
+static void js_matrix_event_batch_finalizer(JSRuntime *rt, JSValue val) {
+  MatrixEventBatchData *batch_data = JS_GetOpaque(val, js_matrix_event_batch_class_id);
+
+  if (batch_data) {
+    JS_FreeValueRT(rt, batch_data->arena);
+    js_free_rt(rt, batch_data);
+  }
+}
+
+static void js_matrix_event_batch_gc_mark(JSRuntime *rt, JSValueConst val, JS_MarkFunc *mark_func) {
+  MatrixEventBatchData *batch_data = JS_GetOpaque(val, js_matrix_event_batch_class_id);
+
+  if (batch_data) {
+    JS_MarkValue(rt, batch_data->arena, mark_func);
+  }
+}
+
+static JSClassDef js_matrix_event_batch_class = {
+  "MatrixEventBatch",
+  .finalizer = js_matrix_event_batch_finalizer,
+  .gc_mark = js_matrix_event_batch_gc_mark
+};
+
+static MatrixEventHeader *js_matrix_event_batch_get_header(
+  JSContext *ctx,
+  JSValueConst this_val,
+  JSValueConst index_arg,
+  MatrixEventBatchData **out_batch_data
+) {
+  MatrixEventBatchData *batch_data = JS_GetOpaque2(ctx, this_val, js_matrix_event_batch_class_id);
+
+  if (batch_data == NULL) {
+    return NULL;
+  }
+
+  uint32_t index;
+
+  if (JS_ToUint32(ctx, &index, index_arg) == -1) {
+    return NULL;
+  }
+
+  if (index >= batch_data->count) {
+    JS_ThrowRangeError(ctx, "Matrix: event index out of range.");
+    return NULL;
+  }
+
+  *out_batch_data = batch_data;
+
+  return (MatrixEventHeader *)batch_data->arena_data + index;
+}
+
+// The headers are in the arena, which the script can write to, so every range is checked before it is read.
+static const char *js_matrix_event_batch_get_range(
+  JSContext *ctx,
+  MatrixEventBatchData *batch_data,
+  uint32_t offset,
+  uint32_t length
+) {
+  if (offset > batch_data->arena_byte_length || length > batch_data->arena_byte_length - offset) {
+    JS_ThrowRangeError(ctx, "Matrix: event data is outside of the arena.");
+    return NULL;
+  }
+
+  return (const char *)batch_data->arena_data + offset;
+}
+
+typedef enum MatrixEventBatchString {
+  MatrixEventBatchString_Action,
+  MatrixEventBatchString_Type,
+  MatrixEventBatchString_Sender,
+} MatrixEventBatchString;
+
+static JSValue js_matrix_event_batch_get_string(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv,
+  int magic
+) {
+  MatrixEventBatchData *batch_data;
+  MatrixEventHeader *header = js_matrix_event_batch_get_header(ctx, this_val, argv[0], &batch_data);
+
+  if (header == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  uint32_t offset;
+  uint32_t length;
+
+  if (magic == MatrixEventBatchString_Action) {
+    offset = header->action_offset;
+    length = header->action_length;
+  } else if (magic == MatrixEventBatchString_Type) {
+    offset = header->type_offset;
+    length = header->type_length;
+  } else {
+    offset = header->sender_offset;
+    length = header->sender_length;
+  }
+
+  if (length == 0) {
+    return JS_UNDEFINED;
+  }
+
+  const char *data = js_matrix_event_batch_get_range(ctx, batch_data, offset, length);
+
+  if (data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_NewStringLen(ctx, data, length);
+}
+
+// Only the events the script asks for are parsed.
+static JSValue js_matrix_event_batch_get_event(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  MatrixEventBatchData *batch_data;
+  MatrixEventHeader *header = js_matrix_event_batch_get_header(ctx, this_val, argv[0], &batch_data);
+
+  if (header == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  const char *data = js_matrix_event_batch_get_range(ctx, batch_data, header->byte_offset, header->byte_length);
+
+  if (data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  // JS_ParseJSON reads up to a null terminator, which the packed events in the arena don't have.
+  char *json = js_malloc(ctx, header->byte_length + 1);
+
+  if (json == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  memcpy(json, data, header->byte_length);
+  json[header->byte_length] = '\0';
+
+  JSValue event = JS_ParseJSON(ctx, json, header->byte_length, "<matrix-event>");
+  js_free(ctx, json);
+
+  return event;
+}
+
+static JSValue js_matrix_event_batch_get_arena(JSContext *ctx, JSValueConst this_val) {
+  MatrixEventBatchData *batch_data = JS_GetOpaque2(ctx, this_val, js_matrix_event_batch_class_id);
+
+  if (batch_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_DupValue(ctx, batch_data->arena);
+}
+
+static JSValue js_matrix_event_batch_get_count(JSContext *ctx, JSValueConst this_val) {
+  MatrixEventBatchData *batch_data = JS_GetOpaque2(ctx, this_val, js_matrix_event_batch_class_id);
+
+  if (batch_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_NewUint32(ctx, batch_data->count);
+}
+
+static const JSCFunctionListEntry js_matrix_event_batch_proto_funcs[] = {
+  JS_CGETSET_DEF("arena", js_matrix_event_batch_get_arena, NULL),
+  JS_CGETSET_DEF("count", js_matrix_event_batch_get_count, NULL),
+  JS_CFUNC_MAGIC_DEF("getAction", 1, js_matrix_event_batch_get_string, MatrixEventBatchString_Action),
+  JS_CFUNC_MAGIC_DEF("getType", 1, js_matrix_event_batch_get_string, MatrixEventBatchString_Type),
+  JS_CFUNC_MAGIC_DEF("getSender", 1, js_matrix_event_batch_get_string, MatrixEventBatchString_Sender),
+  JS_CFUNC_DEF("getEvent", 1, js_matrix_event_batch_get_event),
+  JS_PROP_STRING_DEF("[Symbol.toStringTag]", "MatrixEventBatch", JS_PROP_CONFIGURABLE),
+};
+
+static JSValue js_matrix_event_batch_constructor(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  return JS_ThrowTypeError(ctx, "Illegal Constructor.");
+}
+
+void js_define_matrix_event_batch(JSContext *ctx, JSValue matrix) {
+  JS_NewClassID(&js_matrix_event_batch_class_id);
+  JS_NewClass(JS_GetRuntime(ctx), js_matrix_event_batch_class_id, &js_matrix_event_batch_class);
+  JSValue matrix_event_batch_proto = JS_NewObject(ctx);
+  JS_SetPropertyFunctionList(
+    ctx,
+    matrix_event_batch_proto,
+    js_matrix_event_batch_proto_funcs,
+    countof(js_matrix_event_batch_proto_funcs)
+  );
+  JS_SetClassProto(ctx, js_matrix_event_batch_class_id, matrix_event_batch_proto);
+
+  JSValue constructor = JS_NewCFunction2(
+    ctx,
+    js_matrix_event_batch_constructor,
+    "MatrixEventBatch",
+    0,
+    JS_CFUNC_constructor,
+    0
+  );
+  JS_SetConstructor(ctx, constructor, matrix_event_batch_proto);
+  JS_SetPropertyStr(
+    ctx,
+    matrix,
+    "MatrixEventBatch",
+    constructor
+  );
+}
+
+/**
+ * Public Methods
+ **/
+
+JSValue js_matrix_receive_event_batch(JSContext *ctx, JSValueConst arena) {
+  size_t arena_byte_length;
+  uint8_t *arena_data = JS_GetArrayBuffer(ctx, &arena_byte_length, arena);
+
+  if (arena_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  int32_t count = matrix_receive_batch(arena_data, arena_byte_length);
+
+  if (count == -1) {
+    JS_ThrowRangeError(ctx, "Matrix: error receiving events, the arena may be too small.");
+    return JS_EXCEPTION;
+  }
+
+  if ((size_t)count * sizeof(MatrixEventHeader) > arena_byte_length) {
+    JS_ThrowRangeError(ctx, "Matrix: event headers are outside of the arena.");
+    return JS_EXCEPTION;
+  }
+
+  JSValue batch = JS_NewObjectClass(ctx, js_matrix_event_batch_class_id);
+
+  if (JS_IsException(batch)) {
+    return batch;
+  }
+
+  MatrixEventBatchData *batch_data = js_mallocz(ctx, sizeof(MatrixEventBatchData));
+
+  if (batch_data == NULL) {
+    JS_FreeValue(ctx, batch);
+    return JS_EXCEPTION;
+  }
+
+  batch_data->arena = JS_DupValue(ctx, arena);
+  batch_data->arena_data = arena_data;
+  batch_data->arena_byte_length = arena_byte_length;
+  batch_data->count = count;
+  JS_SetOpaque(batch, batch_data);
+
+  return batch;
+}
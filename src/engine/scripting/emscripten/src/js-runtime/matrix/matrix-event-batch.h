@@ -0,0 +1,22 @@
+#ifndef __matrix_event_batch_js_h
+#define __matrix_event_batch_js_h
+#include "../quickjs/quickjs.h"
+#include "../../matrix.h"
+
+typedef struct MatrixEventBatchData {
+  // Held by the batch so arena_data stays valid for as long as the batch is alive.
+  JSValue arena;
+  uint8_t *arena_data;
+  size_t arena_byte_length;
+  uint32_t count;
+} MatrixEventBatchData;
+
+extern JSClassID js_matrix_event_batch_class_id;
+
+void js_define_matrix_event_batch(JSContext *ctx, JSValue matrix);
+
+// Drains the queued events into the arena. The batch reads from the arena, so it is only valid until the arena
+// is passed to receiveBatch again.
+JSValue js_matrix_receive_event_batch(JSContext *ctx, JSValueConst arena);
+
+#endif
@@ -3,6 +3,7 @@
 #include "../quickjs/quickjs.h"
 #include "../../matrix.h"
 #include "./matrix-js.h"
+#include "./matrix-event-batch.h"
 
 static JSValue js_matrix_listen(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
   if (matrix_listen() == 0) {
@@ -25,7 +26,10 @@ static JSValue js_matrix_close(JSContext *ctx, JSValueConst this_val, int argc,
 }
 
 static JSValue js_matrix_send(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
-  JSValue eventStr = JS_JSONStringify(ctx, argv[0], JS_UNDEFINED, JS_UNDEFINED);
+  // Events that are already JSON strings are sent as is, ASCII strings are read without a copy.
+  JSValue eventStr = JS_IsString(argv[0])
+    ? JS_DupValue(ctx, argv[0])
+    : JS_JSONStringify(ctx, argv[0], JS_UNDEFINED, JS_UNDEFINED);
 
   if (JS_IsException(eventStr)) {
     return JS_EXCEPTION;
@@ -77,6 +81,10 @@ static JSValue js_matrix_receive(JSContext *ctx, JSValueConst this_val, int argc
   return value;
 }
 
+static JSValue js_matrix_receive_batch(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  return js_matrix_receive_event_batch(ctx, argv[0]);
+}
+
 void js_define_matrix_api(JSContext *ctx) {
   JSValue global = JS_GetGlobalObject(ctx);
 
@@ -84,6 +92,8 @@ void js_define_matrix_api(JSContext *ctx) {
   JS_SetPropertyStr(ctx, matrix, "listen", JS_NewCFunction(ctx, js_matrix_listen, "listen", 0));
   JS_SetPropertyStr(ctx, matrix, "close", JS_NewCFunction(ctx, js_matrix_close, "close", 0));
   JS_SetPropertyStr(ctx, matrix, "receive", JS_NewCFunction(ctx, js_matrix_receive, "receive", 0));
+  JS_SetPropertyStr(ctx, matrix, "receiveBatch", JS_NewCFunction(ctx, js_matrix_receive_batch, "receiveBatch", 1));
   JS_SetPropertyStr(ctx, matrix, "send", JS_NewCFunction(ctx, js_matrix_send, "send", 1));
+  js_define_matrix_event_batch(ctx, matrix);
   JS_SetPropertyStr(ctx, global, "matrix", matrix);
 }
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include <string.h>
+#include "../quickjs/cutils.h"
+#include "../quickjs/quickjs.h"
+#include "./bytecode.h"
+
+#define JS_BYTECODE_MAGIC "QJBC"
+#define JS_BYTECODE_MAGIC_LENGTH 4
+
+// Header: magic, version length (1 byte), version string (not null terminated)
+static size_t js_bytecode_header_size() {
+  return JS_BYTECODE_MAGIC_LENGTH + 1 + strlen(CONFIG_VERSION);
+}
+
+JSValue js_compile_script(JSContext *ctx, const char *source, size_t source_length, const char *filename) {
+  return JS_Eval(ctx, source, source_length, filename, JS_EVAL_TYPE_GLOBAL | JS_EVAL_FLAG_COMPILE_ONLY);
+}
+
+uint8_t *js_write_bytecode(JSContext *ctx, JSValueConst function, size_t *size) {
+  size_t bytecode_size;
+  uint8_t *bytecode = JS_WriteObject(ctx, &bytecode_size, function, JS_WRITE_OBJ_BYTECODE);
+
+  if (bytecode == NULL) {
+    return NULL;
+  }
+
+  size_t version_length = strlen(CONFIG_VERSION);
+  size_t header_size = js_bytecode_header_size();
+  uint8_t *buf = js_malloc(ctx, header_size + bytecode_size);
+
+  if (buf == NULL) {
+    js_free(ctx, bytecode);
+    return NULL;
+  }
+
+  memcpy(buf, JS_BYTECODE_MAGIC, JS_BYTECODE_MAGIC_LENGTH);
+  buf[JS_BYTECODE_MAGIC_LENGTH] = (uint8_t)version_length;
+  memcpy(buf + JS_BYTECODE_MAGIC_LENGTH + 1, CONFIG_VERSION, version_length);
+  memcpy(buf + header_size, bytecode, bytecode_size);
+
+  js_free(ctx, bytecode);
+
+  *size = header_size + bytecode_size;
+
+  return buf;
+}
+
+JSValue js_read_bytecode(JSContext *ctx, const uint8_t *buf, size_t size) {
+  size_t version_length = strlen(CONFIG_VERSION);
+  size_t header_size = js_bytecode_header_size();
+
+  if (size <= header_size || memcmp(buf, JS_BYTECODE_MAGIC, JS_BYTECODE_MAGIC_LENGTH) != 0) {
+    return JS_ThrowTypeError(ctx, "Invalid bytecode.");
+  }
+
+  if (
+    buf[JS_BYTECODE_MAGIC_LENGTH] != version_length ||
+    memcmp(buf + JS_BYTECODE_MAGIC_LENGTH + 1, CONFIG_VERSION, version_length) != 0
+  ) {
+    return JS_ThrowTypeError(ctx, "Bytecode was compiled with a different QuickJS version.");
+  }
+
+  return JS_ReadObject(ctx, buf + header_size, size - header_size, JS_READ_OBJ_BYTECODE);
+}
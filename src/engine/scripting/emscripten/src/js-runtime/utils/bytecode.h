@@ -0,0 +1,22 @@
+#ifndef __js_utils_bytecode_h
+#define __js_utils_bytecode_h
+#include <stdint.h>
+#include <stddef.h>
+#include "../quickjs/quickjs.h"
+
+/**
+ * Compiled scripts are stored as QuickJS bytecode (JS_WriteObject) prefixed with a header containing the
+ * QuickJS CONFIG_VERSION they were compiled with. Bytecode is only valid for the exact QuickJS build that wrote
+ * it, so js_read_bytecode rejects anything with a different version instead of letting JS_ReadObject misread it.
+ **/
+
+// Compiles a global script without running it. Returns the function object to pass to JS_EvalFunction.
+JSValue js_compile_script(JSContext *ctx, const char *source, size_t source_length, const char *filename);
+
+// Returns a js_malloc'd buffer containing the header and bytecode for a compiled script, or NULL on error.
+uint8_t *js_write_bytecode(JSContext *ctx, JSValueConst function, size_t *size);
+
+// Returns the function object for the bytecode, or throws if it is invalid or was written by another version.
+JSValue js_read_bytecode(JSContext *ctx, const uint8_t *buf, size_t size);
+
+#endif
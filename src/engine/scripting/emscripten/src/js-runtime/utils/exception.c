@@ -15,6 +15,22 @@ int js_handle_exception(JSContext *ctx, JSValue result) {
 
   JSValue error = JS_GetException(ctx);
 
+  // QuickJS leaves a null exception when it can't allocate the Error at the memory limit
+  if (JS_IsNull(error)) {
+    emscripten_console_errorf("Uncaught null, the script may have exceeded its memory limit.");
+    JS_FreeValue(ctx, result);
+    return -1;
+  }
+
+  if (!JS_IsObject(error)) {
+    const char* error_str = JS_ToCString(ctx, error);
+    emscripten_console_errorf("Uncaught %s", error_str ? error_str : "exception");
+    JS_FreeCString(ctx, error_str);
+    JS_FreeValue(ctx, error);
+    JS_FreeValue(ctx, result);
+    return -1;
+  }
+
   JSValue name_val = JS_GetPropertyStr(ctx, error, "name");
   const char* name = JS_ToCString(ctx, name_val);
 
@@ -0,0 +1,85 @@
+#include <string.h>
+
+#include "../quickjs/quickjs.h"
+#include "./handle-table.h"
+
+int js_handle_table_set(JSContext *ctx, JSHandleTable *table, uint32_t id, JSValue value) {
+  uint32_t page_index = id >> JS_HANDLE_TABLE_PAGE_BITS;
+
+  if (page_index >= table->page_count) {
+    uint32_t page_count = table->page_count == 0 ? 16 : table->page_count;
+
+    while (page_count <= page_index) {
+      page_count *= 2;
+    }
+
+    JSValue **pages = js_realloc(ctx, table->pages, sizeof(JSValue *) * page_count);
+
+    if (pages == NULL) {
+      JS_FreeValue(ctx, value);
+      return -1;
+    }
+
+    memset(pages + table->page_count, 0, sizeof(JSValue *) * (page_count - table->page_count));
+    table->pages = pages;
+    table->page_count = page_count;
+  }
+
+  JSValue *page = table->pages[page_index];
+
+  if (page == NULL) {
+    page = js_malloc(ctx, sizeof(JSValue) * JS_HANDLE_TABLE_PAGE_SIZE);
+
+    if (page == NULL) {
+      JS_FreeValue(ctx, value);
+      return -1;
+    }
+
+    // Zeroed memory is the integer 0, not undefined, so empty slots are filled explicitly.
+    for (int i = 0; i < JS_HANDLE_TABLE_PAGE_SIZE; i++) {
+      page[i] = JS_UNDEFINED;
+    }
+
+    table->pages[page_index] = page;
+  }
+
+  uint32_t slot = id & JS_HANDLE_TABLE_PAGE_MASK;
+  JS_FreeValue(ctx, page[slot]);
+  page[slot] = value;
+
+  return 0;
+}
+
+JSValue js_handle_table_remove(JSHandleTable *table, uint32_t id) {
+  uint32_t page_index = id >> JS_HANDLE_TABLE_PAGE_BITS;
+
+  if (page_index >= table->page_count || table->pages[page_index] == NULL) {
+    return JS_UNDEFINED;
+  }
+
+  uint32_t slot = id & JS_HANDLE_TABLE_PAGE_MASK;
+  JSValue value = table->pages[page_index][slot];
+  table->pages[page_index][slot] = JS_UNDEFINED;
+
+  return value;
+}
+
+void js_handle_table_free(JSRuntime *rt, JSHandleTable *table) {
+  for (uint32_t i = 0; i < table->page_count; i++) {
+    JSValue *page = table->pages[i];
+
+    if (page == NULL) {
+      continue;
+    }
+
+    for (int j = 0; j < JS_HANDLE_TABLE_PAGE_SIZE; j++) {
+      JS_FreeValueRT(rt, page[j]);
+    }
+
+    js_free_rt(rt, page);
+  }
+
+  js_free_rt(rt, table->pages);
+  table->pages = NULL;
+  table->page_count = 0;
+}
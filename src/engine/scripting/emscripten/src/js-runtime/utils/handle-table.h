@@ -0,0 +1,42 @@
+#ifndef __js_utils_handle_table_h
+#define __js_utils_handle_table_h
+#include <stdint.h>
+#include "../quickjs/quickjs.h"
+
+/**
+ * Handle Table
+ *
+ * Maps resource ids to their cached JS objects. Ids are dense integers handed out by the host, so values are
+ * stored in fixed size pages that are allocated on first use. Lookups are two array loads with no atoms or
+ * shape changes involved.
+ **/
+
+#define JS_HANDLE_TABLE_PAGE_BITS 8
+#define JS_HANDLE_TABLE_PAGE_SIZE (1 << JS_HANDLE_TABLE_PAGE_BITS)
+#define JS_HANDLE_TABLE_PAGE_MASK (JS_HANDLE_TABLE_PAGE_SIZE - 1)
+
+typedef struct JSHandleTable {
+  JSValue **pages;
+  uint32_t page_count;
+} JSHandleTable;
+
+// Returns a borrowed reference to the value stored for id or JS_UNDEFINED.
+static inline JSValueConst js_handle_table_get(JSHandleTable *table, uint32_t id) {
+  uint32_t page_index = id >> JS_HANDLE_TABLE_PAGE_BITS;
+
+  if (page_index >= table->page_count || table->pages[page_index] == NULL) {
+    return JS_UNDEFINED;
+  }
+
+  return table->pages[page_index][id & JS_HANDLE_TABLE_PAGE_MASK];
+}
+
+// Stores value for id, taking ownership of it and freeing any previous value. Returns -1 on allocation failure.
+int js_handle_table_set(JSContext *ctx, JSHandleTable *table, uint32_t id, JSValue value);
+
+// Removes the value stored for id and returns it. The caller owns the returned value.
+JSValue js_handle_table_remove(JSHandleTable *table, uint32_t id);
+
+void js_handle_table_free(JSRuntime *rt, JSHandleTable *table);
+
+#endif
@@ -0,0 +1,56 @@
+#include "../quickjs/quickjs.h"
+#include "./exception.h"
+#include "./hooks.h"
+
+void js_init_hooks(JSContext *ctx) {
+  JSRuntime *rt = JS_GetRuntime(ctx);
+  JSHooks *hooks = js_mallocz_rt(rt, sizeof(JSHooks));
+
+  for (int i = 0; i < JSHook_Count; i++) {
+    hooks->callbacks[i] = JS_NULL;
+  }
+
+  JS_SetRuntimeOpaque(rt, hooks);
+}
+
+JSValue js_get_hook(JSContext *ctx, JSHook hook) {
+  JSHooks *hooks = JS_GetRuntimeOpaque(JS_GetRuntime(ctx));
+  return JS_DupValue(ctx, hooks->callbacks[hook]);
+}
+
+JSValue js_set_hook(JSContext *ctx, JSHook hook, JSValueConst callback) {
+  if (!JS_IsFunction(ctx, callback) && !JS_IsNull(callback) && !JS_IsUndefined(callback)) {
+    return JS_ThrowTypeError(ctx, "Expected a function or null.");
+  }
+
+  JSHooks *hooks = JS_GetRuntimeOpaque(JS_GetRuntime(ctx));
+  JS_FreeValue(ctx, hooks->callbacks[hook]);
+  hooks->callbacks[hook] = JS_IsUndefined(callback) ? JS_NULL : JS_DupValue(ctx, callback);
+
+  return JS_UNDEFINED;
+}
+
+/**
+ * Calls the hook's callback if one is set.
+ * Returns 0 on success or when no callback is set, -1 if the callback threw.
+ **/
+int js_call_hook(JSContext *ctx, JSHook hook, int argc, JSValueConst *argv) {
+  JSHooks *hooks = JS_GetRuntimeOpaque(JS_GetRuntime(ctx));
+
+  if (JS_IsNull(hooks->callbacks[hook])) {
+    return 0;
+  }
+
+  // Hold a reference in case the callback reassigns its own hook while it runs.
+  JSValue callback = JS_DupValue(ctx, hooks->callbacks[hook]);
+  JSValue val = JS_Call(ctx, callback, JS_UNDEFINED, argc, argv);
+  JS_FreeValue(ctx, callback);
+
+  if (js_handle_exception(ctx, val) < 0) {
+    return -1;
+  }
+
+  JS_FreeValue(ctx, val);
+
+  return 0;
+}
@@ -0,0 +1,28 @@
+#ifndef __js_utils_hooks_h
+#define __js_utils_hooks_h
+#include "../quickjs/quickjs.h"
+
+typedef enum JSHook {
+  JSHook_WorldLoad,
+  JSHook_WorldEnter,
+  JSHook_WorldUpdate,
+  JSHook_NetworkPeerEntered,
+  JSHook_NetworkPeerExited,
+  JSHook_Count,
+} JSHook;
+
+// Per-runtime dispatch table for the lifecycle callbacks the host calls into every frame (world.onupdate etc.)
+// The callbacks are stored when the script assigns them so dispatching doesn't do any property lookups.
+typedef struct JSHooks {
+  JSValue callbacks[JSHook_Count];
+} JSHooks;
+
+void js_init_hooks(JSContext *ctx);
+
+JSValue js_get_hook(JSContext *ctx, JSHook hook);
+
+JSValue js_set_hook(JSContext *ctx, JSHook hook, JSValueConst callback);
+
+int js_call_hook(JSContext *ctx, JSHook hook, int argc, JSValueConst *argv);
+
+#endif
@@ -15,13 +15,126 @@ void *get_typed_array_data(JSContext *ctx, JSValue *value, size_t byte_length) {
   }
 
   if (view_byte_length != byte_length) {
+    JS_FreeValue(ctx, buffer);
     JS_ThrowRangeError(ctx, "WebSG: Invalid typed array length.");
     return NULL;
   }
 
   size_t buffer_byte_length;
   uint8_t *data = JS_GetArrayBuffer(ctx, &buffer_byte_length, buffer);
+  // The typed array keeps its buffer alive, so the reference returned above isn't needed.
+  JS_FreeValue(ctx, buffer);
+
+  if (data == NULL) {
+    return NULL;
+  }
+
   data += view_byte_offset;
 
   return (void *)data;
-}
\ No newline at end of file
+}
+
+void *get_typed_array_elements(JSContext *ctx, JSValue *value, size_t bytes_per_element, uint32_t *length) {
+  size_t view_byte_offset;
+  size_t view_byte_length;
+  size_t view_bytes_per_element;
+
+  JSValue buffer = JS_GetTypedArrayBuffer(ctx, *value, &view_byte_offset, &view_byte_length, &view_bytes_per_element);
+
+  if (JS_IsException(buffer)) {
+    return NULL;
+  }
+
+  if (view_bytes_per_element != bytes_per_element) {
+    JS_FreeValue(ctx, buffer);
+    JS_ThrowTypeError(ctx, "WebSG: Invalid typed array type.");
+    return NULL;
+  }
+
+  size_t buffer_byte_length;
+  uint8_t *data = JS_GetArrayBuffer(ctx, &buffer_byte_length, buffer);
+  JS_FreeValue(ctx, buffer);
+
+  if (data == NULL) {
+    return NULL;
+  }
+
+  *length = view_byte_length / bytes_per_element;
+
+  return (void *)(data + view_byte_offset);
+}
+
+static const char *js_typed_array_constructor_names[JSTypedArrayType_Count] = {
+  "Uint8Array",
+  "Int32Array",
+  "Uint32Array",
+  "Float32Array",
+};
+
+void js_init_typed_arrays(JSContext *ctx) {
+  JSTypedArrays *typed_arrays = js_mallocz(ctx, sizeof(JSTypedArrays));
+
+  if (typed_arrays == NULL) {
+    return;
+  }
+
+  JSValue global = JS_GetGlobalObject(ctx);
+
+  for (int i = 0; i < JSTypedArrayType_Count; i++) {
+    JSValue constructor = JS_GetPropertyStr(ctx, global, js_typed_array_constructor_names[i]);
+    JSValue typed_array = JS_CallConstructor(ctx, constructor, 0, NULL);
+
+    typed_arrays->constructors[i] = constructor;
+    typed_arrays->class_ids[i] = JS_IsObject(typed_array) ? JS_GetClassID(typed_array) : 0;
+
+    JS_FreeValue(ctx, typed_array);
+  }
+
+  JS_FreeValue(ctx, global);
+
+  JS_SetContextOpaque(ctx, typed_arrays);
+}
+
+static JSValue js_call_typed_array_constructor(JSContext *ctx, JSTypedArrayType type, int argc, JSValueConst *argv) {
+  JSTypedArrays *typed_arrays = JS_GetContextOpaque(ctx);
+
+  if (typed_arrays == NULL) {
+    return JS_ThrowInternalError(ctx, "Typed arrays are not initialized.");
+  }
+
+  return JS_CallConstructor(ctx, typed_arrays->constructors[type], argc, argv);
+}
+
+JSValue js_new_typed_array_view(JSContext *ctx, JSTypedArrayType type, void *data, size_t byte_length) {
+  JSValue buffer = JS_NewArrayBuffer(ctx, (uint8_t *)data, byte_length, NULL, NULL, 0);
+
+  if (JS_IsException(buffer)) {
+    return buffer;
+  }
+
+  JSValue typed_array = js_call_typed_array_constructor(ctx, type, 1, &buffer);
+  JS_FreeValue(ctx, buffer);
+
+  return typed_array;
+}
+
+JSValue js_new_typed_array_subview(
+  JSContext *ctx,
+  JSTypedArrayType type,
+  JSValue buffer,
+  uint32_t byte_offset,
+  uint32_t length
+) {
+  JSValue args[3] = { buffer, JS_NewUint32(ctx, byte_offset), JS_NewUint32(ctx, length) };
+  return js_call_typed_array_constructor(ctx, type, 3, args);
+}
+
+int js_is_typed_array_type(JSContext *ctx, JSValueConst value, JSTypedArrayType type) {
+  JSTypedArrays *typed_arrays = JS_GetContextOpaque(ctx);
+
+  if (typed_arrays == NULL || !JS_IsObject(value)) {
+    return 0;
+  }
+
+  return JS_GetClassID(value) == typed_arrays->class_ids[type];
+}
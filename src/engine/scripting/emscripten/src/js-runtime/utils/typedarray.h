@@ -4,4 +4,42 @@
 
 void *get_typed_array_data(JSContext *ctx, JSValue *value, size_t byte_length);
 
+// Like get_typed_array_data for typed arrays of any length, which is written to length. Throws if the typed array's
+// elements aren't bytes_per_element long.
+void *get_typed_array_elements(JSContext *ctx, JSValue *value, size_t bytes_per_element, uint32_t *length);
+
+typedef enum JSTypedArrayType {
+  JSTypedArrayType_Uint8,
+  JSTypedArrayType_Int32,
+  JSTypedArrayType_Uint32,
+  JSTypedArrayType_Float32,
+  JSTypedArrayType_Count,
+} JSTypedArrayType;
+
+// Per-context typed array constructors and class ids, captured before any script runs so that scripts replacing
+// or deleting the globals can't change what the runtime creates, and creating a view doesn't look up a global.
+typedef struct JSTypedArrays {
+  JSValue constructors[JSTypedArrayType_Count];
+  int class_ids[JSTypedArrayType_Count];
+} JSTypedArrays;
+
+// Must be called after the context is created and before any script is evaluated.
+void js_init_typed_arrays(JSContext *ctx);
+
+// Creates a typed array that aliases data instead of copying it.
+// The memory is not owned by the typed array and must outlive it.
+JSValue js_new_typed_array_view(JSContext *ctx, JSTypedArrayType type, void *data, size_t byte_length);
+
+// Creates a typed array with length elements of an existing ArrayBuffer, starting at byte_offset.
+JSValue js_new_typed_array_subview(
+  JSContext *ctx,
+  JSTypedArrayType type,
+  JSValue buffer,
+  uint32_t byte_offset,
+  uint32_t length
+);
+
+// Returns 1 if value is a typed array of the type, e.g. a Uint32Array and not any 4 byte typed array.
+int js_is_typed_array_type(JSContext *ctx, JSValueConst value, JSTypedArrayType type);
+
 #endif
@@ -0,0 +1,333 @@
+#include <string.h>
+#include "../quickjs/cutils.h"
+#include "../quickjs/quickjs.h"
+#include "../../websg-networking.h"
+#include "./channel.h"
+
+JSClassID js_websg_network_channel_class_id;
+
+typedef enum WebSGNetworkChannelProp {
+  WebSGNetworkChannelProp_Priority,
+  WebSGNetworkChannelProp_Budget,
+  WebSGNetworkChannelProp_MaxBacklog,
+  WebSGNetworkChannelProp_MaxQueuedByteLength,
+  WebSGNetworkChannelProp_QueuedByteLength,
+  WebSGNetworkChannelProp_SentByteLength,
+  WebSGNetworkChannelProp_DeferredCount,
+  WebSGNetworkChannelProp_DroppedCount,
+} WebSGNetworkChannelProp;
+
+/**
+ * Class Definition
+ **/
+
+static void js_websg_network_channel_finalizer(JSRuntime *rt, JSValue val) {
+  WebSGNetworkChannelData *channel_data = JS_GetOpaque(val, js_websg_network_channel_class_id);
+
+  if (channel_data) {
+    js_free_rt(rt, channel_data);
+  }
+}
+
+static JSClassDef js_websg_network_channel_class = {
+  "NetworkChannel",
+  .finalizer = js_websg_network_channel_finalizer
+};
+
+static WebSGNetworkChannel *js_websg_network_channel_get(JSContext *ctx, JSValueConst this_val) {
+  WebSGNetworkChannelData *channel_data = JS_GetOpaque2(ctx, this_val, js_websg_network_channel_class_id);
+
+  if (channel_data == NULL) {
+    return NULL;
+  }
+
+  return &channel_data->network_data->channels[channel_data->channel_index];
+}
+
+static JSValue js_websg_network_channel_get_reliable(JSContext *ctx, JSValueConst this_val) {
+  WebSGNetworkChannel *channel = js_websg_network_channel_get(ctx, this_val);
+
+  if (channel == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_NewBool(ctx, channel->reliable);
+}
+
+static JSValue js_websg_network_channel_get_prop(JSContext *ctx, JSValueConst this_val, int prop) {
+  WebSGNetworkChannel *channel = js_websg_network_channel_get(ctx, this_val);
+
+  if (channel == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  switch (prop) {
+    case WebSGNetworkChannelProp_Priority:
+      return JS_NewInt32(ctx, channel->priority);
+    case WebSGNetworkChannelProp_Budget:
+      return JS_NewUint32(ctx, channel->budget);
+    case WebSGNetworkChannelProp_MaxBacklog:
+      return JS_NewUint32(ctx, channel->max_backlog);
+    case WebSGNetworkChannelProp_MaxQueuedByteLength:
+      return JS_NewUint32(ctx, channel->max_queued_byte_length);
+    case WebSGNetworkChannelProp_QueuedByteLength:
+      return JS_NewUint32(ctx, channel->queued_byte_length);
+    case WebSGNetworkChannelProp_SentByteLength:
+      return JS_NewUint32(ctx, channel->sent_byte_length);
+    case WebSGNetworkChannelProp_DeferredCount:
+      return JS_NewUint32(ctx, channel->deferred_count);
+    case WebSGNetworkChannelProp_DroppedCount:
+      return JS_NewUint32(ctx, channel->dropped_count);
+    default:
+      return JS_UNDEFINED;
+  }
+}
+
+// Budgets and backlog limits can be changed at any time, so scripts can adapt their send rate to the peers' stats.
+static JSValue js_websg_network_channel_set_limit(JSContext *ctx, JSValueConst this_val, JSValueConst arg, int prop) {
+  WebSGNetworkChannel *channel = js_websg_network_channel_get(ctx, this_val);
+
+  if (channel == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  uint32_t value;
+
+  if (JS_ToUint32(ctx, &value, arg) == -1) {
+    return JS_EXCEPTION;
+  }
+
+  if (prop == WebSGNetworkChannelProp_Budget) {
+    channel->budget = value;
+  } else if (prop == WebSGNetworkChannelProp_MaxBacklog) {
+    channel->max_backlog = value;
+  } else {
+    channel->max_queued_byte_length = value;
+  }
+
+  return JS_UNDEFINED;
+}
+
+static const JSCFunctionListEntry js_websg_network_channel_proto_funcs[] = {
+  JS_CGETSET_DEF("reliable", js_websg_network_channel_get_reliable, NULL),
+  JS_CGETSET_MAGIC_DEF("priority", js_websg_network_channel_get_prop, NULL, WebSGNetworkChannelProp_Priority),
+  JS_CGETSET_MAGIC_DEF(
+    "budget",
+    js_websg_network_channel_get_prop,
+    js_websg_network_channel_set_limit,
+    WebSGNetworkChannelProp_Budget
+  ),
+  JS_CGETSET_MAGIC_DEF(
+    "maxBacklog",
+    js_websg_network_channel_get_prop,
+    js_websg_network_channel_set_limit,
+    WebSGNetworkChannelProp_MaxBacklog
+  ),
+  JS_CGETSET_MAGIC_DEF(
+    "maxQueuedByteLength",
+    js_websg_network_channel_get_prop,
+    js_websg_network_channel_set_limit,
+    WebSGNetworkChannelProp_MaxQueuedByteLength
+  ),
+  JS_CGETSET_MAGIC_DEF(
+    "queuedByteLength",
+    js_websg_network_channel_get_prop,
+    NULL,
+    WebSGNetworkChannelProp_QueuedByteLength
+  ),
+  JS_CGETSET_MAGIC_DEF(
+    "sentByteLength",
+    js_websg_network_channel_get_prop,
+    NULL,
+    WebSGNetworkChannelProp_SentByteLength
+  ),
+  JS_CGETSET_MAGIC_DEF(
+    "deferredCount",
+    js_websg_network_channel_get_prop,
+    NULL,
+    WebSGNetworkChannelProp_DeferredCount
+  ),
+  JS_CGETSET_MAGIC_DEF(
+    "droppedCount",
+    js_websg_network_channel_get_prop,
+    NULL,
+    WebSGNetworkChannelProp_DroppedCount
+  ),
+  JS_PROP_STRING_DEF("[Symbol.toStringTag]", "NetworkChannel", JS_PROP_CONFIGURABLE),
+};
+
+static JSValue js_websg_network_channel_constructor(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  return JS_ThrowTypeError(ctx, "Illegal Constructor.");
+}
+
+void js_websg_define_network_channel(JSContext *ctx, JSValue websg_networking) {
+  JS_NewClassID(&js_websg_network_channel_class_id);
+  JS_NewClass(JS_GetRuntime(ctx), js_websg_network_channel_class_id, &js_websg_network_channel_class);
+  JSValue channel_proto = JS_NewObject(ctx);
+  JS_SetPropertyFunctionList(
+    ctx,
+    channel_proto,
+    js_websg_network_channel_proto_funcs,
+    countof(js_websg_network_channel_proto_funcs)
+  );
+  JS_SetClassProto(ctx, js_websg_network_channel_class_id, channel_proto);
+
+  JSValue constructor = JS_NewCFunction2(
+    ctx,
+    js_websg_network_channel_constructor,
+    "NetworkChannel",
+    0,
+    JS_CFUNC_constructor,
+    0
+  );
+  JS_SetConstructor(ctx, constructor, channel_proto);
+  JS_SetPropertyStr(
+    ctx,
+    websg_networking,
+    "NetworkChannel",
+    constructor
+  );
+}
+
+/**
+ * Public Methods
+ **/
+
+static int js_websg_network_channel_get_option(
+  JSContext *ctx,
+  JSValueConst options,
+  const char *name,
+  uint32_t *value
+) {
+  JSValue option = JS_GetPropertyStr(ctx, options, name);
+
+  if (JS_IsException(option)) {
+    return -1;
+  }
+
+  if (JS_IsUndefined(option)) {
+    return 0;
+  }
+
+  int result = JS_ToUint32(ctx, value, option);
+  JS_FreeValue(ctx, option);
+  return result;
+}
+
+JSValue js_websg_network_define_channel(JSContext *ctx, WebSGNetworkData *network_data, JSValueConst options) {
+  int reliable = 1;
+  int32_t priority = 0;
+  uint32_t budget = 0;
+  uint32_t max_backlog = 0;
+  uint32_t max_queued_byte_length = WEBSG_NETWORK_CHANNEL_DEFAULT_MAX_QUEUED_BYTE_LENGTH;
+
+  if (!JS_IsUndefined(options)) {
+    if (!JS_IsObject(options)) {
+      return JS_ThrowTypeError(ctx, "WebSGNetworking: defineChannel expects an options object.");
+    }
+
+    JSValue reliable_val = JS_GetPropertyStr(ctx, options, "reliable");
+
+    if (JS_IsException(reliable_val)) {
+      return JS_EXCEPTION;
+    }
+
+    if (!JS_IsUndefined(reliable_val)) {
+      reliable = JS_ToBool(ctx, reliable_val);
+      JS_FreeValue(ctx, reliable_val);
+
+      if (reliable == -1) {
+        return JS_EXCEPTION;
+      }
+    }
+
+    JSValue priority_val = JS_GetPropertyStr(ctx, options, "priority");
+
+    if (JS_IsException(priority_val)) {
+      return JS_EXCEPTION;
+    }
+
+    if (!JS_IsUndefined(priority_val)) {
+      int result = JS_ToInt32(ctx, &priority, priority_val);
+      JS_FreeValue(ctx, priority_val);
+
+      if (result == -1) {
+        return JS_EXCEPTION;
+      }
+    }
+
+    if (js_websg_network_channel_get_option(ctx, options, "budget", &budget) == -1) {
+      return JS_EXCEPTION;
+    }
+
+    if (js_websg_network_channel_get_option(ctx, options, "maxBacklog", &max_backlog) == -1) {
+      return JS_EXCEPTION;
+    }
+
+    int result = js_websg_network_channel_get_option(
+      ctx,
+      options,
+      "maxQueuedByteLength",
+      &max_queued_byte_length
+    );
+
+    if (result == -1) {
+      return JS_EXCEPTION;
+    }
+  }
+
+  if (network_data->channel_count == network_data->channel_capacity) {
+    uint32_t capacity = network_data->channel_capacity == 0 ? 4 : network_data->channel_capacity * 2;
+    WebSGNetworkChannel *channels = js_realloc(ctx, network_data->channels, sizeof(WebSGNetworkChannel) * capacity);
+
+    if (channels == NULL) {
+      return JS_EXCEPTION;
+    }
+
+    network_data->channels = channels;
+    network_data->channel_capacity = capacity;
+  }
+
+  JSValue channel = JS_NewObjectClass(ctx, js_websg_network_channel_class_id);
+
+  if (JS_IsException(channel)) {
+    return channel;
+  }
+
+  WebSGNetworkChannelData *channel_data = js_mallocz(ctx, sizeof(WebSGNetworkChannelData));
+
+  if (channel_data == NULL) {
+    JS_FreeValue(ctx, channel);
+    return JS_EXCEPTION;
+  }
+
+  uint32_t channel_index = network_data->channel_count++;
+  WebSGNetworkChannel *channel_state = &network_data->channels[channel_index];
+  memset(channel_state, 0, sizeof(WebSGNetworkChannel));
+  channel_state->reliable = reliable;
+  channel_state->priority = priority;
+  channel_state->budget = budget;
+  channel_state->max_backlog = max_backlog;
+  channel_state->max_queued_byte_length = max_queued_byte_length;
+
+  channel_data->network_data = network_data;
+  channel_data->channel_index = channel_index;
+  JS_SetOpaque(channel, channel_data);
+
+  return channel;
+}
+
+uint32_t js_websg_get_network_channel(JSContext *ctx, WebSGNetworkData *network_data, JSValueConst value) {
+  WebSGNetworkChannelData *channel_data = JS_GetOpaque(value, js_websg_network_channel_class_id);
+
+  if (channel_data == NULL || channel_data->network_data != network_data) {
+    return 0;
+  }
+
+  return channel_data->channel_index + 1;
+}
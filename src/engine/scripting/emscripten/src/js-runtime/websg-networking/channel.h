@@ -0,0 +1,25 @@
+#ifndef __websg_network_channel_js_h
+#define __websg_network_channel_js_h
+#include "../quickjs/quickjs.h"
+#include "../../websg-networking.h"
+#include "./network.h"
+
+typedef struct WebSGNetworkChannelData {
+  WebSGNetworkData *network_data;
+  // Index into network_data->channels, which can be reallocated.
+  uint32_t channel_index;
+} WebSGNetworkChannelData;
+
+extern JSClassID js_websg_network_channel_class_id;
+
+void js_websg_define_network_channel(JSContext *ctx, JSValue websg_networking);
+
+#define WEBSG_NETWORK_CHANNEL_DEFAULT_MAX_QUEUED_BYTE_LENGTH (1024 * 1024)
+
+// Parses a { reliable, priority, budget, maxBacklog, maxQueuedByteLength } options object.
+JSValue js_websg_network_define_channel(JSContext *ctx, WebSGNetworkData *network_data, JSValueConst options);
+
+// Returns the channel index + 1 if the value is a channel of this network, 0 otherwise.
+uint32_t js_websg_get_network_channel(JSContext *ctx, WebSGNetworkData *network_data, JSValueConst value);
+
+#endif
@@ -0,0 +1,255 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../quickjs/quickjs.h"
+#include "../../websg.h"
+#include "../../websg-networking.h"
+#include "../utils/array.h"
+#include "../websg/node.h"
+#include "./interest.h"
+
+static int32_t js_websg_interest_cell_coord(float_t value, float_t cell_size) {
+  float_t cell = floorf(value / cell_size);
+
+  if (!(cell > -1073741824.0f)) {
+    return -1073741824;
+  } else if (cell > 1073741824.0f) {
+    return 1073741824;
+  }
+
+  return (int32_t)cell;
+}
+
+static uint32_t js_websg_interest_hash_cell(const int32_t *cell) {
+  return ((uint32_t)cell[0] * 73856093u) ^ ((uint32_t)cell[1] * 19349663u) ^ ((uint32_t)cell[2] * 83492791u);
+}
+
+static int js_websg_interest_compare_peers(const void *a, const void *b) {
+  const int32_t *cell_a = ((const WebSGInterestPeer *)a)->cell;
+  const int32_t *cell_b = ((const WebSGInterestPeer *)b)->cell;
+
+  for (int i = 0; i < 3; i++) {
+    if (cell_a[i] != cell_b[i]) {
+      return cell_a[i] < cell_b[i] ? -1 : 1;
+    }
+  }
+
+  return 0;
+}
+
+static WebSGInterestCell *js_websg_interest_find_cell(WebSGInterest *interest, const int32_t *cell) {
+  uint32_t mask = interest->cell_capacity - 1;
+  uint32_t i = js_websg_interest_hash_cell(cell) & mask;
+
+  while (interest->cells[i].count != 0) {
+    if (memcmp(interest->cells[i].cell, cell, sizeof(int32_t) * 3) == 0) {
+      break;
+    }
+
+    i = (i + 1) & mask;
+  }
+
+  return &interest->cells[i];
+}
+
+int js_websg_interest_add_peer(JSContext *ctx, WebSGInterest *interest, uint32_t peer_index) {
+  for (uint32_t i = 0; i < interest->peer_count; i++) {
+    if (interest->peers[i].peer_index == peer_index) {
+      return 0;
+    }
+  }
+
+  if (interest->peer_count == interest->peer_capacity) {
+    uint32_t capacity = interest->peer_capacity == 0 ? 16 : interest->peer_capacity * 2;
+    WebSGInterestPeer *peers = js_realloc(ctx, interest->peers, sizeof(WebSGInterestPeer) * capacity);
+
+    if (peers == NULL) {
+      return -1;
+    }
+
+    interest->peers = peers;
+
+    uint32_t *results = js_realloc(ctx, interest->results, sizeof(uint32_t) * capacity);
+
+    if (results == NULL) {
+      return -1;
+    }
+
+    interest->results = results;
+    interest->peer_capacity = capacity;
+  }
+
+  WebSGInterestPeer *peer = &interest->peers[interest->peer_count++];
+  memset(peer, 0, sizeof(WebSGInterestPeer));
+  peer->peer_index = peer_index;
+
+  // Not relevant to anything until the next refresh reads its position.
+  peer->position[0] = INFINITY;
+  interest->grid_valid = false;
+
+  return 0;
+}
+
+void js_websg_interest_remove_peer(WebSGInterest *interest, uint32_t peer_index) {
+  for (uint32_t i = 0; i < interest->peer_count; i++) {
+    if (interest->peers[i].peer_index == peer_index) {
+      interest->peers[i] = interest->peers[--interest->peer_count];
+      // The grid's runs are stale until the next refresh, so queries fall back to a linear scan.
+      interest->grid_valid = false;
+      return;
+    }
+  }
+}
+
+int js_websg_interest_refresh(JSContext *ctx, WebSGInterest *interest) {
+  for (uint32_t i = 0; i < interest->peer_count; i++) {
+    WebSGInterestPeer *peer = &interest->peers[i];
+
+    if (websg_peer_get_translation(peer->peer_index, peer->position) == -1) {
+      peer->position[0] = INFINITY;
+    }
+
+    for (int j = 0; j < 3; j++) {
+      peer->cell[j] = js_websg_interest_cell_coord(peer->position[j], interest->cell_size);
+    }
+  }
+
+  // peers is NULL until the first peer is added, and qsort requires a valid pointer even for zero elements.
+  if (interest->peer_count > 0) {
+    qsort(interest->peers, interest->peer_count, sizeof(WebSGInterestPeer), js_websg_interest_compare_peers);
+  }
+
+  uint32_t capacity = 16;
+
+  while (capacity < interest->peer_count * 2) {
+    capacity *= 2;
+  }
+
+  if (capacity != interest->cell_capacity) {
+    WebSGInterestCell *cells = js_realloc(ctx, interest->cells, sizeof(WebSGInterestCell) * capacity);
+
+    if (cells == NULL) {
+      return -1;
+    }
+
+    interest->cells = cells;
+    interest->cell_capacity = capacity;
+  }
+
+  memset(interest->cells, 0, sizeof(WebSGInterestCell) * interest->cell_capacity);
+
+  for (uint32_t i = 0; i < interest->peer_count; i++) {
+    WebSGInterestPeer *peer = &interest->peers[i];
+    WebSGInterestCell *cell = js_websg_interest_find_cell(interest, peer->cell);
+
+    if (cell->count == 0) {
+      memcpy(cell->cell, peer->cell, sizeof(int32_t) * 3);
+      cell->start = i;
+    }
+
+    cell->count++;
+  }
+
+  interest->grid_valid = true;
+
+  return 0;
+}
+
+static uint32_t js_websg_interest_query_peers(
+  WebSGInterest *interest,
+  const float_t *position,
+  uint32_t start,
+  uint32_t end,
+  uint32_t *peer_indices,
+  uint32_t count
+) {
+  float_t radius_squared = interest->radius * interest->radius;
+
+  for (uint32_t i = start; i < end; i++) {
+    WebSGInterestPeer *peer = &interest->peers[i];
+    float_t dx = peer->position[0] - position[0];
+    float_t dy = peer->position[1] - position[1];
+    float_t dz = peer->position[2] - position[2];
+
+    if (dx * dx + dy * dy + dz * dz <= radius_squared) {
+      peer_indices[count++] = peer->peer_index;
+    }
+  }
+
+  return count;
+}
+
+uint32_t js_websg_interest_query(WebSGInterest *interest, const float_t *position) {
+  uint32_t *peer_indices = interest->results;
+  int32_t min[3];
+  int32_t max[3];
+  double cell_count = 1;
+
+  for (int i = 0; i < 3; i++) {
+    min[i] = js_websg_interest_cell_coord(position[i] - interest->radius, interest->cell_size);
+    max[i] = js_websg_interest_cell_coord(position[i] + interest->radius, interest->cell_size);
+    cell_count *= (double)max[i] - min[i] + 1;
+  }
+
+  uint32_t count = 0;
+
+  // Scanning every peer is cheaper than visiting more cells than there are peers.
+  if (!interest->grid_valid || cell_count > interest->peer_count) {
+    count = js_websg_interest_query_peers(interest, position, 0, interest->peer_count, peer_indices, 0);
+  } else {
+    int32_t cell[3];
+
+    for (cell[0] = min[0]; cell[0] <= max[0]; cell[0]++) {
+      for (cell[1] = min[1]; cell[1] <= max[1]; cell[1]++) {
+        for (cell[2] = min[2]; cell[2] <= max[2]; cell[2]++) {
+          WebSGInterestCell *run = js_websg_interest_find_cell(interest, cell);
+
+          if (run->count > 0) {
+            count = js_websg_interest_query_peers(
+              interest,
+              position,
+              run->start,
+              run->start + run->count,
+              peer_indices,
+              count
+            );
+          }
+        }
+      }
+    }
+  }
+
+  for (uint32_t i = 1; i < count; i++) {
+    uint32_t peer_index = peer_indices[i];
+    uint32_t j = i;
+
+    while (j > 0 && peer_indices[j - 1] > peer_index) {
+      peer_indices[j] = peer_indices[j - 1];
+      j--;
+    }
+
+    peer_indices[j] = peer_index;
+  }
+
+  return count;
+}
+
+int js_websg_interest_get_origin(JSContext *ctx, JSValueConst origin, float_t *position) {
+  WebSGNodeData *node_data = JS_GetOpaque(origin, js_websg_node_class_id);
+
+  if (node_data == NULL) {
+    return js_get_float_array_like(ctx, origin, position, 3);
+  }
+
+  float_t world_matrix[16];
+
+  if (websg_node_get_world_matrix(node_data->node_id, world_matrix) == -1) {
+    JS_ThrowInternalError(ctx, "WebSGNetworking: Error getting origin node's world matrix.");
+    return -1;
+  }
+
+  position[0] = world_matrix[12];
+  position[1] = world_matrix[13];
+  position[2] = world_matrix[14];
+
+  return 0;
+}
@@ -0,0 +1,59 @@
+#ifndef __websg_network_interest_js_h
+#define __websg_network_interest_js_h
+#include <math.h>
+#include <stdbool.h>
+#include "../quickjs/quickjs.h"
+#include "../../websg-networking.h"
+
+/**
+ * Interest Management
+ *
+ * Once a script calls network.setInterest({ radius, cellSize }), messages broadcast or queued with an origin and
+ * replicator state only go to the remote peers within radius of the origin. Peer positions are read once per tick
+ * and bucketed into a uniform grid of cellSize cells, so a query only visits the cells the radius overlaps.
+ **/
+
+typedef struct WebSGInterestPeer {
+  uint32_t peer_index;
+  float_t position[3];
+  int32_t cell[3];
+} WebSGInterestPeer;
+
+// Open addressing table entry for the run of peers in a grid cell, count is 0 for empty slots.
+typedef struct WebSGInterestCell {
+  int32_t cell[3];
+  uint32_t start;
+  uint32_t count;
+} WebSGInterestCell;
+
+typedef struct WebSGInterest {
+  bool enabled;
+  float_t radius;
+  float_t cell_size;
+  // Remote peers in the world, sorted by cell after every refresh.
+  WebSGInterestPeer *peers;
+  uint32_t peer_count;
+  uint32_t peer_capacity;
+  WebSGInterestCell *cells;
+  uint32_t cell_capacity;
+  // False when peers were added or removed since the last refresh.
+  bool grid_valid;
+  // Query results, with room for every peer.
+  uint32_t *results;
+} WebSGInterest;
+
+int js_websg_interest_add_peer(JSContext *ctx, WebSGInterest *interest, uint32_t peer_index);
+
+void js_websg_interest_remove_peer(WebSGInterest *interest, uint32_t peer_index);
+
+// Reads the peers' positions and rebuilds the grid. Called once per tick while interest is enabled.
+int js_websg_interest_refresh(JSContext *ctx, WebSGInterest *interest);
+
+// Writes the indices of the peers within radius of position to interest->results in ascending order and returns
+// how many there are. The results are overwritten by the next query.
+uint32_t js_websg_interest_query(WebSGInterest *interest, const float_t *position);
+
+// Reads an origin argument, either a node (its world position) or an array-like of 3 numbers.
+int js_websg_interest_get_origin(JSContext *ctx, JSValueConst origin, float_t *position);
+
+#endif
@@ -0,0 +1,108 @@
+#include <string.h>
+#include "../quickjs/quickjs.h"
+#include "./interpolation.h"
+
+static inline uint32_t js_websg_interpolation_buffer_slot(WebSGInterpolationBuffer *buffer, uint32_t i) {
+  return (buffer->head + i) % WEBSG_INTERPOLATION_BUFFER_SIZE;
+}
+
+static inline const float_t *js_websg_interpolation_buffer_sample(
+  WebSGInterpolationBuffer *buffer,
+  uint32_t element_count,
+  uint32_t i
+) {
+  return buffer->samples + js_websg_interpolation_buffer_slot(buffer, i) * element_count;
+}
+
+int js_websg_interpolation_buffer_init(JSContext *ctx, WebSGInterpolationBuffer *buffer, uint32_t element_count) {
+  buffer->samples = js_malloc(ctx, sizeof(float_t) * element_count * WEBSG_INTERPOLATION_BUFFER_SIZE);
+  buffer->head = 0;
+  buffer->count = 0;
+  buffer->settled = 0;
+
+  return buffer->samples == NULL ? -1 : 0;
+}
+
+void js_websg_interpolation_buffer_push(
+  WebSGInterpolationBuffer *buffer,
+  uint32_t element_count,
+  float_t time,
+  float_t min_interval,
+  const float_t *elements
+) {
+  uint32_t slot;
+  uint32_t newest = js_websg_interpolation_buffer_slot(buffer, buffer->count - 1);
+
+  if (buffer->count > 0 && time <= buffer->times[newest]) {
+    // Several snapshots received in the same tick, only the last one is kept.
+    slot = newest;
+    time = buffer->times[slot];
+  } else if (
+    buffer->count > 1 &&
+    buffer->times[newest] - buffer->times[js_websg_interpolation_buffer_slot(buffer, buffer->count - 2)] < min_interval
+  ) {
+    slot = newest;
+  } else if (buffer->count == WEBSG_INTERPOLATION_BUFFER_SIZE) {
+    slot = buffer->head;
+    buffer->head = js_websg_interpolation_buffer_slot(buffer, 1);
+  } else {
+    slot = js_websg_interpolation_buffer_slot(buffer, buffer->count++);
+  }
+
+  buffer->times[slot] = time;
+  memcpy(buffer->samples + slot * element_count, elements, sizeof(float_t) * element_count);
+  buffer->settled = 0;
+}
+
+float_t js_websg_interpolation_buffer_find(
+  WebSGInterpolationBuffer *buffer,
+  uint32_t element_count,
+  float_t time,
+  float_t max_extrapolation,
+  const float_t **from,
+  const float_t **to
+) {
+  uint32_t newest = buffer->count - 1;
+  float_t newest_time = buffer->times[js_websg_interpolation_buffer_slot(buffer, newest)];
+
+  // Nothing to blend with yet, or the render time hasn't reached the oldest sample.
+  if (buffer->count == 1 || time <= buffer->times[buffer->head]) {
+    *from = js_websg_interpolation_buffer_sample(buffer, element_count, 0);
+    *to = *from;
+    buffer->settled = buffer->count == 1;
+    return 0;
+  }
+
+  if (time >= newest_time) {
+    float_t previous_time = buffer->times[js_websg_interpolation_buffer_slot(buffer, newest - 1)];
+    float_t extrapolated_time = time;
+
+    if (time >= newest_time + max_extrapolation) {
+      extrapolated_time = newest_time + max_extrapolation;
+      buffer->settled = 1;
+    }
+
+    *from = js_websg_interpolation_buffer_sample(buffer, element_count, newest - 1);
+    *to = js_websg_interpolation_buffer_sample(buffer, element_count, newest);
+    return (extrapolated_time - previous_time) / (newest_time - previous_time);
+  }
+
+  uint32_t i = newest - 1;
+
+  while (buffer->times[js_websg_interpolation_buffer_slot(buffer, i)] > time) {
+    i--;
+  }
+
+  float_t from_time = buffer->times[js_websg_interpolation_buffer_slot(buffer, i)];
+  float_t to_time = buffer->times[js_websg_interpolation_buffer_slot(buffer, i + 1)];
+  *from = js_websg_interpolation_buffer_sample(buffer, element_count, i);
+  *to = js_websg_interpolation_buffer_sample(buffer, element_count, i + 1);
+
+  return (time - from_time) / (to_time - from_time);
+}
+
+void js_websg_interpolation_buffer_free(JSRuntime *rt, WebSGInterpolationBuffer *buffer) {
+  js_free_rt(rt, buffer->samples);
+  buffer->samples = NULL;
+  buffer->count = 0;
+}
@@ -0,0 +1,58 @@
+#ifndef __websg_network_interpolation_js_h
+#define __websg_network_interpolation_js_h
+#include <math.h>
+#include <stdint.h>
+#include "../quickjs/quickjs.h"
+
+/**
+ * Interpolation Buffer
+ *
+ * Timestamped samples of a remote entity's transform. They are played back delay seconds behind the current time,
+ * so there is usually a sample on either side of the render time even when snapshots arrive at a low tick rate.
+ * Past the newest sample, motion is extrapolated from the last two samples for up to max_extrapolation seconds and
+ * then held.
+ *
+ * Samples are stamped with the local time they were received at, snapshots don't carry the sender's clock. Samples
+ * closer together than min_interval are merged, so that a full buffer still reaches back past the delay when
+ * snapshots arrive at a high tick rate.
+ **/
+
+#define WEBSG_INTERPOLATION_BUFFER_SIZE 8
+
+typedef struct WebSGInterpolationBuffer {
+  // WEBSG_INTERPOLATION_BUFFER_SIZE samples of element_count floats each.
+  float_t *samples;
+  float_t times[WEBSG_INTERPOLATION_BUFFER_SIZE];
+  // Index of the oldest sample.
+  uint32_t head;
+  uint32_t count;
+  // The render time has passed the end of the extrapolation window and the held sample was applied.
+  int settled;
+} WebSGInterpolationBuffer;
+
+int js_websg_interpolation_buffer_init(JSContext *ctx, WebSGInterpolationBuffer *buffer, uint32_t element_count);
+
+// Adds a sample, replacing the newest one if it isn't older than time or is still within min_interval of the one
+// before it, and the oldest one if the buffer is full.
+void js_websg_interpolation_buffer_push(
+  WebSGInterpolationBuffer *buffer,
+  uint32_t element_count,
+  float_t time,
+  float_t min_interval,
+  const float_t *elements
+);
+
+// Finds the samples to blend at time, the result is from * (1 - t) + to * t where t is returned.
+// t is greater than 1 when extrapolating. The buffer must have at least one sample.
+float_t js_websg_interpolation_buffer_find(
+  WebSGInterpolationBuffer *buffer,
+  uint32_t element_count,
+  float_t time,
+  float_t max_extrapolation,
+  const float_t **from,
+  const float_t **to
+);
+
+void js_websg_interpolation_buffer_free(JSRuntime *rt, WebSGInterpolationBuffer *buffer);
+
+#endif
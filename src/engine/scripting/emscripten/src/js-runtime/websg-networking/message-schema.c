@@ -0,0 +1,743 @@
+#include <math.h>
+#include <string.h>
+#include "../quickjs/cutils.h"
+#include "../quickjs/quickjs.h"
+#include "../../websg.h"
+#include "../../websg-networking.h"
+#include "../websg/node.h"
+#include "../websg/world.h"
+#include "./message-schema.h"
+
+JSClassID js_websg_message_schema_class_id;
+
+/**
+ * Field Parsing
+ **/
+
+typedef struct WebSGMessageFieldTypeInfo {
+  const char *name;
+  WebSGMessageFieldType type;
+  uint32_t element_count;
+  uint32_t element_byte_length;
+} WebSGMessageFieldTypeInfo;
+
+static const WebSGMessageFieldTypeInfo js_websg_message_field_types[] = {
+  { "bool", WebSGMessageFieldType_Bool, 1, 1 },
+  { "u8", WebSGMessageFieldType_U8, 1, 1 },
+  { "u16", WebSGMessageFieldType_U16, 1, 2 },
+  { "u32", WebSGMessageFieldType_U32, 1, 4 },
+  { "i8", WebSGMessageFieldType_I8, 1, 1 },
+  { "i16", WebSGMessageFieldType_I16, 1, 2 },
+  { "i32", WebSGMessageFieldType_I32, 1, 4 },
+  { "f32", WebSGMessageFieldType_F32, 1, 4 },
+  { "vec3", WebSGMessageFieldType_Vec3, 3, 4 },
+  { "quat", WebSGMessageFieldType_Quat, 4, 4 },
+  { "node", WebSGMessageFieldType_Node, 1, 4 },
+};
+
+static int js_websg_message_field_is_float(WebSGMessageField *field) {
+  return field->type == WebSGMessageFieldType_F32 ||
+    field->type == WebSGMessageFieldType_Vec3 ||
+    field->type == WebSGMessageFieldType_Quat;
+}
+
+static int js_websg_get_float_option(JSContext *ctx, JSValueConst obj, const char *name, float_t *value) {
+  JSValue val = JS_GetPropertyStr(ctx, obj, name);
+
+  if (JS_IsUndefined(val)) {
+    return 0;
+  }
+
+  double number;
+  int result = JS_ToFloat64(ctx, &number, val);
+  JS_FreeValue(ctx, val);
+
+  if (result == -1) {
+    return -1;
+  }
+
+  *value = (float_t)number;
+
+  return 1;
+}
+
+static int js_websg_parse_message_quantization(JSContext *ctx, JSValueConst item, WebSGMessageField *field) {
+  JSValue bits_val = JS_GetPropertyStr(ctx, item, "bits");
+
+  if (JS_IsUndefined(bits_val)) {
+    return 0;
+  }
+
+  int result = JS_ToUint32(ctx, &field->bits, bits_val);
+  JS_FreeValue(ctx, bits_val);
+
+  if (result == -1) {
+    return -1;
+  }
+
+  if (!js_websg_message_field_is_float(field)) {
+    JS_ThrowTypeError(ctx, "WebSGNetworking: Only f32, vec3 and quat fields can be quantized.");
+    return -1;
+  }
+
+  if (field->bits != 8 && field->bits != 16) {
+    JS_ThrowRangeError(ctx, "WebSGNetworking: Quantized fields must use 8 or 16 bits.");
+    return -1;
+  }
+
+  // Quaternion components are always within [-1, 1].
+  field->min = field->type == WebSGMessageFieldType_Quat ? -1.0f : 0.0f;
+  field->max = 1.0f;
+
+  int has_min = js_websg_get_float_option(ctx, item, "min", &field->min);
+  int has_max = has_min == -1 ? -1 : js_websg_get_float_option(ctx, item, "max", &field->max);
+
+  if (has_max == -1) {
+    return -1;
+  }
+
+  if (field->type != WebSGMessageFieldType_Quat && (!has_min || !has_max)) {
+    JS_ThrowTypeError(ctx, "WebSGNetworking: Quantized fields need a min and max.");
+    return -1;
+  }
+
+  if (!(field->min < field->max) || !isfinite(field->min) || !isfinite(field->max)) {
+    JS_ThrowRangeError(ctx, "WebSGNetworking: Quantized field min must be less than max.");
+    return -1;
+  }
+
+  return 0;
+}
+
+static int js_websg_parse_message_field(JSContext *ctx, JSValueConst item, WebSGMessageField *field) {
+  if (!JS_IsObject(item)) {
+    JS_ThrowTypeError(ctx, "WebSGNetworking: Schema fields must be { name, type } objects.");
+    return -1;
+  }
+
+  JSValue name_val = JS_GetPropertyStr(ctx, item, "name");
+
+  if (!JS_IsString(name_val)) {
+    JS_FreeValue(ctx, name_val);
+    JS_ThrowTypeError(ctx, "WebSGNetworking: Schema field name must be a string.");
+    return -1;
+  }
+
+  field->name = JS_ValueToAtom(ctx, name_val);
+  JS_FreeValue(ctx, name_val);
+
+  if (field->name == JS_ATOM_NULL) {
+    return -1;
+  }
+
+  JSValue type_val = JS_GetPropertyStr(ctx, item, "type");
+  const char *type = JS_ToCString(ctx, type_val);
+  JS_FreeValue(ctx, type_val);
+
+  if (type == NULL) {
+    return -1;
+  }
+
+  const WebSGMessageFieldTypeInfo *type_info = NULL;
+
+  for (uint32_t i = 0; i < countof(js_websg_message_field_types); i++) {
+    if (strcmp(js_websg_message_field_types[i].name, type) == 0) {
+      type_info = &js_websg_message_field_types[i];
+      break;
+    }
+  }
+
+  if (type_info == NULL) {
+    JS_ThrowTypeError(ctx, "WebSGNetworking: Unknown schema field type \"%s\".", type);
+    JS_FreeCString(ctx, type);
+    return -1;
+  }
+
+  JS_FreeCString(ctx, type);
+
+  field->type = type_info->type;
+  field->element_count = type_info->element_count;
+
+  return js_websg_parse_message_quantization(ctx, item, field);
+}
+
+static uint32_t js_websg_message_field_byte_length(WebSGMessageField *field) {
+  if (field->bits > 0) {
+    return field->element_count * (field->bits / 8);
+  }
+
+  for (uint32_t i = 0; i < countof(js_websg_message_field_types); i++) {
+    if (js_websg_message_field_types[i].type == field->type) {
+      return field->element_count * js_websg_message_field_types[i].element_byte_length;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * Encoding
+ **/
+
+static uint8_t *js_websg_write_float(WebSGMessageField *field, uint8_t *p, float_t value) {
+  if (field->bits == 0) {
+    memcpy(p, &value, 4);
+    return p + 4;
+  }
+
+  float_t steps = (float_t)((1u << field->bits) - 1);
+  float_t t = (value - field->min) / (field->max - field->min);
+  t = isnan(t) ? 0.0f : fminf(fmaxf(t, 0.0f), 1.0f);
+  uint32_t quantized = (uint32_t)roundf(t * steps);
+
+  if (field->bits == 8) {
+    *p = (uint8_t)quantized;
+    return p + 1;
+  }
+
+  uint16_t quantized_u16 = (uint16_t)quantized;
+  memcpy(p, &quantized_u16, 2);
+  return p + 2;
+}
+
+static const uint8_t *js_websg_read_float(WebSGMessageField *field, const uint8_t *p, float_t *value) {
+  if (field->bits == 0) {
+    memcpy(value, p, 4);
+    return p + 4;
+  }
+
+  float_t steps = (float_t)((1u << field->bits) - 1);
+  uint32_t quantized;
+
+  if (field->bits == 8) {
+    quantized = *p;
+    p += 1;
+  } else {
+    uint16_t quantized_u16;
+    memcpy(&quantized_u16, p, 2);
+    quantized = quantized_u16;
+    p += 2;
+  }
+
+  *value = field->min + (field->max - field->min) * ((float_t)quantized / steps);
+
+  return p;
+}
+
+static int js_websg_encode_message_field(
+  JSContext *ctx,
+  WebSGMessageField *field,
+  JSValueConst value,
+  uint8_t *p
+) {
+  switch (field->type) {
+    case WebSGMessageFieldType_Bool: {
+      int result = JS_ToBool(ctx, value);
+
+      if (result == -1) {
+        return -1;
+      }
+
+      *p = (uint8_t)result;
+      return 0;
+    }
+    case WebSGMessageFieldType_U8:
+    case WebSGMessageFieldType_I8:
+    case WebSGMessageFieldType_U16:
+    case WebSGMessageFieldType_I16:
+    case WebSGMessageFieldType_U32:
+    case WebSGMessageFieldType_I32: {
+      // Wraps like a DataView setter.
+      int32_t integer;
+
+      if (JS_ToInt32(ctx, &integer, value) == -1) {
+        return -1;
+      }
+
+      if (field->type == WebSGMessageFieldType_U8 || field->type == WebSGMessageFieldType_I8) {
+        *p = (uint8_t)integer;
+      } else if (field->type == WebSGMessageFieldType_U16 || field->type == WebSGMessageFieldType_I16) {
+        uint16_t integer_u16 = (uint16_t)integer;
+        memcpy(p, &integer_u16, 2);
+      } else {
+        memcpy(p, &integer, 4);
+      }
+
+      return 0;
+    }
+    case WebSGMessageFieldType_F32: {
+      double number;
+
+      if (JS_ToFloat64(ctx, &number, value) == -1) {
+        return -1;
+      }
+
+      js_websg_write_float(field, p, (float_t)number);
+      return 0;
+    }
+    case WebSGMessageFieldType_Vec3:
+    case WebSGMessageFieldType_Quat: {
+      // Arrays, typed arrays and WebSG vectors are all indexable.
+      for (uint32_t i = 0; i < field->element_count; i++) {
+        JSValue element = JS_GetPropertyUint32(ctx, value, i);
+        double number;
+        int result = JS_ToFloat64(ctx, &number, element);
+        JS_FreeValue(ctx, element);
+
+        if (result == -1) {
+          return -1;
+        }
+
+        p = js_websg_write_float(field, p, (float_t)number);
+      }
+
+      return 0;
+    }
+    case WebSGMessageFieldType_Node: {
+      network_id_t network_id = 0;
+
+      if (!JS_IsUndefined(value) && !JS_IsNull(value)) {
+        WebSGNodeData *node_data = JS_GetOpaque2(ctx, value, js_websg_node_class_id);
+
+        if (node_data == NULL) {
+          return -1;
+        }
+
+        network_id = websg_node_get_network_id(node_data->node_id);
+      }
+
+      memcpy(p, &network_id, 4);
+      return 0;
+    }
+  }
+
+  return 0;
+}
+
+static int js_websg_encode_message(
+  JSContext *ctx,
+  WebSGMessageSchemaData *schema_data,
+  JSValueConst message,
+  uint8_t *data
+) {
+  if (!JS_IsObject(message)) {
+    JS_ThrowTypeError(ctx, "WebSGNetworking: Expected a message object.");
+    return -1;
+  }
+
+  for (uint32_t i = 0; i < schema_data->field_count; i++) {
+    WebSGMessageField *field = &schema_data->fields[i];
+    JSValue value = JS_GetProperty(ctx, message, field->name);
+
+    if (JS_IsException(value)) {
+      return -1;
+    }
+
+    int result = js_websg_encode_message_field(ctx, field, value, data + field->byte_offset);
+    JS_FreeValue(ctx, value);
+
+    if (result == -1) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * Decoding
+ **/
+
+static JSValue js_websg_decode_message_field(
+  JSContext *ctx,
+  WebSGMessageSchemaData *schema_data,
+  WebSGMessageField *field,
+  const uint8_t *p,
+  JSValueConst target
+) {
+  switch (field->type) {
+    case WebSGMessageFieldType_Bool:
+      return JS_NewBool(ctx, *p != 0);
+    case WebSGMessageFieldType_U8:
+      return JS_NewUint32(ctx, *p);
+    case WebSGMessageFieldType_I8:
+      return JS_NewInt32(ctx, (int8_t)*p);
+    case WebSGMessageFieldType_U16: {
+      uint16_t value;
+      memcpy(&value, p, 2);
+      return JS_NewUint32(ctx, value);
+    }
+    case WebSGMessageFieldType_I16: {
+      int16_t value;
+      memcpy(&value, p, 2);
+      return JS_NewInt32(ctx, value);
+    }
+    case WebSGMessageFieldType_U32: {
+      uint32_t value;
+      memcpy(&value, p, 4);
+      return JS_NewUint32(ctx, value);
+    }
+    case WebSGMessageFieldType_I32: {
+      int32_t value;
+      memcpy(&value, p, 4);
+      return JS_NewInt32(ctx, value);
+    }
+    case WebSGMessageFieldType_F32: {
+      float_t value;
+      js_websg_read_float(field, p, &value);
+      return JS_NewFloat64(ctx, value);
+    }
+    case WebSGMessageFieldType_Vec3:
+    case WebSGMessageFieldType_Quat: {
+      // Decoding into an existing array, typed array or WebSG vector writes its elements in place.
+      JSValue elements = JS_IsObject(target) ? JS_DupValue(ctx, target) : JS_NewArray(ctx);
+
+      if (JS_IsException(elements)) {
+        return elements;
+      }
+
+      for (uint32_t i = 0; i < field->element_count; i++) {
+        float_t value;
+        p = js_websg_read_float(field, p, &value);
+
+        if (JS_SetPropertyUint32(ctx, elements, i, JS_NewFloat64(ctx, value)) == -1) {
+          JS_FreeValue(ctx, elements);
+          return JS_EXCEPTION;
+        }
+      }
+
+      return elements;
+    }
+    case WebSGMessageFieldType_Node: {
+      network_id_t network_id;
+      memcpy(&network_id, p, 4);
+
+      node_id_t node_id = network_id == 0 ? 0 : websg_network_get_node_id(network_id);
+
+      if (node_id == 0) {
+        return JS_NULL;
+      }
+
+      return js_websg_get_node_by_id(ctx, schema_data->world_data, node_id);
+    }
+  }
+
+  return JS_UNDEFINED;
+}
+
+static int js_websg_decode_message(
+  JSContext *ctx,
+  WebSGMessageSchemaData *schema_data,
+  const uint8_t *data,
+  JSValueConst message
+) {
+  for (uint32_t i = 0; i < schema_data->field_count; i++) {
+    WebSGMessageField *field = &schema_data->fields[i];
+    JSValue target = JS_UNDEFINED;
+
+    if (field->type == WebSGMessageFieldType_Vec3 || field->type == WebSGMessageFieldType_Quat) {
+      target = JS_GetProperty(ctx, message, field->name);
+
+      if (JS_IsException(target)) {
+        return -1;
+      }
+    }
+
+    JSValue value = js_websg_decode_message_field(ctx, schema_data, field, data + field->byte_offset, target);
+    JS_FreeValue(ctx, target);
+
+    if (JS_IsException(value)) {
+      return -1;
+    }
+
+    if (JS_SetProperty(ctx, message, field->name, value) == -1) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * Class Definition
+ **/
+
+static void js_websg_message_schema_finalizer(JSRuntime *rt, JSValue val) {
+  WebSGMessageSchemaData *schema_data = JS_GetOpaque(val, js_websg_message_schema_class_id);
+
+  if (schema_data) {
+    for (uint32_t i = 0; i < schema_data->field_count; i++) {
+      JS_FreeAtomRT(rt, schema_data->fields[i].name);
+    }
+
+    js_free_rt(rt, schema_data->fields);
+    js_free_rt(rt, schema_data);
+  }
+}
+
+static JSClassDef js_websg_message_schema_class = {
+  "MessageSchema",
+  .finalizer = js_websg_message_schema_finalizer
+};
+
+// Returns a pointer to byte_length bytes of the ArrayBuffer at the optional byte offset argument.
+static uint8_t *js_websg_message_schema_get_data(
+  JSContext *ctx,
+  WebSGMessageSchemaData *schema_data,
+  JSValueConst buffer,
+  int argc,
+  JSValueConst *argv,
+  int byte_offset_index
+) {
+  size_t buffer_byte_length;
+  uint8_t *data = JS_GetArrayBuffer(ctx, &buffer_byte_length, buffer);
+
+  if (data == NULL) {
+    return NULL;
+  }
+
+  uint32_t byte_offset = 0;
+
+  if (argc > byte_offset_index && JS_ToUint32(ctx, &byte_offset, argv[byte_offset_index]) == -1) {
+    return NULL;
+  }
+
+  if ((uint64_t)byte_offset + schema_data->byte_length > buffer_byte_length) {
+    JS_ThrowRangeError(ctx, "WebSGNetworking: The buffer is too small for the message.");
+    return NULL;
+  }
+
+  return data + byte_offset;
+}
+
+static JSValue js_websg_message_schema_get_byte_length(JSContext *ctx, JSValueConst this_val) {
+  WebSGMessageSchemaData *schema_data = JS_GetOpaque2(ctx, this_val, js_websg_message_schema_class_id);
+
+  if (schema_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_NewUint32(ctx, schema_data->byte_length);
+}
+
+static JSValue js_websg_message_schema_encode(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGMessageSchemaData *schema_data = JS_GetOpaque2(ctx, this_val, js_websg_message_schema_class_id);
+
+  if (schema_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  JSValue buffer = JS_NewArrayBufferCopy(ctx, NULL, schema_data->byte_length);
+
+  if (JS_IsException(buffer)) {
+    return buffer;
+  }
+
+  size_t byte_length;
+  uint8_t *data = JS_GetArrayBuffer(ctx, &byte_length, buffer);
+
+  if (data == NULL || js_websg_encode_message(ctx, schema_data, argv[0], data) == -1) {
+    JS_FreeValue(ctx, buffer);
+    return JS_EXCEPTION;
+  }
+
+  return buffer;
+}
+
+static JSValue js_websg_message_schema_encode_into(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  WebSGMessageSchemaData *schema_data = JS_GetOpaque2(ctx, this_val, js_websg_message_schema_class_id);
+
+  if (schema_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  uint8_t *data = js_websg_message_schema_get_data(ctx, schema_data, argv[1], argc, argv, 2);
+
+  if (data == NULL || js_websg_encode_message(ctx, schema_data, argv[0], data) == -1) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_NewUint32(ctx, schema_data->byte_length);
+}
+
+static JSValue js_websg_message_schema_decode(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGMessageSchemaData *schema_data = JS_GetOpaque2(ctx, this_val, js_websg_message_schema_class_id);
+
+  if (schema_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  uint8_t *data = js_websg_message_schema_get_data(ctx, schema_data, argv[0], argc, argv, 1);
+
+  if (data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  JSValue message = JS_NewObject(ctx);
+
+  if (JS_IsException(message)) {
+    return message;
+  }
+
+  if (js_websg_decode_message(ctx, schema_data, data, message) == -1) {
+    JS_FreeValue(ctx, message);
+    return JS_EXCEPTION;
+  }
+
+  return message;
+}
+
+static JSValue js_websg_message_schema_decode_into(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  WebSGMessageSchemaData *schema_data = JS_GetOpaque2(ctx, this_val, js_websg_message_schema_class_id);
+
+  if (schema_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  uint8_t *data = js_websg_message_schema_get_data(ctx, schema_data, argv[0], argc, argv, 2);
+
+  if (data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  if (!JS_IsObject(argv[1])) {
+    return JS_ThrowTypeError(ctx, "WebSGNetworking: Expected a message object to decode into.");
+  }
+
+  if (js_websg_decode_message(ctx, schema_data, data, argv[1]) == -1) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_DupValue(ctx, argv[1]);
+}
+
+static const JSCFunctionListEntry js_websg_message_schema_proto_funcs[] = {
+  JS_CGETSET_DEF("byteLength", js_websg_message_schema_get_byte_length, NULL),
+  JS_CFUNC_DEF("encode", 1, js_websg_message_schema_encode),
+  JS_CFUNC_DEF("encodeInto", 3, js_websg_message_schema_encode_into),
+  JS_CFUNC_DEF("decode", 2, js_websg_message_schema_decode),
+  JS_CFUNC_DEF("decodeInto", 3, js_websg_message_schema_decode_into),
+  JS_PROP_STRING_DEF("[Symbol.toStringTag]", "MessageSchema", JS_PROP_CONFIGURABLE),
+};
+
+static JSValue js_websg_message_schema_constructor(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  return JS_ThrowTypeError(ctx, "Illegal Constructor.");
+}
+
+void js_websg_define_message_schema(JSContext *ctx, JSValue websg_networking) {
+  JS_NewClassID(&js_websg_message_schema_class_id);
+  JS_NewClass(JS_GetRuntime(ctx), js_websg_message_schema_class_id, &js_websg_message_schema_class);
+  JSValue message_schema_proto = JS_NewObject(ctx);
+  JS_SetPropertyFunctionList(
+    ctx,
+    message_schema_proto,
+    js_websg_message_schema_proto_funcs,
+    countof(js_websg_message_schema_proto_funcs)
+  );
+  JS_SetClassProto(ctx, js_websg_message_schema_class_id, message_schema_proto);
+
+  JSValue constructor = JS_NewCFunction2(
+    ctx,
+    js_websg_message_schema_constructor,
+    "MessageSchema",
+    0,
+    JS_CFUNC_constructor,
+    0
+  );
+  JS_SetConstructor(ctx, constructor, message_schema_proto);
+  JS_SetPropertyStr(
+    ctx,
+    websg_networking,
+    "MessageSchema",
+    constructor
+  );
+}
+
+/**
+ * Public Methods
+ **/
+
+JSValue js_websg_new_message_schema(JSContext *ctx, JSValueConst fields) {
+  if (!JS_IsArray(ctx, fields)) {
+    return JS_ThrowTypeError(ctx, "WebSGNetworking: defineSchema expects an array of fields.");
+  }
+
+  JSValue length_val = JS_GetPropertyStr(ctx, fields, "length");
+  uint32_t field_count;
+  int result = JS_ToUint32(ctx, &field_count, length_val);
+  JS_FreeValue(ctx, length_val);
+
+  if (result == -1) {
+    return JS_EXCEPTION;
+  }
+
+  JSValue global = JS_GetGlobalObject(ctx);
+  JSValue world = JS_GetPropertyStr(ctx, global, "world");
+  WebSGWorldData *world_data = JS_GetOpaque2(ctx, world, js_websg_world_class_id);
+  JS_FreeValue(ctx, world);
+  JS_FreeValue(ctx, global);
+
+  if (world_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  JSValue schema = JS_NewObjectClass(ctx, js_websg_message_schema_class_id);
+
+  if (JS_IsException(schema)) {
+    return schema;
+  }
+
+  WebSGMessageSchemaData *schema_data = js_mallocz(ctx, sizeof(WebSGMessageSchemaData));
+
+  if (schema_data == NULL) {
+    JS_FreeValue(ctx, schema);
+    return JS_EXCEPTION;
+  }
+
+  schema_data->world_data = world_data;
+  JS_SetOpaque(schema, schema_data);
+
+  if (field_count > 0) {
+    schema_data->fields = js_mallocz(ctx, sizeof(WebSGMessageField) * field_count);
+
+    if (schema_data->fields == NULL) {
+      JS_FreeValue(ctx, schema);
+      return JS_EXCEPTION;
+    }
+  }
+
+  for (uint32_t i = 0; i < field_count; i++) {
+    WebSGMessageField *field = &schema_data->fields[i];
+    JSValue item = JS_GetPropertyUint32(ctx, fields, i);
+    result = js_websg_parse_message_field(ctx, item, field);
+    JS_FreeValue(ctx, item);
+
+    // Counted before checking the result so that the finalizer frees the field's name.
+    schema_data->field_count++;
+
+    if (result == -1) {
+      JS_FreeValue(ctx, schema);
+      return JS_EXCEPTION;
+    }
+
+    field->byte_offset = schema_data->byte_length;
+    schema_data->byte_length += js_websg_message_field_byte_length(field);
+  }
+
+  return schema;
+}
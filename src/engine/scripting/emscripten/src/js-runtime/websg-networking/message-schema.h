@@ -0,0 +1,58 @@
+#ifndef __websg_network_message_schema_js_h
+#define __websg_network_message_schema_js_h
+#include <math.h>
+#include "../quickjs/quickjs.h"
+#include "../../websg-networking.h"
+#include "../websg/world.h"
+
+/**
+ * Message Schema
+ *
+ * network.defineSchema() compiles a list of { name, type } fields once into a fixed size binary layout. Messages
+ * are then encoded from and decoded into plain objects in C instead of with DataViews in the script. Fields are
+ * packed in order, little endian and without padding.
+ *
+ * Types: "bool", "u8", "u16", "u32", "i8", "i16", "i32", "f32", "vec3", "quat" and "node". Float types can be
+ * quantized to 8 or 16 bits with { bits, min, max }. Nodes are sent as their network id, 0 for null or nodes that
+ * aren't networked, and decode to null when the receiver doesn't know the node.
+ **/
+
+typedef enum WebSGMessageFieldType {
+  WebSGMessageFieldType_Bool,
+  WebSGMessageFieldType_U8,
+  WebSGMessageFieldType_U16,
+  WebSGMessageFieldType_U32,
+  WebSGMessageFieldType_I8,
+  WebSGMessageFieldType_I16,
+  WebSGMessageFieldType_I32,
+  WebSGMessageFieldType_F32,
+  WebSGMessageFieldType_Vec3,
+  WebSGMessageFieldType_Quat,
+  WebSGMessageFieldType_Node,
+} WebSGMessageFieldType;
+
+typedef struct WebSGMessageField {
+  JSAtom name;
+  WebSGMessageFieldType type;
+  uint32_t element_count;
+  // Float types only, 0 for full precision floats.
+  uint32_t bits;
+  float_t min;
+  float_t max;
+  uint32_t byte_offset;
+} WebSGMessageField;
+
+typedef struct WebSGMessageSchemaData {
+  WebSGWorldData *world_data;
+  WebSGMessageField *fields;
+  uint32_t field_count;
+  uint32_t byte_length;
+} WebSGMessageSchemaData;
+
+extern JSClassID js_websg_message_schema_class_id;
+
+void js_websg_define_message_schema(JSContext *ctx, JSValue websg_networking);
+
+JSValue js_websg_new_message_schema(JSContext *ctx, JSValueConst fields);
+
+#endif
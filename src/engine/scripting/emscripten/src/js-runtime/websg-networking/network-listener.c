@@ -4,6 +4,7 @@
 #include "./websg-networking-js.h"
 #include "./network-listener.h"
 #include "./network-message-iterator.h"
+#include "./network-message-batch.h"
 
 JSClassID js_websg_network_listener_class_id;
 
@@ -29,6 +30,59 @@ static JSValue js_websg_network_listener_receive(JSContext *ctx, JSValueConst th
   return js_websg_create_network_message_iterator(ctx, network_listener_data, argv[0]);
 }
 
+static JSValue js_websg_network_listener_receive_batch(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  WebSGNetworkListenerData *network_listener_data = JS_GetOpaque(this_val, js_websg_network_listener_class_id);
+
+  size_t arena_byte_length;
+  uint8_t *arena_data = JS_GetArrayBuffer(ctx, &arena_byte_length, argv[0]);
+
+  if (arena_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  int32_t count = websg_network_listener_receive_batch(
+    network_listener_data->listener_id,
+    arena_data,
+    arena_byte_length
+  );
+
+  if (count == -1) {
+    JS_ThrowInternalError(ctx, "WebSGNetworking: error receiving messages.");
+    return JS_EXCEPTION;
+  }
+
+  if (count < 0) {
+    network_listener_data->next_message_byte_length = (uint32_t)-count;
+    JS_ThrowRangeError(
+      ctx,
+      "WebSGNetworking: the next message needs an arena of %u bytes, see nextMessageByteLength.",
+      network_listener_data->next_message_byte_length
+    );
+    return JS_EXCEPTION;
+  }
+
+  network_listener_data->next_message_byte_length = 0;
+
+  return js_websg_new_network_message_batch_instance(
+    ctx,
+    network_listener_data->network_data,
+    argv[0],
+    arena_data,
+    arena_byte_length,
+    count
+  );
+}
+
+static JSValue js_websg_network_listener_get_next_message_byte_length(JSContext *ctx, JSValueConst this_val) {
+  WebSGNetworkListenerData *network_listener_data = JS_GetOpaque(this_val, js_websg_network_listener_class_id);
+  return JS_NewUint32(ctx, network_listener_data->next_message_byte_length);
+}
+
 static JSValue js_websg_network_listener_close(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
   WebSGNetworkListenerData *network_listener_data = JS_GetOpaque(this_val, js_websg_network_listener_class_id);
 
@@ -43,7 +97,9 @@ static JSValue js_websg_network_listener_close(JSContext *ctx, JSValueConst this
 
 static const JSCFunctionListEntry js_websg_network_listener_proto_funcs[] = {
   JS_CFUNC_DEF("receive", 1, js_websg_network_listener_receive),
+  JS_CFUNC_DEF("receiveBatch", 1, js_websg_network_listener_receive_batch),
   JS_CFUNC_DEF("close", 0, js_websg_network_listener_close),
+  JS_CGETSET_DEF("nextMessageByteLength", js_websg_network_listener_get_next_message_byte_length, NULL),
   JS_PROP_STRING_DEF("[Symbol.toStringTag]", "NetworkListener", JS_PROP_CONFIGURABLE),
 };
 
@@ -92,6 +148,12 @@ JSValue js_websg_new_network_listener_instance(JSContext *ctx, WebSGNetworkData
   }
 
   WebSGNetworkListenerData *listener_data = js_mallocz(ctx, sizeof(WebSGNetworkListenerData));
+
+  if (listener_data == NULL) {
+    JS_FreeValue(ctx, network_listener);
+    return JS_EXCEPTION;
+  }
+
   listener_data->network_data = network_data;
   listener_data->listener_id = listener_id;
   JS_SetOpaque(network_listener, listener_data);
@@ -7,6 +7,8 @@
 typedef struct WebSGNetworkListenerData {
   WebSGNetworkData *network_data;
   network_listener_id_t listener_id;
+  // Arena byte length needed by the message that didn't fit in the last receiveBatch call, 0 if every message fit.
+  uint32_t next_message_byte_length;
 } WebSGNetworkListenerData;
 
 extern JSClassID js_websg_network_listener_class_id;
@@ -0,0 +1,259 @@
+#include "../quickjs/cutils.h"
+#include "../quickjs/quickjs.h"
+#include "../../websg-networking.h"
+#include "../utils/typedarray.h"
+#include "./websg-networking-js.h"
+#include "./peer.h"
+#include "./network-message-batch.h"
+
+JSClassID js_websg_network_message_batch_class_id;
+
+/**
+ * Class Definition
+ **/
+
+static void js_websg_network_message_batch_finalizer(JSRuntime *rt, JSValue val) {
+  WebSGNetworkMessageBatchData *batch_data = JS_GetOpaque(val, js_websg_network_message_batch_class_id);
+
+  if (batch_data) {
+    JS_FreeValueRT(rt, batch_data->arena);
+    js_free_rt(rt, batch_data);
+  }
+}
+
+static void js_websg_network_message_batch_gc_mark(JSRuntime *rt, JSValueConst val, JS_MarkFunc *mark_func) {
+  WebSGNetworkMessageBatchData *batch_data = JS_GetOpaque(val, js_websg_network_message_batch_class_id);
+
+  if (batch_data) {
+    JS_MarkValue(rt, batch_data->arena, mark_func);
+  }
+}
+
+static JSClassDef js_websg_network_message_batch_class = {
+  "NetworkMessageBatch",
+  .finalizer = js_websg_network_message_batch_finalizer,
+  .gc_mark = js_websg_network_message_batch_gc_mark
+};
+
+// The headers are in the arena, which the script can write to, so payload ranges are checked on every read.
+static NetworkMessageHeader *js_websg_network_message_batch_get_header(
+  JSContext *ctx,
+  JSValueConst this_val,
+  JSValueConst index_arg,
+  WebSGNetworkMessageBatchData **out_batch_data
+) {
+  WebSGNetworkMessageBatchData *batch_data = JS_GetOpaque2(ctx, this_val, js_websg_network_message_batch_class_id);
+
+  if (batch_data == NULL) {
+    return NULL;
+  }
+
+  uint32_t index;
+
+  if (JS_ToUint32(ctx, &index, index_arg) == -1) {
+    return NULL;
+  }
+
+  if (index >= batch_data->count) {
+    JS_ThrowRangeError(ctx, "WebSGNetworking: message index out of range.");
+    return NULL;
+  }
+
+  NetworkMessageHeader *header = (NetworkMessageHeader *)batch_data->arena_data + index;
+
+  if (
+    header->byte_offset > batch_data->arena_byte_length ||
+    header->byte_length > batch_data->arena_byte_length - header->byte_offset
+  ) {
+    JS_ThrowRangeError(ctx, "WebSGNetworking: message payload is outside of the arena.");
+    return NULL;
+  }
+
+  *out_batch_data = batch_data;
+
+  return header;
+}
+
+static JSValue js_websg_network_message_batch_get_peer(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  WebSGNetworkMessageBatchData *batch_data;
+  NetworkMessageHeader *header = js_websg_network_message_batch_get_header(ctx, this_val, argv[0], &batch_data);
+
+  if (header == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return js_websg_get_peer(ctx, batch_data->network_data, header->peer_index);
+}
+
+static JSValue js_websg_network_message_batch_is_binary(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  WebSGNetworkMessageBatchData *batch_data;
+  NetworkMessageHeader *header = js_websg_network_message_batch_get_header(ctx, this_val, argv[0], &batch_data);
+
+  if (header == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_NewBool(ctx, header->binary);
+}
+
+// Returns a Uint8Array over the message's payload in the arena, no bytes are copied.
+static JSValue js_websg_network_message_batch_get_data(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  WebSGNetworkMessageBatchData *batch_data;
+  NetworkMessageHeader *header = js_websg_network_message_batch_get_header(ctx, this_val, argv[0], &batch_data);
+
+  if (header == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return js_new_typed_array_subview(ctx, JSTypedArrayType_Uint8, batch_data->arena, header->byte_offset, header->byte_length);
+}
+
+static JSValue js_websg_network_message_batch_get_text(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  WebSGNetworkMessageBatchData *batch_data;
+  NetworkMessageHeader *header = js_websg_network_message_batch_get_header(ctx, this_val, argv[0], &batch_data);
+
+  if (header == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_NewStringLen(ctx, (const char *)batch_data->arena_data + header->byte_offset, header->byte_length);
+}
+
+static JSValue js_websg_network_message_batch_get_arena(JSContext *ctx, JSValueConst this_val) {
+  WebSGNetworkMessageBatchData *batch_data = JS_GetOpaque2(ctx, this_val, js_websg_network_message_batch_class_id);
+
+  if (batch_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_DupValue(ctx, batch_data->arena);
+}
+
+static JSValue js_websg_network_message_batch_get_count(JSContext *ctx, JSValueConst this_val) {
+  WebSGNetworkMessageBatchData *batch_data = JS_GetOpaque2(ctx, this_val, js_websg_network_message_batch_class_id);
+
+  if (batch_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_NewUint32(ctx, batch_data->count);
+}
+
+static const JSCFunctionListEntry js_websg_network_message_batch_proto_funcs[] = {
+  JS_CGETSET_DEF("arena", js_websg_network_message_batch_get_arena, NULL),
+  JS_CGETSET_DEF("count", js_websg_network_message_batch_get_count, NULL),
+  JS_CFUNC_DEF("getPeer", 1, js_websg_network_message_batch_get_peer),
+  JS_CFUNC_DEF("isBinary", 1, js_websg_network_message_batch_is_binary),
+  JS_CFUNC_DEF("getData", 1, js_websg_network_message_batch_get_data),
+  JS_CFUNC_DEF("getText", 1, js_websg_network_message_batch_get_text),
+  JS_PROP_STRING_DEF("[Symbol.toStringTag]", "NetworkMessageBatch", JS_PROP_CONFIGURABLE),
+};
+
+static JSValue js_websg_network_message_batch_constructor(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  return JS_ThrowTypeError(ctx, "Illegal Constructor.");
+}
+
+void js_websg_define_network_message_batch(JSContext *ctx, JSValue websg_networking) {
+  JS_NewClassID(&js_websg_network_message_batch_class_id);
+  JS_NewClass(JS_GetRuntime(ctx), js_websg_network_message_batch_class_id, &js_websg_network_message_batch_class);
+  JSValue network_message_batch_proto = JS_NewObject(ctx);
+  JS_SetPropertyFunctionList(
+    ctx,
+    network_message_batch_proto,
+    js_websg_network_message_batch_proto_funcs,
+    countof(js_websg_network_message_batch_proto_funcs)
+  );
+  JS_SetClassProto(ctx, js_websg_network_message_batch_class_id, network_message_batch_proto);
+
+  JSValue constructor = JS_NewCFunction2(
+    ctx,
+    js_websg_network_message_batch_constructor,
+    "NetworkMessageBatch",
+    0,
+    JS_CFUNC_constructor,
+    0
+  );
+  JS_SetConstructor(ctx, constructor, network_message_batch_proto);
+  JS_SetPropertyStr(
+    ctx,
+    websg_networking,
+    "NetworkMessageBatch",
+    constructor
+  );
+}
+
+/**
+ * Public Methods
+ **/
+
+// The batch reads from the arena, so it is only valid until the arena is passed to receiveBatch again.
+JSValue js_websg_new_network_message_batch_instance(
+  JSContext *ctx,
+  WebSGNetworkData *network_data,
+  JSValueConst arena,
+  uint8_t *arena_data,
+  size_t arena_byte_length,
+  uint32_t count
+) {
+  if ((size_t)count * sizeof(NetworkMessageHeader) > arena_byte_length) {
+    JS_ThrowRangeError(ctx, "WebSGNetworking: message headers are outside of the arena.");
+    return JS_EXCEPTION;
+  }
+
+  JSValue network_message_batch = JS_NewObjectClass(ctx, js_websg_network_message_batch_class_id);
+
+  if (JS_IsException(network_message_batch)) {
+    return network_message_batch;
+  }
+
+  WebSGNetworkMessageBatchData *batch_data = js_mallocz(ctx, sizeof(WebSGNetworkMessageBatchData));
+
+  if (batch_data == NULL) {
+    JS_FreeValue(ctx, network_message_batch);
+    return JS_EXCEPTION;
+  }
+
+  batch_data->network_data = network_data;
+  batch_data->arena = JS_DupValue(ctx, arena);
+  batch_data->arena_data = arena_data;
+  batch_data->arena_byte_length = arena_byte_length;
+  batch_data->count = count;
+  JS_SetOpaque(network_message_batch, batch_data);
+
+  // Each header is 4 uint32s: peer index, byte offset, byte length and binary flag.
+  JSValue headers = js_new_typed_array_subview(ctx, JSTypedArrayType_Uint32, arena, 0, count * 4);
+
+  if (JS_IsException(headers)) {
+    JS_FreeValue(ctx, network_message_batch);
+    return JS_EXCEPTION;
+  }
+
+  JS_DefinePropertyValueStr(ctx, network_message_batch, "headers", headers, JS_PROP_ENUMERABLE);
+
+  return network_message_batch;
+}
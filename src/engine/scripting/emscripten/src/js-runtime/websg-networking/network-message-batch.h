@@ -0,0 +1,29 @@
+#ifndef __websg_network_message_batch_js_h
+#define __websg_network_message_batch_js_h
+#include "../quickjs/quickjs.h"
+#include "../../websg-networking.h"
+#include "./network.h"
+
+typedef struct WebSGNetworkMessageBatchData {
+  WebSGNetworkData *network_data;
+  // Held by the batch so arena_data stays valid for as long as the batch is alive.
+  JSValue arena;
+  uint8_t *arena_data;
+  size_t arena_byte_length;
+  uint32_t count;
+} WebSGNetworkMessageBatchData;
+
+extern JSClassID js_websg_network_message_batch_class_id;
+
+void js_websg_define_network_message_batch(JSContext *ctx, JSValue websg_networking);
+
+JSValue js_websg_new_network_message_batch_instance(
+  JSContext *ctx,
+  WebSGNetworkData *network_data,
+  JSValueConst arena,
+  uint8_t *arena_data,
+  size_t arena_byte_length,
+  uint32_t count
+);
+
+#endif
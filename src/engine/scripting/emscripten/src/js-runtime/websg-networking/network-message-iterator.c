@@ -42,16 +42,14 @@ static JSValue js_websg_network_message_iterator_next(
 
   uint32_t listener_id = it->listener_data->listener_id;
 
-  NetworkMessageInfo *info = js_mallocz(ctx, sizeof(NetworkMessageInfo));
+  NetworkMessageInfo info;
 
-  int result = websg_network_listener_get_message_info(listener_id, info);
+  int result = websg_network_listener_get_message_info(listener_id, &info);
 
   if (result == -1) {
-    js_free(ctx, info);
     JS_ThrowInternalError(ctx, "WebSGNetworking: error getting message info.");
     return JS_EXCEPTION;
   } else if (result == 0) {
-    js_free(ctx, info);
     *pdone = TRUE;
     return JS_UNDEFINED;
   }
@@ -62,20 +60,18 @@ static JSValue js_websg_network_message_iterator_next(
   uint32_t target_byte_length;
 
   if (JS_IsUndefined(it->array_buffer)) {
-    target = js_mallocz(ctx, info->byte_length);
-    target_byte_length = info->byte_length;
+    target = js_mallocz(ctx, info.byte_length);
+    target_byte_length = info.byte_length;
   } else {
     target = it->buffer_data;
     target_byte_length = it->buffer_size;
   }
 
   if (target == NULL) {
-    js_free(ctx, info);
     return JS_EXCEPTION;
   }
 
-  if (info->byte_length > target_byte_length) {
-    js_free(ctx, info);
+  if (info.byte_length > target_byte_length) {
     JS_ThrowRangeError(ctx, "WebSGNetworking: message is too large for target array buffer.");
     return JS_EXCEPTION;
   }
@@ -87,8 +83,6 @@ static JSValue js_websg_network_message_iterator_next(
   );
 
   if (read_bytes == -1) {
-    js_free(ctx, info);
-
     if (JS_IsUndefined(it->array_buffer)) {
       js_free(ctx, target);
     }
@@ -99,7 +93,7 @@ static JSValue js_websg_network_message_iterator_next(
 
   JSValue data;
 
-  if (info->binary) {
+  if (info.binary) {
     if (JS_IsUndefined(it->array_buffer)) {
       data = JS_NewArrayBuffer(ctx, target, read_bytes, js_websg_network_buffer_free, NULL, 0);
     } else {
@@ -107,15 +101,15 @@ static JSValue js_websg_network_message_iterator_next(
     }
   } else {
     data = JS_NewStringLen(ctx, (const char *)target, read_bytes);
-  }
 
-  JSValue peer = js_websg_get_peer(ctx, it->listener_data->network_data, info->peer_index);
-
-  int is_binary = info->binary;
+    if (JS_IsUndefined(it->array_buffer)) {
+      js_free(ctx, target);
+    }
+  }
 
-  js_free(ctx, info);
+  JSValue peer = js_websg_get_peer(ctx, it->listener_data->network_data, info.peer_index);
 
-  return js_websg_new_network_message_instance(ctx, peer, data, (uint32_t)read_bytes, is_binary);
+  return js_websg_new_network_message_instance(ctx, peer, data, (uint32_t)read_bytes, info.binary);
 }
 
 static JSValue js_websg_network_message_iterator(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
@@ -1,14 +1,314 @@
+#include <math.h>
+#include <string.h>
 #include "../quickjs/quickjs.h"
 #include "../quickjs/cutils.h"
 #include "../../websg-networking.h"
-#include "../../websg-networking.h"
+#include "./channel.h"
 #include "./network-listener.h"
 #include "./peer.h"
+#include "./peer-poses.h"
+#include "./message-schema.h"
 #include "../utils/exception.h"
+#include "../utils/hooks.h"
 #include "./replicator.h"
 
 JSClassID js_websg_network_class_id;
 
+/**
+ * Send Queue
+ **/
+
+static uint32_t js_websg_network_hash_send_key(uint32_t peer_index, uint32_t key) {
+  return (peer_index * 0x9E3779B1u) ^ (key * 0x85EBCA6Bu);
+}
+
+static WebSGNetworkSendKey *js_websg_network_find_send_key(
+  WebSGNetworkSendQueue *queue,
+  uint32_t peer_index,
+  uint32_t key
+) {
+  uint32_t mask = queue->key_capacity - 1;
+  uint32_t i = js_websg_network_hash_send_key(peer_index, key) & mask;
+
+  while (queue->keys[i].message_index != 0) {
+    if (queue->keys[i].peer_index == peer_index && queue->keys[i].key == key) {
+      break;
+    }
+
+    i = (i + 1) & mask;
+  }
+
+  return &queue->keys[i];
+}
+
+// Keeps the table at most half full so probes stay short.
+static int js_websg_network_reserve_send_keys(JSContext *ctx, WebSGNetworkSendQueue *queue) {
+  if ((queue->key_count + 1) * 2 <= queue->key_capacity) {
+    return 0;
+  }
+
+  uint32_t capacity = queue->key_capacity == 0 ? 64 : queue->key_capacity * 2;
+  WebSGNetworkSendKey *keys = js_mallocz(ctx, sizeof(WebSGNetworkSendKey) * capacity);
+
+  if (keys == NULL) {
+    return -1;
+  }
+
+  WebSGNetworkSendKey *prev_keys = queue->keys;
+  uint32_t prev_capacity = queue->key_capacity;
+
+  queue->keys = keys;
+  queue->key_capacity = capacity;
+
+  for (uint32_t i = 0; i < prev_capacity; i++) {
+    if (prev_keys[i].message_index != 0) {
+      *js_websg_network_find_send_key(queue, prev_keys[i].peer_index, prev_keys[i].key) = prev_keys[i];
+    }
+  }
+
+  js_free(ctx, prev_keys);
+
+  return 0;
+}
+
+static int js_websg_network_append_payload(
+  JSContext *ctx,
+  WebSGNetworkSendQueue *queue,
+  const uint8_t *data,
+  uint32_t byte_length,
+  uint32_t *byte_offset
+) {
+  if (queue->payloads_byte_length + byte_length > queue->payloads_capacity) {
+    uint32_t capacity = queue->payloads_capacity == 0 ? 4096 : queue->payloads_capacity * 2;
+
+    while (capacity < queue->payloads_byte_length + byte_length) {
+      capacity *= 2;
+    }
+
+    uint8_t *payloads = js_realloc(ctx, queue->payloads, capacity);
+
+    if (payloads == NULL) {
+      return -1;
+    }
+
+    queue->payloads = payloads;
+    queue->payloads_capacity = capacity;
+  }
+
+  memcpy(queue->payloads + queue->payloads_byte_length, data, byte_length);
+  *byte_offset = queue->payloads_byte_length;
+  queue->payloads_byte_length += byte_length;
+
+  return 0;
+}
+
+int32_t js_websg_network_queue_message(
+  JSContext *ctx,
+  WebSGNetworkData *network_data,
+  uint32_t peer_index,
+  JSValueConst message,
+  int reliable,
+  uint32_t channel,
+  int has_key,
+  uint32_t key
+) {
+  WebSGNetworkSendQueue *queue = &network_data->send_queue;
+  int binary = !JS_IsString(message);
+
+  size_t byte_length;
+  const uint8_t *data;
+
+  if (binary) {
+    data = JS_GetArrayBuffer(ctx, &byte_length, message);
+  } else {
+    data = (const uint8_t *)JS_ToCStringLen(ctx, &byte_length, message);
+  }
+
+  if (data == NULL) {
+    return -1;
+  }
+
+  // Rejected here so that one oversized message can't fail the flush for every other message in the queue.
+  if (byte_length > NETWORK_MAX_MESSAGE_BYTE_LENGTH) {
+    JS_ThrowRangeError(
+      ctx,
+      "WebSGNetworking: message is %zu bytes, larger than the %u byte limit.",
+      byte_length,
+      NETWORK_MAX_MESSAGE_BYTE_LENGTH
+    );
+
+    if (!binary) {
+      JS_FreeCString(ctx, (const char *)data);
+    }
+
+    return -1;
+  }
+
+  WebSGNetworkSendKey *send_key = NULL;
+
+  if (has_key) {
+    if (js_websg_network_reserve_send_keys(ctx, queue) == -1) {
+      if (!binary) {
+        JS_FreeCString(ctx, (const char *)data);
+      }
+
+      return -1;
+    }
+
+    send_key = js_websg_network_find_send_key(queue, peer_index, key);
+  }
+
+  if (channel != 0) {
+    WebSGNetworkChannel *channel_state = &network_data->channels[channel - 1];
+    uint32_t queued_byte_length = channel_state->queued_byte_length;
+
+    if (send_key && send_key->message_index != 0 && queue->meta[send_key->message_index - 1].channel == channel) {
+      queued_byte_length -= queue->headers[send_key->message_index - 1].byte_length;
+    }
+
+    // Messages held back on a reliable channel stay queued, so a backed up peer can't grow the queue without bound.
+    if (
+      channel_state->max_queued_byte_length != 0 &&
+      queued_byte_length + byte_length > channel_state->max_queued_byte_length
+    ) {
+      channel_state->dropped_count++;
+      JS_ThrowRangeError(
+        ctx,
+        "WebSGNetworking: channel queue is full (%u of %u bytes), the message was dropped.",
+        queued_byte_length,
+        channel_state->max_queued_byte_length
+      );
+
+      if (!binary) {
+        JS_FreeCString(ctx, (const char *)data);
+      }
+
+      return -1;
+    }
+  }
+
+  uint32_t byte_offset;
+  int result = js_websg_network_append_payload(ctx, queue, data, byte_length, &byte_offset);
+
+  if (!binary) {
+    JS_FreeCString(ctx, (const char *)data);
+  }
+
+  if (result == -1) {
+    return -1;
+  }
+
+  if (channel != 0) {
+    network_data->channels[channel - 1].queued_byte_length += byte_length;
+  }
+
+  if (send_key && send_key->message_index != 0) {
+    // Last write wins, the superseded payload is left in the buffer until the queue is flushed.
+    NetworkOutboundMessageHeader *header = &queue->headers[send_key->message_index - 1];
+    WebSGNetworkSendMeta *meta = &queue->meta[send_key->message_index - 1];
+
+    if (meta->channel != 0) {
+      network_data->channels[meta->channel - 1].queued_byte_length -= header->byte_length;
+    }
+
+    header->byte_offset = byte_offset;
+    header->byte_length = byte_length;
+    header->binary = binary;
+    header->reliable = reliable;
+    meta->channel = channel;
+    return 0;
+  }
+
+  if (queue->count == queue->capacity) {
+    uint32_t capacity = queue->capacity == 0 ? 64 : queue->capacity * 2;
+    NetworkOutboundMessageHeader *headers = js_realloc(
+      ctx,
+      queue->headers,
+      sizeof(NetworkOutboundMessageHeader) * capacity
+    );
+
+    if (headers == NULL) {
+      return -1;
+    }
+
+    queue->headers = headers;
+
+    WebSGNetworkSendMeta *meta = js_realloc(ctx, queue->meta, sizeof(WebSGNetworkSendMeta) * capacity);
+
+    if (meta == NULL) {
+      return -1;
+    }
+
+    queue->meta = meta;
+    queue->capacity = capacity;
+  }
+
+  WebSGNetworkSendMeta *meta = &queue->meta[queue->count];
+  meta->channel = channel;
+  meta->has_key = has_key;
+  meta->key = key;
+
+  NetworkOutboundMessageHeader *header = &queue->headers[queue->count++];
+  header->peer_index = peer_index;
+  header->byte_offset = byte_offset;
+  header->byte_length = byte_length;
+  header->binary = binary;
+  header->reliable = reliable;
+
+  if (send_key) {
+    send_key->peer_index = peer_index;
+    send_key->key = key;
+    send_key->message_index = queue->count;
+    queue->key_count++;
+  }
+
+  return 0;
+}
+
+JSValue js_websg_network_queue_message_args(
+  JSContext *ctx,
+  WebSGNetworkData *network_data,
+  uint32_t peer_index,
+  int argc,
+  JSValueConst *argv
+) {
+  int reliable = 1;
+  uint32_t channel = 0;
+
+  if (argc > 1 && !JS_IsUndefined(argv[1])) {
+    channel = js_websg_get_network_channel(ctx, network_data, argv[1]);
+
+    if (channel != 0) {
+      reliable = network_data->channels[channel - 1].reliable;
+    } else {
+      reliable = JS_ToBool(ctx, argv[1]);
+
+      if (reliable == -1) {
+        return JS_EXCEPTION;
+      }
+    }
+  }
+
+  // The host can't broadcast unreliably, so reject it here instead of having the flush drop it every frame.
+  if (!reliable && peer_index == NETWORK_BROADCAST_PEER_INDEX) {
+    JS_ThrowTypeError(ctx, "WebSGNetworking: Unreliable broadcast is not supported, queue the message for each peer.");
+    return JS_EXCEPTION;
+  }
+
+  int has_key = argc > 2 && !JS_IsUndefined(argv[2]);
+  uint32_t key = 0;
+
+  if (has_key && JS_ToUint32(ctx, &key, argv[2]) == -1) {
+    return JS_EXCEPTION;
+  }
+
+  if (js_websg_network_queue_message(ctx, network_data, peer_index, argv[0], reliable, channel, has_key, key) == -1) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_UNDEFINED;
+}
+
 /**
  * Class Definition
  **/
@@ -30,7 +330,54 @@ static JSValue js_websg_network_listen(JSContext *ctx, JSValueConst this_val, in
   return js_websg_new_network_listener_instance(ctx, network_data, listener_id);
 }
 
+// Reads the optional origin argument, returns 1 when the message should only go to the peers relevant to it.
+static int js_websg_network_get_relevant_peers(
+  JSContext *ctx,
+  WebSGNetworkData *network_data,
+  int argc,
+  JSValueConst *argv,
+  int origin_index,
+  uint32_t *relevant_count
+) {
+  if (argc <= origin_index || JS_IsUndefined(argv[origin_index]) || !network_data->interest.enabled) {
+    return 0;
+  }
+
+  float_t position[3];
+
+  if (js_websg_interest_get_origin(ctx, argv[origin_index], position) == -1) {
+    return -1;
+  }
+
+  *relevant_count = js_websg_interest_query(&network_data->interest, position);
+
+  return 1;
+}
+
 static JSValue js_websg_network_broadcast(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGNetworkData *network_data = JS_GetOpaque2(ctx, this_val, js_websg_network_class_id);
+
+  if (network_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  int reliable = 1;
+
+  if (argc > 1 && !JS_IsUndefined(argv[1])) {
+    reliable = JS_ToBool(ctx, argv[1]);
+
+    if (reliable == -1) {
+      return JS_EXCEPTION;
+    }
+  }
+
+  uint32_t relevant_count = 0;
+  int relevant = js_websg_network_get_relevant_peers(ctx, network_data, argc, argv, 2, &relevant_count);
+
+  if (relevant == -1) {
+    return JS_EXCEPTION;
+  }
+
   int binary = !JS_IsString(argv[0]);
 
   size_t byte_length;
@@ -46,17 +393,24 @@ static JSValue js_websg_network_broadcast(JSContext *ctx, JSValueConst this_val,
     return JS_EXCEPTION;
   }
 
-  int reliable = 1;
+  int32_t result = 0;
 
-  if (argc > 1) {
-    reliable = JS_ToBool(ctx, argv[1]);
-
-    if (reliable == -1) {
-      return JS_EXCEPTION;
+  if (relevant) {
+    // Keep sending after a failure so one bad peer doesn't keep the message from the rest.
+    for (uint32_t i = 0; i < relevant_count; i++) {
+      if (websg_peer_send(network_data->interest.results[i], buffer, byte_length, binary, reliable) != 0) {
+        result = -1;
+      }
     }
+  } else {
+    result = websg_network_broadcast(buffer, byte_length, binary, reliable);
+  }
+
+  if (!binary) {
+    JS_FreeCString(ctx, (const char *)buffer);
   }
 
-  if (websg_network_broadcast(buffer, byte_length, binary, reliable) == 0) {
+  if (result == 0) {
     return JS_UNDEFINED;
   }
 
@@ -65,6 +419,121 @@ static JSValue js_websg_network_broadcast(JSContext *ctx, JSValueConst this_val,
   return JS_EXCEPTION;
 }
 
+static JSValue js_websg_network_queue(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGNetworkData *network_data = JS_GetOpaque2(ctx, this_val, js_websg_network_class_id);
+
+  if (network_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  uint32_t relevant_count = 0;
+  int relevant = js_websg_network_get_relevant_peers(ctx, network_data, argc, argv, 3, &relevant_count);
+
+  if (relevant == -1) {
+    return JS_EXCEPTION;
+  }
+
+  if (!relevant) {
+    return js_websg_network_queue_message_args(ctx, network_data, NETWORK_BROADCAST_PEER_INDEX, argc, argv);
+  }
+
+  // Queueing can't run a query, so the results stay valid for the whole loop.
+  for (uint32_t i = 0; i < relevant_count; i++) {
+    JSValue result = js_websg_network_queue_message_args(
+      ctx,
+      network_data,
+      network_data->interest.results[i],
+      argc < 3 ? argc : 3,
+      argv
+    );
+
+    if (JS_IsException(result)) {
+      return result;
+    }
+  }
+
+  return JS_UNDEFINED;
+}
+
+static JSValue js_websg_network_set_interest(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGNetworkData *network_data = JS_GetOpaque2(ctx, this_val, js_websg_network_class_id);
+
+  if (network_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  if (argc < 1 || !JS_IsObject(argv[0])) {
+    return JS_ThrowTypeError(ctx, "WebSGNetworking: setInterest expects an options object.");
+  }
+
+  JSValue radius_val = JS_GetPropertyStr(ctx, argv[0], "radius");
+  double radius;
+  int result = JS_ToFloat64(ctx, &radius, radius_val);
+  JS_FreeValue(ctx, radius_val);
+
+  if (result == -1) {
+    return JS_EXCEPTION;
+  }
+
+  if (!(radius > 0) || isinf(radius)) {
+    return JS_ThrowRangeError(ctx, "WebSGNetworking: Interest radius must be a positive number.");
+  }
+
+  double cell_size = radius;
+  JSValue cell_size_val = JS_GetPropertyStr(ctx, argv[0], "cellSize");
+
+  if (JS_IsException(cell_size_val)) {
+    return JS_EXCEPTION;
+  }
+
+  if (!JS_IsUndefined(cell_size_val)) {
+    result = JS_ToFloat64(ctx, &cell_size, cell_size_val);
+    JS_FreeValue(ctx, cell_size_val);
+
+    if (result == -1) {
+      return JS_EXCEPTION;
+    }
+
+    if (!(cell_size > 0) || isinf(cell_size)) {
+      return JS_ThrowRangeError(ctx, "WebSGNetworking: Interest cellSize must be a positive number.");
+    }
+  }
+
+  WebSGInterest *interest = &network_data->interest;
+  interest->enabled = true;
+  interest->radius = radius;
+  interest->cell_size = cell_size;
+  interest->grid_valid = false;
+
+  // Refreshed right away so that messages sent before the next update are already filtered.
+  if (js_websg_interest_refresh(ctx, interest) == -1) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_UNDEFINED;
+}
+
+static JSValue js_websg_network_clear_interest(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGNetworkData *network_data = JS_GetOpaque2(ctx, this_val, js_websg_network_class_id);
+
+  if (network_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  network_data->interest.enabled = false;
+
+  return JS_UNDEFINED;
+}
+
+static JSValue js_websg_network_flush_queue(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  if (js_websg_network_flush(ctx, this_val) == -1) {
+    JS_ThrowInternalError(ctx, "WebSGNetworking: error sending queued messages.");
+    return JS_EXCEPTION;
+  }
+
+  return JS_UNDEFINED;
+}
+
 static JSValue js_websg_network_get_host(JSContext *ctx, JSValueConst this_val) {
   WebSGNetworkData *network_data = JS_GetOpaque2(ctx, this_val, js_websg_network_class_id);
   uint32_t peer_index = websg_network_get_host_peer_index();
@@ -92,6 +561,40 @@ static JSValue js_websg_network_get_peers(JSContext *ctx, JSValueConst this_val)
   return JS_DupValue(ctx, network_data->peers);
 }
 
+static JSValue js_websg_network_get_peer_poses_method(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  WebSGNetworkData *network_data = JS_GetOpaque2(ctx, this_val, js_websg_network_class_id);
+
+  if (network_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return js_websg_network_get_peer_poses(ctx, network_data);
+}
+
+static JSValue js_websg_network_define_channel_method(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  WebSGNetworkData *network_data = JS_GetOpaque2(ctx, this_val, js_websg_network_class_id);
+
+  if (network_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return js_websg_network_define_channel(ctx, network_data, argc > 0 ? argv[0] : JS_UNDEFINED);
+}
+
+static JSValue js_websg_network_define_schema(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  return js_websg_new_message_schema(ctx, argv[0]);
+}
+
 static JSValue js_websg_network_define_replicator(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
   if (argc < 1 || !JS_IsFunction(ctx, argv[0])) {
     return JS_ThrowTypeError(ctx, "WebSGNetworking: Unable to create replicator, expected a function as the first argument.");
@@ -99,20 +602,62 @@ static JSValue js_websg_network_define_replicator(JSContext *ctx, JSValueConst t
 
   WebSGNetworkData *network_data = JS_GetOpaque(this_val, js_websg_network_class_id);
 
+  JSValue batch_factory_function = JS_UNDEFINED;
+
+  if (argc > 1 && !JS_IsUndefined(argv[1])) {
+    if (!JS_IsFunction(ctx, argv[1])) {
+      return JS_ThrowTypeError(ctx, "WebSGNetworking: Unable to create replicator, expected a batch factory function.");
+    }
+
+    batch_factory_function = JS_DupValue(ctx, argv[1]);
+  }
+
   JSValue factory_function = JS_DupValue(ctx, argv[0]);
 
   replication_id_t replicator_id = websg_network_define_replicator();
 
-  return js_websg_new_replicator_instance(ctx, network_data, replicator_id, factory_function);
+  return js_websg_new_replicator_instance(
+    ctx,
+    network_data,
+    replicator_id,
+    factory_function,
+    batch_factory_function
+  );
+}
+
+static JSValue js_websg_network_get_hook(JSContext *ctx, JSValueConst this_val, int hook) {
+  return js_get_hook(ctx, hook);
 }
 
+static JSValue js_websg_network_set_hook(JSContext *ctx, JSValueConst this_val, JSValueConst arg, int hook) {
+  return js_set_hook(ctx, hook, arg);
+}
 
 static const JSCFunctionListEntry js_websg_network_proto_funcs[] = {
   JS_CFUNC_DEF("listen", 0, js_websg_network_listen),
-  JS_CFUNC_DEF("broadcast", 2, js_websg_network_broadcast),
-  JS_CFUNC_DEF("defineReplicator", 1, js_websg_network_define_replicator),
+  JS_CFUNC_DEF("broadcast", 3, js_websg_network_broadcast),
+  JS_CFUNC_DEF("queue", 4, js_websg_network_queue),
+  JS_CFUNC_DEF("flush", 0, js_websg_network_flush_queue),
+  JS_CFUNC_DEF("setInterest", 1, js_websg_network_set_interest),
+  JS_CFUNC_DEF("clearInterest", 0, js_websg_network_clear_interest),
+  JS_CFUNC_DEF("getPeerPoses", 0, js_websg_network_get_peer_poses_method),
+  JS_CFUNC_DEF("defineChannel", 1, js_websg_network_define_channel_method),
+  JS_CFUNC_DEF("defineSchema", 1, js_websg_network_define_schema),
+  JS_CFUNC_DEF("defineReplicator", 2, js_websg_network_define_replicator),
   JS_CGETSET_DEF("host", js_websg_network_get_host, NULL),
   JS_CGETSET_DEF("local", js_websg_network_get_local, NULL),
+  JS_CGETSET_MAGIC_DEF(
+    "onpeerentered",
+    js_websg_network_get_hook,
+    js_websg_network_set_hook,
+    JSHook_NetworkPeerEntered
+  ),
+  JS_CGETSET_MAGIC_DEF(
+    "onpeerexited",
+    js_websg_network_get_hook,
+    js_websg_network_set_hook,
+    JSHook_NetworkPeerExited
+  ),
   JS_PROP_STRING_DEF("[Symbol.toStringTag]", "Network", JS_PROP_CONFIGURABLE),
 };
 
@@ -157,12 +702,439 @@ JSValue js_websg_new_network(JSContext *ctx) {
   }
 
   WebSGNetworkData *network_data = js_mallocz(ctx, sizeof(WebSGNetworkData));
+
+  if (network_data == NULL) {
+    JS_FreeValue(ctx, network);
+    return JS_EXCEPTION;
+  }
+
   network_data->peers = JS_NewObject(ctx);
+  network_data->peer_poses = JS_UNDEFINED;
   JS_SetOpaque(network, network_data);
 
   return network;
 }
 
+static int js_websg_network_reserve_flush_scratch(JSContext *ctx, WebSGNetworkSendQueue *queue) {
+  if (queue->scratch_capacity >= queue->capacity) {
+    return 0;
+  }
+
+  uint32_t capacity = queue->capacity;
+
+  uint32_t *order = js_realloc(ctx, queue->order, sizeof(uint32_t) * capacity);
+
+  if (order == NULL) {
+    return -1;
+  }
+
+  queue->order = order;
+
+  NetworkOutboundMessageHeader *sent = js_realloc(ctx, queue->sent, sizeof(NetworkOutboundMessageHeader) * capacity);
+
+  if (sent == NULL) {
+    return -1;
+  }
+
+  queue->sent = sent;
+
+  uint8_t *deferred = js_realloc(ctx, queue->deferred, capacity);
+
+  if (deferred == NULL) {
+    return -1;
+  }
+
+  queue->deferred = deferred;
+  queue->scratch_capacity = capacity;
+
+  return 0;
+}
+
+static int32_t js_websg_network_get_peer_backlog(
+  JSContext *ctx,
+  WebSGNetworkSendQueue *queue,
+  uint32_t peer_index,
+  uint32_t *backlog
+) {
+  for (uint32_t i = 0; i < queue->peer_backlog_count; i++) {
+    if (queue->peer_backlogs[i].peer_index == peer_index) {
+      *backlog = queue->peer_backlogs[i].backlog;
+      return 0;
+    }
+  }
+
+  NetworkPeerStats stats;
+
+  // Peers that have left don't have a backlog.
+  if (websg_peer_get_stats(peer_index, &stats) == -1) {
+    stats.backlog = 0;
+  }
+
+  if (queue->peer_backlog_count == queue->peer_backlog_capacity) {
+    uint32_t capacity = queue->peer_backlog_capacity == 0 ? 16 : queue->peer_backlog_capacity * 2;
+    WebSGNetworkPeerBacklog *peer_backlogs = js_realloc(
+      ctx,
+      queue->peer_backlogs,
+      sizeof(WebSGNetworkPeerBacklog) * capacity
+    );
+
+    if (peer_backlogs == NULL) {
+      return -1;
+    }
+
+    queue->peer_backlogs = peer_backlogs;
+    queue->peer_backlog_capacity = capacity;
+  }
+
+  queue->peer_backlogs[queue->peer_backlog_count].peer_index = peer_index;
+  queue->peer_backlogs[queue->peer_backlog_count].backlog = stats.backlog;
+  queue->peer_backlog_count++;
+  *backlog = stats.backlog;
+
+  return 0;
+}
+
+static int js_websg_network_is_peer_blocked(WebSGNetworkSendQueue *queue, uint32_t channel, uint32_t peer_index) {
+  for (uint32_t i = 0; i < queue->blocked_peer_count; i++) {
+    if (queue->blocked_peers[i].channel == channel && queue->blocked_peers[i].peer_index == peer_index) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+static int js_websg_network_block_peer(
+  JSContext *ctx,
+  WebSGNetworkSendQueue *queue,
+  uint32_t channel,
+  uint32_t peer_index
+) {
+  if (queue->blocked_peer_count == queue->blocked_peer_capacity) {
+    uint32_t capacity = queue->blocked_peer_capacity == 0 ? 16 : queue->blocked_peer_capacity * 2;
+    WebSGNetworkBlockedPeer *blocked_peers = js_realloc(
+      ctx,
+      queue->blocked_peers,
+      sizeof(WebSGNetworkBlockedPeer) * capacity
+    );
+
+    if (blocked_peers == NULL) {
+      return -1;
+    }
+
+    queue->blocked_peers = blocked_peers;
+    queue->blocked_peer_capacity = capacity;
+  }
+
+  queue->blocked_peers[queue->blocked_peer_count].channel = channel;
+  queue->blocked_peers[queue->blocked_peer_count].peer_index = peer_index;
+  queue->blocked_peer_count++;
+
+  return 0;
+}
+
+static int32_t js_websg_network_get_message_priority(WebSGNetworkData *network_data, WebSGNetworkSendMeta *meta) {
+  return meta->channel == 0 ? 0 : network_data->channels[meta->channel - 1].priority;
+}
+
+// Orders the queue by channel priority, highest first. Messages with the same priority keep their queue order.
+static void js_websg_network_sort_send_queue(WebSGNetworkData *network_data) {
+  WebSGNetworkSendQueue *queue = &network_data->send_queue;
+  uint32_t ordered = 0;
+  int64_t previous_priority = INT64_MAX;
+
+  while (ordered < queue->count) {
+    int64_t priority = INT64_MIN;
+
+    for (uint32_t i = 0; i < queue->count; i++) {
+      int32_t message_priority = js_websg_network_get_message_priority(network_data, &queue->meta[i]);
+
+      if (message_priority < previous_priority && message_priority > priority) {
+        priority = message_priority;
+      }
+    }
+
+    for (uint32_t i = 0; i < queue->count; i++) {
+      if (js_websg_network_get_message_priority(network_data, &queue->meta[i]) == priority) {
+        queue->order[ordered++] = i;
+      }
+    }
+
+    previous_priority = priority;
+  }
+}
+
+typedef enum WebSGNetworkSendAction {
+  WebSGNetworkSendAction_Send,
+  WebSGNetworkSendAction_Defer,
+  WebSGNetworkSendAction_Drop,
+} WebSGNetworkSendAction;
+
+static int js_websg_network_get_send_action(
+  JSContext *ctx,
+  WebSGNetworkData *network_data,
+  NetworkOutboundMessageHeader *header,
+  WebSGNetworkSendMeta *meta
+) {
+  if (meta->channel == 0) {
+    return WebSGNetworkSendAction_Send;
+  }
+
+  WebSGNetworkSendQueue *queue = &network_data->send_queue;
+  WebSGNetworkChannel *channel = &network_data->channels[meta->channel - 1];
+  int held = WebSGNetworkSendAction_Defer;
+
+  if (!channel->reliable) {
+    held = WebSGNetworkSendAction_Drop;
+  } else if (channel->blocked || js_websg_network_is_peer_blocked(queue, meta->channel, header->peer_index)) {
+    return WebSGNetworkSendAction_Defer;
+  }
+
+  if (
+    channel->budget != 0 &&
+    channel->budget_used != 0 &&
+    channel->budget_used + header->byte_length > channel->budget
+  ) {
+    // Later messages on a reliable channel can't overtake this one.
+    channel->blocked = channel->reliable;
+    return held;
+  }
+
+  if (channel->max_backlog != 0 && header->peer_index != NETWORK_BROADCAST_PEER_INDEX) {
+    uint32_t backlog;
+
+    if (js_websg_network_get_peer_backlog(ctx, queue, header->peer_index, &backlog) == -1) {
+      return -1;
+    }
+
+    if (backlog > channel->max_backlog) {
+      if (channel->reliable && js_websg_network_block_peer(ctx, queue, meta->channel, header->peer_index) == -1) {
+        return -1;
+      }
+
+      return held;
+    }
+  }
+
+  return WebSGNetworkSendAction_Send;
+}
+
+// Held back messages are moved to the front of the queue, in their original order, and keep their keys.
+static int js_websg_network_compact_send_queue(JSContext *ctx, WebSGNetworkSendQueue *queue) {
+  uint32_t deferred_byte_length = 0;
+
+  for (uint32_t i = 0; i < queue->count; i++) {
+    if (queue->deferred[i]) {
+      deferred_byte_length += queue->headers[i].byte_length;
+    }
+  }
+
+  if (deferred_byte_length > queue->deferred_payloads_capacity) {
+    uint8_t *deferred_payloads = js_realloc(ctx, queue->deferred_payloads, deferred_byte_length);
+
+    if (deferred_payloads == NULL) {
+      return -1;
+    }
+
+    queue->deferred_payloads = deferred_payloads;
+    queue->deferred_payloads_capacity = deferred_byte_length;
+  }
+
+  if (queue->key_count > 0) {
+    memset(queue->keys, 0, sizeof(WebSGNetworkSendKey) * queue->key_capacity);
+    queue->key_count = 0;
+  }
+
+  uint32_t count = 0;
+  uint32_t byte_offset = 0;
+
+  for (uint32_t i = 0; i < queue->count; i++) {
+    if (!queue->deferred[i]) {
+      continue;
+    }
+
+    NetworkOutboundMessageHeader header = queue->headers[i];
+    WebSGNetworkSendMeta meta = queue->meta[i];
+    memcpy(queue->deferred_payloads + byte_offset, queue->payloads + header.byte_offset, header.byte_length);
+    header.byte_offset = byte_offset;
+    byte_offset += header.byte_length;
+
+    queue->headers[count] = header;
+    queue->meta[count] = meta;
+    count++;
+
+    if (meta.has_key) {
+      if (js_websg_network_reserve_send_keys(ctx, queue) == -1) {
+        return -1;
+      }
+
+      WebSGNetworkSendKey *send_key = js_websg_network_find_send_key(queue, header.peer_index, meta.key);
+      send_key->peer_index = header.peer_index;
+      send_key->key = meta.key;
+      send_key->message_index = count;
+      queue->key_count++;
+    }
+  }
+
+  if (byte_offset > 0) {
+    memcpy(queue->payloads, queue->deferred_payloads, byte_offset);
+  }
+
+  queue->count = count;
+  queue->payloads_byte_length = byte_offset;
+
+  return 0;
+}
+
+// Applies channel priorities, budgets and backpressure, then sends what's left with a single import call.
+static int32_t js_websg_network_flush_channels(JSContext *ctx, WebSGNetworkData *network_data) {
+  WebSGNetworkSendQueue *queue = &network_data->send_queue;
+
+  if (js_websg_network_reserve_flush_scratch(ctx, queue) == -1) {
+    return -1;
+  }
+
+  for (uint32_t i = 0; i < network_data->channel_count; i++) {
+    WebSGNetworkChannel *channel = &network_data->channels[i];
+    channel->budget_used = 0;
+    channel->blocked = 0;
+    channel->sent_byte_length = 0;
+    channel->deferred_count = 0;
+  }
+
+  queue->blocked_peer_count = 0;
+  queue->peer_backlog_count = 0;
+
+  js_websg_network_sort_send_queue(network_data);
+
+  uint32_t sent_count = 0;
+  uint32_t deferred_count = 0;
+
+  for (uint32_t i = 0; i < queue->count; i++) {
+    uint32_t index = queue->order[i];
+    NetworkOutboundMessageHeader *header = &queue->headers[index];
+    WebSGNetworkSendMeta *meta = &queue->meta[index];
+
+    int action = js_websg_network_get_send_action(ctx, network_data, header, meta);
+
+    if (action == -1) {
+      return -1;
+    }
+
+    queue->deferred[index] = action == WebSGNetworkSendAction_Defer;
+
+    if (meta->channel == 0) {
+      queue->sent[sent_count++] = *header;
+      continue;
+    }
+
+    WebSGNetworkChannel *channel = &network_data->channels[meta->channel - 1];
+
+    if (action == WebSGNetworkSendAction_Send) {
+      queue->sent[sent_count++] = *header;
+      channel->budget_used += header->byte_length;
+      channel->sent_byte_length += header->byte_length;
+      channel->queued_byte_length -= header->byte_length;
+    } else if (action == WebSGNetworkSendAction_Drop) {
+      channel->dropped_count++;
+      channel->queued_byte_length -= header->byte_length;
+    } else {
+      channel->deferred_count++;
+      deferred_count++;
+    }
+  }
+
+  int32_t result = 0;
+
+  if (sent_count > 0) {
+    result = websg_network_send_batch(queue->sent, sent_count, queue->payloads, queue->payloads_byte_length);
+  }
+
+  if (deferred_count == 0) {
+    queue->count = 0;
+    queue->payloads_byte_length = 0;
+
+    if (queue->key_count > 0) {
+      memset(queue->keys, 0, sizeof(WebSGNetworkSendKey) * queue->key_capacity);
+      queue->key_count = 0;
+    }
+  } else if (js_websg_network_compact_send_queue(ctx, queue) == -1) {
+    return -1;
+  }
+
+  return result;
+}
+
+// Sends everything queued since the last flush with a single import call. Called after every world update.
+int32_t js_websg_network_flush(JSContext *ctx, JSValue network) {
+  WebSGNetworkData *network_data = JS_GetOpaque(network, js_websg_network_class_id);
+  WebSGNetworkSendQueue *queue = &network_data->send_queue;
+
+  // Runs even when the queue is empty, so the channels' stats are reset.
+  if (network_data->channel_count > 0) {
+    return js_websg_network_flush_channels(ctx, network_data);
+  }
+
+  if (queue->count == 0) {
+    return 0;
+  }
+
+  int32_t result = websg_network_send_batch(
+    queue->headers,
+    queue->count,
+    queue->payloads,
+    queue->payloads_byte_length
+  );
+
+  queue->count = 0;
+  queue->payloads_byte_length = 0;
+
+  if (queue->key_count > 0) {
+    memset(queue->keys, 0, sizeof(WebSGNetworkSendKey) * queue->key_capacity);
+    queue->key_count = 0;
+  }
+
+  return result;
+}
+
+int32_t js_websg_network_refresh_interest(JSContext *ctx, JSValue network) {
+  WebSGNetworkData *network_data = JS_GetOpaque(network, js_websg_network_class_id);
+
+  if (!network_data->interest.enabled) {
+    return 0;
+  }
+
+  if (js_websg_interest_refresh(ctx, &network_data->interest) == -1) {
+    return js_handle_exception(ctx, JS_EXCEPTION);
+  }
+
+  return 0;
+}
+
+int32_t js_websg_network_receive_replicator_states(JSContext *ctx, JSValue network, float_t time) {
+  WebSGNetworkData *network_data = JS_GetOpaque(network, js_websg_network_class_id);
+
+  for (WebSGReplicatorState *state = network_data->replicator_states; state != NULL; state = state->next) {
+    if (js_websg_replicator_state_receive(ctx, state, time) == -1) {
+      return js_handle_exception(ctx, JS_EXCEPTION);
+    }
+  }
+
+  return 0;
+}
+
+int32_t js_websg_network_send_replicator_states(JSContext *ctx, JSValue network) {
+  WebSGNetworkData *network_data = JS_GetOpaque(network, js_websg_network_class_id);
+
+  for (WebSGReplicatorState *state = network_data->replicator_states; state != NULL; state = state->next) {
+    if (js_websg_replicator_state_send(ctx, state, &network_data->interest) == -1) {
+      return js_handle_exception(ctx, JS_EXCEPTION);
+    }
+  }
+
+  return 0;
+}
+
 int32_t js_websg_network_local_peer_entered(JSContext *ctx, JSValue network) {
   uint32_t local_peer_index = websg_network_get_local_peer_index();
 
@@ -190,24 +1162,18 @@ int32_t js_websg_network_peer_entered(JSContext *ctx, JSValue network, uint32_t
 
   JS_SetPropertyUint32(ctx, network_data->peers, peer_index, peer);
 
-  JSValue network_on_peer_entered_func = JS_GetPropertyStr(ctx, network, "onpeerentered");
+  if (js_websg_interest_add_peer(ctx, &network_data->interest, peer_index) == -1) {
+    return js_handle_exception(ctx, JS_EXCEPTION);
+  }
 
-  if (js_handle_exception(ctx, network_on_peer_entered_func) < 0) {
-    return -1;
-  } else if (JS_IsUndefined(network_on_peer_entered_func)) {
-    return 0;
+  for (WebSGReplicatorState *state = network_data->replicator_states; state != NULL; state = state->next) {
+    if (js_websg_replicator_state_add_keyframe_peer(ctx, state, peer_index) == -1) {
+      return js_handle_exception(ctx, JS_EXCEPTION);
+    }
   }
 
   JSValueConst args[] = { peer };
-  JSValue val = JS_Call(ctx, network_on_peer_entered_func, JS_UNDEFINED, 1, args);
-  JS_FreeValue(ctx, network_on_peer_entered_func);
-
-  if (js_handle_exception(ctx, val) < 0) {
-    return -1;
-  } else {
-    JS_FreeValue(ctx, val);
-    return 0;
-  }
+  return js_call_hook(ctx, JSHook_NetworkPeerEntered, 1, args);
 }
 
 int32_t js_websg_network_peer_exited(JSContext *ctx, JSValue network, uint32_t peer_index) {
@@ -219,22 +1185,10 @@ int32_t js_websg_network_peer_exited(JSContext *ctx, JSValue network, uint32_t p
     return -1;
   }
 
-  JSValue network_on_peer_exited_func = JS_GetPropertyStr(ctx, network, "onpeerexited");
-
-  if (js_handle_exception(ctx, network_on_peer_exited_func) < 0) {
-    return -1;
-  } else if (JS_IsUndefined(network_on_peer_exited_func)) {
-    return 0;
-  }
+  js_websg_interest_remove_peer(&network_data->interest, peer_index);
 
   JSValueConst args[] = { peer };
-  JSValue val = JS_Call(ctx, network_on_peer_exited_func, JS_UNDEFINED, 1, args);
-  JS_FreeValue(ctx, network_on_peer_exited_func);
-
-  if (js_handle_exception(ctx, val) < 0) {
-    return -1;
-  } else {
-    JS_FreeValue(ctx, val);
-    return 0;
-  }
-}
\ No newline at end of file
+  int32_t result = js_call_hook(ctx, JSHook_NetworkPeerExited, 1, args);
+  JS_FreeValue(ctx, peer);
+  return result;
+}
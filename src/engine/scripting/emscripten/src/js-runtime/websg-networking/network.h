@@ -1,11 +1,102 @@
 #ifndef __js_websg_network_h
 #define __js_websg_network_h
 #include "../quickjs/quickjs.h"
+#include "../utils/handle-table.h"
+#include "../../websg-networking.h"
+#include "./replicator-state.h"
+#include "./interest.h"
+
+typedef struct WebSGNetworkSendKey {
+  uint32_t peer_index;
+  uint32_t key;
+  // Index of the message in the send queue + 1, 0 when the slot is empty.
+  uint32_t message_index;
+} WebSGNetworkSendKey;
+
+typedef struct WebSGNetworkSendMeta {
+  // Channel index + 1, 0 for messages queued without a channel.
+  uint32_t channel;
+  uint32_t key;
+  int has_key;
+} WebSGNetworkSendMeta;
+
+// A reliable channel's messages to a peer that were held back this flush, so later ones can't overtake them.
+typedef struct WebSGNetworkBlockedPeer {
+  uint32_t channel;
+  uint32_t peer_index;
+} WebSGNetworkBlockedPeer;
+
+typedef struct WebSGNetworkPeerBacklog {
+  uint32_t peer_index;
+  uint32_t backlog;
+} WebSGNetworkPeerBacklog;
+
+// Messages queued with network.queue() and peer.queue(), sent together at the end of the tick.
+// Keyed messages replace the payload of the earlier message with the same peer and key, keeping its position.
+// Messages held back by a channel's budget or backpressure stay at the front of the queue for the next flush.
+typedef struct WebSGNetworkSendQueue {
+  NetworkOutboundMessageHeader *headers;
+  WebSGNetworkSendMeta *meta;
+  uint32_t count;
+  uint32_t capacity;
+  uint8_t *payloads;
+  uint32_t payloads_byte_length;
+  uint32_t payloads_capacity;
+  WebSGNetworkSendKey *keys;
+  uint32_t key_count;
+  uint32_t key_capacity;
+  // Reused between flushes when channels are defined.
+  uint32_t *order;
+  NetworkOutboundMessageHeader *sent;
+  uint8_t *deferred;
+  uint32_t scratch_capacity;
+  uint8_t *deferred_payloads;
+  uint32_t deferred_payloads_capacity;
+  WebSGNetworkBlockedPeer *blocked_peers;
+  uint32_t blocked_peer_count;
+  uint32_t blocked_peer_capacity;
+  WebSGNetworkPeerBacklog *peer_backlogs;
+  uint32_t peer_backlog_count;
+  uint32_t peer_backlog_capacity;
+} WebSGNetworkSendQueue;
+
+// Defined with network.defineChannel(). Messages on higher priority channels are sent first. Reliable channels hold
+// messages over their budget or to backed up peers until the next flush, unreliable channels drop them.
+typedef struct WebSGNetworkChannel {
+  int reliable;
+  int32_t priority;
+  // Bytes sent per flush, 0 for no limit. Broadcasts count once, the first message of a flush is always sent.
+  uint32_t budget;
+  // Peer backlog in bytes above which messages to that peer are held back, 0 for no limit. Broadcasts aren't held.
+  uint32_t max_backlog;
+  // Bytes that can be queued on the channel, 0 for no limit. Messages that don't fit are rejected when queued.
+  uint32_t max_queued_byte_length;
+  // Bytes queued and not sent yet, including messages held back by earlier flushes.
+  uint32_t queued_byte_length;
+  // Bytes sent and messages held back by the last flush.
+  uint32_t sent_byte_length;
+  uint32_t deferred_count;
+  // Unreliable messages dropped and messages rejected by a full queue since the channel was defined.
+  uint32_t dropped_count;
+  // Flush state.
+  uint32_t budget_used;
+  int blocked;
+} WebSGNetworkChannel;
 
 typedef struct WebSGNetworkData {
   JSValue peers;
-  JSValue replicators;
+  JSHandleTable replicators;
   JSValue replications;
+  WebSGNetworkSendQueue send_queue;
+  WebSGNetworkChannel *channels;
+  uint32_t channel_count;
+  uint32_t channel_capacity;
+  // States defined with replicator.defineState(), most recently defined first.
+  WebSGReplicatorState *replicator_states;
+  // Created by the first network.getPeerPoses() call.
+  JSValue peer_poses;
+  // Set with network.setInterest(), disabled by default.
+  WebSGInterest interest;
 } WebSGNetworkData;
 
 extern JSClassID js_websg_network_class_id;
@@ -16,6 +107,39 @@ JSValue js_websg_new_network(JSContext *ctx);
 
 void js_websg_network(JSContext *ctx, JSValue websg_networking);
 
+// Copies the message into the send queue. Pass has_key to coalesce it with earlier messages using the same key.
+// channel is the channel index + 1, or 0 to send the message outside of any channel.
+int32_t js_websg_network_queue_message(
+  JSContext *ctx,
+  WebSGNetworkData *network_data,
+  uint32_t peer_index,
+  JSValueConst message,
+  int reliable,
+  uint32_t channel,
+  int has_key,
+  uint32_t key
+);
+
+// Parses the (message, reliable | channel = true, key?) arguments shared by network.queue() and peer.queue().
+JSValue js_websg_network_queue_message_args(
+  JSContext *ctx,
+  WebSGNetworkData *network_data,
+  uint32_t peer_index,
+  int argc,
+  JSValueConst *argv
+);
+
+int32_t js_websg_network_flush(JSContext *ctx, JSValue network);
+
+// Reads remote peer positions for interest management. Called before every world update while it's enabled.
+int32_t js_websg_network_refresh_interest(JSContext *ctx, JSValue network);
+
+// Applies received replicator state snapshots to remote nodes. Called before every world update.
+int32_t js_websg_network_receive_replicator_states(JSContext *ctx, JSValue network, float_t time);
+
+// Queues snapshots of local replicator state. Called after every world update, before the flush.
+int32_t js_websg_network_send_replicator_states(JSContext *ctx, JSValue network);
+
 int32_t js_websg_network_local_peer_entered(JSContext *ctx, JSValue network);
 
 int32_t js_websg_network_peer_entered(JSContext *ctx, JSValue network, uint32_t peer_index);
@@ -0,0 +1,285 @@
+#include "../quickjs/cutils.h"
+#include "../quickjs/quickjs.h"
+#include "../../websg-networking.h"
+#include "../utils/typedarray.h"
+#include "./peer.h"
+#include "./peer-poses.h"
+
+JSClassID js_websg_peer_poses_class_id;
+
+/**
+ * Class Definition
+ **/
+
+static void js_websg_peer_poses_finalizer(JSRuntime *rt, JSValue val) {
+  WebSGPeerPosesData *peer_poses_data = JS_GetOpaque(val, js_websg_peer_poses_class_id);
+
+  if (peer_poses_data) {
+    JS_FreeValueRT(rt, peer_poses_data->buffer);
+    JS_FreeValueRT(rt, peer_poses_data->translations);
+    JS_FreeValueRT(rt, peer_poses_data->rotations);
+    js_free_rt(rt, peer_poses_data->peer_indices);
+    js_free_rt(rt, peer_poses_data);
+  }
+}
+
+static JSClassDef js_websg_peer_poses_class = {
+  "PeerPoses",
+  .finalizer = js_websg_peer_poses_finalizer
+};
+
+static JSValue js_websg_peer_poses_get_count(JSContext *ctx, JSValueConst this_val) {
+  WebSGPeerPosesData *peer_poses_data = JS_GetOpaque2(ctx, this_val, js_websg_peer_poses_class_id);
+
+  if (peer_poses_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_NewUint32(ctx, peer_poses_data->count);
+}
+
+static JSValue js_websg_peer_poses_get_translations(JSContext *ctx, JSValueConst this_val) {
+  WebSGPeerPosesData *peer_poses_data = JS_GetOpaque2(ctx, this_val, js_websg_peer_poses_class_id);
+
+  if (peer_poses_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_DupValue(ctx, peer_poses_data->translations);
+}
+
+static JSValue js_websg_peer_poses_get_rotations(JSContext *ctx, JSValueConst this_val) {
+  WebSGPeerPosesData *peer_poses_data = JS_GetOpaque2(ctx, this_val, js_websg_peer_poses_class_id);
+
+  if (peer_poses_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_DupValue(ctx, peer_poses_data->rotations);
+}
+
+static JSValue js_websg_peer_poses_get_peer(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGPeerPosesData *peer_poses_data = JS_GetOpaque2(ctx, this_val, js_websg_peer_poses_class_id);
+
+  if (peer_poses_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  uint32_t index;
+
+  if (JS_ToUint32(ctx, &index, argv[0]) == -1) {
+    return JS_EXCEPTION;
+  }
+
+  if (index >= peer_poses_data->count) {
+    return JS_ThrowRangeError(ctx, "WebSGNetworking: peer pose index out of range.");
+  }
+
+  return js_websg_get_peer(ctx, peer_poses_data->network_data, peer_poses_data->peer_indices[index]);
+}
+
+static const JSCFunctionListEntry js_websg_peer_poses_proto_funcs[] = {
+  JS_CGETSET_DEF("count", js_websg_peer_poses_get_count, NULL),
+  JS_CGETSET_DEF("translations", js_websg_peer_poses_get_translations, NULL),
+  JS_CGETSET_DEF("rotations", js_websg_peer_poses_get_rotations, NULL),
+  JS_CFUNC_DEF("getPeer", 1, js_websg_peer_poses_get_peer),
+  JS_PROP_STRING_DEF("[Symbol.toStringTag]", "PeerPoses", JS_PROP_CONFIGURABLE),
+};
+
+static JSValue js_websg_peer_poses_constructor(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  return JS_ThrowTypeError(ctx, "Illegal Constructor.");
+}
+
+void js_websg_define_peer_poses(JSContext *ctx, JSValue websg_networking) {
+  JS_NewClassID(&js_websg_peer_poses_class_id);
+  JS_NewClass(JS_GetRuntime(ctx), js_websg_peer_poses_class_id, &js_websg_peer_poses_class);
+  JSValue peer_poses_proto = JS_NewObject(ctx);
+  JS_SetPropertyFunctionList(
+    ctx,
+    peer_poses_proto,
+    js_websg_peer_poses_proto_funcs,
+    countof(js_websg_peer_poses_proto_funcs)
+  );
+  JS_SetClassProto(ctx, js_websg_peer_poses_class_id, peer_poses_proto);
+
+  JSValue constructor = JS_NewCFunction2(
+    ctx,
+    js_websg_peer_poses_constructor,
+    "PeerPoses",
+    0,
+    JS_CFUNC_constructor,
+    0
+  );
+  JS_SetConstructor(ctx, constructor, peer_poses_proto);
+  JS_SetPropertyStr(
+    ctx,
+    websg_networking,
+    "PeerPoses",
+    constructor
+  );
+}
+
+/**
+ * Public Methods
+ **/
+
+static void js_websg_peer_poses_buffer_free(JSRuntime *rt, void *opaque, void *ptr) {
+  js_free_rt(rt, ptr);
+}
+
+// The poses live in an ArrayBuffer, so views a script held on to stay valid after the buffer is replaced.
+static int js_websg_peer_poses_reserve(JSContext *ctx, WebSGPeerPosesData *peer_poses_data, uint32_t count) {
+  if (count <= peer_poses_data->capacity) {
+    return 0;
+  }
+
+  uint32_t capacity = peer_poses_data->capacity == 0 ? 16 : peer_poses_data->capacity;
+
+  while (capacity < count) {
+    capacity *= 2;
+  }
+
+  uint32_t *peer_indices = js_realloc(ctx, peer_poses_data->peer_indices, sizeof(uint32_t) * capacity);
+
+  if (peer_indices == NULL) {
+    return -1;
+  }
+
+  peer_poses_data->peer_indices = peer_indices;
+
+  float_t *poses = js_mallocz(ctx, sizeof(float_t) * 7 * capacity);
+
+  if (poses == NULL) {
+    return -1;
+  }
+
+  JSValue buffer = JS_NewArrayBuffer(
+    ctx,
+    (uint8_t *)poses,
+    sizeof(float_t) * 7 * capacity,
+    js_websg_peer_poses_buffer_free,
+    NULL,
+    0
+  );
+
+  if (JS_IsException(buffer)) {
+    js_free(ctx, poses);
+    return -1;
+  }
+
+  JS_FreeValue(ctx, peer_poses_data->buffer);
+  peer_poses_data->buffer = buffer;
+  peer_poses_data->poses = poses;
+  peer_poses_data->capacity = capacity;
+  // Forces the views to be recreated over the new buffer.
+  peer_poses_data->view_count = UINT32_MAX;
+
+  return 0;
+}
+
+static int js_websg_peer_poses_update_views(JSContext *ctx, WebSGPeerPosesData *peer_poses_data) {
+  uint32_t count = peer_poses_data->count;
+
+  if (count == peer_poses_data->view_count) {
+    return 0;
+  }
+
+  JSValue translations = js_new_typed_array_subview(ctx, JSTypedArrayType_Float32, peer_poses_data->buffer, 0, count * 3);
+
+  if (JS_IsException(translations)) {
+    return -1;
+  }
+
+  JSValue rotations = js_new_typed_array_subview(
+    ctx,
+    JSTypedArrayType_Float32,
+    peer_poses_data->buffer,
+    sizeof(float_t) * count * 3,
+    count * 4
+  );
+
+  if (JS_IsException(rotations)) {
+    JS_FreeValue(ctx, translations);
+    return -1;
+  }
+
+  JS_FreeValue(ctx, peer_poses_data->translations);
+  JS_FreeValue(ctx, peer_poses_data->rotations);
+  peer_poses_data->translations = translations;
+  peer_poses_data->rotations = rotations;
+  peer_poses_data->view_count = count;
+
+  return 0;
+}
+
+static JSValue js_websg_new_peer_poses(JSContext *ctx, WebSGNetworkData *network_data) {
+  JSValue peer_poses = JS_NewObjectClass(ctx, js_websg_peer_poses_class_id);
+
+  if (JS_IsException(peer_poses)) {
+    return peer_poses;
+  }
+
+  WebSGPeerPosesData *peer_poses_data = js_mallocz(ctx, sizeof(WebSGPeerPosesData));
+
+  if (peer_poses_data == NULL) {
+    JS_FreeValue(ctx, peer_poses);
+    return JS_EXCEPTION;
+  }
+
+  peer_poses_data->network_data = network_data;
+  peer_poses_data->buffer = JS_UNDEFINED;
+  peer_poses_data->translations = JS_UNDEFINED;
+  peer_poses_data->rotations = JS_UNDEFINED;
+  JS_SetOpaque(peer_poses, peer_poses_data);
+
+  if (js_websg_peer_poses_reserve(ctx, peer_poses_data, 1) == -1) {
+    JS_FreeValue(ctx, peer_poses);
+    return JS_EXCEPTION;
+  }
+
+  return peer_poses;
+}
+
+JSValue js_websg_network_get_peer_poses(JSContext *ctx, WebSGNetworkData *network_data) {
+  if (JS_IsUndefined(network_data->peer_poses)) {
+    network_data->peer_poses = js_websg_new_peer_poses(ctx, network_data);
+
+    if (JS_IsException(network_data->peer_poses)) {
+      network_data->peer_poses = JS_UNDEFINED;
+      return JS_EXCEPTION;
+    }
+  }
+
+  WebSGPeerPosesData *peer_poses_data = JS_GetOpaque(network_data->peer_poses, js_websg_peer_poses_class_id);
+
+  int32_t count = websg_network_get_peer_poses(
+    peer_poses_data->peer_indices,
+    peer_poses_data->poses,
+    peer_poses_data->capacity
+  );
+
+  // More peers than fit, grow and read them again.
+  if (count > (int32_t)peer_poses_data->capacity) {
+    if (js_websg_peer_poses_reserve(ctx, peer_poses_data, count) == -1) {
+      return JS_EXCEPTION;
+    }
+
+    count = websg_network_get_peer_poses(
+      peer_poses_data->peer_indices,
+      peer_poses_data->poses,
+      peer_poses_data->capacity
+    );
+  }
+
+  if (count < 0 || count > (int32_t)peer_poses_data->capacity) {
+    return JS_ThrowInternalError(ctx, "WebSGNetworking: Error getting peer poses.");
+  }
+
+  peer_poses_data->count = count;
+
+  if (js_websg_peer_poses_update_views(ctx, peer_poses_data) == -1) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_DupValue(ctx, network_data->peer_poses);
+}
@@ -0,0 +1,29 @@
+#ifndef __websg_network_peer_poses_js_h
+#define __websg_network_peer_poses_js_h
+#include "../quickjs/quickjs.h"
+#include "../../websg-networking.h"
+#include "./network.h"
+
+typedef struct WebSGPeerPosesData {
+  WebSGNetworkData *network_data;
+  uint32_t count;
+  uint32_t capacity;
+  uint32_t *peer_indices;
+  // capacity * 7 floats owned by buffer, count translations followed by count rotations.
+  float_t *poses;
+  JSValue buffer;
+  // Views over the first count poses, recreated when the count or buffer changes.
+  JSValue translations;
+  JSValue rotations;
+  uint32_t view_count;
+} WebSGPeerPosesData;
+
+extern JSClassID js_websg_peer_poses_class_id;
+
+void js_websg_define_peer_poses(JSContext *ctx, JSValue websg_networking);
+
+// Reads every peer's pose with one import call into the network's PeerPoses, which is created on first use and
+// reused after that.
+JSValue js_websg_network_get_peer_poses(JSContext *ctx, WebSGNetworkData *network_data);
+
+#endif
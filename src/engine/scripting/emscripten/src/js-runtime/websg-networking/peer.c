@@ -55,6 +55,64 @@ static JSValue js_websg_peer_get_is_local(JSContext *ctx, JSValueConst this_val)
   return JS_NewBool(ctx, result);
 }
 
+// The translation and rotation wrappers are created on first access and cached on the peer, most peers' poses are
+// never read through them.
+static JSValue js_websg_peer_get_translation(JSContext *ctx, JSValueConst this_val) {
+  WebSGPeerData *peer_data = JS_GetOpaque2(ctx, this_val, js_websg_peer_class_id);
+
+  if (peer_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  if (js_websg_define_vector3_prop_read_only(
+    ctx,
+    this_val,
+    "translation",
+    peer_data->peer_index,
+    &websg_peer_get_translation_element
+  ) == -1) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_GetPropertyStr(ctx, this_val, "translation");
+}
+
+static JSValue js_websg_peer_get_rotation(JSContext *ctx, JSValueConst this_val) {
+  WebSGPeerData *peer_data = JS_GetOpaque2(ctx, this_val, js_websg_peer_class_id);
+
+  if (peer_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  if (js_websg_define_quaternion_prop_read_only(
+    ctx,
+    this_val,
+    "rotation",
+    peer_data->peer_index,
+    &websg_peer_get_rotation_element
+  ) == -1) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_GetPropertyStr(ctx, this_val, "rotation");
+}
+
+static JSValue js_websg_peer_get_stat(JSContext *ctx, JSValueConst this_val, int magic) {
+  WebSGPeerData *peer_data = JS_GetOpaque2(ctx, this_val, js_websg_peer_class_id);
+
+  if (peer_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  NetworkPeerStats stats;
+
+  if (websg_peer_get_stats(peer_data->peer_index, &stats) == -1) {
+    return JS_ThrowInternalError(ctx, "WebSGNetworking: Error getting peer stats.");
+  }
+
+  return magic == 0 ? JS_NewUint32(ctx, stats.backlog) : JS_NewFloat64(ctx, stats.rtt);
+}
+
 static JSValue js_websg_peer_send(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
   WebSGPeerData *peer_data = JS_GetOpaque(this_val, js_websg_peer_class_id);
 
@@ -92,11 +150,21 @@ static JSValue js_websg_peer_send(JSContext *ctx, JSValueConst this_val, int arg
   return JS_EXCEPTION;
 }
 
+static JSValue js_websg_peer_queue(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGPeerData *peer_data = JS_GetOpaque(this_val, js_websg_peer_class_id);
+  return js_websg_network_queue_message_args(ctx, peer_data->network_data, peer_data->peer_index, argc, argv);
+}
+
 static const JSCFunctionListEntry js_websg_peer_proto_funcs[] = {
   JS_CGETSET_DEF("id", js_websg_peer_get_id, NULL),
   JS_CGETSET_DEF("isHost", js_websg_peer_get_is_host, NULL),
   JS_CGETSET_DEF("isLocal", js_websg_peer_get_is_local, NULL),
+  JS_CGETSET_DEF("translation", js_websg_peer_get_translation, NULL),
+  JS_CGETSET_DEF("rotation", js_websg_peer_get_rotation, NULL),
+  JS_CGETSET_MAGIC_DEF("backlog", js_websg_peer_get_stat, NULL, 0),
+  JS_CGETSET_MAGIC_DEF("rtt", js_websg_peer_get_stat, NULL, 1),
   JS_CFUNC_DEF("send", 2, js_websg_peer_send),
+  JS_CFUNC_DEF("queue", 3, js_websg_peer_queue),
   JS_PROP_STRING_DEF("[Symbol.toStringTag]", "Peer", JS_PROP_CONFIGURABLE),
 };
 
@@ -145,26 +213,16 @@ JSValue js_websg_create_peer(JSContext *ctx, WebSGNetworkData *network_data, uin
   }
 
   WebSGPeerData *peer_data = js_mallocz(ctx, sizeof(WebSGPeerData));
+
+  if (peer_data == NULL) {
+    JS_FreeValue(ctx, peer);
+    return JS_EXCEPTION;
+  }
+
   peer_data->network_data = network_data;
   peer_data->peer_index = peer_index;
   JS_SetOpaque(peer, peer_data);
 
-  js_websg_define_vector3_prop_read_only(
-    ctx,
-    peer,
-    "translation",
-    peer_index,
-    &websg_peer_get_translation_element
-  );
-
-  js_websg_define_quaternion_prop_read_only(
-    ctx,
-    peer,
-    "rotation",
-    peer_index,
-    &websg_peer_get_rotation_element
-  );
-
   return JS_DupValue(ctx, peer);
 }
 
@@ -0,0 +1,349 @@
+#include "../quickjs/cutils.h"
+#include "../quickjs/quickjs.h"
+#include "../../websg-networking.h"
+#include "../utils/typedarray.h"
+#include "../websg/node.h"
+#include "../websg/world.h"
+#include "./peer.h"
+#include "./replication-batch.h"
+
+JSClassID js_websg_replication_batch_class_id;
+
+/**
+ * Class Definition
+ **/
+
+static void js_websg_replication_batch_finalizer(JSRuntime *rt, JSValue val) {
+  WebSGReplicationBatchData *batch_data = JS_GetOpaque(val, js_websg_replication_batch_class_id);
+
+  if (batch_data) {
+    JS_FreeValueRT(rt, batch_data->arena);
+    js_free_rt(rt, batch_data);
+  }
+}
+
+static void js_websg_replication_batch_gc_mark(JSRuntime *rt, JSValueConst val, JS_MarkFunc *mark_func) {
+  WebSGReplicationBatchData *batch_data = JS_GetOpaque(val, js_websg_replication_batch_class_id);
+
+  if (batch_data) {
+    JS_MarkValue(rt, batch_data->arena, mark_func);
+  }
+}
+
+static JSClassDef js_websg_replication_batch_class = {
+  "ReplicationBatch",
+  .finalizer = js_websg_replication_batch_finalizer,
+  .gc_mark = js_websg_replication_batch_gc_mark
+};
+
+static ReplicationHeader *js_websg_replication_batch_get_header(
+  JSContext *ctx,
+  JSValueConst this_val,
+  JSValueConst index_arg,
+  WebSGReplicationBatchData **out_batch_data
+) {
+  WebSGReplicationBatchData *batch_data = JS_GetOpaque2(ctx, this_val, js_websg_replication_batch_class_id);
+
+  if (batch_data == NULL) {
+    return NULL;
+  }
+
+  uint32_t index;
+
+  if (JS_ToUint32(ctx, &index, index_arg) == -1) {
+    return NULL;
+  }
+
+  if (index >= batch_data->count) {
+    JS_ThrowRangeError(ctx, "WebSGNetworking: replication index out of range.");
+    return NULL;
+  }
+
+  *out_batch_data = batch_data;
+
+  return (ReplicationHeader *)batch_data->arena_data + index;
+}
+
+static JSValue js_websg_replication_batch_get_peer(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  WebSGReplicationBatchData *batch_data;
+  ReplicationHeader *header = js_websg_replication_batch_get_header(ctx, this_val, argv[0], &batch_data);
+
+  if (header == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return js_websg_get_peer(ctx, batch_data->network_data, header->peer_index);
+}
+
+// Returns a Uint8Array over the replication's payload in the arena, no bytes are copied.
+static JSValue js_websg_replication_batch_get_data(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  WebSGReplicationBatchData *batch_data;
+  ReplicationHeader *header = js_websg_replication_batch_get_header(ctx, this_val, argv[0], &batch_data);
+
+  if (header == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  // The headers are in the arena, which the script can write to.
+  if (
+    header->byte_offset > batch_data->arena_byte_length ||
+    header->byte_length > batch_data->arena_byte_length - header->byte_offset
+  ) {
+    return JS_ThrowRangeError(ctx, "WebSGNetworking: replication payload is outside of the arena.");
+  }
+
+  return js_new_typed_array_subview(ctx, JSTypedArrayType_Uint8, batch_data->arena, header->byte_offset, header->byte_length);
+}
+
+static JSValue js_websg_replication_batch_get_arena(JSContext *ctx, JSValueConst this_val) {
+  WebSGReplicationBatchData *batch_data = JS_GetOpaque2(ctx, this_val, js_websg_replication_batch_class_id);
+
+  if (batch_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_DupValue(ctx, batch_data->arena);
+}
+
+static JSValue js_websg_replication_batch_get_count(JSContext *ctx, JSValueConst this_val) {
+  WebSGReplicationBatchData *batch_data = JS_GetOpaque2(ctx, this_val, js_websg_replication_batch_class_id);
+
+  if (batch_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  return JS_NewUint32(ctx, batch_data->count);
+}
+
+static const JSCFunctionListEntry js_websg_replication_batch_proto_funcs[] = {
+  JS_CGETSET_DEF("arena", js_websg_replication_batch_get_arena, NULL),
+  JS_CGETSET_DEF("count", js_websg_replication_batch_get_count, NULL),
+  JS_CFUNC_DEF("getPeer", 1, js_websg_replication_batch_get_peer),
+  JS_CFUNC_DEF("getData", 1, js_websg_replication_batch_get_data),
+  JS_PROP_STRING_DEF("[Symbol.toStringTag]", "ReplicationBatch", JS_PROP_CONFIGURABLE),
+};
+
+static JSValue js_websg_replication_batch_constructor(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  return JS_ThrowTypeError(ctx, "Illegal Constructor.");
+}
+
+void js_websg_define_replication_batch(JSContext *ctx, JSValue websg_networking) {
+  JS_NewClassID(&js_websg_replication_batch_class_id);
+  JS_NewClass(JS_GetRuntime(ctx), js_websg_replication_batch_class_id, &js_websg_replication_batch_class);
+  JSValue replication_batch_proto = JS_NewObject(ctx);
+  JS_SetPropertyFunctionList(
+    ctx,
+    replication_batch_proto,
+    js_websg_replication_batch_proto_funcs,
+    countof(js_websg_replication_batch_proto_funcs)
+  );
+  JS_SetClassProto(ctx, js_websg_replication_batch_class_id, replication_batch_proto);
+
+  JSValue constructor = JS_NewCFunction2(
+    ctx,
+    js_websg_replication_batch_constructor,
+    "ReplicationBatch",
+    0,
+    JS_CFUNC_constructor,
+    0
+  );
+  JS_SetConstructor(ctx, constructor, replication_batch_proto);
+  JS_SetPropertyStr(
+    ctx,
+    websg_networking,
+    "ReplicationBatch",
+    constructor
+  );
+}
+
+/**
+ * Public Methods
+ **/
+
+// Creates the nodes for the batch's remote spawns, with one batch factory call when the replicator has one.
+static JSValue js_websg_replication_batch_create_nodes(
+  JSContext *ctx,
+  WebSGReplicatorData *replicator_data,
+  WebSGWorldData *world_data,
+  ReplicationHeader *headers,
+  uint32_t count
+) {
+  uint32_t remote_count = 0;
+
+  for (uint32_t i = 0; i < count; i++) {
+    if (headers[i].node_id == 0) {
+      remote_count++;
+    }
+  }
+
+  JSValue created_nodes = JS_UNDEFINED;
+
+  if (remote_count > 0 && !JS_IsUndefined(replicator_data->batch_factory_function)) {
+    JSValueConst args[] = { JS_NewUint32(ctx, remote_count) };
+    created_nodes = JS_Call(ctx, replicator_data->batch_factory_function, JS_UNDEFINED, 1, args);
+
+    if (JS_IsException(created_nodes)) {
+      return JS_EXCEPTION;
+    }
+
+    uint32_t length = 0;
+
+    if (JS_IsArray(ctx, created_nodes)) {
+      JSValue length_val = JS_GetPropertyStr(ctx, created_nodes, "length");
+      JS_ToUint32(ctx, &length, length_val);
+      JS_FreeValue(ctx, length_val);
+    }
+
+    if (length < remote_count) {
+      JS_FreeValue(ctx, created_nodes);
+      return JS_ThrowTypeError(
+        ctx,
+        "WebSGNetworking: replicator batch factory must return an array with a node for each spawn."
+      );
+    }
+  }
+
+  JSValue nodes = JS_NewArray(ctx);
+
+  if (JS_IsException(nodes)) {
+    JS_FreeValue(ctx, created_nodes);
+    return JS_EXCEPTION;
+  }
+
+  uint32_t created_index = 0;
+
+  for (uint32_t i = 0; i < count; i++) {
+    ReplicationHeader *header = &headers[i];
+    JSValue node;
+
+    if (header->node_id > 0) {
+      node = js_websg_get_node_by_id(ctx, world_data, header->node_id);
+    } else {
+      if (JS_IsUndefined(created_nodes)) {
+        node = JS_Call(ctx, replicator_data->factory_function, JS_UNDEFINED, 0, NULL);
+      } else {
+        node = JS_GetPropertyUint32(ctx, created_nodes, created_index++);
+      }
+
+      if (js_websg_replicator_init_remote_node(ctx, replicator_data, header->network_id, node) == -1) {
+        JS_FreeValue(ctx, node);
+        JS_FreeValue(ctx, nodes);
+        JS_FreeValue(ctx, created_nodes);
+        return JS_EXCEPTION;
+      }
+    }
+
+    JS_SetPropertyUint32(ctx, nodes, i, node);
+  }
+
+  JS_FreeValue(ctx, created_nodes);
+
+  return nodes;
+}
+
+// The batch reads from the arena, so it is only valid until the arena is passed to spawnedBatch or despawnedBatch
+// again. Its nodes stay valid.
+JSValue js_websg_receive_replication_batch(
+  JSContext *ctx,
+  WebSGReplicatorData *replicator_data,
+  WebSGReplicatorIteratorType type,
+  JSValueConst arena
+) {
+  size_t arena_byte_length;
+  uint8_t *arena_data = JS_GetArrayBuffer(ctx, &arena_byte_length, arena);
+
+  if (arena_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  int32_t count;
+
+  if (type == WebSGReplicatorIteratorType_Spawned) {
+    count = websg_replicator_spawned_receive_batch(replicator_data->replicator_id, arena_data, arena_byte_length);
+  } else {
+    count = websg_replicator_despawned_receive_batch(replicator_data->replicator_id, arena_data, arena_byte_length);
+  }
+
+  if (count == -1) {
+    JS_ThrowRangeError(ctx, "WebSGNetworking: error receiving replications, the arena may be too small.");
+    return JS_EXCEPTION;
+  }
+
+  if ((size_t)count * sizeof(ReplicationHeader) > arena_byte_length) {
+    JS_ThrowRangeError(ctx, "WebSGNetworking: replication headers are outside of the arena.");
+    return JS_EXCEPTION;
+  }
+
+  JSValue global = JS_GetGlobalObject(ctx);
+  JSValue world = JS_GetPropertyStr(ctx, global, "world");
+  WebSGWorldData *world_data = JS_GetOpaque2(ctx, world, js_websg_world_class_id);
+  JS_FreeValue(ctx, world);
+  JS_FreeValue(ctx, global);
+
+  if (world_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  JSValue nodes = js_websg_replication_batch_create_nodes(
+    ctx,
+    replicator_data,
+    world_data,
+    (ReplicationHeader *)arena_data,
+    count
+  );
+
+  if (JS_IsException(nodes)) {
+    return JS_EXCEPTION;
+  }
+
+  JSValue replication_batch = JS_NewObjectClass(ctx, js_websg_replication_batch_class_id);
+
+  if (JS_IsException(replication_batch)) {
+    JS_FreeValue(ctx, nodes);
+    return replication_batch;
+  }
+
+  WebSGReplicationBatchData *batch_data = js_mallocz(ctx, sizeof(WebSGReplicationBatchData));
+
+  if (batch_data == NULL) {
+    JS_FreeValue(ctx, nodes);
+    JS_FreeValue(ctx, replication_batch);
+    return JS_EXCEPTION;
+  }
+
+  batch_data->network_data = replicator_data->network_data;
+  batch_data->arena = JS_DupValue(ctx, arena);
+  batch_data->arena_data = arena_data;
+  batch_data->arena_byte_length = arena_byte_length;
+  batch_data->count = count;
+  JS_SetOpaque(replication_batch, batch_data);
+
+  // Each header is 5 uint32s: node id, network id, peer index, byte offset and byte length.
+  JSValue headers = js_new_typed_array_subview(ctx, JSTypedArrayType_Uint32, arena, 0, count * 5);
+
+  if (JS_IsException(headers)) {
+    JS_FreeValue(ctx, nodes);
+    JS_FreeValue(ctx, replication_batch);
+    return JS_EXCEPTION;
+  }
+
+  JS_DefinePropertyValueStr(ctx, replication_batch, "headers", headers, JS_PROP_ENUMERABLE);
+  JS_DefinePropertyValueStr(ctx, replication_batch, "nodes", nodes, JS_PROP_ENUMERABLE);
+
+  return replication_batch;
+}
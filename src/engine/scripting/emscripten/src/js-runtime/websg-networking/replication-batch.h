@@ -0,0 +1,30 @@
+#ifndef __websg_network_replication_batch_js_h
+#define __websg_network_replication_batch_js_h
+#include "../quickjs/quickjs.h"
+#include "../../websg-networking.h"
+#include "./network.h"
+#include "./replicator.h"
+#include "./replication-iterator.h"
+
+typedef struct WebSGReplicationBatchData {
+  WebSGNetworkData *network_data;
+  // Held by the batch so arena_data stays valid for as long as the batch is alive.
+  JSValue arena;
+  uint8_t *arena_data;
+  size_t arena_byte_length;
+  uint32_t count;
+} WebSGReplicationBatchData;
+
+extern JSClassID js_websg_replication_batch_class_id;
+
+void js_websg_define_replication_batch(JSContext *ctx, JSValue websg_networking);
+
+// Drains the replicator's spawned or despawned queue into the arena and resolves every replication's node.
+JSValue js_websg_receive_replication_batch(
+  JSContext *ctx,
+  WebSGReplicatorData *replicator_data,
+  WebSGReplicatorIteratorType type,
+  JSValueConst arena
+);
+
+#endif
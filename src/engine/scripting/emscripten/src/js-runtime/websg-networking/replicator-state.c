@@ -0,0 +1,1734 @@
+#include <math.h>
+#include <string.h>
+#include "../quickjs/cutils.h"
+#include "../quickjs/quickjs.h"
+#include "../../websg.h"
+#include "../../websg-networking.h"
+#include "../websg/component-store.h"
+#include "./replicator-state.h"
+
+#define WEBSG_SNAPSHOT_TYPE_DELTA 0
+#define WEBSG_SNAPSHOT_TYPE_KEYFRAME 1
+
+#define WEBSG_ENTRY_TYPE_DELTA 0
+#define WEBSG_ENTRY_TYPE_FULL 1
+#define WEBSG_ENTRY_TYPE_REMOVED 2
+
+// Snapshot type + uint32 entry count
+#define WEBSG_SNAPSHOT_HEADER_BYTE_LENGTH 5
+#define WEBSG_VARINT_MAX_BYTE_LENGTH 5
+
+/**
+ * Encoding
+ **/
+
+static inline uint8_t *js_websg_write_varint(uint8_t *p, uint32_t value) {
+  while (value >= 0x80) {
+    *p++ = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+
+  *p++ = (uint8_t)value;
+
+  return p;
+}
+
+static inline int js_websg_read_varint(const uint8_t **p, const uint8_t *end, uint32_t *value) {
+  uint32_t result = 0;
+
+  for (int shift = 0; shift < 35; shift += 7) {
+    if (*p >= end) {
+      return -1;
+    }
+
+    uint8_t byte = *(*p)++;
+    result |= (uint32_t)(byte & 0x7F) << shift;
+
+    if ((byte & 0x80) == 0) {
+      *value = result;
+      return 0;
+    }
+  }
+
+  return -1;
+}
+
+static inline uint32_t js_websg_zigzag_encode(int32_t value) {
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t js_websg_zigzag_decode(uint32_t value) {
+  return (int32_t)((value >> 1) ^ (0u - (value & 1)));
+}
+
+static int32_t js_websg_quantize(float_t value, float_t precision) {
+  float_t quantized = roundf(value / precision);
+
+  if (isnan(quantized)) {
+    return 0;
+  } else if (quantized >= 2147483520.0f) {
+    return INT32_MAX;
+  } else if (quantized <= -2147483648.0f) {
+    return INT32_MIN;
+  }
+
+  return (int32_t)quantized;
+}
+
+static uint32_t js_websg_replicator_state_all_fields_mask(WebSGReplicatorState *state) {
+  return state->field_count == 32 ? 0xFFFFFFFF : (1u << state->field_count) - 1;
+}
+
+static uint32_t js_websg_replicator_state_max_entry_byte_length(WebSGReplicatorState *state) {
+  return WEBSG_VARINT_MAX_BYTE_LENGTH * 2 + 1 + WEBSG_VARINT_MAX_BYTE_LENGTH * state->value_count;
+}
+
+static uint32_t js_websg_replicator_state_changed_mask(
+  WebSGReplicatorState *state,
+  const int32_t *values,
+  const int32_t *baseline
+) {
+  uint32_t mask = 0;
+
+  for (uint32_t i = 0; i < state->field_count; i++) {
+    WebSGReplicatorField *field = &state->fields[i];
+    uint32_t offset = field->value_offset;
+
+    if (memcmp(values + offset, baseline + offset, sizeof(int32_t) * field->element_count) != 0) {
+      mask |= 1u << i;
+    }
+  }
+
+  return mask;
+}
+
+// baseline is NULL for full entries, which carry the values themselves rather than deltas.
+static uint8_t *js_websg_replicator_state_write_entry(
+  WebSGReplicatorState *state,
+  uint8_t *p,
+  network_id_t network_id,
+  uint8_t entry_type,
+  uint32_t mask,
+  const int32_t *values,
+  const int32_t *baseline
+) {
+  p = js_websg_write_varint(p, network_id);
+  *p++ = entry_type;
+
+  if (entry_type == WEBSG_ENTRY_TYPE_REMOVED) {
+    return p;
+  }
+
+  p = js_websg_write_varint(p, mask);
+
+  for (uint32_t i = 0; i < state->field_count; i++) {
+    if ((mask & (1u << i)) == 0) {
+      continue;
+    }
+
+    WebSGReplicatorField *field = &state->fields[i];
+
+    for (uint32_t j = field->value_offset; j < field->value_offset + field->element_count; j++) {
+      int32_t value = baseline ? (int32_t)((uint32_t)values[j] - (uint32_t)baseline[j]) : values[j];
+      p = js_websg_write_varint(p, js_websg_zigzag_encode(value));
+    }
+  }
+
+  return p;
+}
+
+static void js_websg_replicator_state_write_header(uint8_t *packet, uint8_t snapshot_type, uint32_t entry_count) {
+  packet[0] = snapshot_type;
+  packet[1] = entry_count & 0xFF;
+  packet[2] = (entry_count >> 8) & 0xFF;
+  packet[3] = (entry_count >> 16) & 0xFF;
+  packet[4] = (entry_count >> 24) & 0xFF;
+}
+
+/**
+ * Buffers
+ **/
+
+static int js_websg_replicator_state_reserve_packet(JSContext *ctx, WebSGReplicatorState *state, uint32_t byte_length) {
+  if (byte_length <= state->packet_capacity) {
+    return 0;
+  }
+
+  uint32_t capacity = state->packet_capacity == 0 ? 1024 : state->packet_capacity;
+
+  while (capacity < byte_length) {
+    capacity *= 2;
+  }
+
+  uint8_t *packet = js_realloc(ctx, state->packet, capacity);
+
+  if (packet == NULL) {
+    return -1;
+  }
+
+  state->packet = packet;
+  state->packet_capacity = capacity;
+
+  return 0;
+}
+
+static int js_websg_replicator_state_reserve_scratch(JSContext *ctx, WebSGReplicatorState *state, uint32_t count) {
+  if (count <= state->scratch_capacity) {
+    return 0;
+  }
+
+  uint32_t capacity = state->scratch_capacity == 0 ? 64 : state->scratch_capacity;
+
+  while (capacity < count) {
+    capacity *= 2;
+  }
+
+  node_id_t *node_ids = js_realloc(ctx, state->node_ids, sizeof(node_id_t) * capacity);
+
+  if (node_ids == NULL) {
+    return -1;
+  }
+
+  state->node_ids = node_ids;
+
+  // 4 elements covers the largest transform field (rotation).
+  float_t *elements = js_realloc(ctx, state->elements, sizeof(float_t) * 4 * capacity);
+
+  if (elements == NULL) {
+    return -1;
+  }
+
+  state->elements = elements;
+
+  int32_t *values = js_realloc(ctx, state->values, sizeof(int32_t) * state->value_count * capacity);
+
+  if (values == NULL) {
+    return -1;
+  }
+
+  state->values = values;
+
+  float_t *positions = js_realloc(ctx, state->positions, sizeof(float_t) * 3 * capacity);
+
+  if (positions == NULL) {
+    return -1;
+  }
+
+  state->positions = positions;
+
+  uint32_t *entity_indices = js_realloc(ctx, state->entity_indices, sizeof(uint32_t) * capacity);
+
+  if (entity_indices == NULL) {
+    return -1;
+  }
+
+  state->entity_indices = entity_indices;
+  state->scratch_capacity = capacity;
+
+  return 0;
+}
+
+/**
+ * Entities
+ **/
+
+static WebSGReplicatedEntity *js_websg_replicated_entity_list_push(
+  JSContext *ctx,
+  WebSGReplicatedEntityList *list,
+  uint32_t value_count
+) {
+  if (list->count == list->capacity) {
+    uint32_t capacity = list->capacity == 0 ? 16 : list->capacity * 2;
+    WebSGReplicatedEntity *entities = js_realloc(ctx, list->entities, sizeof(WebSGReplicatedEntity) * capacity);
+
+    if (entities == NULL) {
+      return NULL;
+    }
+
+    list->entities = entities;
+    list->capacity = capacity;
+  }
+
+  int32_t *baseline = js_mallocz(ctx, sizeof(int32_t) * value_count);
+
+  if (baseline == NULL) {
+    return NULL;
+  }
+
+  WebSGReplicatedEntity *entity = &list->entities[list->count++];
+  memset(entity, 0, sizeof(WebSGReplicatedEntity));
+  entity->baseline = baseline;
+
+  return entity;
+}
+
+// Swaps the last entity into index, so indices and pointers into the list are invalidated.
+static void js_websg_replicated_entity_list_remove(JSRuntime *rt, WebSGReplicatedEntityList *list, uint32_t index) {
+  js_free_rt(rt, list->entities[index].baseline);
+  js_free_rt(rt, list->entities[index].relevant_peers);
+  js_websg_interpolation_buffer_free(rt, &list->entities[index].interpolation);
+  list->entities[index] = list->entities[--list->count];
+}
+
+static uint32_t js_websg_hash_network_id(network_id_t network_id) {
+  return network_id * 0x9E3779B1u;
+}
+
+static uint32_t *js_websg_replicator_state_find_remote_slot(WebSGReplicatorState *state, network_id_t network_id) {
+  uint32_t mask = state->remote_table_capacity - 1;
+  uint32_t i = js_websg_hash_network_id(network_id) & mask;
+
+  while (state->remote_table[i] != 0) {
+    if (state->remote.entities[state->remote_table[i] - 1].network_id == network_id) {
+      break;
+    }
+
+    i = (i + 1) & mask;
+  }
+
+  return &state->remote_table[i];
+}
+
+// Sizes the table for entity_count entities at most half full and reinserts every remote entity.
+static int js_websg_replicator_state_rebuild_remote_table(
+  JSContext *ctx,
+  WebSGReplicatorState *state,
+  uint32_t entity_count
+) {
+  uint32_t capacity = state->remote_table_capacity == 0 ? 64 : state->remote_table_capacity;
+
+  while (capacity < entity_count * 2) {
+    capacity *= 2;
+  }
+
+  if (capacity != state->remote_table_capacity) {
+    uint32_t *remote_table = js_realloc(ctx, state->remote_table, sizeof(uint32_t) * capacity);
+
+    if (remote_table == NULL) {
+      return -1;
+    }
+
+    state->remote_table = remote_table;
+    state->remote_table_capacity = capacity;
+  }
+
+  memset(state->remote_table, 0, sizeof(uint32_t) * state->remote_table_capacity);
+
+  for (uint32_t i = 0; i < state->remote.count; i++) {
+    *js_websg_replicator_state_find_remote_slot(state, state->remote.entities[i].network_id) = i + 1;
+  }
+
+  return 0;
+}
+
+static WebSGReplicatedEntity *js_websg_replicator_state_find_remote(
+  WebSGReplicatorState *state,
+  network_id_t network_id
+) {
+  if (state->remote_table_capacity == 0) {
+    return NULL;
+  }
+
+  uint32_t slot = *js_websg_replicator_state_find_remote_slot(state, network_id);
+
+  return slot == 0 ? NULL : &state->remote.entities[slot - 1];
+}
+
+static WebSGReplicatedEntity *js_websg_replicator_state_get_remote(
+  JSContext *ctx,
+  WebSGReplicatorState *state,
+  network_id_t network_id
+) {
+  WebSGReplicatedEntity *entity = js_websg_replicator_state_find_remote(state, network_id);
+
+  if (entity != NULL) {
+    return entity;
+  }
+
+  if ((state->remote.count + 1) * 2 > state->remote_table_capacity) {
+    if (js_websg_replicator_state_rebuild_remote_table(ctx, state, state->remote.count + 1) == -1) {
+      return NULL;
+    }
+  }
+
+  entity = js_websg_replicated_entity_list_push(ctx, &state->remote, state->value_count);
+
+  if (entity == NULL) {
+    return NULL;
+  }
+
+  if (
+    state->interpolate &&
+    js_websg_interpolation_buffer_init(ctx, &entity->interpolation, state->sample_element_count) == -1
+  ) {
+    js_websg_replicated_entity_list_remove(JS_GetRuntime(ctx), &state->remote, state->remote.count - 1);
+    return NULL;
+  }
+
+  entity->network_id = network_id;
+  *js_websg_replicator_state_find_remote_slot(state, network_id) = state->remote.count;
+
+  return entity;
+}
+
+static int js_websg_replicator_state_remove_remote(
+  JSContext *ctx,
+  WebSGReplicatorState *state,
+  network_id_t network_id
+) {
+  WebSGReplicatedEntity *entity = js_websg_replicator_state_find_remote(state, network_id);
+
+  if (entity == NULL) {
+    return 0;
+  }
+
+  js_websg_replicated_entity_list_remove(JS_GetRuntime(ctx), &state->remote, entity - state->remote.entities);
+
+  return js_websg_replicator_state_rebuild_remote_table(ctx, state, state->remote.count);
+}
+
+/**
+ * Schema
+ **/
+
+static int js_websg_parse_transform_field(JSContext *ctx, JSValueConst name_val, WebSGReplicatorField *field) {
+  const char *name = JS_ToCString(ctx, name_val);
+
+  if (name == NULL) {
+    return -1;
+  }
+
+  field->storage_type = ComponentPropStorageType_f32;
+
+  if (strcmp(name, "translation") == 0) {
+    field->type = WebSGReplicatorFieldType_Translation;
+    field->element_count = 3;
+    field->precision = 0.001f;
+  } else if (strcmp(name, "rotation") == 0) {
+    field->type = WebSGReplicatorFieldType_Rotation;
+    field->element_count = 4;
+    field->precision = 0.0001f;
+  } else if (strcmp(name, "scale") == 0) {
+    field->type = WebSGReplicatorFieldType_Scale;
+    field->element_count = 3;
+    field->precision = 0.001f;
+  } else {
+    JS_ThrowTypeError(ctx, "WebSGNetworking: Unknown transform field \"%s\".", name);
+    JS_FreeCString(ctx, name);
+    return -1;
+  }
+
+  JS_FreeCString(ctx, name);
+
+  return 0;
+}
+
+static int js_websg_parse_component_prop_field(
+  JSContext *ctx,
+  JSValueConst component_store,
+  JSValueConst prop_val,
+  WebSGReplicatorField *field
+) {
+  WebSGComponentStoreData *store_data = JS_GetOpaque2(ctx, component_store, js_websg_component_store_class_id);
+
+  if (store_data == NULL) {
+    return -1;
+  }
+
+  const char *prop = JS_ToCString(ctx, prop_val);
+
+  if (prop == NULL) {
+    return -1;
+  }
+
+  component_id_t component_id = store_data->component_id;
+  int32_t prop_count = websg_component_definition_get_prop_count(component_id);
+  int32_t prop_idx = -1;
+
+  for (int32_t i = 0; i < prop_count && prop_idx == -1; i++) {
+    uint32_t prop_name_length = websg_component_definition_get_prop_name_length(component_id, i);
+    char *prop_name = js_mallocz(ctx, prop_name_length + 1);
+
+    if (prop_name == NULL) {
+      JS_FreeCString(ctx, prop);
+      return -1;
+    }
+
+    if (websg_component_definition_get_prop_name(component_id, i, prop_name, prop_name_length) != -1 &&
+        strcmp(prop_name, prop) == 0) {
+      prop_idx = i;
+    }
+
+    js_free(ctx, prop_name);
+  }
+
+  if (prop_idx == -1) {
+    JS_ThrowTypeError(ctx, "WebSGNetworking: Component has no prop \"%s\".", prop);
+    JS_FreeCString(ctx, prop);
+    return -1;
+  }
+
+  JS_FreeCString(ctx, prop);
+
+  field->type = WebSGReplicatorFieldType_ComponentProp;
+  field->store_data = store_data;
+  field->prop_idx = prop_idx;
+  field->storage_type = websg_component_definition_get_prop_storage_type(component_id, prop_idx);
+  field->element_count = websg_component_definition_get_prop_size(component_id, prop_idx);
+  field->precision = field->storage_type == ComponentPropStorageType_f32 ? 0.001f : 1.0f;
+
+  return 0;
+}
+
+static int js_websg_parse_replicator_field(JSContext *ctx, JSValueConst item, WebSGReplicatorField *field) {
+  if (JS_IsString(item)) {
+    return js_websg_parse_transform_field(ctx, item, field);
+  }
+
+  if (!JS_IsObject(item)) {
+    JS_ThrowTypeError(ctx, "WebSGNetworking: State fields must be a transform name or a field object.");
+    return -1;
+  }
+
+  JSValue component_val = JS_GetPropertyStr(ctx, item, "component");
+  int result;
+
+  if (JS_IsUndefined(component_val)) {
+    JSValue transform_val = JS_GetPropertyStr(ctx, item, "transform");
+    result = js_websg_parse_transform_field(ctx, transform_val, field);
+    JS_FreeValue(ctx, transform_val);
+  } else {
+    JSValue prop_val = JS_GetPropertyStr(ctx, item, "prop");
+    result = js_websg_parse_component_prop_field(ctx, component_val, prop_val, field);
+    JS_FreeValue(ctx, prop_val);
+  }
+
+  JS_FreeValue(ctx, component_val);
+
+  if (result == -1) {
+    return -1;
+  }
+
+  JSValue precision_val = JS_GetPropertyStr(ctx, item, "precision");
+
+  if (!JS_IsUndefined(precision_val)) {
+    double precision;
+
+    if (JS_ToFloat64(ctx, &precision, precision_val) == -1) {
+      JS_FreeValue(ctx, precision_val);
+      return -1;
+    }
+
+    if (!(precision > 0)) {
+      JS_FreeValue(ctx, precision_val);
+      JS_ThrowRangeError(ctx, "WebSGNetworking: State field precision must be greater than 0.");
+      return -1;
+    }
+
+    field->precision = (float_t)precision;
+  }
+
+  JS_FreeValue(ctx, precision_val);
+
+  return 0;
+}
+
+static int js_websg_get_interpolation_option(
+  JSContext *ctx,
+  JSValueConst interpolation,
+  const char *name,
+  float_t *value
+) {
+  JSValue option = JS_GetPropertyStr(ctx, interpolation, name);
+
+  if (JS_IsException(option)) {
+    return -1;
+  }
+
+  if (JS_IsUndefined(option)) {
+    return 0;
+  }
+
+  double number;
+  int result = JS_ToFloat64(ctx, &number, option);
+  JS_FreeValue(ctx, option);
+
+  if (result == -1) {
+    return -1;
+  }
+
+  if (!(number >= 0) || isinf(number)) {
+    JS_ThrowRangeError(ctx, "WebSGNetworking: Interpolation %s must be a positive number.", name);
+    return -1;
+  }
+
+  *value = number;
+
+  return 0;
+}
+
+static int js_websg_parse_replicator_state_options(
+  JSContext *ctx,
+  WebSGReplicatorState *state,
+  JSValueConst options
+) {
+  if (JS_IsUndefined(options)) {
+    return 0;
+  }
+
+  if (!JS_IsObject(options)) {
+    JS_ThrowTypeError(ctx, "WebSGNetworking: Expected a replicator state options object.");
+    return -1;
+  }
+
+  JSValue interpolation = JS_GetPropertyStr(ctx, options, "interpolation");
+
+  if (JS_IsException(interpolation)) {
+    return -1;
+  }
+
+  // true enables interpolation with the defaults.
+  if (!JS_ToBool(ctx, interpolation)) {
+    JS_FreeValue(ctx, interpolation);
+    return 0;
+  }
+
+  // Defaults suit snapshots sent 10-20 times per second.
+  state->interpolation_delay = 0.1f;
+  state->max_extrapolation = 0.25f;
+
+  if (
+    js_websg_get_interpolation_option(ctx, interpolation, "delay", &state->interpolation_delay) == -1 ||
+    js_websg_get_interpolation_option(ctx, interpolation, "maxExtrapolation", &state->max_extrapolation) == -1
+  ) {
+    JS_FreeValue(ctx, interpolation);
+    return -1;
+  }
+
+  JS_FreeValue(ctx, interpolation);
+
+  // Keeps a full buffer spanning a little more than the delay.
+  state->min_sample_interval = state->interpolation_delay / (WEBSG_INTERPOLATION_BUFFER_SIZE - 2);
+
+  // Schemas of component props only have nothing to interpolate.
+  if (state->sample_element_count == 0) {
+    return 0;
+  }
+
+  state->sample = js_malloc(ctx, sizeof(float_t) * state->sample_element_count);
+
+  if (state->sample == NULL) {
+    return -1;
+  }
+
+  state->interpolate = true;
+
+  return 0;
+}
+
+/**
+ * Public Methods
+ **/
+
+WebSGReplicatorState *js_websg_create_replicator_state(
+  JSContext *ctx,
+  replicator_id_t replicator_id,
+  JSValueConst schema,
+  JSValueConst options
+) {
+  if (!JS_IsArray(ctx, schema)) {
+    JS_ThrowTypeError(ctx, "WebSGNetworking: Expected an array of state fields.");
+    return NULL;
+  }
+
+  uint32_t field_count;
+  JSValue length_val = JS_GetPropertyStr(ctx, schema, "length");
+
+  if (JS_ToUint32(ctx, &field_count, length_val) == -1) {
+    JS_FreeValue(ctx, length_val);
+    return NULL;
+  }
+
+  JS_FreeValue(ctx, length_val);
+
+  if (field_count == 0 || field_count > WEBSG_REPLICATOR_MAX_FIELDS) {
+    JS_ThrowRangeError(ctx, "WebSGNetworking: Replicator state must have between 1 and 32 fields.");
+    return NULL;
+  }
+
+  WebSGReplicatorState *state = js_mallocz(ctx, sizeof(WebSGReplicatorState));
+
+  if (state == NULL) {
+    return NULL;
+  }
+
+  state->replicator_id = replicator_id;
+  state->fields = js_mallocz(ctx, sizeof(WebSGReplicatorField) * field_count);
+
+  if (state->fields == NULL) {
+    js_free(ctx, state);
+    return NULL;
+  }
+
+  for (uint32_t i = 0; i < field_count; i++) {
+    JSValue item = JS_GetPropertyUint32(ctx, schema, i);
+    WebSGReplicatorField *field = &state->fields[i];
+    int result = js_websg_parse_replicator_field(ctx, item, field);
+    JS_FreeValue(ctx, item);
+
+    if (result == -1) {
+      js_free(ctx, state->fields);
+      js_free(ctx, state);
+      return NULL;
+    }
+
+    field->value_offset = state->value_count;
+    state->value_count += field->element_count;
+
+    if (field->type != WebSGReplicatorFieldType_ComponentProp) {
+      field->sample_offset = state->sample_element_count;
+      state->sample_element_count += field->element_count;
+    }
+  }
+
+  state->field_count = field_count;
+
+  if (js_websg_parse_replicator_state_options(ctx, state, options) == -1) {
+    js_free(ctx, state->fields);
+    js_free(ctx, state);
+    return NULL;
+  }
+
+  return state;
+}
+
+void js_websg_free_replicator_state(JSRuntime *rt, WebSGReplicatorState *state) {
+  for (uint32_t i = 0; i < state->local.count; i++) {
+    js_free_rt(rt, state->local.entities[i].baseline);
+    js_free_rt(rt, state->local.entities[i].relevant_peers);
+  }
+
+  for (uint32_t i = 0; i < state->peer_packet_capacity; i++) {
+    js_free_rt(rt, state->peer_packets[i].data);
+  }
+
+  for (uint32_t i = 0; i < state->remote.count; i++) {
+    js_free_rt(rt, state->remote.entities[i].baseline);
+    js_websg_interpolation_buffer_free(rt, &state->remote.entities[i].interpolation);
+  }
+
+  js_free_rt(rt, state->local.entities);
+  js_free_rt(rt, state->remote.entities);
+  js_free_rt(rt, state->remote_table);
+  js_free_rt(rt, state->keyframe_peers);
+  js_free_rt(rt, state->packet);
+  js_free_rt(rt, state->node_ids);
+  js_free_rt(rt, state->elements);
+  js_free_rt(rt, state->values);
+  js_free_rt(rt, state->positions);
+  js_free_rt(rt, state->entity_indices);
+  js_free_rt(rt, state->peer_packets);
+  js_free_rt(rt, state->peer_slots);
+  js_free_rt(rt, state->entry);
+  js_free_rt(rt, state->sample);
+  js_free_rt(rt, state->fields);
+  js_free_rt(rt, state);
+}
+
+int js_websg_replicator_state_add_local(JSContext *ctx, WebSGReplicatorState *state, node_id_t node_id) {
+  WebSGReplicatedEntity *entity = js_websg_replicated_entity_list_push(ctx, &state->local, state->value_count);
+
+  if (entity == NULL) {
+    return -1;
+  }
+
+  entity->node_id = node_id;
+  entity->component_store_index = websg_node_get_component_store_index(node_id);
+
+  return 0;
+}
+
+void js_websg_replicator_state_remove_local(WebSGReplicatorState *state, node_id_t node_id) {
+  for (uint32_t i = 0; i < state->local.count; i++) {
+    if (state->local.entities[i].node_id == node_id) {
+      state->local.entities[i].removed = true;
+      return;
+    }
+  }
+}
+
+int js_websg_replicator_state_set_remote_node(
+  JSContext *ctx,
+  WebSGReplicatorState *state,
+  network_id_t network_id,
+  node_id_t node_id
+) {
+  WebSGReplicatedEntity *entity = js_websg_replicator_state_get_remote(ctx, state, network_id);
+
+  if (entity == NULL) {
+    return -1;
+  }
+
+  entity->node_id = node_id;
+  entity->component_store_index = websg_node_get_component_store_index(node_id);
+  // State may have arrived before the node was spawned.
+  entity->dirty = entity->has_baseline;
+
+  return 0;
+}
+
+int js_websg_replicator_state_add_keyframe_peer(JSContext *ctx, WebSGReplicatorState *state, uint32_t peer_index) {
+  for (uint32_t i = 0; i < state->keyframe_peer_count; i++) {
+    if (state->keyframe_peers[i] == peer_index) {
+      return 0;
+    }
+  }
+
+  if (state->keyframe_peer_count == state->keyframe_peer_capacity) {
+    uint32_t capacity = state->keyframe_peer_capacity == 0 ? 8 : state->keyframe_peer_capacity * 2;
+    uint32_t *keyframe_peers = js_realloc(ctx, state->keyframe_peers, sizeof(uint32_t) * capacity);
+
+    if (keyframe_peers == NULL) {
+      return -1;
+    }
+
+    state->keyframe_peers = keyframe_peers;
+    state->keyframe_peer_capacity = capacity;
+  }
+
+  state->keyframe_peers[state->keyframe_peer_count++] = peer_index;
+
+  return 0;
+}
+
+/**
+ * Send
+ **/
+
+// Reads and quantizes the schema's values for the count nodes in state->node_ids into state->values.
+static int32_t js_websg_replicator_state_read_values(
+  JSContext *ctx,
+  WebSGReplicatorState *state,
+  uint32_t count
+) {
+  for (uint32_t i = 0; i < state->field_count; i++) {
+    WebSGReplicatorField *field = &state->fields[i];
+    int32_t result = 0;
+
+    if (field->type == WebSGReplicatorFieldType_Translation) {
+      result = websg_nodes_get_translations(state->node_ids, count, state->elements);
+    } else if (field->type == WebSGReplicatorFieldType_Rotation) {
+      result = websg_nodes_get_rotations(state->node_ids, count, state->elements);
+    } else if (field->type == WebSGReplicatorFieldType_Scale) {
+      result = websg_nodes_get_scales(state->node_ids, count, state->elements);
+    } else {
+      continue;
+    }
+
+    if (result == -1) {
+      JS_ThrowInternalError(ctx, "WebSGNetworking: Error reading replicated node transforms.");
+      return -1;
+    }
+
+    for (uint32_t j = 0; j < count; j++) {
+      int32_t *values = state->values + j * state->value_count + field->value_offset;
+      float_t *elements = state->elements + j * field->element_count;
+
+      for (uint32_t k = 0; k < field->element_count; k++) {
+        values[k] = js_websg_quantize(elements[k], field->precision);
+      }
+    }
+  }
+
+  return 0;
+}
+
+static void js_websg_replicator_state_read_component_values(
+  WebSGReplicatorState *state,
+  WebSGReplicatedEntity *entity,
+  int32_t *values
+) {
+  for (uint32_t i = 0; i < state->field_count; i++) {
+    WebSGReplicatorField *field = &state->fields[i];
+
+    if (field->type != WebSGReplicatorFieldType_ComponentProp) {
+      continue;
+    }
+
+    WebSGComponentStoreData *store_data = field->store_data;
+    uint8_t *column = (uint8_t *)store_data->store + store_data->prop_byte_offsets[field->prop_idx];
+    uint32_t element_index = entity->component_store_index * field->element_count;
+
+    for (uint32_t k = 0; k < field->element_count; k++) {
+      void *element = column + sizeof(int32_t) * (element_index + k);
+
+      if (field->storage_type == ComponentPropStorageType_f32) {
+        values[field->value_offset + k] = js_websg_quantize(*(float_t *)element, field->precision);
+      } else {
+        values[field->value_offset + k] = *(int32_t *)element;
+      }
+    }
+  }
+}
+
+static int js_websg_replicator_state_reserve_peer_packets(
+  JSContext *ctx,
+  WebSGReplicatorState *state,
+  WebSGInterest *interest
+) {
+  uint32_t peer_count = interest->peer_count;
+
+  if (peer_count > state->peer_packet_capacity) {
+    WebSGReplicatorPeerPacket *peer_packets = js_realloc(
+      ctx,
+      state->peer_packets,
+      sizeof(WebSGReplicatorPeerPacket) * peer_count
+    );
+
+    if (peer_packets == NULL) {
+      return -1;
+    }
+
+    memset(
+      peer_packets + state->peer_packet_capacity,
+      0,
+      sizeof(WebSGReplicatorPeerPacket) * (peer_count - state->peer_packet_capacity)
+    );
+    state->peer_packets = peer_packets;
+    state->peer_packet_capacity = peer_count;
+  }
+
+  uint32_t slot_count = 0;
+
+  for (uint32_t i = 0; i < peer_count; i++) {
+    if (interest->peers[i].peer_index >= slot_count) {
+      slot_count = interest->peers[i].peer_index + 1;
+    }
+  }
+
+  if (slot_count > state->peer_slot_capacity) {
+    uint32_t *peer_slots = js_realloc(ctx, state->peer_slots, sizeof(uint32_t) * slot_count);
+
+    if (peer_slots == NULL) {
+      return -1;
+    }
+
+    state->peer_slots = peer_slots;
+    state->peer_slot_capacity = slot_count;
+  }
+
+  memset(state->peer_slots, 0, sizeof(uint32_t) * state->peer_slot_capacity);
+
+  for (uint32_t i = 0; i < peer_count; i++) {
+    WebSGReplicatorPeerPacket *peer_packet = &state->peer_packets[i];
+    peer_packet->peer_index = interest->peers[i].peer_index;
+    peer_packet->byte_length = WEBSG_SNAPSHOT_HEADER_BYTE_LENGTH;
+    peer_packet->entry_count = 0;
+    peer_packet->keyframe = false;
+    state->peer_slots[peer_packet->peer_index] = i + 1;
+  }
+
+  // A peer that left and came back under the same index lost its baselines.
+  for (uint32_t i = 0; i < state->keyframe_peer_count; i++) {
+    uint32_t peer_index = state->keyframe_peers[i];
+
+    if (peer_index < state->peer_slot_capacity && state->peer_slots[peer_index] != 0) {
+      state->peer_packets[state->peer_slots[peer_index] - 1].keyframe = true;
+    }
+  }
+
+  if (state->entry == NULL) {
+    // Room for a full and a delta entry, each encoded once and copied into every peer's packet.
+    state->entry = js_malloc(ctx, js_websg_replicator_state_max_entry_byte_length(state) * 2);
+
+    if (state->entry == NULL) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+static int js_websg_replicator_state_append_peer_entry(
+  JSContext *ctx,
+  WebSGReplicatorState *state,
+  uint32_t peer_index,
+  const uint8_t *entry,
+  uint32_t entry_byte_length
+) {
+  if (peer_index >= state->peer_slot_capacity || state->peer_slots[peer_index] == 0) {
+    return 0;
+  }
+
+  WebSGReplicatorPeerPacket *peer_packet = &state->peer_packets[state->peer_slots[peer_index] - 1];
+  uint32_t byte_length = peer_packet->byte_length + entry_byte_length;
+
+  if (byte_length > peer_packet->capacity) {
+    uint32_t capacity = peer_packet->capacity == 0 ? 1024 : peer_packet->capacity;
+
+    while (capacity < byte_length) {
+      capacity *= 2;
+    }
+
+    uint8_t *data = js_realloc(ctx, peer_packet->data, capacity);
+
+    if (data == NULL) {
+      return -1;
+    }
+
+    peer_packet->data = data;
+    peer_packet->capacity = capacity;
+  }
+
+  memcpy(peer_packet->data + peer_packet->byte_length, entry, entry_byte_length);
+  peer_packet->byte_length = byte_length;
+  peer_packet->entry_count++;
+
+  return 0;
+}
+
+// Writes removals for despawned entities and drops them from the list, removing them reorders the list.
+static uint8_t *js_websg_replicator_state_write_removals(
+  JSContext *ctx,
+  WebSGReplicatorState *state,
+  uint8_t *p,
+  uint32_t *entry_count
+) {
+  WebSGReplicatedEntityList *local = &state->local;
+
+  for (uint32_t i = 0; i < local->count;) {
+    WebSGReplicatedEntity *entity = &local->entities[i];
+
+    if (!entity->removed) {
+      i++;
+      continue;
+    }
+
+    if (entity->has_baseline) {
+      p = js_websg_replicator_state_write_entry(
+        state,
+        p,
+        entity->network_id,
+        WEBSG_ENTRY_TYPE_REMOVED,
+        0,
+        NULL,
+        NULL
+      );
+      (*entry_count)++;
+    }
+
+    js_websg_replicated_entity_list_remove(JS_GetRuntime(ctx), local, i);
+  }
+
+  return p;
+}
+
+// Sends every peer the entries of the entities relevant to it, values were read into state->values.
+static int32_t js_websg_replicator_state_send_relevant(
+  JSContext *ctx,
+  WebSGReplicatorState *state,
+  WebSGInterest *interest,
+  uint32_t count
+) {
+  WebSGReplicatedEntityList *local = &state->local;
+
+  if (js_websg_replicator_state_reserve_peer_packets(ctx, state, interest) == -1) {
+    return -1;
+  }
+
+  // Entities are filtered by their translation, read separately in case the schema doesn't include it.
+  if (count > 0 && websg_nodes_get_translations(state->node_ids, count, state->positions) == -1) {
+    JS_ThrowInternalError(ctx, "WebSGNetworking: Error reading replicated node transforms.");
+    return -1;
+  }
+
+  uint32_t all_fields = js_websg_replicator_state_all_fields_mask(state);
+  uint8_t *full_entry = state->entry;
+  uint8_t *delta_entry = state->entry + js_websg_replicator_state_max_entry_byte_length(state);
+  uint32_t j = 0;
+
+  for (uint32_t i = 0; i < local->count; i++) {
+    WebSGReplicatedEntity *entity = &local->entities[i];
+
+    if (entity->removed || entity->network_id == 0) {
+      continue;
+    }
+
+    int32_t *values = state->values + state->value_count * j;
+    float_t *position = state->positions + 3 * j;
+    j++;
+
+    js_websg_replicator_state_read_component_values(state, entity, values);
+
+    uint32_t relevant_count = js_websg_interest_query(interest, position);
+    uint32_t *relevant_peers = interest->results;
+    uint32_t mask = entity->has_baseline
+      ? js_websg_replicator_state_changed_mask(state, values, entity->baseline)
+      : all_fields;
+    uint32_t full_byte_length = 0;
+    uint32_t delta_byte_length = 0;
+    uint32_t previous = 0;
+
+    for (uint32_t k = 0; k < relevant_count; k++) {
+      uint32_t peer_index = relevant_peers[k];
+
+      while (previous < entity->relevant_peer_count && entity->relevant_peers[previous] < peer_index) {
+        previous++;
+      }
+
+      bool was_relevant = entity->has_baseline &&
+        !state->peer_packets[state->peer_slots[peer_index] - 1].keyframe &&
+        previous < entity->relevant_peer_count &&
+        entity->relevant_peers[previous] == peer_index;
+
+      const uint8_t *entry;
+      uint32_t entry_byte_length;
+
+      if (!was_relevant) {
+        if (full_byte_length == 0) {
+          full_byte_length = js_websg_replicator_state_write_entry(
+            state,
+            full_entry,
+            entity->network_id,
+            WEBSG_ENTRY_TYPE_FULL,
+            all_fields,
+            values,
+            NULL
+          ) - full_entry;
+        }
+
+        entry = full_entry;
+        entry_byte_length = full_byte_length;
+      } else if (mask != 0) {
+        if (delta_byte_length == 0) {
+          delta_byte_length = js_websg_replicator_state_write_entry(
+            state,
+            delta_entry,
+            entity->network_id,
+            WEBSG_ENTRY_TYPE_DELTA,
+            mask,
+            values,
+            entity->baseline
+          ) - delta_entry;
+        }
+
+        entry = delta_entry;
+        entry_byte_length = delta_byte_length;
+      } else {
+        continue;
+      }
+
+      if (js_websg_replicator_state_append_peer_entry(ctx, state, peer_index, entry, entry_byte_length) == -1) {
+        return -1;
+      }
+    }
+
+    if (relevant_count > entity->relevant_peer_capacity) {
+      uint32_t *peers = js_realloc(ctx, entity->relevant_peers, sizeof(uint32_t) * interest->peer_capacity);
+
+      if (peers == NULL) {
+        return -1;
+      }
+
+      entity->relevant_peers = peers;
+      entity->relevant_peer_capacity = interest->peer_capacity;
+    }
+
+    if (relevant_count > 0) {
+      memcpy(entity->relevant_peers, relevant_peers, sizeof(uint32_t) * relevant_count);
+    }
+
+    entity->relevant_peer_count = relevant_count;
+    memcpy(entity->baseline, values, sizeof(int32_t) * state->value_count);
+    entity->has_baseline = true;
+  }
+
+  for (uint32_t i = 0; i < interest->peer_count; i++) {
+    WebSGReplicatorPeerPacket *peer_packet = &state->peer_packets[i];
+
+    if (peer_packet->entry_count == 0) {
+      continue;
+    }
+
+    js_websg_replicator_state_write_header(peer_packet->data, WEBSG_SNAPSHOT_TYPE_DELTA, peer_packet->entry_count);
+
+    if (websg_replicator_send_state(
+      state->replicator_id,
+      peer_packet->peer_index,
+      peer_packet->data,
+      peer_packet->byte_length
+    )) {
+      JS_ThrowInternalError(ctx, "WebSGNetworking: Error sending replicator state.");
+      return -1;
+    }
+  }
+
+  state->keyframe_peer_count = 0;
+
+  // Removals go to everyone, peers that never saw the entity ignore them.
+  uint32_t entry_count = 0;
+  uint8_t *p = js_websg_replicator_state_write_removals(
+    ctx,
+    state,
+    state->packet + WEBSG_SNAPSHOT_HEADER_BYTE_LENGTH,
+    &entry_count
+  );
+
+  if (entry_count == 0) {
+    return 0;
+  }
+
+  js_websg_replicator_state_write_header(state->packet, WEBSG_SNAPSHOT_TYPE_DELTA, entry_count);
+
+  uint32_t byte_length = p - state->packet;
+
+  if (websg_replicator_send_state(state->replicator_id, NETWORK_BROADCAST_PEER_INDEX, state->packet, byte_length)) {
+    JS_ThrowInternalError(ctx, "WebSGNetworking: Error sending replicator state.");
+    return -1;
+  }
+
+  return 0;
+}
+
+int32_t js_websg_replicator_state_send(JSContext *ctx, WebSGReplicatorState *state, WebSGInterest *interest) {
+  WebSGReplicatedEntityList *local = &state->local;
+  uint32_t count = 0;
+  bool interest_enabled = interest != NULL && interest->enabled;
+
+  // Switching between broadcast and per-peer snapshots leaves peers with stale baselines, so start over in full.
+  if (interest_enabled != state->interest_enabled) {
+    for (uint32_t i = 0; i < local->count; i++) {
+      local->entities[i].has_baseline = false;
+      local->entities[i].relevant_peer_count = 0;
+    }
+
+    state->interest_enabled = interest_enabled;
+  }
+
+  for (uint32_t i = 0; i < local->count; i++) {
+    WebSGReplicatedEntity *entity = &local->entities[i];
+
+    if (!entity->removed && entity->network_id == 0) {
+      entity->network_id = websg_node_get_network_id(entity->node_id);
+    }
+
+    if (!entity->removed && entity->network_id != 0) {
+      count++;
+    }
+  }
+
+  if (js_websg_replicator_state_reserve_scratch(ctx, state, count) == -1) {
+    return -1;
+  }
+
+  uint32_t max_byte_length = WEBSG_SNAPSHOT_HEADER_BYTE_LENGTH +
+    local->count * js_websg_replicator_state_max_entry_byte_length(state);
+
+  if (js_websg_replicator_state_reserve_packet(ctx, state, max_byte_length) == -1) {
+    return -1;
+  }
+
+  uint32_t j = 0;
+
+  for (uint32_t i = 0; i < local->count; i++) {
+    WebSGReplicatedEntity *entity = &local->entities[i];
+
+    if (!entity->removed && entity->network_id != 0) {
+      state->node_ids[j++] = entity->node_id;
+    }
+  }
+
+  if (count > 0 && js_websg_replicator_state_read_values(ctx, state, count) == -1) {
+    return -1;
+  }
+
+  if (interest_enabled) {
+    return js_websg_replicator_state_send_relevant(ctx, state, interest, count);
+  }
+
+  uint32_t all_fields = js_websg_replicator_state_all_fields_mask(state);
+  uint8_t *p;
+  uint32_t entry_count;
+
+  // Peers that just entered get the previous tick's values in full, the delta below then applies on top of them.
+  if (state->keyframe_peer_count > 0) {
+    p = state->packet + WEBSG_SNAPSHOT_HEADER_BYTE_LENGTH;
+    entry_count = 0;
+
+    for (uint32_t i = 0; i < local->count; i++) {
+      WebSGReplicatedEntity *entity = &local->entities[i];
+
+      if (!entity->removed && entity->has_baseline) {
+        p = js_websg_replicator_state_write_entry(
+          state,
+          p,
+          entity->network_id,
+          WEBSG_ENTRY_TYPE_FULL,
+          all_fields,
+          entity->baseline,
+          NULL
+        );
+        entry_count++;
+      }
+    }
+
+    if (entry_count > 0) {
+      js_websg_replicator_state_write_header(state->packet, WEBSG_SNAPSHOT_TYPE_KEYFRAME, entry_count);
+
+      for (uint32_t i = 0; i < state->keyframe_peer_count; i++) {
+        uint32_t byte_length = p - state->packet;
+
+        if (websg_replicator_send_state(state->replicator_id, state->keyframe_peers[i], state->packet, byte_length)) {
+          JS_ThrowInternalError(ctx, "WebSGNetworking: Error sending replicator state.");
+          return -1;
+        }
+      }
+    }
+
+    state->keyframe_peer_count = 0;
+  }
+
+  p = state->packet + WEBSG_SNAPSHOT_HEADER_BYTE_LENGTH;
+  entry_count = 0;
+  j = 0;
+
+  for (uint32_t i = 0; i < local->count; i++) {
+    WebSGReplicatedEntity *entity = &local->entities[i];
+
+    if (entity->removed || entity->network_id == 0) {
+      continue;
+    }
+
+    int32_t *values = state->values + state->value_count * j++;
+    js_websg_replicator_state_read_component_values(state, entity, values);
+
+    if (!entity->has_baseline) {
+      p = js_websg_replicator_state_write_entry(
+        state,
+        p,
+        entity->network_id,
+        WEBSG_ENTRY_TYPE_FULL,
+        all_fields,
+        values,
+        NULL
+      );
+      entity->has_baseline = true;
+    } else {
+      uint32_t mask = js_websg_replicator_state_changed_mask(state, values, entity->baseline);
+
+      if (mask == 0) {
+        continue;
+      }
+
+      p = js_websg_replicator_state_write_entry(
+        state,
+        p,
+        entity->network_id,
+        WEBSG_ENTRY_TYPE_DELTA,
+        mask,
+        values,
+        entity->baseline
+      );
+    }
+
+    memcpy(entity->baseline, values, sizeof(int32_t) * state->value_count);
+    entry_count++;
+  }
+
+  // Removed entities are written last, removing them reorders the list.
+  p = js_websg_replicator_state_write_removals(ctx, state, p, &entry_count);
+
+  if (entry_count == 0) {
+    return 0;
+  }
+
+  js_websg_replicator_state_write_header(state->packet, WEBSG_SNAPSHOT_TYPE_DELTA, entry_count);
+
+  uint32_t byte_length = p - state->packet;
+
+  if (websg_replicator_send_state(state->replicator_id, NETWORK_BROADCAST_PEER_INDEX, state->packet, byte_length)) {
+    JS_ThrowInternalError(ctx, "WebSGNetworking: Error sending replicator state.");
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * Receive
+ **/
+
+// Dequantizes a transform field. Quantization leaves rotations slightly off unit length, so they are renormalized.
+static void js_websg_replicator_state_dequantize(
+  WebSGReplicatorField *field,
+  const int32_t *values,
+  float_t *elements
+) {
+  float_t length_squared = 0;
+
+  for (uint32_t k = 0; k < field->element_count; k++) {
+    elements[k] = values[k] * field->precision;
+    length_squared += elements[k] * elements[k];
+  }
+
+  if (field->type == WebSGReplicatorFieldType_Rotation && length_squared > 0) {
+    float_t inverse_length = 1.0f / sqrtf(length_squared);
+
+    for (uint32_t k = 0; k < 4; k++) {
+      elements[k] *= inverse_length;
+    }
+  }
+}
+
+static void js_websg_replicator_state_push_sample(
+  WebSGReplicatorState *state,
+  WebSGReplicatedEntity *entity,
+  float_t time
+) {
+  for (uint32_t f = 0; f < state->field_count; f++) {
+    WebSGReplicatorField *field = &state->fields[f];
+
+    if (field->type != WebSGReplicatorFieldType_ComponentProp) {
+      js_websg_replicator_state_dequantize(
+        field,
+        entity->baseline + field->value_offset,
+        state->sample + field->sample_offset
+      );
+    }
+  }
+
+  js_websg_interpolation_buffer_push(
+    &entity->interpolation,
+    state->sample_element_count,
+    time,
+    state->min_sample_interval,
+    state->sample
+  );
+}
+
+static int32_t js_websg_replicator_state_decode(
+  JSContext *ctx,
+  WebSGReplicatorState *state,
+  const uint8_t *packet,
+  uint32_t byte_length,
+  float_t time
+) {
+  const uint8_t *p = packet + WEBSG_SNAPSHOT_HEADER_BYTE_LENGTH;
+  const uint8_t *end = packet + byte_length;
+
+  if (byte_length < WEBSG_SNAPSHOT_HEADER_BYTE_LENGTH || packet[0] > WEBSG_SNAPSHOT_TYPE_KEYFRAME) {
+    return -1;
+  }
+
+  uint32_t entry_count = packet[1] | (packet[2] << 8) | (packet[3] << 16) | ((uint32_t)packet[4] << 24);
+
+  for (uint32_t i = 0; i < entry_count; i++) {
+    uint32_t network_id;
+
+    if (js_websg_read_varint(&p, end, &network_id) == -1 || p >= end) {
+      return -1;
+    }
+
+    uint8_t entry_type = *p++;
+
+    if (entry_type == WEBSG_ENTRY_TYPE_REMOVED) {
+      if (js_websg_replicator_state_remove_remote(ctx, state, network_id) == -1) {
+        return -1;
+      }
+
+      continue;
+    } else if (entry_type > WEBSG_ENTRY_TYPE_REMOVED) {
+      return -1;
+    }
+
+    uint32_t mask;
+
+    if (js_websg_read_varint(&p, end, &mask) == -1 || (mask & ~js_websg_replicator_state_all_fields_mask(state))) {
+      return -1;
+    }
+
+    bool full = entry_type == WEBSG_ENTRY_TYPE_FULL;
+
+    WebSGReplicatedEntity *entity = full
+      ? js_websg_replicator_state_get_remote(ctx, state, network_id)
+      : js_websg_replicator_state_find_remote(state, network_id);
+
+    // A delta without a baseline can't be applied, its values are skipped.
+    if (entity != NULL && !full && !entity->has_baseline) {
+      entity = NULL;
+    }
+
+    for (uint32_t f = 0; f < state->field_count; f++) {
+      if ((mask & (1u << f)) == 0) {
+        continue;
+      }
+
+      WebSGReplicatorField *field = &state->fields[f];
+
+      for (uint32_t k = field->value_offset; k < field->value_offset + field->element_count; k++) {
+        uint32_t encoded;
+
+        if (js_websg_read_varint(&p, end, &encoded) == -1) {
+          return -1;
+        }
+
+        if (entity == NULL) {
+          continue;
+        }
+
+        int32_t value = js_websg_zigzag_decode(encoded);
+        entity->baseline[k] = full ? value : (int32_t)((uint32_t)entity->baseline[k] + (uint32_t)value);
+      }
+    }
+
+    if (entity != NULL) {
+      entity->has_baseline = true;
+      entity->dirty = true;
+
+      if (state->interpolate) {
+        js_websg_replicator_state_push_sample(state, entity, time);
+      }
+    }
+  }
+
+  return 0;
+}
+
+// Nodes that were removed since are skipped by the host, so the result is ignored.
+static void js_websg_replicator_state_set_transforms(
+  WebSGReplicatorState *state,
+  WebSGReplicatorField *field,
+  uint32_t count
+) {
+  if (field->type == WebSGReplicatorFieldType_Translation) {
+    websg_nodes_set_translations(state->node_ids, count, state->elements);
+  } else if (field->type == WebSGReplicatorFieldType_Rotation) {
+    websg_nodes_set_rotations(state->node_ids, count, state->elements);
+  } else if (field->type == WebSGReplicatorFieldType_Scale) {
+    websg_nodes_set_scales(state->node_ids, count, state->elements);
+  }
+}
+
+// Rotations are blended along the shortest path and renormalized, which is close enough to a slerp between
+// snapshots a tick apart.
+static void js_websg_replicator_state_blend(
+  WebSGReplicatorField *field,
+  const float_t *from,
+  const float_t *to,
+  float_t t,
+  float_t *elements
+) {
+  float_t sign = 1;
+
+  if (field->type == WebSGReplicatorFieldType_Rotation) {
+    float_t dot = from[0] * to[0] + from[1] * to[1] + from[2] * to[2] + from[3] * to[3];
+    sign = dot < 0 ? -1 : 1;
+  }
+
+  float_t length_squared = 0;
+
+  for (uint32_t k = 0; k < field->element_count; k++) {
+    elements[k] = from[k] + (to[k] * sign - from[k]) * t;
+    length_squared += elements[k] * elements[k];
+  }
+
+  if (field->type == WebSGReplicatorFieldType_Rotation && length_squared > 0) {
+    float_t inverse_length = 1.0f / sqrtf(length_squared);
+
+    for (uint32_t k = 0; k < 4; k++) {
+      elements[k] *= inverse_length;
+    }
+  }
+}
+
+// Plays back the buffered transforms of every remote entity that is still moving.
+static int32_t js_websg_replicator_state_apply_interpolated(
+  JSContext *ctx,
+  WebSGReplicatorState *state,
+  float_t time
+) {
+  WebSGReplicatedEntityList *remote = &state->remote;
+  uint32_t count = 0;
+
+  for (uint32_t i = 0; i < remote->count; i++) {
+    WebSGReplicatedEntity *entity = &remote->entities[i];
+
+    if (entity->node_id != 0 && entity->interpolation.count > 0 && !entity->interpolation.settled) {
+      count++;
+    }
+  }
+
+  if (count == 0) {
+    return 0;
+  }
+
+  if (js_websg_replicator_state_reserve_scratch(ctx, state, count) == -1) {
+    return -1;
+  }
+
+  uint32_t j = 0;
+
+  for (uint32_t i = 0; i < remote->count; i++) {
+    WebSGReplicatedEntity *entity = &remote->entities[i];
+
+    if (entity->node_id != 0 && entity->interpolation.count > 0 && !entity->interpolation.settled) {
+      state->node_ids[j] = entity->node_id;
+      state->entity_indices[j] = i;
+      j++;
+    }
+  }
+
+  float_t render_time = time - state->interpolation_delay;
+
+  for (uint32_t f = 0; f < state->field_count; f++) {
+    WebSGReplicatorField *field = &state->fields[f];
+
+    if (field->type == WebSGReplicatorFieldType_ComponentProp) {
+      continue;
+    }
+
+    for (uint32_t j = 0; j < count; j++) {
+      WebSGInterpolationBuffer *buffer = &remote->entities[state->entity_indices[j]].interpolation;
+      const float_t *from;
+      const float_t *to;
+      float_t t = js_websg_interpolation_buffer_find(
+        buffer,
+        state->sample_element_count,
+        render_time,
+        state->max_extrapolation,
+        &from,
+        &to
+      );
+
+      js_websg_replicator_state_blend(
+        field,
+        from + field->sample_offset,
+        to + field->sample_offset,
+        t,
+        state->elements + j * field->element_count
+      );
+    }
+
+    js_websg_replicator_state_set_transforms(state, field, count);
+  }
+
+  return 0;
+}
+
+static int32_t js_websg_replicator_state_apply(JSContext *ctx, WebSGReplicatorState *state) {
+  WebSGReplicatedEntityList *remote = &state->remote;
+  uint32_t count = 0;
+
+  for (uint32_t i = 0; i < remote->count; i++) {
+    if (remote->entities[i].dirty && remote->entities[i].node_id != 0) {
+      count++;
+    }
+  }
+
+  if (count == 0) {
+    return 0;
+  }
+
+  if (js_websg_replicator_state_reserve_scratch(ctx, state, count) == -1) {
+    return -1;
+  }
+
+  uint32_t j = 0;
+
+  for (uint32_t i = 0; i < remote->count; i++) {
+    WebSGReplicatedEntity *entity = &remote->entities[i];
+
+    if (entity->dirty && entity->node_id != 0) {
+      state->node_ids[j] = entity->node_id;
+      memcpy(state->values + state->value_count * j, entity->baseline, sizeof(int32_t) * state->value_count);
+      j++;
+    }
+  }
+
+  for (uint32_t f = 0; f < state->field_count; f++) {
+    WebSGReplicatorField *field = &state->fields[f];
+
+    // Interpolated transforms are applied by js_websg_replicator_state_apply_interpolated.
+    if (field->type == WebSGReplicatorFieldType_ComponentProp || state->interpolate) {
+      continue;
+    }
+
+    for (uint32_t j = 0; j < count; j++) {
+      js_websg_replicator_state_dequantize(
+        field,
+        state->values + j * state->value_count + field->value_offset,
+        state->elements + j * field->element_count
+      );
+    }
+
+    js_websg_replicator_state_set_transforms(state, field, count);
+  }
+
+  for (uint32_t i = 0; i < remote->count; i++) {
+    WebSGReplicatedEntity *entity = &remote->entities[i];
+
+    if (!entity->dirty || entity->node_id == 0) {
+      continue;
+    }
+
+    for (uint32_t f = 0; f < state->field_count; f++) {
+      WebSGReplicatorField *field = &state->fields[f];
+
+      if (field->type != WebSGReplicatorFieldType_ComponentProp) {
+        continue;
+      }
+
+      WebSGComponentStoreData *store_data = field->store_data;
+      uint8_t *column = (uint8_t *)store_data->store + store_data->prop_byte_offsets[field->prop_idx];
+      uint32_t element_index = entity->component_store_index * field->element_count;
+
+      for (uint32_t k = 0; k < field->element_count; k++) {
+        void *element = column + sizeof(int32_t) * (element_index + k);
+        int32_t value = entity->baseline[field->value_offset + k];
+
+        if (field->storage_type == ComponentPropStorageType_f32) {
+          *(float_t *)element = value * field->precision;
+        } else {
+          *(int32_t *)element = value;
+        }
+      }
+    }
+
+    entity->dirty = false;
+  }
+
+  return 0;
+}
+
+int32_t js_websg_replicator_state_receive(JSContext *ctx, WebSGReplicatorState *state, float_t time) {
+  int32_t byte_length;
+
+  while ((byte_length = websg_replicator_get_state_byte_length(state->replicator_id)) > 0) {
+    if (js_websg_replicator_state_reserve_packet(ctx, state, byte_length) == -1) {
+      return -1;
+    }
+
+    int32_t read_bytes = websg_replicator_receive_state(state->replicator_id, state->packet, state->packet_capacity);
+
+    if (read_bytes <= 0) {
+      byte_length = -1;
+      break;
+    }
+
+    if (js_websg_replicator_state_decode(ctx, state, state->packet, read_bytes, time) == -1) {
+      JS_ThrowInternalError(ctx, "WebSGNetworking: Received a malformed replicator state snapshot.");
+      return -1;
+    }
+  }
+
+  if (byte_length == -1) {
+    JS_ThrowInternalError(ctx, "WebSGNetworking: Error receiving replicator state.");
+    return -1;
+  }
+
+  if (js_websg_replicator_state_apply(ctx, state) == -1) {
+    return -1;
+  }
+
+  return state->interpolate ? js_websg_replicator_state_apply_interpolated(ctx, state, time) : 0;
+}
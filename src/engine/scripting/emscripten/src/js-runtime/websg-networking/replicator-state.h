@@ -0,0 +1,167 @@
+#ifndef __websg_replicator_state_js_h
+#define __websg_replicator_state_js_h
+#include <stdbool.h>
+#include "../quickjs/quickjs.h"
+#include "../../websg.h"
+#include "../../websg-networking.h"
+#include "../websg/component-store.h"
+#include "./interest.h"
+#include "./interpolation.h"
+
+/**
+ * Replicator State
+ *
+ * Continuous state for the nodes spawned by a replicator. The script describes the state with a schema of
+ * transform fields and component store props. Every tick, the runtime quantizes the schema's values for locally
+ * spawned nodes and broadcasts the fields that changed since the previous snapshot. Snapshots are sent reliably
+ * and in order, so the previous snapshot is always the receiver's baseline. Peers that enter the world are sent a
+ * full snapshot of the baseline first.
+ *
+ * With interest management enabled, each remote peer only gets the entries of the entities within the interest
+ * radius. An entity that becomes relevant to a peer again is sent in full, since the peer missed its deltas.
+ *
+ * With interpolation enabled, received transforms are buffered per remote entity and played back with a delay
+ * instead of being applied right away, see interpolation.h. Component props are still applied as they arrive.
+ *
+ * Snapshot format (integers are LEB128 varints, values are zigzag encoded):
+ *   uint8 snapshot type, uint32 entry count, then for each entry:
+ *   network id, uint8 entry type, and unless the entry is a removal:
+ *   changed field mask, then each element of each changed field as a delta (or the full value for full entries).
+ **/
+
+#define WEBSG_REPLICATOR_MAX_FIELDS 32
+
+typedef enum WebSGReplicatorFieldType {
+  WebSGReplicatorFieldType_Translation,
+  WebSGReplicatorFieldType_Rotation,
+  WebSGReplicatorFieldType_Scale,
+  WebSGReplicatorFieldType_ComponentProp,
+} WebSGReplicatorFieldType;
+
+typedef struct WebSGReplicatorField {
+  WebSGReplicatorFieldType type;
+  // Only used by component prop fields.
+  WebSGComponentStoreData *store_data;
+  uint32_t prop_idx;
+  ComponentPropStorageType storage_type;
+  uint32_t element_count;
+  // f32 values are sent as multiples of precision.
+  float_t precision;
+  // Index of the field's first element in an entity's values.
+  uint32_t value_offset;
+  // Transform fields: index of the field's first element in an interpolation sample.
+  uint32_t sample_offset;
+} WebSGReplicatorField;
+
+typedef struct WebSGReplicatedEntity {
+  // 0 for remote entities whose node hasn't been spawned yet.
+  node_id_t node_id;
+  // 0 for local entities until the host assigns one.
+  network_id_t network_id;
+  uint32_t component_store_index;
+  bool has_baseline;
+  // Local entities: despawned, a removal still has to be sent.
+  bool removed;
+  // Remote entities: the baseline changed since it was last applied to the node.
+  bool dirty;
+  // value_count quantized values.
+  int32_t *baseline;
+  // Local entities with interest management: the peers the entity was relevant to last tick, ascending.
+  uint32_t *relevant_peers;
+  uint32_t relevant_peer_count;
+  uint32_t relevant_peer_capacity;
+  // Remote entities with interpolation: the received transforms.
+  WebSGInterpolationBuffer interpolation;
+} WebSGReplicatedEntity;
+
+typedef struct WebSGReplicatedEntityList {
+  WebSGReplicatedEntity *entities;
+  uint32_t count;
+  uint32_t capacity;
+} WebSGReplicatedEntityList;
+
+typedef struct WebSGReplicatorPeerPacket {
+  uint32_t peer_index;
+  uint8_t *data;
+  uint32_t byte_length;
+  uint32_t capacity;
+  uint32_t entry_count;
+  // The peer entered since the last tick, every entity relevant to it is sent in full.
+  bool keyframe;
+} WebSGReplicatorPeerPacket;
+
+typedef struct WebSGReplicatorState {
+  replicator_id_t replicator_id;
+  WebSGReplicatorField *fields;
+  uint32_t field_count;
+  uint32_t value_count;
+  WebSGReplicatedEntityList local;
+  WebSGReplicatedEntityList remote;
+  // Open addressing table from network id to remote entity index + 1, rebuilt when a remote entity is removed.
+  uint32_t *remote_table;
+  uint32_t remote_table_capacity;
+  // Peers that entered since the last tick and need a full snapshot.
+  uint32_t *keyframe_peers;
+  uint32_t keyframe_peer_count;
+  uint32_t keyframe_peer_capacity;
+  // Reused between ticks.
+  uint8_t *packet;
+  uint32_t packet_capacity;
+  node_id_t *node_ids;
+  float_t *elements;
+  int32_t *values;
+  float_t *positions;
+  uint32_t *entity_indices;
+  uint32_t scratch_capacity;
+  // Interest management, one packet per remote peer.
+  bool interest_enabled;
+  WebSGReplicatorPeerPacket *peer_packets;
+  uint32_t peer_packet_capacity;
+  // Peer index to peer packet + 1.
+  uint32_t *peer_slots;
+  uint32_t peer_slot_capacity;
+  uint8_t *entry;
+  // Set with the interpolation option, disabled by default.
+  bool interpolate;
+  float_t interpolation_delay;
+  float_t max_extrapolation;
+  float_t min_sample_interval;
+  // Elements of all transform fields, the size of an interpolation sample.
+  uint32_t sample_element_count;
+  float_t *sample;
+  struct WebSGReplicatorState *next;
+} WebSGReplicatorState;
+
+// Parses a schema array of "translation" | "rotation" | "scale" strings and
+// { transform, precision } / { component, prop, precision } objects, and an optional
+// { interpolation: { delay, maxExtrapolation } } options object.
+WebSGReplicatorState *js_websg_create_replicator_state(
+  JSContext *ctx,
+  replicator_id_t replicator_id,
+  JSValueConst schema,
+  JSValueConst options
+);
+
+void js_websg_free_replicator_state(JSRuntime *rt, WebSGReplicatorState *state);
+
+int js_websg_replicator_state_add_local(JSContext *ctx, WebSGReplicatorState *state, node_id_t node_id);
+
+void js_websg_replicator_state_remove_local(WebSGReplicatorState *state, node_id_t node_id);
+
+// Called when a remote replication is spawned, so received state can be applied to its node.
+int js_websg_replicator_state_set_remote_node(
+  JSContext *ctx,
+  WebSGReplicatorState *state,
+  network_id_t network_id,
+  node_id_t node_id
+);
+
+int js_websg_replicator_state_add_keyframe_peer(JSContext *ctx, WebSGReplicatorState *state, uint32_t peer_index);
+
+// Encodes and sends the tick's snapshots for local entities, filtered by interest when it's enabled.
+int32_t js_websg_replicator_state_send(JSContext *ctx, WebSGReplicatorState *state, WebSGInterest *interest);
+
+// Decodes every queued snapshot and applies the new values to remote nodes. time is the world time in seconds.
+int32_t js_websg_replicator_state_receive(JSContext *ctx, WebSGReplicatorState *state, float_t time);
+
+#endif
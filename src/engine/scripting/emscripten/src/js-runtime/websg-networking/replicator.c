@@ -9,6 +9,7 @@
 #include "./replicator.h"
 #include "./replication.h"
 #include "./replication-iterator.h"
+#include "./replication-batch.h"
 #include "./network.h"
 
 JSClassID js_websg_replicator_class_id;
@@ -21,13 +22,29 @@ static void js_websg_replicator_finalizer(JSRuntime *rt, JSValue val) {
   WebSGReplicatorData *replicator_data = JS_GetOpaque(val, js_websg_replicator_class_id);
 
   if (replicator_data) {
+    if (replicator_data->state) {
+      js_websg_free_replicator_state(rt, replicator_data->state);
+    }
+
+    JS_FreeValueRT(rt, replicator_data->factory_function);
+    JS_FreeValueRT(rt, replicator_data->batch_factory_function);
     js_free_rt(rt, replicator_data);
   }
 }
 
+static void js_websg_replicator_gc_mark(JSRuntime *rt, JSValueConst val, JS_MarkFunc *mark_func) {
+  WebSGReplicatorData *replicator_data = JS_GetOpaque(val, js_websg_replicator_class_id);
+
+  if (replicator_data) {
+    JS_MarkValue(rt, replicator_data->factory_function, mark_func);
+    JS_MarkValue(rt, replicator_data->batch_factory_function, mark_func);
+  }
+}
+
 static JSClassDef js_websg_replicator_class = {
   "Replicator",
-  .finalizer = js_websg_replicator_finalizer
+  .finalizer = js_websg_replicator_finalizer,
+  .gc_mark = js_websg_replicator_gc_mark
 };
 
 static JSValue js_websg_replicator_spawn(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
@@ -54,6 +71,12 @@ static JSValue js_websg_replicator_spawn(JSContext *ctx, JSValueConst this_val,
     return JS_EXCEPTION;
   }
 
+  if (replicator_data->state) {
+    if (js_websg_replicator_state_add_local(ctx, replicator_data->state, node_data->node_id) == -1) {
+      return JS_EXCEPTION;
+    }
+  }
+
   return JS_DupValue(ctx, node);
 }
 
@@ -85,6 +108,41 @@ static JSValue js_websg_replicator_despawn(JSContext *ctx, JSValueConst this_val
     return JS_EXCEPTION;
   }
 
+  if (replicator_data->state) {
+    js_websg_replicator_state_remove_local(replicator_data->state, node_data->node_id);
+  }
+
+  return JS_UNDEFINED;
+}
+
+static JSValue js_websg_replicator_spawned_batch(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGReplicatorData *replicator_data = JS_GetOpaque(this_val, js_websg_replicator_class_id);
+  return js_websg_receive_replication_batch(ctx, replicator_data, WebSGReplicatorIteratorType_Spawned, argv[0]);
+}
+
+static JSValue js_websg_replicator_despawned_batch(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGReplicatorData *replicator_data = JS_GetOpaque(this_val, js_websg_replicator_class_id);
+  return js_websg_receive_replication_batch(ctx, replicator_data, WebSGReplicatorIteratorType_Despawned, argv[0]);
+}
+
+static JSValue js_websg_replicator_define_state(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGReplicatorData *replicator_data = JS_GetOpaque(this_val, js_websg_replicator_class_id);
+
+  if (replicator_data->state) {
+    return JS_ThrowTypeError(ctx, "WebSGNetworking: Replicator state is already defined.");
+  }
+
+  WebSGReplicatorState *state = js_websg_create_replicator_state(ctx, replicator_data->replicator_id, argv[0], argv[1]);
+
+  if (state == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  WebSGNetworkData *network_data = replicator_data->network_data;
+  state->next = network_data->replicator_states;
+  network_data->replicator_states = state;
+  replicator_data->state = state;
+
   return JS_UNDEFINED;
 }
 
@@ -103,6 +161,9 @@ static const JSCFunctionListEntry js_websg_replicator_proto_funcs[] = {
   JS_CFUNC_DEF("spawned", 0, js_websg_replicator_spawned),
   JS_CFUNC_DEF("despawn", 2, js_websg_replicator_despawn),
   JS_CFUNC_DEF("despawned", 0, js_websg_replicator_despawned),
+  JS_CFUNC_DEF("spawnedBatch", 1, js_websg_replicator_spawned_batch),
+  JS_CFUNC_DEF("despawnedBatch", 1, js_websg_replicator_despawned_batch),
+  JS_CFUNC_DEF("defineState", 2, js_websg_replicator_define_state),
   JS_PROP_STRING_DEF("[Symbol.toStringTag]", "Replicator", JS_PROP_CONFIGURABLE),
 };
 
@@ -134,19 +195,73 @@ void js_websg_define_replicator(JSContext *ctx, JSValue network) {
   );
 }
 
-JSValue js_websg_new_replicator_instance(JSContext *ctx, WebSGNetworkData *network_data, replicator_id_t replicator_id, JSValue factory_function) {
+JSValue js_websg_new_replicator_instance(
+  JSContext *ctx,
+  WebSGNetworkData *network_data,
+  replicator_id_t replicator_id,
+  JSValue factory_function,
+  JSValue batch_factory_function
+) {
   JSValue replicator = JS_NewObjectClass(ctx, js_websg_replicator_class_id);
 
   if (JS_IsException(replicator)) {
+    JS_FreeValue(ctx, factory_function);
+    JS_FreeValue(ctx, batch_factory_function);
     return replicator;
   }
 
   WebSGReplicatorData *replicator_data = js_mallocz(ctx, sizeof(WebSGReplicatorData));
+
+  if (replicator_data == NULL) {
+    JS_FreeValue(ctx, factory_function);
+    JS_FreeValue(ctx, batch_factory_function);
+    JS_FreeValue(ctx, replicator);
+    return JS_EXCEPTION;
+  }
+
   replicator_data->replicator_id = replicator_id;
   replicator_data->factory_function = factory_function;
+  replicator_data->batch_factory_function = batch_factory_function;
+  replicator_data->network_data = network_data;
   JS_SetOpaque(replicator, replicator_data);
 
-  JS_SetPropertyUint32(ctx, network_data->replicators, replicator_id, JS_DupValue(ctx, replicator));
+  js_handle_table_set(ctx, &network_data->replicators, replicator_id, JS_DupValue(ctx, replicator));
 
   return replicator;
-}
\ No newline at end of file
+}
+
+int js_websg_replicator_init_remote_node(
+  JSContext *ctx,
+  WebSGReplicatorData *replicator_data,
+  network_id_t network_id,
+  JSValueConst node
+) {
+  if (JS_IsException(node)) {
+    return -1;
+  }
+
+  WebSGNodeData *node_data = JS_GetOpaque(node, js_websg_node_class_id);
+
+  if (node_data == NULL) {
+    JS_ThrowInternalError(ctx, "WebSGNetworking: replicator factory function did not return a node.");
+    return -1;
+  }
+
+  NetworkSynchronizerProps synchronizer_props = {
+    .network_id = network_id,
+    .replicator_id = replicator_data->replicator_id,
+  };
+
+  if (websg_node_add_network_synchronizer(node_data->node_id, &synchronizer_props) == -1) {
+    JS_ThrowInternalError(ctx, "WebSGNetworking: unable to assign networkID to nodeID.");
+    return -1;
+  }
+
+  WebSGReplicatorState *state = replicator_data->state;
+
+  if (state && js_websg_replicator_state_set_remote_node(ctx, state, network_id, node_data->node_id) == -1) {
+    return -1;
+  }
+
+  return 0;
+}
@@ -8,7 +8,13 @@
 
 typedef struct WebSGReplicatorData {
   replicator_id_t replicator_id;
+  // Owned by the replicator, freed by its finalizer.
   JSValue factory_function;
+  // Optional, creates the nodes for a batch of remote spawns at once. Called with the count, returns an array.
+  JSValue batch_factory_function;
+  WebSGNetworkData *network_data;
+  // NULL until replicator.defineState() is called.
+  WebSGReplicatorState *state;
 } WebSGReplicatorData;
 
 extern JSClassID js_websg_replicator_class_id;
@@ -17,6 +23,20 @@ void js_websg_define_replicator(JSContext *ctx, JSValue network);
 
 JSValue js_websg_create_replicator(JSContext *ctx, float* elements);
 
-JSValue js_websg_new_replicator_instance(JSContext *ctx, WebSGNetworkData *network_data, replicator_id_t replicator_id, JSValue factory_function);
+JSValue js_websg_new_replicator_instance(
+  JSContext *ctx,
+  WebSGNetworkData *network_data,
+  replicator_id_t replicator_id,
+  JSValue factory_function,
+  JSValue batch_factory_function
+);
+
+// Assigns the network id of a remote spawn to the node the factory created for it.
+int js_websg_replicator_init_remote_node(
+  JSContext *ctx,
+  WebSGReplicatorData *replicator_data,
+  network_id_t network_id,
+  JSValueConst node
+);
 
 #endif
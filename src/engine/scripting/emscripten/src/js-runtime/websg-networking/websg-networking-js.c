@@ -2,14 +2,19 @@
 #include "../quickjs/cutils.h"
 #include "../../websg-networking.h"
 #include "./websg-networking-js.h"
+#include "./channel.h"
 #include "./network-listener.h"
 #include "./network-message-iterator.h"
 #include "./network-message.h"
+#include "./network-message-batch.h"
 #include "./network.h"
 #include "./peer.h"
+#include "./peer-poses.h"
+#include "./message-schema.h"
 #include "./replicator.h"
 #include "./replication.h"
 #include "./replication-iterator.h"
+#include "./replication-batch.h"
 
 void js_define_websg_networking_api(JSContext *ctx) {
   JSValue global = JS_GetGlobalObject(ctx);
@@ -19,11 +24,16 @@ void js_define_websg_networking_api(JSContext *ctx) {
   js_websg_define_network_listener(ctx, websg_networking);
   js_websg_define_network_message_iterator(ctx);
   js_websg_define_network_message(ctx, websg_networking);
+  js_websg_define_network_message_batch(ctx, websg_networking);
   js_websg_define_network(ctx, websg_networking);
+  js_websg_define_network_channel(ctx, websg_networking);
   js_websg_define_peer(ctx, websg_networking);
+  js_websg_define_peer_poses(ctx, websg_networking);
+  js_websg_define_message_schema(ctx, websg_networking);
   js_websg_define_replicator(ctx, websg_networking);
   js_websg_define_replication_iterator(ctx);
   js_websg_define_replication(ctx, websg_networking);
+  js_websg_define_replication_batch(ctx, websg_networking);
   JS_SetPropertyStr(ctx, global, "WebSGNetworking", websg_networking);
 
   JSValue network = js_websg_new_network(ctx);
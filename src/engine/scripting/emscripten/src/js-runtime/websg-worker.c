@@ -7,7 +7,10 @@
 
 #include "./quickjs/cutils.h"
 #include "./quickjs/quickjs.h"
+#include "./utils/bytecode.h"
 #include "./utils/exception.h"
+#include "./utils/hooks.h"
+#include "./utils/typedarray.h"
 
 #include "../websg.h"
 #include "../websg-networking.h"
@@ -26,30 +29,124 @@
 
 JSRuntime *rt;
 JSContext *ctx;
+// The network object is looked up once so that peer events don't have to go through the global object.
+JSValue network;
+// Written by websg_get_memory_usage, the host reads it straight out of memory.
+JSMemoryUsage memory_usage;
 
 /**
  * Web Scene Graph (WebSG) Implementation
  **/
 
+/**
+ * Runs the environment script. Bytecode provided by the host is used when it was compiled by this QuickJS
+ * version, otherwise the source is compiled and the bytecode is handed back to the host to cache for next time.
+ * JS_ReadObject doesn't validate bytecode, so hosts must only provide bytecode from trusted sources.
+ **/
+static JSValue js_eval_environment_script(JSContext *ctx) {
+  int32_t bytecode_size = thirdroom_get_js_bytecode_size();
+
+  if (bytecode_size > 0) {
+    uint8_t *bytecode = js_malloc(ctx, bytecode_size);
+
+    if (bytecode == NULL) {
+      return JS_EXCEPTION;
+    }
+
+    JSValue function;
+
+    if (thirdroom_get_js_bytecode(bytecode) == bytecode_size) {
+      function = js_read_bytecode(ctx, bytecode, bytecode_size);
+    } else {
+      function = JS_ThrowInternalError(ctx, "Failed to get script bytecode.");
+    }
+
+    js_free(ctx, bytecode);
+
+    if (!JS_IsException(function)) {
+      return JS_EvalFunction(ctx, function);
+    }
+
+    // Log the error and fall back to the source
+    js_handle_exception(ctx, function);
+  }
+
+  // The size includes the null terminator JS_Eval expects after the source.
+  int32_t source_len = thirdroom_get_js_source_size();
+
+  if (source_len <= 0) {
+    return JS_ThrowInternalError(ctx, "Failed to get script source.");
+  }
+
+  char *source = js_mallocz(ctx, source_len);
+
+  if (source == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  int32_t read_source_len = thirdroom_get_js_source(source);
+
+  if (read_source_len < 0 || read_source_len != source_len - 1) {
+    js_free(ctx, source);
+    return JS_ThrowInternalError(ctx, "Failed to get script source.");
+  }
+
+  JSValue function = js_compile_script(ctx, source, read_source_len, "<environment-script>");
+
+  js_free(ctx, source);
+
+  if (JS_IsException(function)) {
+    return function;
+  }
+
+  size_t compiled_size;
+  uint8_t *compiled = js_write_bytecode(ctx, function, &compiled_size);
+
+  if (compiled != NULL) {
+    thirdroom_set_js_bytecode(compiled, compiled_size);
+    js_free(ctx, compiled);
+  } else {
+    // Not being able to cache the script shouldn't stop it from running
+    JS_FreeValue(ctx, JS_GetException(ctx));
+  }
+
+  return JS_EvalFunction(ctx, function);
+}
+
 /*********************
  * Exported Functions
  *********************/
 
 export int32_t websg_initialize() {
   rt = JS_NewRuntime();
+
+  uint32_t memory_limit = thirdroom_get_memory_limit();
+
+  if (memory_limit > 0) {
+    JS_SetMemoryLimit(rt, memory_limit);
+  }
+
+  uint32_t gc_threshold = thirdroom_get_gc_threshold();
+
+  if (gc_threshold > 0) {
+    JS_SetGCThreshold(rt, gc_threshold);
+  }
   ctx = JS_NewContext(rt);
 
+  js_init_hooks(ctx);
+  js_init_typed_arrays(ctx);
+
   js_define_global_api(ctx);
   js_define_thirdroom_api(ctx);
   js_define_matrix_api(ctx);
   js_define_websg_api(ctx);
   js_define_websg_networking_api(ctx);
 
-  int32_t source_len = thirdroom_get_js_source_size();
-  char *source = js_mallocz(ctx, source_len); // TODO: can we free this after JS_Eval?
-  int32_t read_source_len = thirdroom_get_js_source(source);
+  JSValue global = JS_GetGlobalObject(ctx);
+  network = JS_GetPropertyStr(ctx, global, "network");
+  JS_FreeValue(ctx, global);
 
-  JSValue val = JS_Eval(ctx, source, read_source_len, "<environment-script>", JS_EVAL_TYPE_GLOBAL);
+  JSValue val = js_eval_environment_script(ctx);
 
   if (js_handle_exception(ctx, val) < 0) {
     return -1;
@@ -60,99 +157,52 @@ export int32_t websg_initialize() {
 }
 
 export int32_t websg_load() {
-  JSValue global = JS_GetGlobalObject(ctx);
-  JSValue world = JS_GetPropertyStr(ctx, global, "world");
-  JSValue world_on_load_func = JS_GetPropertyStr(ctx, world, "onload");
-
-  if (js_handle_exception(ctx, world_on_load_func)) {
-    return -1;
-  } else if (JS_IsUndefined(world_on_load_func)) {
-    return 0;
-  }
-
-  JSValueConst args[] = {};
-  JSValue val = JS_Call(ctx, world_on_load_func, JS_UNDEFINED, 0, args);
-  JS_FreeValue(ctx, world_on_load_func);
-
-  if (js_handle_exception(ctx, val) < 0) {
-    return -1;
-  } else {
-    JS_FreeValue(ctx, val);
-    return 0;
-  }
+  return js_call_hook(ctx, JSHook_WorldLoad, 0, NULL);
 }
 
 export int32_t websg_enter() {
-  JSValue global = JS_GetGlobalObject(ctx);
-  JSValue world = JS_GetPropertyStr(ctx, global, "world");
-  JSValue world_on_enter_func = JS_GetPropertyStr(ctx, world, "onenter");
-
-  if (js_handle_exception(ctx, world_on_enter_func) < 0) {
-    return -1;
-  } else if (JS_IsUndefined(world_on_enter_func)) {
-    return 0;
-  }
-
-  JSValue network = JS_GetPropertyStr(ctx, global, "network");
-
   js_websg_network_local_peer_entered(ctx, network);
 
-  JSValueConst args[] = {};
-  JSValue val = JS_Call(ctx, world_on_enter_func, JS_UNDEFINED, 0, args);
-  JS_FreeValue(ctx, world_on_enter_func);
-
-  if (js_handle_exception(ctx, val) < 0) {
-    return -1;
-  } else {
-    JS_FreeValue(ctx, val);
-    return 0;
-  }
+  return js_call_hook(ctx, JSHook_WorldEnter, 0, NULL);
 }
 
 export int32_t websg_update(float_t dt, float_t time) {
-  JSValue global = JS_GetGlobalObject(ctx);
-  JSValue world = JS_GetPropertyStr(ctx, global, "world");
-  JSValue world_on_update_func = JS_GetPropertyStr(ctx, world, "onupdate");
+  // Floats are stored inline in the JSValue, so the args don't need to be freed.
+  JSValueConst args[] = { JS_NewFloat64(ctx, dt), JS_NewFloat64(ctx, time) };
 
-  if (js_handle_exception(ctx, world_on_update_func) < 0) {
+  if (js_websg_network_refresh_interest(ctx, network) == -1) {
     return -1;
-  } else if (JS_IsUndefined(world_on_update_func)) {
-    return 0;
   }
 
-  JSValue dt_val = JS_NewFloat64(ctx, dt);
-
-  if (js_handle_exception(ctx, dt_val) < 0) {
+  if (js_websg_network_receive_replicator_states(ctx, network, time) == -1) {
     return -1;
   }
 
-  JSValue time_val = JS_NewFloat64(ctx, time);
+  int32_t result = js_call_hook(ctx, JSHook_WorldUpdate, 2, args);
 
-  if (js_handle_exception(ctx, time_val) < 0) {
+  if (js_websg_network_send_replicator_states(ctx, network) == -1) {
     return -1;
   }
 
-  JSValueConst args[] = { dt_val, time_val };
-  JSValue val = JS_Call(ctx, world_on_update_func, JS_UNDEFINED, 2, args);
-  JS_FreeValue(ctx, world_on_update_func);
-
-  if (js_handle_exception(ctx, val) < 0) {
+  // Messages queued during the update are sent even if it threw, so that they aren't delayed to the next tick.
+  if (js_websg_network_flush(ctx, network) == -1) {
     return -1;
-  } else {
-    JS_FreeValue(ctx, val);
-    return 0;
   }
+
+  return result;
+}
+
+// Walks the whole QuickJS heap, so this is meant for debugging and stats, not for every frame.
+export JSMemoryUsage *websg_get_memory_usage() {
+  JS_ComputeMemoryUsage(rt, &memory_usage);
+  return &memory_usage;
 }
 
 export int32_t websg_peer_entered(uint32_t peer_index) {
-  JSValue global = JS_GetGlobalObject(ctx);
-  JSValue network = JS_GetPropertyStr(ctx, global, "network");
   return js_websg_network_peer_entered(ctx, network, peer_index);
 }
 
 export int32_t websg_peer_exited(uint32_t peer_index) {
-  JSValue global = JS_GetGlobalObject(ctx);
-  JSValue network = JS_GetPropertyStr(ctx, global, "network");
   return js_websg_network_peer_exited(ctx, network, peer_index);
 }
 
@@ -148,11 +148,17 @@ JSValue js_websg_new_accessor_instance(JSContext *ctx, WebSGWorldData *world_dat
   }
 
   WebSGAccessorData *accessor_data = js_mallocz(ctx, sizeof(WebSGAccessorData));
+
+  if (accessor_data == NULL) {
+    JS_FreeValue(ctx, accessor);
+    return JS_EXCEPTION;
+  }
+
   accessor_data->world_data = world_data;
   accessor_data->accessor_id = accessor_id;
   JS_SetOpaque(accessor, accessor_data);
 
-  JS_SetPropertyUint32(ctx, world_data->accessors, accessor_id, JS_DupValue(ctx, accessor));
+  js_handle_table_set(ctx, &world_data->accessors, accessor_id, JS_DupValue(ctx, accessor));
   
   return accessor;
 }
@@ -162,7 +168,7 @@ JSValue js_websg_new_accessor_instance(JSContext *ctx, WebSGWorldData *world_dat
  **/
 
 JSValue js_websg_get_accessor_by_id(JSContext *ctx, WebSGWorldData *world_data, accessor_id_t accessor_id) {
-  JSValue accessor = JS_GetPropertyUint32(ctx, world_data->accessors, accessor_id);
+  JSValueConst accessor = js_handle_table_get(&world_data->accessors, accessor_id);
 
   if (!JS_IsUndefined(accessor)) {
     return JS_DupValue(ctx, accessor);
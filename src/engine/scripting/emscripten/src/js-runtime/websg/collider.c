@@ -4,7 +4,9 @@
 #include "./websg-js.h"
 #include "./collider.h"
 #include "./mesh.h"
+#include "./physics-body.h"
 #include "../utils/array.h"
+#include "../utils/typedarray.h"
 
 JSClassID js_websg_collider_class_id;
 
@@ -54,7 +56,176 @@ static JSClassDef js_websg_collider_class = {
   .finalizer = js_websg_collider_finalizer
 };
 
+// Reads the optional rotations typed array of a shape query, rotations is NULL when there isn't one. The options
+// getter may return a new typed array, so the caller owns rotations_val and frees it after the host call.
+static int js_websg_collider_get_rotations(
+  JSContext *ctx,
+  JSValueConst options,
+  uint32_t count,
+  JSValue *rotations_val,
+  float_t **rotations
+) {
+  *rotations_val = JS_UNDEFINED;
+  *rotations = NULL;
+
+  if (JS_IsUndefined(options)) {
+    return 0;
+  }
+
+  *rotations_val = JS_GetPropertyStr(ctx, options, "rotations");
+
+  if (JS_IsException(*rotations_val)) {
+    *rotations_val = JS_UNDEFINED;
+    return -1;
+  }
+
+  if (JS_IsUndefined(*rotations_val)) {
+    return 0;
+  }
+
+  *rotations = get_typed_array_data(ctx, rotations_val, sizeof(float_t) * 4 * count);
+
+  return *rotations == NULL ? -1 : 0;
+}
+
+static JSValue js_websg_collider_cast(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGColliderData *collider_data = JS_GetOpaque2(ctx, this_val, js_websg_collider_class_id);
+
+  if (collider_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  uint32_t origins_length;
+  float_t *origins = get_typed_array_elements(ctx, &argv[0], sizeof(float_t), &origins_length);
+
+  if (origins == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  uint32_t count = origins_length / 3;
+  float_t *directions = get_typed_array_data(ctx, &argv[1], sizeof(float_t) * 3 * count);
+
+  if (directions == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  PhysicsHit *hits = js_websg_get_physics_hits(ctx, argv[2], count);
+
+  if (hits == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  WebSGPhysicsQueryOptions options;
+
+  if (js_websg_parse_physics_query_options(ctx, argv[3], &options) == -1) {
+    return JS_EXCEPTION;
+  }
+
+  JSValue rotations_val;
+  float_t *rotations;
+
+  if (js_websg_collider_get_rotations(ctx, argv[3], count, &rotations_val, &rotations) == -1) {
+    JS_FreeValue(ctx, rotations_val);
+    return JS_EXCEPTION;
+  }
+
+  if (count == 0) {
+    JS_FreeValue(ctx, rotations_val);
+    return JS_NewInt32(ctx, 0);
+  }
+
+  int32_t hit_count = websg_world_cast_shapes(
+    collider_data->collider_id,
+    origins,
+    rotations,
+    directions,
+    count,
+    options.max_distance,
+    options.exclude_node_id,
+    hits
+  );
+
+  JS_FreeValue(ctx, rotations_val);
+
+  if (hit_count == -1) {
+    JS_ThrowInternalError(ctx, "WebSG: Error casting collider, only box, sphere and capsule colliders are supported.");
+    return JS_EXCEPTION;
+  }
+
+  return JS_NewInt32(ctx, hit_count);
+}
+
+static JSValue js_websg_collider_overlap(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGColliderData *collider_data = JS_GetOpaque2(ctx, this_val, js_websg_collider_class_id);
+
+  if (collider_data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  uint32_t positions_length;
+  float_t *positions = get_typed_array_elements(ctx, &argv[0], sizeof(float_t), &positions_length);
+
+  if (positions == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  uint32_t count = positions_length / 3;
+  uint32_t *overlap_counts = get_typed_array_data(ctx, &argv[1], sizeof(uint32_t) * count);
+
+  if (overlap_counts == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  uint32_t max_node_count;
+  node_id_t *node_ids = get_typed_array_elements(ctx, &argv[2], sizeof(node_id_t), &max_node_count);
+
+  if (node_ids == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  WebSGPhysicsQueryOptions options;
+
+  if (js_websg_parse_physics_query_options(ctx, argv[3], &options) == -1) {
+    return JS_EXCEPTION;
+  }
+
+  JSValue rotations_val;
+  float_t *rotations;
+
+  if (js_websg_collider_get_rotations(ctx, argv[3], count, &rotations_val, &rotations) == -1) {
+    JS_FreeValue(ctx, rotations_val);
+    return JS_EXCEPTION;
+  }
+
+  if (count == 0) {
+    JS_FreeValue(ctx, rotations_val);
+    return JS_NewInt32(ctx, 0);
+  }
+
+  int32_t overlap_count = websg_world_overlap_shapes(
+    collider_data->collider_id,
+    positions,
+    rotations,
+    count,
+    options.exclude_node_id,
+    overlap_counts,
+    node_ids,
+    max_node_count
+  );
+
+  JS_FreeValue(ctx, rotations_val);
+
+  if (overlap_count == -1) {
+    JS_ThrowInternalError(ctx, "WebSG: Error testing overlaps, only box, sphere and capsule colliders are supported.");
+    return JS_EXCEPTION;
+  }
+
+  return JS_NewInt32(ctx, overlap_count);
+}
+
 static const JSCFunctionListEntry js_websg_collider_proto_funcs[] = {
+  JS_CFUNC_DEF("cast", 4, js_websg_collider_cast),
+  JS_CFUNC_DEF("overlap", 4, js_websg_collider_overlap),
   JS_PROP_STRING_DEF("[Symbol.toStringTag]", "Collider", JS_PROP_CONFIGURABLE),
 };
 
@@ -119,17 +290,23 @@ JSValue js_websg_new_collider_instance(JSContext *ctx, WebSGWorldData *world_dat
   }
 
   WebSGColliderData *collider_data = js_mallocz(ctx, sizeof(WebSGColliderData));
+
+  if (collider_data == NULL) {
+    JS_FreeValue(ctx, collider);
+    return JS_EXCEPTION;
+  }
+
   collider_data->world_data = world_data;
   collider_data->collider_id = collider_id;
   JS_SetOpaque(collider, collider_data);
 
-  JS_SetPropertyUint32(ctx, world_data->colliders, collider_id, JS_DupValue(ctx, collider));
+  js_handle_table_set(ctx, &world_data->colliders, collider_id, JS_DupValue(ctx, collider));
   
   return collider;
 }
 
 JSValue js_websg_get_collider_by_id(JSContext *ctx, WebSGWorldData *world_data, collider_id_t collider_id) {
-  JSValue collider = JS_GetPropertyUint32(ctx, world_data->colliders, collider_id);
+  JSValueConst collider = js_handle_table_get(&world_data->colliders, collider_id);
 
   if (!JS_IsUndefined(collider)) {
     return JS_DupValue(ctx, collider);
@@ -157,6 +334,8 @@ JSValue js_websg_world_create_collider(JSContext *ctx, JSValueConst this_val, in
     return JS_EXCEPTION;
   }
 
+  props->type = collider_type;
+
   JSValue is_trigger_val = JS_GetPropertyStr(ctx, argv[0], "isTrigger");
 
   if (!JS_IsUndefined(is_trigger_val)) {
@@ -12,6 +12,7 @@ static void js_websg_collision_iterator_finalizer(JSRuntime *rt, JSValue val) {
 
   if (it) {
     js_free_rt(rt, it->collisions);
+    js_free_rt(rt, it->contacts);
     js_free_rt(rt, it);
   }
 }
@@ -43,9 +44,13 @@ static JSValue js_websg_collision_iterator_next(
 
   *pdone = FALSE;
 
-  CollisionItem collision = it->collisions[it->idx];
+  JSValue val;
 
-  JSValue val = js_websg_new_collision(ctx, it->world_data, &collision);
+  if (it->contacts != NULL) {
+    val = js_websg_new_collision_with_contact(ctx, it->world_data, &it->contacts[it->idx]);
+  } else {
+    val = js_websg_new_collision(ctx, it->world_data, &it->collisions[it->idx]);
+  }
 
   it->idx = it->idx + 1;
 
@@ -72,6 +77,11 @@ void js_websg_define_collision_iterator(JSContext *ctx) {
 
 JSValue js_websg_create_collision_iterator(JSContext *ctx, WebSGCollisionListenerData *listener_data) {
   WebSGCollisionIteratorData *it = js_mallocz(ctx, sizeof(WebSGCollisionIteratorData));
+
+  if (it == NULL) {
+    return JS_EXCEPTION;
+  }
+
   it->world_data = listener_data->world_data;
   it->count = websg_collisions_listener_get_collision_count(listener_data->listener_id);
 
@@ -81,17 +91,42 @@ JSValue js_websg_create_collision_iterator(JSContext *ctx, WebSGCollisionListene
     return JS_EXCEPTION;
   }
 
-  CollisionItem *collisions = it->count == 0 ? NULL : js_mallocz(ctx, it->count * sizeof(CollisionItem));
-
-  if (websg_collisions_listener_get_collisions(listener_data->listener_id, collisions, it->count) == -1) {
-    js_free(ctx, it);
-    js_free(ctx, collisions);
-    JS_ThrowInternalError(ctx, "WebSGNetworking: error getting collisions.");
-    return JS_EXCEPTION;
+  if (listener_data->filtered) {
+    CollisionContact *contacts = it->count == 0 ? NULL : js_mallocz(ctx, it->count * sizeof(CollisionContact));
+
+    if (it->count != 0 && contacts == NULL) {
+      js_free(ctx, it);
+      return JS_EXCEPTION;
+    }
+
+    int32_t read_count = it->count == 0 ? 0 : websg_collision_listener_get_contacts(
+      listener_data->listener_id,
+      contacts,
+      it->count
+    );
+
+    if (read_count == -1) {
+      js_free(ctx, it);
+      js_free(ctx, contacts);
+      JS_ThrowInternalError(ctx, "WebSG: error getting contacts.");
+      return JS_EXCEPTION;
+    }
+
+    it->count = read_count;
+    it->contacts = contacts;
+  } else {
+    CollisionItem *collisions = it->count == 0 ? NULL : js_mallocz(ctx, it->count * sizeof(CollisionItem));
+
+    if (websg_collisions_listener_get_collisions(listener_data->listener_id, collisions, it->count) == -1) {
+      js_free(ctx, it);
+      js_free(ctx, collisions);
+      JS_ThrowInternalError(ctx, "WebSGNetworking: error getting collisions.");
+      return JS_EXCEPTION;
+    }
+
+    it->collisions = collisions;
   }
 
-  it->collisions = collisions;
-
   JSValue iter_obj = JS_NewObjectClass(ctx, js_websg_collision_iterator_class_id);
 
   if (JS_IsException(iter_obj)) {
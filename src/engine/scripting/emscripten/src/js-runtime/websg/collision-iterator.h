@@ -6,7 +6,9 @@
 
 typedef struct WebSGCollisionIteratorData {
     WebSGWorldData *world_data;
+    // Only one is set: filtered listeners deliver contacts.
     CollisionItem *collisions;
+    CollisionContact *contacts;
     uint32_t idx;
     uint32_t count;
 } WebSGCollisionIteratorData;
@@ -5,6 +5,7 @@
 #include "./world.h"
 #include "./collision-listener.h"
 #include "./collision-iterator.h"
+#include "./node.h"
 
 JSClassID js_websg_collision_listener_class_id;
 
@@ -52,8 +53,53 @@ static JSValue js_websg_collision_listener_dispose(
   return JS_EXCEPTION;
 }
 
+static JSValue js_websg_collision_listener_read_contacts(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  WebSGCollisionListenerData *collision_listener_data = JS_GetOpaque(this_val, js_websg_collision_listener_class_id);
+
+  size_t byte_length;
+  uint8_t *data = JS_GetArrayBuffer(ctx, &byte_length, argv[0]);
+
+  if (data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  uint32_t max_count = byte_length / sizeof(CollisionContact);
+  int32_t count = max_count == 0 ? 0 : websg_collision_listener_get_contacts(
+    collision_listener_data->listener_id,
+    (CollisionContact *)data,
+    max_count
+  );
+
+  if (count == -1) {
+    JS_ThrowInternalError(ctx, "WebSG: error reading contacts.");
+    return JS_EXCEPTION;
+  }
+
+  return JS_NewInt32(ctx, count);
+}
+
+static JSValue js_websg_collision_listener_get_dropped_count(JSContext *ctx, JSValueConst this_val) {
+  WebSGCollisionListenerData *collision_listener_data = JS_GetOpaque(this_val, js_websg_collision_listener_class_id);
+
+  int32_t dropped_count = websg_collision_listener_get_dropped_count(collision_listener_data->listener_id);
+
+  if (dropped_count == -1) {
+    JS_ThrowInternalError(ctx, "WebSG: error getting dropped collision count.");
+    return JS_EXCEPTION;
+  }
+
+  return JS_NewUint32(ctx, dropped_count);
+}
+
 static const JSCFunctionListEntry js_websg_collision_listener_proto_funcs[] = {
   JS_CFUNC_DEF("collisions", 1, js_websg_collision_listener_collisions),
+  JS_CFUNC_DEF("readContacts", 1, js_websg_collision_listener_read_contacts),
+  JS_CGETSET_DEF("droppedCount", js_websg_collision_listener_get_dropped_count, NULL),
   JS_CFUNC_DEF("dispose", 0, js_websg_collision_listener_dispose),
   JS_PROP_STRING_DEF("[Symbol.toStringTag]", "CollisionListener", JS_PROP_CONFIGURABLE),
 };
@@ -100,6 +146,78 @@ void js_websg_define_collision_listener(JSContext *ctx, JSValue websg) {
  * World Methods
  **/
 
+#define WEBSG_DEFAULT_COLLISION_LISTENER_CAPACITY 256
+
+static void js_websg_free_collision_listener_nodes(
+  JSContext *ctx,
+  JSValue nodes_val,
+  CollisionListenerProps *props,
+  int owned
+) {
+  if (owned) {
+    js_free(ctx, props->nodes);
+  }
+
+  JS_FreeValue(ctx, nodes_val);
+}
+
+static collision_listener_id_t js_websg_create_filtered_collision_listener(JSContext *ctx, JSValueConst options) {
+  CollisionListenerProps props = { .capacity = WEBSG_DEFAULT_COLLISION_LISTENER_CAPACITY };
+
+  // nodes_val is held until the listener is created because props.nodes may point into a Uint32Array.
+  JSValue nodes_val = JS_GetPropertyStr(ctx, options, "nodes");
+  int owned = 0;
+
+  if (!JS_IsUndefined(nodes_val)) {
+    owned = js_websg_get_node_ids(ctx, nodes_val, &props.nodes, &props.node_count);
+
+    if (owned < 0) {
+      JS_FreeValue(ctx, nodes_val);
+      return 0;
+    }
+  }
+
+  JSValue collision_groups_val = JS_GetPropertyStr(ctx, options, "collisionGroups");
+
+  if (!JS_IsUndefined(collision_groups_val)) {
+    int result = JS_ToUint32(ctx, &props.collision_groups, collision_groups_val);
+    JS_FreeValue(ctx, collision_groups_val);
+
+    if (result < 0) {
+      js_websg_free_collision_listener_nodes(ctx, nodes_val, &props, owned);
+      return 0;
+    }
+  }
+
+  JSValue capacity_val = JS_GetPropertyStr(ctx, options, "capacity");
+
+  if (!JS_IsUndefined(capacity_val)) {
+    int result = JS_ToUint32(ctx, &props.capacity, capacity_val);
+    JS_FreeValue(ctx, capacity_val);
+
+    if (result < 0) {
+      js_websg_free_collision_listener_nodes(ctx, nodes_val, &props, owned);
+      return 0;
+    }
+
+    if (props.capacity == 0) {
+      js_websg_free_collision_listener_nodes(ctx, nodes_val, &props, owned);
+      JS_ThrowRangeError(ctx, "WebSG: Collision listener capacity must be greater than 0.");
+      return 0;
+    }
+  }
+
+  collision_listener_id_t listener_id = websg_world_create_filtered_collision_listener(&props);
+
+  js_websg_free_collision_listener_nodes(ctx, nodes_val, &props, owned);
+
+  if (listener_id == 0) {
+    JS_ThrowInternalError(ctx, "WebSG: error creating listener.");
+  }
+
+  return listener_id;
+}
+
 JSValue js_websg_world_create_collision_listener(
   JSContext *ctx,
   JSValueConst this_val,
@@ -108,22 +226,47 @@ JSValue js_websg_world_create_collision_listener(
 ) {
   WebSGWorldData *world_data = JS_GetOpaque(this_val, js_websg_world_class_id);
 
+  bool filtered = !JS_IsUndefined(argv[0]);
+
+  if (filtered && !JS_IsObject(argv[0])) {
+    return JS_ThrowTypeError(ctx, "WebSG: Expected a collision listener options object.");
+  }
+
+  collision_listener_id_t listener_id;
+
+  if (filtered) {
+    listener_id = js_websg_create_filtered_collision_listener(ctx, argv[0]);
+
+    if (listener_id == 0) {
+      return JS_EXCEPTION;
+    }
+  } else {
+    listener_id = websg_world_create_collision_listener();
+
+    if (listener_id == 0) {
+      JS_ThrowInternalError(ctx, "WebSG: error creating listener.");
+      return JS_EXCEPTION;
+    }
+  }
+
   JSValue collision_listener = JS_NewObjectClass(ctx, js_websg_collision_listener_class_id);
 
   if (JS_IsException(collision_listener)) {
+    websg_collision_listener_dispose(listener_id);
     return collision_listener;
   }
 
-  collision_listener_id_t listener_id = websg_world_create_collision_listener();
+  WebSGCollisionListenerData *listener_data = js_mallocz(ctx, sizeof(WebSGCollisionListenerData));
 
-  if (listener_id == 0) {
-    JS_ThrowInternalError(ctx, "WebSGNetworking: error creating listener.");
+  if (listener_data == NULL) {
+    websg_collision_listener_dispose(listener_id);
+    JS_FreeValue(ctx, collision_listener);
     return JS_EXCEPTION;
   }
 
-  WebSGCollisionListenerData *listener_data = js_mallocz(ctx, sizeof(WebSGCollisionListenerData));
   listener_data->world_data = world_data;
   listener_data->listener_id = listener_id;
+  listener_data->filtered = filtered;
   JS_SetOpaque(collision_listener, listener_data);
   
   return collision_listener;
@@ -1,5 +1,6 @@
 #ifndef __websg_collision_listener_js_h
 #define __websg_collision_listener_js_h
+#include <stdbool.h>
 #include "../../websg.h"
 #include "../quickjs/quickjs.h"
 #include "./world.h"
@@ -7,6 +8,8 @@
 typedef struct WebSGCollisionListenerData {
   WebSGWorldData *world_data;
   collision_listener_id_t listener_id;
+  // Created with options: collisions are filtered on the host, kept in a ring buffer and carry contact data.
+  bool filtered;
 } WebSGCollisionListenerData;
 
 extern JSClassID js_websg_collision_listener_class_id;
@@ -96,3 +96,57 @@ JSValue js_websg_new_collision(JSContext *ctx, WebSGWorldData *world_data, Colli
   
   return collision;
 }
+
+static JSValue js_websg_new_contact_vector(JSContext *ctx, float_t *elements) {
+  JSValue arr = JS_NewArray(ctx);
+
+  if (JS_IsException(arr)) {
+    return arr;
+  }
+
+  for (int i = 0; i < 3; i++) {
+    JS_SetPropertyUint32(ctx, arr, i, JS_NewFloat64(ctx, elements[i]));
+  }
+
+  return arr;
+}
+
+JSValue js_websg_new_collision_with_contact(JSContext *ctx, WebSGWorldData *world_data, CollisionContact *contact) {
+  CollisionItem collision_item = {
+    .node_a = contact->node_a,
+    .node_b = contact->node_b,
+    .started = contact->started,
+  };
+
+  JSValue collision = js_websg_new_collision(ctx, world_data, &collision_item);
+
+  if (JS_IsException(collision)) {
+    return collision;
+  }
+
+  JS_DefinePropertyValueStr(
+    ctx,
+    collision,
+    "position",
+    js_websg_new_contact_vector(ctx, contact->position),
+    JS_PROP_ENUMERABLE | JS_PROP_CONFIGURABLE
+  );
+
+  JS_DefinePropertyValueStr(
+    ctx,
+    collision,
+    "normal",
+    js_websg_new_contact_vector(ctx, contact->normal),
+    JS_PROP_ENUMERABLE | JS_PROP_CONFIGURABLE
+  );
+
+  JS_DefinePropertyValueStr(
+    ctx,
+    collision,
+    "impulse",
+    JS_NewFloat64(ctx, contact->impulse),
+    JS_PROP_ENUMERABLE | JS_PROP_CONFIGURABLE
+  );
+
+  return collision;
+}
@@ -11,4 +11,7 @@ void js_websg_define_collision(JSContext *ctx, JSValue websg);
 
 JSValue js_websg_new_collision(JSContext *ctx, WebSGWorldData *world_data, CollisionItem *collision);
 
+// Collisions of filtered listeners also have position, normal and impulse properties.
+JSValue js_websg_new_collision_with_contact(JSContext *ctx, WebSGWorldData *world_data, CollisionContact *contact);
+
 #endif
@@ -4,6 +4,7 @@
 #include "./websg-js.h"
 #include "./component-store.h"
 #include "./component.h"
+#include "../utils/typedarray.h"
 
 JSClassID js_websg_component_store_class_id;
 
@@ -15,6 +16,11 @@ static void js_websg_component_store_finalizer(JSRuntime *rt, JSValue val) {
   WebSGComponentStoreData *component_store_data = JS_GetOpaque(val, js_websg_component_store_class_id);
 
   if (component_store_data) {
+    js_handle_table_free(rt, &component_store_data->component_instances);
+    JS_FreeValueRT(rt, component_store_data->prop_arrays);
+    JS_FreeValueRT(rt, component_store_data->store_buffer);
+    js_free_rt(rt, component_store_data->prop_byte_offsets);
+    js_free_rt(rt, component_store_data->props);
     js_free_rt(rt, component_store_data->store);
     js_free_rt(rt, component_store_data);
   }
@@ -25,7 +31,29 @@ static JSClassDef js_websg_component_store_class = {
   .finalizer = js_websg_component_store_finalizer
 };
 
+static JSValue js_websg_component_store_get_prop_array(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  WebSGComponentStoreData *component_store_data = JS_GetOpaque(this_val, js_websg_component_store_class_id);
+
+  const char *prop_name = JS_ToCString(ctx, argv[0]);
+
+  if (prop_name == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  JSValue prop_array = JS_GetPropertyStr(ctx, component_store_data->prop_arrays, prop_name);
+
+  JS_FreeCString(ctx, prop_name);
+
+  return prop_array;
+}
+
 static const JSCFunctionListEntry js_websg_component_store_proto_funcs[] = {
+  JS_CFUNC_DEF("getPropArray", 1, js_websg_component_store_get_prop_array),
   JS_PROP_STRING_DEF("[Symbol.toStringTag]", "ComponentStore", JS_PROP_CONFIGURABLE),
 };
 
@@ -67,6 +95,97 @@ void js_websg_define_component_store(JSContext *ctx, JSValue websg) {
   );
 }
 
+/**
+ * Prop columns are laid out back to back in the store, each holding component_store_size * prop_size
+ * elements, so every column can be exposed as a typed array over the store's ArrayBuffer without copying.
+ **/
+static int js_websg_component_store_create_prop_arrays(
+  JSContext *ctx,
+  WebSGComponentStoreData *component_store_data,
+  size_t store_byte_length
+) {
+  uint32_t component_store_size = component_store_data->component_store_size;
+  component_id_t component_id = component_store_data->component_id;
+  int32_t prop_count = websg_component_definition_get_prop_count(component_id);
+
+  if (prop_count == -1) {
+    JS_ThrowInternalError(ctx, "WebSG: Failed to get component prop count.");
+    return -1;
+  }
+
+  WebSGComponentStoreProp *props = js_mallocz(ctx, sizeof(WebSGComponentStoreProp) * prop_count);
+
+  if (props == NULL) {
+    return -1;
+  }
+
+  component_store_data->props = props;
+
+  JSValue store_buffer = JS_NewArrayBuffer(ctx, component_store_data->store, store_byte_length, NULL, NULL, 0);
+
+  if (JS_IsException(store_buffer)) {
+    return -1;
+  }
+
+  component_store_data->store_buffer = store_buffer;
+
+  JSValue prop_arrays = JS_NewObject(ctx);
+
+  for (int32_t i = 0; i < prop_count; i++) {
+    uint32_t prop_name_length = websg_component_definition_get_prop_name_length(component_id, i);
+    char *prop_name = js_mallocz(ctx, sizeof(char) * (prop_name_length + 1));
+
+    if (websg_component_definition_get_prop_name(component_id, i, prop_name, prop_name_length) == -1) {
+      js_free(ctx, prop_name);
+      JS_FreeValue(ctx, prop_arrays);
+      JS_ThrowInternalError(ctx, "WebSG: Failed to get prop name.");
+      return -1;
+    }
+
+    ComponentPropStorageType storage_type = websg_component_definition_get_prop_storage_type(component_id, i);
+    int32_t prop_size = websg_component_definition_get_prop_size(component_id, i);
+
+    JSTypedArrayType typed_array_type;
+
+    if (storage_type == ComponentPropStorageType_i32) {
+      typed_array_type = JSTypedArrayType_Int32;
+    } else if (storage_type == ComponentPropStorageType_u32) {
+      typed_array_type = JSTypedArrayType_Uint32;
+    } else if (storage_type == ComponentPropStorageType_f32) {
+      typed_array_type = JSTypedArrayType_Float32;
+    } else {
+      js_free(ctx, prop_name);
+      JS_FreeValue(ctx, prop_arrays);
+      JS_ThrowInternalError(ctx, "WebSG: Invalid prop storage type.");
+      return -1;
+    }
+
+    props[i].size = prop_size;
+    props[i].typed_array_type = typed_array_type;
+
+    JSValue prop_array = js_new_typed_array_subview(
+      ctx,
+      typed_array_type,
+      store_buffer,
+      component_store_data->prop_byte_offsets[i],
+      prop_size * component_store_size
+    );
+
+    if (JS_IsException(prop_array)) {
+      js_free(ctx, prop_name);
+      JS_FreeValue(ctx, prop_arrays);
+      return -1;
+    }
+
+    JS_DefinePropertyValueStr(ctx, prop_arrays, prop_name, prop_array, JS_PROP_ENUMERABLE);
+    js_free(ctx, prop_name);
+  }
+
+  component_store_data->prop_arrays = prop_arrays;
+
+  return 0;
+}
+
 /**
  * Public Methods
  **/
@@ -105,15 +224,28 @@ JSValue js_websg_new_component_store_instance(
   websg_world_set_component_store(component_id, store);
 
   WebSGComponentStoreData *component_store_data = js_mallocz(ctx, sizeof(WebSGComponentStoreData));
+
+  if (component_store_data == NULL) {
+    JS_FreeValue(ctx, component_store);
+    return JS_EXCEPTION;
+  }
+
   component_store_data->world_data = world_data;
   component_store_data->component_id = component_id;
   component_store_data->component_instance_class_id = component_instance_class_id;
-  component_store_data->component_instances = JS_NewObject(ctx);
   component_store_data->prop_byte_offsets = prop_byte_offsets;
+  component_store_data->component_store_size = component_store_size;
   component_store_data->store = store;
+  component_store_data->store_buffer = JS_UNDEFINED;
+  component_store_data->prop_arrays = JS_UNDEFINED;
   JS_SetOpaque(component_store, component_store_data);
 
-  JS_SetPropertyUint32(ctx, world_data->component_stores, component_id, JS_DupValue(ctx, component_store));
+  if (js_websg_component_store_create_prop_arrays(ctx, component_store_data, store_byte_length) == -1) {
+    JS_FreeValue(ctx, component_store);
+    return JS_EXCEPTION;
+  }
+
+  js_handle_table_set(ctx, &world_data->component_stores, component_id, JS_DupValue(ctx, component_store));
   
   return component_store;
 }
@@ -123,9 +255,8 @@ JSValue js_websg_component_store_get_instance(
   WebSGComponentStoreData *component_store_data,
   uint32_t component_store_index
 ) {
-  JSValue component_instance = JS_GetPropertyUint32(
-    ctx,
-    component_store_data->component_instances,
+  JSValue component_instance = js_handle_table_get(
+    &component_store_data->component_instances,
     component_store_index
   );
 
@@ -136,9 +267,13 @@ JSValue js_websg_component_store_get_instance(
       component_store_index
     );
 
-    JS_SetPropertyUint32(
+    if (JS_IsException(component_instance)) {
+      return component_instance;
+    }
+
+    js_handle_table_set(
       ctx,
-      component_store_data->component_instances,
+      &component_store_data->component_instances,
       component_store_index,
       component_instance
     );
@@ -152,7 +287,7 @@ JSValue js_websg_get_component_store_by_id(
   WebSGWorldData *world_data,
   component_id_t component_id
 ) {
-  JSValue component_store = JS_GetPropertyUint32(ctx, world_data->component_stores, component_id);
+  JSValueConst component_store = js_handle_table_get(&world_data->component_stores, component_id);
 
   if (!JS_IsUndefined(component_store)) {
     return JS_DupValue(ctx, component_store);
@@ -3,14 +3,27 @@
 #include "../../websg.h"
 #include "../quickjs/quickjs.h"
 #include "./world.h"
+#include "../utils/typedarray.h"
+
+typedef struct WebSGComponentStoreProp {
+  uint32_t size;
+  JSTypedArrayType typed_array_type;
+} WebSGComponentStoreProp;
 
 typedef struct WebSGComponentStoreData {
   WebSGWorldData *world_data;
   component_id_t component_id;
-  JSValue component_instances;
+  JSHandleTable component_instances;
   JSClassID component_instance_class_id;
   uint32_t *prop_byte_offsets;
+  // The element count and typed array type of each prop, indexed by prop index.
+  WebSGComponentStoreProp *props;
+  uint32_t component_store_size;
   void* store;
+  // An ArrayBuffer aliasing the whole store that prop arrays and array prop subviews are created over.
+  JSValue store_buffer;
+  // Maps prop names to typed arrays that alias their columns in the store.
+  JSValue prop_arrays;
 } WebSGComponentStoreData;
 
 extern JSClassID js_websg_component_store_class_id;
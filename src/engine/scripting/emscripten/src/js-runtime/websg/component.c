@@ -351,6 +351,37 @@ static JSValue js_websg_component_get_rgba_prop(JSContext *ctx, JSValueConst thi
   return JS_DupValue(ctx, prop_val);
 }
 
+// Array props are exposed as a subview of the prop's column in the store, so reads and writes go straight to
+// the store and every array prop on every component shares the store's ArrayBuffer.
+static JSValue js_websg_component_get_array_prop(JSContext *ctx, JSValueConst this_val, int prop_idx) {
+  WebSGComponentData *component_data = JS_GetOpaque_UNSAFE(this_val);
+  WebSGComponentStoreData *store_data = component_data->component_store_data;
+
+  JSValue prop_val = JS_GetPropertyUint32(ctx, component_data->private_fields, prop_idx);
+
+  if (!JS_IsUndefined(prop_val)) {
+    return prop_val;
+  }
+
+  if (component_data->component_store_index >= store_data->component_store_size) {
+    return JS_ThrowRangeError(ctx, "WebSG: Component is outside of the component store.");
+  }
+
+  WebSGComponentStoreProp *prop = &store_data->props[prop_idx];
+  uint32_t byte_offset = store_data->prop_byte_offsets[prop_idx] +
+    4 * prop->size * component_data->component_store_index;
+
+  prop_val = js_new_typed_array_subview(ctx, prop->typed_array_type, store_data->store_buffer, byte_offset, prop->size);
+
+  if (JS_IsException(prop_val)) {
+    return JS_EXCEPTION;
+  }
+
+  JS_SetPropertyUint32(ctx, component_data->private_fields, prop_idx, JS_DupValue(ctx, prop_val));
+
+  return prop_val;
+}
+
 JSClassID js_websg_define_component_instance(
   JSContext *ctx,
   component_id_t component_id,
@@ -365,7 +396,7 @@ JSClassID js_websg_define_component_instance(
     return 0;
   }
 
-  const char *component_name = js_mallocz(ctx, sizeof(char) * component_name_length);
+  const char *component_name = js_mallocz(ctx, sizeof(char) * (component_name_length + 1));
 
   if (websg_component_definition_get_name(component_id, component_name, component_name_length) == -1) {
     JS_ThrowInternalError(ctx, "Failed to get component name");
@@ -405,7 +436,7 @@ JSClassID js_websg_define_component_instance(
         return 0;
       }
 
-      const char *prop_name = js_mallocz(ctx, sizeof(char) * prop_name_length);
+      const char *prop_name = js_mallocz(ctx, sizeof(char) * (prop_name_length + 1));
 
       if (websg_component_definition_get_prop_name(component_id, i, prop_name, prop_name_length) == -1) {
         JS_ThrowInternalError(ctx, "Failed to get prop name");
@@ -419,7 +450,7 @@ JSClassID js_websg_define_component_instance(
         return 0;
       }
 
-      const char *prop_type = js_mallocz(ctx, sizeof(char) * prop_type_length);
+      const char *prop_type = js_mallocz(ctx, sizeof(char) * (prop_type_length + 1));
 
       if (websg_component_definition_get_prop_type(component_id, i, prop_type, prop_type_length) == -1) {
         JS_ThrowInternalError(ctx, "Failed to get prop type");
@@ -436,7 +467,7 @@ JSClassID js_websg_define_component_instance(
           return 0;
         }
 
-        const char *ref_type = js_mallocz(ctx, sizeof(char) * ref_type_length);
+        const char *ref_type = js_mallocz(ctx, sizeof(char) * (ref_type_length + 1));
 
         if (websg_component_definition_get_ref_type(component_id, i, ref_type, ref_type_length) == -1) {
           JS_ThrowInternalError(ctx, "Failed to get ref type");
@@ -561,31 +592,17 @@ JSClassID js_websg_define_component_instance(
             NULL,
             i
           );
-        // TODO: Figure out how to handle typed arrays with size defined by prop size.
-        // } else if (storage_type == ComponentPropStorageType_i32) {
-        //   js_websg_define_component_i32_array_prop(
-        //     ctx,
-        //     component_instance_proto,
-        //     prop_name,
-        //     byte_offset,
-        //     prop_size
-        //   );
-        // } else if (storage_type == ComponentPropStorageType_u32) {
-        //   js_websg_define_component_u32_array_prop(
-        //     ctx,
-        //     component_instance_proto,
-        //     prop_name,
-        //     byte_offset,
-        //     prop_size
-        //   );
-        // } else if (storage_type == ComponentPropStorageType_f32) {
-        //   js_websg_define_component_f32_array_prop(
-        //     ctx,
-        //     component_instance_proto,
-        //     prop_name,
-        //     byte_offset,
-        //     prop_size
-        //   );
+        } else if (
+          storage_type == ComponentPropStorageType_i32 ||
+          storage_type == ComponentPropStorageType_u32 ||
+          storage_type == ComponentPropStorageType_f32
+        ) {
+          entry = (JSCFunctionListEntry)JS_CGETSET_MAGIC_DEF(
+            prop_name,
+            js_websg_component_get_array_prop,
+            NULL,
+            i
+          );
         } else {
           JS_ThrowInternalError(ctx, "Invalid prop storage type");
           return 0;
@@ -622,6 +639,12 @@ JSValue js_websg_create_component_instance(
 ) {
   JSValue component_instance = JS_NewObjectClass(ctx, component_store_data->component_instance_class_id);
   WebSGComponentData *component_data = js_mallocz(ctx, sizeof(WebSGComponentData));
+
+  if (component_data == NULL) {
+    JS_FreeValue(ctx, component_instance);
+    return JS_EXCEPTION;
+  }
+
   component_data->component_store_data = component_store_data;
   component_data->component_store_index = component_store_index;
   component_data->private_fields = JS_NewObject(ctx);
@@ -64,11 +64,17 @@ JSValue js_websg_new_image_instance(JSContext *ctx, WebSGWorldData *world_data,
   }
 
   WebSGImageData *image_data = js_mallocz(ctx, sizeof(WebSGImageData));
+
+  if (image_data == NULL) {
+    JS_FreeValue(ctx, image);
+    return JS_EXCEPTION;
+  }
+
   image_data->world_data = world_data;
   image_data->image_id = image_id;
   JS_SetOpaque(image, image_data);
 
-  JS_SetPropertyUint32(ctx, world_data->images, image_id, JS_DupValue(ctx, image));
+  js_handle_table_set(ctx, &world_data->images, image_id, JS_DupValue(ctx, image));
   
   return image;
 }
@@ -78,7 +84,7 @@ JSValue js_websg_new_image_instance(JSContext *ctx, WebSGWorldData *world_data,
  **/
 
 JSValue js_websg_get_image_by_id(JSContext *ctx, WebSGWorldData *world_data, image_id_t image_id) {
-  JSValue image = JS_GetPropertyUint32(ctx, world_data->images, image_id);
+  JSValueConst image = js_handle_table_get(&world_data->images, image_id);
 
   if (!JS_IsUndefined(image)) {
     return JS_DupValue(ctx, image);
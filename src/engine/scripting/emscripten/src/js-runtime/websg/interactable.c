@@ -129,6 +129,12 @@ JSValue js_websg_init_node_interactable(JSContext *ctx, node_id_t node_id) {
   }
 
   WebSGInteractableData *interactable_data = js_mallocz(ctx, sizeof(WebSGInteractableData));
+
+  if (interactable_data == NULL) {
+    JS_FreeValue(ctx, interactable);
+    return JS_EXCEPTION;
+  }
+
   interactable_data->node_id = node_id;
   JS_SetOpaque(interactable, interactable_data);
   
@@ -170,6 +176,12 @@ JSValue js_websg_node_add_interactable(JSContext *ctx, JSValueConst this_val, in
   }
 
   WebSGInteractableData *interactable_data = js_mallocz(ctx, sizeof(WebSGInteractableData));
+
+  if (interactable_data == NULL) {
+    JS_FreeValue(ctx, interactable);
+    return JS_EXCEPTION;
+  }
+
   interactable_data->node_id = node_data->node_id;
   JS_SetOpaque(interactable, interactable_data);
 
@@ -206,6 +218,12 @@ JSValue js_websg_node_get_interactable(JSContext *ctx, JSValueConst this_val) {
     }
 
     WebSGInteractableData *interactable_data = js_mallocz(ctx, sizeof(WebSGInteractableData));
+
+    if (interactable_data == NULL) {
+      JS_FreeValue(ctx, interactable);
+      return JS_EXCEPTION;
+    }
+
     interactable_data->node_id = node_data->node_id;
 
     JS_SetOpaque(interactable, interactable_data);
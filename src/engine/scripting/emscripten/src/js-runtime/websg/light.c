@@ -134,11 +134,17 @@ JSValue js_websg_new_light_instance(JSContext *ctx, WebSGWorldData *world_data,
   );
 
   WebSGLightData *light_data = js_mallocz(ctx, sizeof(WebSGLightData));
+
+  if (light_data == NULL) {
+    JS_FreeValue(ctx, light);
+    return JS_EXCEPTION;
+  }
+
   light_data->world_data = world_data;
   light_data->light_id = light_id;
   JS_SetOpaque(light, light_data);
 
-  JS_SetPropertyUint32(ctx, world_data->lights, light_id, JS_DupValue(ctx, light));
+  js_handle_table_set(ctx, &world_data->lights, light_id, JS_DupValue(ctx, light));
   
   return light;
 }
@@ -148,7 +154,7 @@ JSValue js_websg_new_light_instance(JSContext *ctx, WebSGWorldData *world_data,
  **/
 
 JSValue js_websg_get_light_by_id(JSContext *ctx, WebSGWorldData *world_data, light_id_t light_id) {
-  JSValue light = JS_GetPropertyUint32(ctx, world_data->lights, light_id);
+  JSValueConst light = js_handle_table_get(&world_data->lights, light_id);
 
   if (!JS_IsUndefined(light)) {
     return JS_DupValue(ctx, light);
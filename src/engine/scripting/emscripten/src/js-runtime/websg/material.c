@@ -186,9 +186,17 @@ JSValue js_websg_new_material_instance(JSContext *ctx, WebSGWorldData *world_dat
   );
 
   WebSGMaterialData *material_data = js_mallocz(ctx, sizeof(WebSGMaterialData));
+
+  if (material_data == NULL) {
+    JS_FreeValue(ctx, material);
+    return JS_EXCEPTION;
+  }
+
   material_data->world_data = world_data;
   material_data->material_id = material_id;
   JS_SetOpaque(material, material_data);
+
+  js_handle_table_set(ctx, &world_data->materials, material_id, JS_DupValue(ctx, material));
   
   return material;
 }
@@ -198,7 +206,7 @@ JSValue js_websg_new_material_instance(JSContext *ctx, WebSGWorldData *world_dat
  **/
 
 JSValue js_websg_get_material_by_id(JSContext *ctx, WebSGWorldData *world_data, material_id_t material_id) {
-  JSValue material = JS_GetPropertyUint32(ctx, world_data->materials, material_id);
+  JSValueConst material = js_handle_table_get(&world_data->materials, material_id);
 
   if (!JS_IsUndefined(material)) {
     return JS_DupValue(ctx, material);
@@ -141,6 +141,12 @@ void js_websg_define_matrix4(JSContext *ctx, JSValue websg) {
 JSValue js_websg_create_matrix4(JSContext *ctx, float* elements) {
   JSValue matrix4 = JS_NewObjectClass(ctx, js_websg_matrix4_class_id);
   WebSGMatrix4Data *matrix_data = js_mallocz(ctx, sizeof(WebSGMatrix4Data));
+
+  if (matrix_data == NULL) {
+    JS_FreeValue(ctx, matrix4);
+    return JS_EXCEPTION;
+  }
+
   matrix_data->elements = elements;
   return matrix4;
 }
@@ -156,6 +162,12 @@ JSValue js_websg_new_matrix4_get_set(
   JSValue matrix4 = JS_NewObjectClass(ctx, js_websg_matrix4_class_id);
 
   WebSGMatrix4Data *matrix_data = js_mallocz(ctx, sizeof(WebSGMatrix4Data));
+
+  if (matrix_data == NULL) {
+    JS_FreeValue(ctx, matrix4);
+    return JS_EXCEPTION;
+  }
+
   matrix_data->elements = js_mallocz(ctx, sizeof(float_t) * 16);
   matrix_data->get = get;
   matrix_data->set = set;
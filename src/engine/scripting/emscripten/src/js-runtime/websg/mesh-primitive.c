@@ -319,6 +319,12 @@ JSValue js_websg_new_mesh_primitive_instance(
   }
 
   WebSGMeshPrimitiveData *mesh_primitive_data = js_mallocz(ctx, sizeof(WebSGMeshPrimitiveData));
+
+  if (mesh_primitive_data == NULL) {
+    JS_FreeValue(ctx, mesh_primitive);
+    return JS_EXCEPTION;
+  }
+
   mesh_primitive_data->mesh_id = mesh_id;
   mesh_primitive_data->index = index;
 
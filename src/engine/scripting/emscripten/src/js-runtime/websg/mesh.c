@@ -67,11 +67,17 @@ JSValue js_websg_new_mesh_instance(JSContext *ctx, WebSGWorldData *world_data, m
   }
 
   WebSGMeshData *mesh_data = js_mallocz(ctx, sizeof(WebSGMeshData));
+
+  if (mesh_data == NULL) {
+    JS_FreeValue(ctx, mesh);
+    return JS_EXCEPTION;
+  }
+
   mesh_data->world_data = world_data;
   mesh_data->mesh_id = mesh_id;
   JS_SetOpaque(mesh, mesh_data);
 
-  JS_SetPropertyUint32(ctx, world_data->meshes, mesh_id, JS_DupValue(ctx, mesh));
+  js_handle_table_set(ctx, &world_data->meshes, mesh_id, JS_DupValue(ctx, mesh));
 
   JSValue primitives_arr = JS_NewArray(ctx);
 
@@ -100,7 +106,7 @@ JSValue js_websg_new_mesh_instance(JSContext *ctx, WebSGWorldData *world_data, m
  **/
 
 JSValue js_websg_get_mesh_by_id(JSContext *ctx, WebSGWorldData *world_data, mesh_id_t mesh_id) {
-  JSValue mesh = JS_GetPropertyUint32(ctx, world_data->meshes, mesh_id);
+  JSValueConst mesh = js_handle_table_get(&world_data->meshes, mesh_id);
 
   if (!JS_IsUndefined(mesh)) {
     return JS_DupValue(ctx, mesh);
@@ -1,3 +1,4 @@
+#include <stdint.h>
 #include <string.h>
 #include "../quickjs/cutils.h"
 #include "../quickjs/quickjs.h"
@@ -16,6 +17,7 @@
 #include "./ui-canvas.h"
 #include "./component-store.h"
 #include "../utils/array.h"
+#include "../utils/typedarray.h"
 
 JSClassID js_websg_node_class_id;
 
@@ -25,6 +27,11 @@ static void js_websg_node_finalizer(JSRuntime *rt, JSValue val) {
   if (node_data) {
     JS_FreeValueRT(rt, node_data->interactable);
     JS_FreeValueRT(rt, node_data->physics_body);
+
+    for (int i = 0; i < WebSGNodeTransformProp_Count; i++) {
+      JS_FreeValueRT(rt, node_data->transform_props[i]);
+    }
+
     js_free_rt(rt, node_data);
   }
 }
@@ -101,7 +108,7 @@ JSValue js_websg_node_children(JSContext *ctx, JSValueConst this_val, int argc,
     return JS_EXCEPTION;
   }
 
-  node_id_t *children = js_mallocz(ctx, sizeof(node_id_t) * count);
+  node_id_t *children = count == 0 ? NULL : js_mallocz(ctx, sizeof(node_id_t) * count);
 
   if (websg_node_get_children(node_data->node_id, children, count) == -1) {
     JS_ThrowInternalError(ctx, "WebSG: Error getting node children.");
@@ -400,6 +407,11 @@ static JSValue js_websg_node_get_component(JSContext *ctx, JSValueConst this_val
   return js_websg_component_store_get_instance(ctx, component_store_data, node_data->component_store_index);
 }
 
+static JSValue js_websg_node_get_component_store_index(JSContext *ctx, JSValueConst this_val) {
+  WebSGNodeData *node_data = JS_GetOpaque(this_val, js_websg_node_class_id);
+  return JS_NewUint32(ctx, node_data->component_store_index);
+}
+
 static JSValue js_websg_node_set_forward_direction(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
   WebSGNodeData *node_data = JS_GetOpaque(this_val, js_websg_node_class_id);
 
@@ -421,6 +433,71 @@ static JSValue js_websg_node_set_forward_direction(JSContext *ctx, JSValueConst
   return JS_UNDEFINED;
 }
 
+/**
+ * Transform properties are only created when a script first reads them, so nodes that are just passed around
+ * (query results, children(), collisions) cost a single object.
+ **/
+static JSValue js_websg_node_create_transform_prop(JSContext *ctx, node_id_t node_id, WebSGNodeTransformProp prop) {
+  switch (prop) {
+    case WebSGNodeTransformProp_Translation:
+      return js_websg_new_vector3_get_set(
+        ctx,
+        node_id,
+        &websg_node_get_translation_element,
+        &websg_node_set_translation_element,
+        &websg_node_set_translation,
+        0
+      );
+    case WebSGNodeTransformProp_Rotation:
+      return js_websg_new_quaternion_get_set(
+        ctx,
+        node_id,
+        &websg_node_get_rotation_element,
+        &websg_node_set_rotation_element,
+        &websg_node_set_rotation,
+        0
+      );
+    case WebSGNodeTransformProp_Scale:
+      return js_websg_new_vector3_get_set(
+        ctx,
+        node_id,
+        &websg_node_get_scale_element,
+        &websg_node_set_scale_element,
+        &websg_node_set_scale,
+        0
+      );
+    case WebSGNodeTransformProp_Matrix:
+      return js_websg_new_matrix4_get_set(
+        ctx,
+        node_id,
+        &websg_node_get_matrix_element,
+        &websg_node_set_matrix_element,
+        &websg_node_set_matrix,
+        0
+      );
+    case WebSGNodeTransformProp_WorldMatrix:
+      return js_websg_new_matrix4_get_set(ctx, node_id, &websg_node_get_world_matrix_element, NULL, NULL, 1);
+    default:
+      return JS_ThrowInternalError(ctx, "WebSG: Unknown transform property.");
+  }
+}
+
+static JSValue js_websg_node_get_transform_prop(JSContext *ctx, JSValueConst this_val, int prop) {
+  WebSGNodeData *node_data = JS_GetOpaque(this_val, js_websg_node_class_id);
+
+  if (JS_IsUndefined(node_data->transform_props[prop])) {
+    JSValue value = js_websg_node_create_transform_prop(ctx, node_data->node_id, prop);
+
+    if (JS_IsException(value)) {
+      return JS_EXCEPTION;
+    }
+
+    node_data->transform_props[prop] = value;
+  }
+
+  return JS_DupValue(ctx, node_data->transform_props[prop]);
+}
+
 // Implement the addChild and removeChild methods
 static const JSCFunctionListEntry js_websg_node_proto_funcs[] = {
   JS_CFUNC_DEF("addChild", 1, js_websg_node_add_child),
@@ -428,6 +505,11 @@ static const JSCFunctionListEntry js_websg_node_proto_funcs[] = {
   JS_CFUNC_DEF("getChild", 1, js_websg_node_get_child),
   JS_CFUNC_DEF("children", 0, js_websg_node_children),
   JS_CFUNC_DEF("dispose", 0, js_websg_node_dispose),
+  JS_CGETSET_MAGIC_DEF("translation", js_websg_node_get_transform_prop, NULL, WebSGNodeTransformProp_Translation),
+  JS_CGETSET_MAGIC_DEF("rotation", js_websg_node_get_transform_prop, NULL, WebSGNodeTransformProp_Rotation),
+  JS_CGETSET_MAGIC_DEF("scale", js_websg_node_get_transform_prop, NULL, WebSGNodeTransformProp_Scale),
+  JS_CGETSET_MAGIC_DEF("matrix", js_websg_node_get_transform_prop, NULL, WebSGNodeTransformProp_Matrix),
+  JS_CGETSET_MAGIC_DEF("worldMatrix", js_websg_node_get_transform_prop, NULL, WebSGNodeTransformProp_WorldMatrix),
   JS_CGETSET_DEF("parent", js_websg_node_parent, NULL),
   JS_CGETSET_DEF("isStatic", js_websg_node_get_is_static, js_websg_node_set_is_static),
   JS_CGETSET_DEF("visible", js_websg_node_get_visible, js_websg_node_set_visible),
@@ -446,6 +528,7 @@ static const JSCFunctionListEntry js_websg_node_proto_funcs[] = {
   JS_CFUNC_DEF("removeComponent", 1, js_websg_node_remove_component),
   JS_CFUNC_DEF("hasComponent", 1, js_websg_node_has_component),
   JS_CFUNC_DEF("getComponent", 1, js_websg_node_get_component),
+  JS_CGETSET_DEF("componentStoreIndex", js_websg_node_get_component_store_index, NULL),
   JS_CFUNC_DEF("setForwardDirection", 1, js_websg_node_set_forward_direction),
   JS_PROP_STRING_DEF("[Symbol.toStringTag]", "Node", JS_PROP_CONFIGURABLE),
 };
@@ -485,63 +568,26 @@ JSValue js_websg_new_node_instance(JSContext *ctx, WebSGWorldData *world_data, n
     return node;
   }
 
-  js_websg_define_vector3_prop(
-    ctx,
-    node,
-    "translation",
-    node_id,
-    &websg_node_get_translation_element,
-    &websg_node_set_translation_element,
-    &websg_node_set_translation
-  );
-
-  js_websg_define_quaternion_prop(
-    ctx,
-    node,
-    "rotation",
-    node_id,
-    &websg_node_get_rotation_element,
-    &websg_node_set_rotation_element,
-    &websg_node_set_rotation
-  );
-
-  js_websg_define_vector3_prop(
-    ctx,
-    node,
-    "scale",
-    node_id,
-    &websg_node_get_scale_element,
-    &websg_node_set_scale_element,
-    &websg_node_set_scale
-  );
-
-  js_websg_define_matrix4_prop(
-    ctx,
-    node,
-    "matrix",
-    node_id,
-    &websg_node_get_matrix_element,
-    &websg_node_set_matrix_element,
-    &websg_node_set_matrix
-  );
+  WebSGNodeData *node_data = js_mallocz(ctx, sizeof(WebSGNodeData));
 
-  js_websg_define_matrix4_prop_read_only(
-    ctx,
-    node,
-    "worldMatrix",
-    node_id,
-    &websg_node_get_world_matrix_element
-  );
+  if (node_data == NULL) {
+    JS_FreeValue(ctx, node);
+    return JS_EXCEPTION;
+  }
 
-  WebSGNodeData *node_data = js_mallocz(ctx, sizeof(WebSGNodeData));
   node_data->world_data = world_data;
   node_data->node_id = node_id;
   node_data->component_store_index = websg_node_get_component_store_index(node_id);
   node_data->interactable = js_websg_init_node_interactable(ctx, node_id);
   node_data->physics_body = js_websg_init_node_physics_body(ctx, node_id);
+
+  for (int i = 0; i < WebSGNodeTransformProp_Count; i++) {
+    node_data->transform_props[i] = JS_UNDEFINED;
+  }
+
   JS_SetOpaque(node, node_data);
 
-  JS_SetPropertyUint32(ctx, world_data->nodes, node_id, JS_DupValue(ctx, node));
+  js_handle_table_set(ctx, &world_data->nodes, node_id, JS_DupValue(ctx, node));
 
   return node;
 }
@@ -551,7 +597,7 @@ JSValue js_websg_new_node_instance(JSContext *ctx, WebSGWorldData *world_data, n
  **/
 
 JSValue js_websg_get_node_by_id(JSContext *ctx, WebSGWorldData *world_data, node_id_t node_id) {
-  JSValue node = JS_GetPropertyUint32(ctx, world_data->nodes, node_id);
+  JSValueConst node = js_handle_table_get(&world_data->nodes, node_id);
 
   if (!JS_IsUndefined(node)) {
     return JS_DupValue(ctx, node);
@@ -715,4 +761,197 @@ JSValue js_websg_world_find_node_by_name(JSContext *ctx, JSValueConst this_val,
   }
 
   return js_websg_get_node_by_id(ctx, world_data, node_id);
-}
\ No newline at end of file
+}
+/**
+ * Bulk transform access. Nodes can be passed as an array of Node objects or a Uint32Array of node ids and the
+ * values are packed back to back in a Float32Array, so a whole crowd can be moved with a single import call.
+ **/
+
+int js_websg_get_node_ids(JSContext *ctx, JSValueConst nodes, node_id_t **node_ids, uint32_t *count) {
+  int is_array = JS_IsArray(ctx, nodes);
+
+  if (is_array < 0) {
+    return -1;
+  }
+
+  if (!is_array) {
+    // Other 4 byte typed arrays like Float32Array would be reinterpreted as ids.
+    if (!js_is_typed_array_type(ctx, nodes, JSTypedArrayType_Uint32)) {
+      JS_ThrowTypeError(ctx, "WebSG: Expected an array of nodes or a Uint32Array of node ids.");
+      return -1;
+    }
+
+    size_t view_byte_offset;
+    size_t view_byte_length;
+    size_t view_bytes_per_element;
+
+    JSValue buffer = JS_GetTypedArrayBuffer(ctx, nodes, &view_byte_offset, &view_byte_length, &view_bytes_per_element);
+
+    if (JS_IsException(buffer)) {
+      return -1;
+    }
+
+    size_t buffer_byte_length;
+    uint8_t *data = JS_GetArrayBuffer(ctx, &buffer_byte_length, buffer);
+    JS_FreeValue(ctx, buffer);
+
+    if (data == NULL) {
+      return -1;
+    }
+
+    // Ids are read straight out of the typed array, which keeps its buffer alive for as long as nodes is.
+    *count = view_byte_length / sizeof(node_id_t);
+    *node_ids = *count == 0 ? NULL : (node_id_t *)(data + view_byte_offset);
+
+    return 0;
+  }
+
+  JSValue length_val = JS_GetPropertyStr(ctx, nodes, "length");
+  uint32_t length;
+
+  if (JS_ToUint32(ctx, &length, length_val) < 0) {
+    JS_FreeValue(ctx, length_val);
+    return -1;
+  }
+
+  JS_FreeValue(ctx, length_val);
+
+  if (length > UINT32_MAX / sizeof(node_id_t)) {
+    JS_ThrowRangeError(ctx, "WebSG: Too many nodes.");
+    return -1;
+  }
+
+  node_id_t *ids = NULL;
+
+  if (length > 0) {
+    ids = js_malloc(ctx, sizeof(node_id_t) * length);
+
+    if (ids == NULL) {
+      return -1;
+    }
+  }
+
+  for (uint32_t i = 0; i < length; i++) {
+    JSValue node = JS_GetPropertyUint32(ctx, nodes, i);
+    WebSGNodeData *node_data = JS_GetOpaque2(ctx, node, js_websg_node_class_id);
+    JS_FreeValue(ctx, node);
+
+    if (node_data == NULL) {
+      js_free(ctx, ids);
+      return -1;
+    }
+
+    ids[i] = node_data->node_id;
+  }
+
+  *node_ids = ids;
+  *count = length;
+
+  return 1;
+}
+
+static const uint32_t js_websg_node_transform_prop_lengths[WebSGNodeTransformProp_Count] = { 3, 4, 3, 16, 16 };
+
+static int32_t (*const js_websg_nodes_get_transform_funcs[WebSGNodeTransformProp_Count])(
+  node_id_t *node_ids,
+  uint32_t count,
+  float_t *values
+) = {
+  &websg_nodes_get_translations,
+  &websg_nodes_get_rotations,
+  &websg_nodes_get_scales,
+  &websg_nodes_get_matrices,
+  &websg_nodes_get_world_matrices,
+};
+
+static int32_t (*const js_websg_nodes_set_transform_funcs[WebSGNodeTransformProp_Count])(
+  node_id_t *node_ids,
+  uint32_t count,
+  float_t *values
+) = {
+  &websg_nodes_set_translations,
+  &websg_nodes_set_rotations,
+  &websg_nodes_set_scales,
+  &websg_nodes_set_matrices,
+  &websg_nodes_set_world_matrices,
+};
+
+JSValue js_websg_world_get_node_transforms(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv,
+  int prop
+) {
+  node_id_t *node_ids;
+  uint32_t count;
+
+  int owned = js_websg_get_node_ids(ctx, argv[0], &node_ids, &count);
+
+  if (owned < 0) {
+    return JS_EXCEPTION;
+  }
+
+  size_t byte_length = sizeof(float_t) * js_websg_node_transform_prop_lengths[prop] * count;
+  float_t *values = get_typed_array_data(ctx, &argv[1], byte_length);
+
+  if (values == NULL) {
+    if (owned) {
+      js_free(ctx, node_ids);
+    }
+    return JS_EXCEPTION;
+  }
+
+  int32_t result = count == 0 ? 0 : js_websg_nodes_get_transform_funcs[prop](node_ids, count, values);
+
+  if (owned) {
+    js_free(ctx, node_ids);
+  }
+
+  if (result < 0) {
+    JS_ThrowInternalError(ctx, "WebSG: Couldn't get node transforms.");
+    return JS_EXCEPTION;
+  }
+
+  return JS_DupValue(ctx, argv[1]);
+}
+
+JSValue js_websg_world_set_node_transforms(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv,
+  int prop
+) {
+  node_id_t *node_ids;
+  uint32_t count;
+
+  int owned = js_websg_get_node_ids(ctx, argv[0], &node_ids, &count);
+
+  if (owned < 0) {
+    return JS_EXCEPTION;
+  }
+
+  size_t byte_length = sizeof(float_t) * js_websg_node_transform_prop_lengths[prop] * count;
+  float_t *values = get_typed_array_data(ctx, &argv[1], byte_length);
+
+  if (values == NULL) {
+    if (owned) {
+      js_free(ctx, node_ids);
+    }
+    return JS_EXCEPTION;
+  }
+
+  int32_t result = count == 0 ? 0 : js_websg_nodes_set_transform_funcs[prop](node_ids, count, values);
+
+  if (owned) {
+    js_free(ctx, node_ids);
+  }
+
+  if (result < 0) {
+    JS_ThrowInternalError(ctx, "WebSG: Couldn't set node transforms.");
+    return JS_EXCEPTION;
+  }
+
+  return JS_UNDEFINED;
+}
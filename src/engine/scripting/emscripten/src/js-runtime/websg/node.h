@@ -6,12 +6,23 @@
 
 extern JSClassID js_websg_node_class_id;
 
+typedef enum WebSGNodeTransformProp {
+  WebSGNodeTransformProp_Translation,
+  WebSGNodeTransformProp_Rotation,
+  WebSGNodeTransformProp_Scale,
+  WebSGNodeTransformProp_Matrix,
+  WebSGNodeTransformProp_WorldMatrix,
+  WebSGNodeTransformProp_Count,
+} WebSGNodeTransformProp;
+
 typedef struct WebSGNodeData {
   WebSGWorldData *world_data;
   node_id_t node_id;
   uint32_t component_store_index;
   JSValue interactable;
   JSValue physics_body;
+  // Created on first access, JS_UNDEFINED until then.
+  JSValue transform_props[WebSGNodeTransformProp_Count];
 } WebSGNodeData;
 
 void js_websg_define_node(JSContext *ctx, JSValue websg);
@@ -22,4 +33,25 @@ JSValue js_websg_world_create_node(JSContext *ctx, JSValueConst this_val, int ar
 
 JSValue js_websg_world_find_node_by_name(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv);
 
+// Accepts an array of nodes or a Uint32Array of node ids. Returns 1 if node_ids was allocated with js_malloc and
+// must be freed, which is only the case for an array of nodes, 0 if it points into the Uint32Array or is NULL when
+// empty, and -1 on error.
+int js_websg_get_node_ids(JSContext *ctx, JSValueConst nodes, node_id_t **node_ids, uint32_t *count);
+
+JSValue js_websg_world_get_node_transforms(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv,
+  int prop
+);
+
+JSValue js_websg_world_set_node_transforms(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv,
+  int prop
+);
+
 #endif
@@ -4,6 +4,7 @@
 #include "./node.h"
 #include "./physics-body.h"
 #include "../utils/array.h"
+#include "../utils/typedarray.h"
 
 JSClassID js_websg_physics_body_class_id;
 
@@ -125,6 +126,12 @@ JSValue js_websg_init_node_physics_body(JSContext *ctx, node_id_t node_id) {
   }
 
   WebSGPhysicsBodyData *physics_body_data = js_mallocz(ctx, sizeof(WebSGPhysicsBodyData));
+
+  if (physics_body_data == NULL) {
+    JS_FreeValue(ctx, physics_body);
+    return JS_EXCEPTION;
+  }
+
   physics_body_data->node_id = node_id;
   JS_SetOpaque(physics_body, physics_body_data);
   
@@ -199,6 +206,12 @@ JSValue js_websg_node_add_physics_body(JSContext *ctx, JSValueConst this_val, in
   }
 
   WebSGPhysicsBodyData *physics_body_data = js_mallocz(ctx, sizeof(WebSGPhysicsBodyData));
+
+  if (physics_body_data == NULL) {
+    JS_FreeValue(ctx, physics_body);
+    return JS_EXCEPTION;
+  }
+
   physics_body_data->node_id = node_data->node_id;
   JS_SetOpaque(physics_body, physics_body_data);
 
@@ -235,6 +248,12 @@ JSValue js_websg_node_get_physics_body(JSContext *ctx, JSValueConst this_val) {
     }
 
     WebSGPhysicsBodyData *physics_body_data = js_mallocz(ctx, sizeof(WebSGPhysicsBodyData));
+
+    if (physics_body_data == NULL) {
+      JS_FreeValue(ctx, physics_body);
+      return JS_EXCEPTION;
+    }
+
     physics_body_data->node_id = node_data->node_id;
 
     JS_SetOpaque(physics_body, physics_body_data);
@@ -246,3 +265,231 @@ JSValue js_websg_node_get_physics_body(JSContext *ctx, JSValueConst this_val) {
 
   return JS_DupValue(ctx, node_data->physics_body);
 }
+
+/**
+ * Bulk Physics Body State
+ **/
+
+// Every prop is 3 floats per node, except sleeping which is a uint32.
+static size_t js_websg_physics_body_state_byte_length(int prop, uint32_t count) {
+  return prop == WebSGPhysicsBodyStateProp_Sleeping ? sizeof(uint32_t) * count : sizeof(float_t) * 3 * count;
+}
+
+static int32_t js_websg_get_physics_body_state(int prop, node_id_t *node_ids, uint32_t count, void *values) {
+  switch (prop) {
+    case WebSGPhysicsBodyStateProp_LinearVelocity:
+      return websg_physics_bodies_get_linear_velocities(node_ids, count, values);
+    case WebSGPhysicsBodyStateProp_AngularVelocity:
+      return websg_physics_bodies_get_angular_velocities(node_ids, count, values);
+    case WebSGPhysicsBodyStateProp_Sleeping:
+      return websg_physics_bodies_get_sleeping(node_ids, count, values);
+    default:
+      return -1;
+  }
+}
+
+static int32_t js_websg_set_physics_body_state(int prop, node_id_t *node_ids, uint32_t count, void *values) {
+  switch (prop) {
+    case WebSGPhysicsBodyStateProp_LinearVelocity:
+      return websg_physics_bodies_set_linear_velocities(node_ids, count, values);
+    case WebSGPhysicsBodyStateProp_AngularVelocity:
+      return websg_physics_bodies_set_angular_velocities(node_ids, count, values);
+    case WebSGPhysicsBodyStateProp_Sleeping:
+      return websg_physics_bodies_set_sleeping(node_ids, count, values);
+    case WebSGPhysicsBodyStateProp_Force:
+      return websg_physics_bodies_apply_forces(node_ids, count, values);
+    case WebSGPhysicsBodyStateProp_Impulse:
+      return websg_physics_bodies_apply_impulses(node_ids, count, values);
+    default:
+      return -1;
+  }
+}
+
+JSValue js_websg_world_get_physics_body_states(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv,
+  int prop
+) {
+  node_id_t *node_ids;
+  uint32_t count;
+
+  int owned = js_websg_get_node_ids(ctx, argv[0], &node_ids, &count);
+
+  if (owned < 0) {
+    return JS_EXCEPTION;
+  }
+
+  void *values = get_typed_array_data(ctx, &argv[1], js_websg_physics_body_state_byte_length(prop, count));
+
+  if (values == NULL) {
+    if (owned) {
+      js_free(ctx, node_ids);
+    }
+    return JS_EXCEPTION;
+  }
+
+  int32_t result = count == 0 ? 0 : js_websg_get_physics_body_state(prop, node_ids, count, values);
+
+  if (owned) {
+    js_free(ctx, node_ids);
+  }
+
+  if (result < 0) {
+    JS_ThrowInternalError(ctx, "WebSG: Couldn't get physics body state, every node needs a physics body.");
+    return JS_EXCEPTION;
+  }
+
+  return JS_DupValue(ctx, argv[1]);
+}
+
+JSValue js_websg_world_set_physics_body_states(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv,
+  int prop
+) {
+  node_id_t *node_ids;
+  uint32_t count;
+
+  int owned = js_websg_get_node_ids(ctx, argv[0], &node_ids, &count);
+
+  if (owned < 0) {
+    return JS_EXCEPTION;
+  }
+
+  void *values = get_typed_array_data(ctx, &argv[1], js_websg_physics_body_state_byte_length(prop, count));
+
+  if (values == NULL) {
+    if (owned) {
+      js_free(ctx, node_ids);
+    }
+    return JS_EXCEPTION;
+  }
+
+  int32_t result = count == 0 ? 0 : js_websg_set_physics_body_state(prop, node_ids, count, values);
+
+  if (owned) {
+    js_free(ctx, node_ids);
+  }
+
+  if (result < 0) {
+    JS_ThrowInternalError(ctx, "WebSG: Couldn't set physics body state, every node needs a physics body.");
+    return JS_EXCEPTION;
+  }
+
+  return JS_UNDEFINED;
+}
+
+/**
+ * Physics Queries
+ **/
+
+int js_websg_parse_physics_query_options(JSContext *ctx, JSValueConst options, WebSGPhysicsQueryOptions *query_options) {
+  query_options->max_distance = INFINITY;
+  query_options->exclude_node_id = 0;
+
+  if (JS_IsUndefined(options)) {
+    return 0;
+  }
+
+  JSValue max_distance_val = JS_GetPropertyStr(ctx, options, "maxDistance");
+
+  if (!JS_IsUndefined(max_distance_val)) {
+    double max_distance;
+    int result = JS_ToFloat64(ctx, &max_distance, max_distance_val);
+    JS_FreeValue(ctx, max_distance_val);
+
+    if (result == -1) {
+      return -1;
+    }
+
+    if (!(max_distance >= 0)) {
+      JS_ThrowRangeError(ctx, "WebSG: maxDistance must be a positive number.");
+      return -1;
+    }
+
+    query_options->max_distance = max_distance;
+  }
+
+  JSValue exclude_val = JS_GetPropertyStr(ctx, options, "exclude");
+
+  if (!JS_IsUndefined(exclude_val)) {
+    WebSGNodeData *node_data = JS_GetOpaque2(ctx, exclude_val, js_websg_node_class_id);
+    JS_FreeValue(ctx, exclude_val);
+
+    if (node_data == NULL) {
+      return -1;
+    }
+
+    query_options->exclude_node_id = node_data->node_id;
+  }
+
+  return 0;
+}
+
+PhysicsHit *js_websg_get_physics_hits(JSContext *ctx, JSValueConst hits, uint32_t count) {
+  size_t byte_length;
+  uint8_t *data = JS_GetArrayBuffer(ctx, &byte_length, hits);
+
+  if (data == NULL) {
+    return NULL;
+  }
+
+  if (byte_length < sizeof(PhysicsHit) * count) {
+    JS_ThrowRangeError(ctx, "WebSG: hits buffer must be at least %u bytes.", (uint32_t)(sizeof(PhysicsHit) * count));
+    return NULL;
+  }
+
+  return (PhysicsHit *)data;
+}
+
+JSValue js_websg_world_cast_rays(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  uint32_t origins_length;
+  float_t *origins = get_typed_array_elements(ctx, &argv[0], sizeof(float_t), &origins_length);
+
+  if (origins == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  uint32_t count = origins_length / 3;
+  float_t *directions = get_typed_array_data(ctx, &argv[1], sizeof(float_t) * 3 * count);
+
+  if (directions == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  PhysicsHit *hits = js_websg_get_physics_hits(ctx, argv[2], count);
+
+  if (hits == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  WebSGPhysicsQueryOptions options;
+
+  if (js_websg_parse_physics_query_options(ctx, argv[3], &options) == -1) {
+    return JS_EXCEPTION;
+  }
+
+  if (count == 0) {
+    return JS_NewInt32(ctx, 0);
+  }
+
+  int32_t hit_count = websg_world_cast_rays(
+    origins,
+    directions,
+    count,
+    options.max_distance,
+    options.exclude_node_id,
+    hits
+  );
+
+  if (hit_count == -1) {
+    JS_ThrowInternalError(ctx, "WebSG: Error casting rays.");
+    return JS_EXCEPTION;
+  }
+
+  return JS_NewInt32(ctx, hit_count);
+}
@@ -7,6 +7,21 @@ typedef struct WebSGPhysicsBodyData {
   node_id_t node_id;
 } WebSGPhysicsBodyData;
 
+// Options shared by the physics queries.
+typedef struct WebSGPhysicsQueryOptions {
+  float_t max_distance;
+  node_id_t exclude_node_id;
+} WebSGPhysicsQueryOptions;
+
+typedef enum WebSGPhysicsBodyStateProp {
+  WebSGPhysicsBodyStateProp_LinearVelocity,
+  WebSGPhysicsBodyStateProp_AngularVelocity,
+  WebSGPhysicsBodyStateProp_Sleeping,
+  // Write only.
+  WebSGPhysicsBodyStateProp_Force,
+  WebSGPhysicsBodyStateProp_Impulse,
+} WebSGPhysicsBodyStateProp;
+
 extern JSClassID js_websg_physics_body_class_id;
 
 void js_websg_define_physics_body(JSContext *ctx, JSValue websg);
@@ -19,4 +34,29 @@ JSValue js_websg_node_remove_physics_body(JSContext *ctx, JSValueConst this_val,
 
 JSValue js_websg_node_get_physics_body(JSContext *ctx, JSValueConst this_val);
 
+// Parses an optional { maxDistance, exclude } object.
+int js_websg_parse_physics_query_options(JSContext *ctx, JSValueConst options, WebSGPhysicsQueryOptions *query_options);
+
+// Returns the memory of an ArrayBuffer that fits count hits.
+PhysicsHit *js_websg_get_physics_hits(JSContext *ctx, JSValueConst hits, uint32_t count);
+
+// world.getNodeLinearVelocities(nodes, values) etc, see WebSGPhysicsBodyStateProp.
+JSValue js_websg_world_get_physics_body_states(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv,
+  int prop
+);
+
+JSValue js_websg_world_set_physics_body_states(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv,
+  int prop
+);
+
+JSValue js_websg_world_cast_rays(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv);
+
 #endif
@@ -130,6 +130,12 @@ void js_websg_define_quaternion(JSContext *ctx, JSValue websg) {
 JSValue js_websg_create_quaternion(JSContext *ctx, float* elements) {
   JSValue quaternion = JS_NewObjectClass(ctx, js_websg_quaternion_class_id);
   WebSGQuaternionData *quat_data = js_mallocz(ctx, sizeof(WebSGQuaternionData));
+
+  if (quat_data == NULL) {
+    JS_FreeValue(ctx, quaternion);
+    return JS_EXCEPTION;
+  }
+
   quat_data->elements = elements;
   return quaternion;
 }
@@ -145,6 +151,12 @@ JSValue js_websg_new_quaternion_get_set(
   JSValue quaternion = JS_NewObjectClass(ctx, js_websg_quaternion_class_id);
 
   WebSGQuaternionData *quat_data = js_mallocz(ctx, sizeof(WebSGQuaternionData));
+
+  if (quat_data == NULL) {
+    JS_FreeValue(ctx, quaternion);
+    return JS_EXCEPTION;
+  }
+
   quat_data->elements = js_mallocz(ctx, sizeof(float_t) * 4);
   quat_data->get = get;
   quat_data->set = set;
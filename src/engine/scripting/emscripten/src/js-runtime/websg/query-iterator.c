@@ -0,0 +1,140 @@
+#include "../quickjs/cutils.h"
+#include "../quickjs/quickjs.h"
+#include "../../websg.h"
+#include "./node.h"
+#include "./query.h"
+#include "./query-iterator.h"
+
+JSClassID js_websg_query_iterator_class_id;
+
+// Hands the borrowed buffer back to the query or frees the snapshot. The iterator holds a reference to the query,
+// so the query's buffer is still alive here.
+static void js_websg_query_iterator_release(JSRuntime *rt, WebSGQueryIteratorData *it) {
+  if (it->results == NULL) {
+    return;
+  }
+
+  if (it->borrowed) {
+    it->results->borrowed = 0;
+  } else {
+    js_free_rt(rt, it->snapshot.nodes);
+    it->snapshot.nodes = NULL;
+  }
+
+  it->results = NULL;
+}
+
+static void js_websg_query_iterator_finalizer(JSRuntime *rt, JSValue val) {
+  WebSGQueryIteratorData *it = JS_GetOpaque(val, js_websg_query_iterator_class_id);
+
+  if (it) {
+    js_websg_query_iterator_release(rt, it);
+    JS_FreeValueRT(rt, it->query);
+    js_free_rt(rt, it);
+  }
+}
+
+static JSClassDef js_websg_query_iterator_class = {
+  "QueryIterator",
+  .finalizer = js_websg_query_iterator_finalizer
+};
+
+// Reads from the borrowed result buffer or the iterator's snapshot, neither can change while the iterator is live.
+static JSValue js_websg_query_iterator_next(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv,
+  BOOL *pdone,
+  int magic
+) {
+  WebSGQueryIteratorData *it = JS_GetOpaque2(ctx, this_val, js_websg_query_iterator_class_id);
+
+  if (!it) {
+    *pdone = FALSE;
+    return JS_EXCEPTION;
+  }
+
+  if (it->results == NULL || it->idx >= it->results->count) {
+    // Release the buffer as soon as the loop ends rather than when the iterator is collected.
+    js_websg_query_iterator_release(JS_GetRuntime(ctx), it);
+    *pdone = TRUE;
+    return JS_UNDEFINED;
+  }
+
+  *pdone = FALSE;
+
+  WebSGQueryData *query_data = JS_GetOpaque(it->query, js_websg_query_class_id);
+  node_id_t node_id = it->results->nodes[it->idx];
+
+  it->idx = it->idx + 1;
+
+  return js_websg_get_node_by_id(ctx, query_data->world_data, node_id);
+}
+
+static JSValue js_websg_query_iterator(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  return JS_DupValue(ctx, this_val);
+}
+
+static const JSCFunctionListEntry js_websg_query_iterator_proto_funcs[] = {
+  JS_ITERATOR_NEXT_DEF("next", 0, js_websg_query_iterator_next, 0),
+  JS_PROP_STRING_DEF("[Symbol.toStringTag]", "WebSGQueryIterator", JS_PROP_CONFIGURABLE),
+  JS_CFUNC_DEF("[Symbol.iterator]", 0, js_websg_query_iterator),
+};
+
+void js_websg_define_query_iterator(JSContext *ctx) {
+  JS_NewClassID(&js_websg_query_iterator_class_id);
+  JS_NewClass(JS_GetRuntime(ctx), js_websg_query_iterator_class_id, &js_websg_query_iterator_class);
+  JSValue proto = JS_NewObject(ctx);
+  JS_SetPropertyFunctionList(
+    ctx,
+    proto,
+    js_websg_query_iterator_proto_funcs,
+    countof(js_websg_query_iterator_proto_funcs)
+  );
+  JS_SetClassProto(ctx, js_websg_query_iterator_class_id, proto);
+}
+
+JSValue js_websg_create_query_iterator(
+  JSContext *ctx,
+  JSValueConst query,
+  WebSGQueryResults *results,
+  int borrowed
+) {
+  JSValue iter_obj = JS_NewObjectClass(ctx, js_websg_query_iterator_class_id);
+
+  if (JS_IsException(iter_obj)) {
+    if (!borrowed) {
+      js_free(ctx, results->nodes);
+    }
+
+    return JS_EXCEPTION;
+  }
+
+  WebSGQueryIteratorData *it = js_mallocz(ctx, sizeof(WebSGQueryIteratorData));
+
+  if (!it) {
+    if (!borrowed) {
+      js_free(ctx, results->nodes);
+    }
+
+    JS_FreeValue(ctx, iter_obj);
+    return JS_EXCEPTION;
+  }
+
+  it->query = JS_DupValue(ctx, query);
+  it->borrowed = borrowed;
+  it->idx = 0;
+
+  if (borrowed) {
+    results->borrowed = 1;
+    it->results = results;
+  } else {
+    it->snapshot = *results;
+    it->results = &it->snapshot;
+  }
+
+  JS_SetOpaque(iter_obj, it);
+
+  return iter_obj;
+}
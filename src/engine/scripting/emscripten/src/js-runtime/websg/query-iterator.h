@@ -0,0 +1,29 @@
+#ifndef __websg_query_iterator_js_h
+#define __websg_query_iterator_js_h
+#include "../quickjs/quickjs.h"
+#include "../../websg.h"
+#include "./query.h"
+
+typedef struct WebSGQueryIteratorData {
+  JSValue query;
+  // The query's buffer while borrowed, otherwise &snapshot. NULL once the iterator is done.
+  WebSGQueryResults *results;
+  WebSGQueryResults snapshot;
+  int borrowed;
+  uint32_t idx;
+} WebSGQueryIteratorData;
+
+extern JSClassID js_websg_query_iterator_class_id;
+
+void js_websg_define_query_iterator(JSContext *ctx);
+
+// Borrows the query's results buffer when borrowed is set, otherwise takes ownership of the results' nodes, which
+// are freed even if creating the iterator fails.
+JSValue js_websg_create_query_iterator(
+  JSContext *ctx,
+  JSValueConst query,
+  WebSGQueryResults *results,
+  int borrowed
+);
+
+#endif
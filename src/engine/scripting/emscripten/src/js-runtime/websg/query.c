@@ -4,10 +4,76 @@
 #include "./websg-js.h"
 #include "./query.h"
 #include "./component-store.h"
-#include "./node-iterator.h"
+#include "./query-iterator.h"
 
 JSClassID js_websg_query_class_id;
 
+/**
+ * Private Methods and Variables
+ **/
+
+JSAtom query_modifier_all;
+JSAtom query_modifier_none;
+JSAtom query_modifier_any;
+
+QueryModifier get_query_modifier_from_atom(JSAtom atom) {
+  if (atom == query_modifier_all) {
+    return QueryModifier_All;
+  } else if (atom == query_modifier_none) {
+    return QueryModifier_None;
+  } else if (atom == query_modifier_any) {
+    return QueryModifier_Any;
+  } else {
+    return -1;
+  }
+}
+
+typedef int32_t (*WebSGQueryResultsImport)(query_id_t query_id, node_id_t *results, uint32_t max_count);
+
+// Fills the results buffer using one of the query_get_* imports. The imports report the total count even when it
+// doesn't fit, so the buffer is only grown (and the import called a second time) when the result set has grown.
+static int js_websg_query_fetch_results(
+  JSContext *ctx,
+  query_id_t query_id,
+  WebSGQueryResults *results,
+  WebSGQueryResultsImport get_results
+) {
+  int32_t count = get_results(query_id, results->nodes, results->capacity);
+
+  if (count == -1) {
+    JS_ThrowInternalError(ctx, "WebSG: Failed to get query results.");
+    return -1;
+  }
+
+  if ((uint32_t)count > results->capacity) {
+    uint32_t capacity = results->capacity * 2;
+
+    if (capacity < (uint32_t)count) {
+      capacity = count;
+    }
+
+    node_id_t *nodes = js_realloc(ctx, results->nodes, sizeof(node_id_t) * capacity);
+
+    if (nodes == NULL) {
+      return -1;
+    }
+
+    results->nodes = nodes;
+    results->capacity = capacity;
+
+    count = get_results(query_id, results->nodes, results->capacity);
+
+    if (count == -1 || (uint32_t)count > results->capacity) {
+      JS_ThrowInternalError(ctx, "WebSG: Failed to get query results.");
+      return -1;
+    }
+  }
+
+  results->count = count;
+
+  return 0;
+}
+
 /**
  * Class Definition
  **/
@@ -16,6 +82,9 @@ static void js_websg_query_finalizer(JSRuntime *rt, JSValue val) {
   WebSGQueryData *query_data = JS_GetOpaque(val, js_websg_query_class_id);
 
   if (query_data) {
+    js_free_rt(rt, query_data->results.nodes);
+    js_free_rt(rt, query_data->entered.nodes);
+    js_free_rt(rt, query_data->exited.nodes);
     js_free_rt(rt, query_data);
   }
 }
@@ -25,26 +94,52 @@ static JSClassDef js_websg_query_class = {
   .finalizer = js_websg_query_finalizer
 };
 
-static JSValue js_websg_query_iterator(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+// Iterators borrow the query's buffer. When it is already borrowed, by an outer loop over the same query, the
+// results are fetched into a snapshot owned by the new iterator so refilling doesn't change what the outer loop sees.
+static JSValue js_websg_query_iterate(
+  JSContext *ctx,
+  JSValueConst this_val,
+  WebSGQueryResults *results,
+  WebSGQueryResultsImport get_results
+) {
   WebSGQueryData *query_data = JS_GetOpaque(this_val, js_websg_query_class_id);
 
-  int32_t count = websg_query_get_results_count(query_data->query_id);
+  if (!results->borrowed) {
+    if (js_websg_query_fetch_results(ctx, query_data->query_id, results, get_results) == -1) {
+      return JS_EXCEPTION;
+    }
 
-  if (count == -1) {
-    return JS_ThrowInternalError(ctx, "Failed to get query results count.");
+    return js_websg_create_query_iterator(ctx, this_val, results, 1);
   }
 
-  node_id_t *nodes = js_malloc(ctx, sizeof(node_id_t) * count);
+  WebSGQueryResults snapshot = { 0 };
 
-  if (websg_query_get_results(query_data->query_id, nodes, count) == -1) {
-    js_free(ctx, nodes);
-    return JS_ThrowInternalError(ctx, "Failed to get query results.");
+  if (js_websg_query_fetch_results(ctx, query_data->query_id, &snapshot, get_results) == -1) {
+    js_free(ctx, snapshot.nodes);
+    return JS_EXCEPTION;
   }
 
-  return js_websg_create_node_iterator(ctx, query_data->world_data, nodes, count);
+  return js_websg_create_query_iterator(ctx, this_val, &snapshot, 0);
+}
+
+static JSValue js_websg_query_iterator(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGQueryData *query_data = JS_GetOpaque(this_val, js_websg_query_class_id);
+  return js_websg_query_iterate(ctx, this_val, &query_data->results, websg_query_get_results);
+}
+
+static JSValue js_websg_query_entered(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGQueryData *query_data = JS_GetOpaque(this_val, js_websg_query_class_id);
+  return js_websg_query_iterate(ctx, this_val, &query_data->entered, websg_query_get_entered);
+}
+
+static JSValue js_websg_query_exited(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGQueryData *query_data = JS_GetOpaque(this_val, js_websg_query_class_id);
+  return js_websg_query_iterate(ctx, this_val, &query_data->exited, websg_query_get_exited);
 }
 
 static const JSCFunctionListEntry js_websg_query_proto_funcs[] = {
+  JS_CFUNC_DEF("entered", 0, js_websg_query_entered),
+  JS_CFUNC_DEF("exited", 0, js_websg_query_exited),
   JS_PROP_STRING_DEF("[Symbol.toStringTag]", "Query", JS_PROP_CONFIGURABLE),
   JS_CFUNC_DEF("[Symbol.iterator]", 0, js_websg_query_iterator),
 };
@@ -80,74 +175,201 @@ void js_websg_define_query(JSContext *ctx, JSValue websg) {
     "Query",
     constructor
   );
+
+  query_modifier_all = JS_NewAtom(ctx, "all");
+  query_modifier_none = JS_NewAtom(ctx, "none");
+  query_modifier_any = JS_NewAtom(ctx, "any");
+
+  JSValue query_modifier = JS_NewObject(ctx);
+  JS_SetPropertyStr(ctx, query_modifier, "All", JS_AtomToValue(ctx, query_modifier_all));
+  JS_SetPropertyStr(ctx, query_modifier, "None", JS_AtomToValue(ctx, query_modifier_none));
+  JS_SetPropertyStr(ctx, query_modifier, "Any", JS_AtomToValue(ctx, query_modifier_any));
+  JS_SetPropertyStr(ctx, websg, "QueryModifier", query_modifier);
 }
 
 /**
  * World Methods
  **/
 
-JSValue js_websg_world_create_query(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
-  WebSGWorldData *world_data = JS_GetOpaque(this_val, js_websg_world_class_id);
+static int js_websg_get_array_length(JSContext *ctx, JSValueConst arr, uint32_t *length) {
+  JSValue length_val = JS_GetPropertyStr(ctx, arr, "length");
 
-  JSValue query_list_length_val = JS_GetPropertyStr(ctx, argv[0], "length");
+  if (JS_IsException(length_val)) {
+    return -1;
+  }
 
-  if (JS_IsException(query_list_length_val)) {
-    return JS_EXCEPTION;
+  int ret = JS_ToUint32(ctx, length, length_val);
+
+  JS_FreeValue(ctx, length_val);
+
+  return ret;
+}
+
+static int js_websg_get_component_id(JSContext *ctx, JSValueConst arr, uint32_t idx, component_id_t *component_id) {
+  JSValue component_store_val = JS_GetPropertyUint32(ctx, arr, idx);
+
+  if (JS_IsException(component_store_val)) {
+    return -1;
   }
 
-  uint32_t query_list_length = 0;
+  WebSGComponentStoreData *component_store_data = JS_GetOpaque(
+    component_store_val,
+    js_websg_component_store_class_id
+  );
 
-  if (JS_ToUint32(ctx, &query_list_length, query_list_length_val) == -1) {
-    return JS_EXCEPTION;
+  JS_FreeValue(ctx, component_store_val);
+
+  if (component_store_data == NULL) {
+    JS_ThrowTypeError(ctx, "WebSG: Query components must be ComponentStores.");
+    return -1;
   }
 
-  if (query_list_length == 0) {
-    return JS_ThrowTypeError(ctx, "WebSG: Query must have at least one item.");
+  *component_id = component_store_data->component_id;
+
+  return 0;
+}
+
+// Parses a query list item of the form { modifier: QueryModifier, components: ComponentStore[] }
+static int js_websg_parse_query_item(JSContext *ctx, JSValueConst item_val, QueryItem *item) {
+  JSValue modifier_val = JS_GetPropertyStr(ctx, item_val, "modifier");
+
+  if (JS_IsException(modifier_val)) {
+    return -1;
+  }
+
+  if (JS_IsUndefined(modifier_val)) {
+    item->modifier = QueryModifier_All;
+  } else {
+    JSAtom modifier_atom = JS_ValueToAtom(ctx, modifier_val);
+    item->modifier = get_query_modifier_from_atom(modifier_atom);
+    JS_FreeAtom(ctx, modifier_atom);
   }
 
-  // TODO: Support query modifiers and multiple query list items
-  // For now we just support a single array of component stores
+  JS_FreeValue(ctx, modifier_val);
 
-  component_id_t *component_ids = js_mallocz(ctx, sizeof(component_id_t) * query_list_length);
+  if ((int)item->modifier == -1) {
+    JS_ThrowTypeError(ctx, "WebSG: Unknown query modifier.");
+    return -1;
+  }
 
-  int error = 0;
+  JSValue components_val = JS_GetPropertyStr(ctx, item_val, "components");
 
-  for (int i = 0; i < query_list_length; i++) {
-    JSValue component_definition_val = JS_GetPropertyUint32(ctx, argv[0], i);
+  if (JS_IsException(components_val)) {
+    return -1;
+  }
 
-    WebSGComponentStoreData *component_store_data = JS_GetOpaque2(
-      ctx,
-      component_definition_val,
-      js_websg_component_store_class_id
-    );
+  uint32_t component_count = 0;
 
-    if (component_store_data == NULL) {
-      error = 1;
-      break;
+  if (!JS_IsArray(ctx, components_val) || js_websg_get_array_length(ctx, components_val, &component_count) == -1) {
+    JS_FreeValue(ctx, components_val);
+    JS_ThrowTypeError(ctx, "WebSG: Query item components must be an array of ComponentStores.");
+    return -1;
+  }
+
+  if (component_count == 0) {
+    JS_FreeValue(ctx, components_val);
+    JS_ThrowTypeError(ctx, "WebSG: Query item must have at least one component.");
+    return -1;
+  }
+
+  item->component_ids = js_mallocz(ctx, sizeof(component_id_t) * component_count);
+
+  if (item->component_ids == NULL) {
+    JS_FreeValue(ctx, components_val);
+    return -1;
+  }
+
+  item->component_count = component_count;
+
+  for (uint32_t i = 0; i < component_count; i++) {
+    if (js_websg_get_component_id(ctx, components_val, i, &item->component_ids[i]) == -1) {
+      JS_FreeValue(ctx, components_val);
+      return -1;
     }
+  }
+
+  JS_FreeValue(ctx, components_val);
+
+  return 0;
+}
 
-    component_ids[i] = component_store_data->component_id;
+static void js_websg_free_query_list(JSContext *ctx, QueryList *query_list) {
+  for (uint32_t i = 0; i < query_list->count; i++) {
+    js_free(ctx, query_list->items[i].component_ids);
   }
 
-  if (error) {
-    js_free(ctx, component_ids);
+  js_free(ctx, query_list->items);
+}
+
+// The query list accepts bare ComponentStores, which are grouped into a single "all" item, as well as
+// { modifier, components } objects for "none" and "any" terms.
+JSValue js_websg_world_create_query(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGWorldData *world_data = JS_GetOpaque(this_val, js_websg_world_class_id);
+
+  uint32_t query_list_length = 0;
+
+  if (js_websg_get_array_length(ctx, argv[0], &query_list_length) == -1) {
     return JS_EXCEPTION;
   }
 
-  QueryItem *query_list_item = js_mallocz(ctx, sizeof(QueryItem));
-  query_list_item->component_ids = component_ids;
-  query_list_item->component_count = query_list_length;
-  query_list_item->modifier = QueryModifier_All;
+  if (query_list_length == 0) {
+    return JS_ThrowTypeError(ctx, "WebSG: Query must have at least one item.");
+  }
 
-  QueryList *query_list = js_mallocz(ctx, sizeof(QueryList));
-  query_list->items = query_list_item;
-  query_list->count = 1;
+  QueryList query_list = {
+    // One extra item for the implicit "all" item
+    .items = js_mallocz(ctx, sizeof(QueryItem) * (query_list_length + 1)),
+    .count = 0,
+  };
+
+  if (query_list.items == NULL) {
+    return JS_EXCEPTION;
+  }
 
-  query_id_t query_id = websg_world_create_query(query_list);
+  QueryItem *all_item = NULL;
 
-  js_free(ctx, component_ids);
-  js_free(ctx, query_list_item);
-  js_free(ctx, query_list);
+  for (uint32_t i = 0; i < query_list_length; i++) {
+    JSValue item_val = JS_GetPropertyUint32(ctx, argv[0], i);
+
+    if (JS_IsException(item_val)) {
+      js_websg_free_query_list(ctx, &query_list);
+      return JS_EXCEPTION;
+    }
+
+    WebSGComponentStoreData *component_store_data = JS_GetOpaque(item_val, js_websg_component_store_class_id);
+
+    if (component_store_data != NULL) {
+      if (all_item == NULL) {
+        all_item = &query_list.items[query_list.count++];
+        all_item->modifier = QueryModifier_All;
+        all_item->component_ids = js_mallocz(ctx, sizeof(component_id_t) * query_list_length);
+
+        if (all_item->component_ids == NULL) {
+          JS_FreeValue(ctx, item_val);
+          js_websg_free_query_list(ctx, &query_list);
+          return JS_EXCEPTION;
+        }
+      }
+
+      all_item->component_ids[all_item->component_count++] = component_store_data->component_id;
+    } else if (JS_IsObject(item_val)) {
+      if (js_websg_parse_query_item(ctx, item_val, &query_list.items[query_list.count++]) == -1) {
+        JS_FreeValue(ctx, item_val);
+        js_websg_free_query_list(ctx, &query_list);
+        return JS_EXCEPTION;
+      }
+    } else {
+      JS_FreeValue(ctx, item_val);
+      js_websg_free_query_list(ctx, &query_list);
+      return JS_ThrowTypeError(ctx, "WebSG: Query items must be ComponentStores or query item objects.");
+    }
+
+    JS_FreeValue(ctx, item_val);
+  }
+
+  query_id_t query_id = websg_world_create_query(&query_list);
+
+  js_websg_free_query_list(ctx, &query_list);
 
   if (query_id == 0) {
     JS_ThrowInternalError(ctx, "WebSG: Couldn't create query.");
@@ -161,6 +383,12 @@ JSValue js_websg_world_create_query(JSContext *ctx, JSValueConst this_val, int a
   }
 
   WebSGQueryData *query_data = js_mallocz(ctx, sizeof(WebSGQueryData));
+
+  if (query_data == NULL) {
+    JS_FreeValue(ctx, query);
+    return JS_EXCEPTION;
+  }
+
   query_data->world_data = world_data;
   query_data->query_id = query_id;
   JS_SetOpaque(query, query_data);
@@ -4,9 +4,22 @@
 #include "../quickjs/quickjs.h"
 #include "./world.h"
 
+// Result buffers are kept for the lifetime of the query and only grow, so iterating a query every frame
+// doesn't allocate. Nested iterations of the same query get their own buffer while this one is borrowed.
+typedef struct WebSGQueryResults {
+  node_id_t *nodes;
+  uint32_t count;
+  uint32_t capacity;
+  // Set while an unfinished iterator reads from the buffer.
+  int borrowed;
+} WebSGQueryResults;
+
 typedef struct WebSGQueryData {
   WebSGWorldData *world_data;
   query_id_t query_id;
+  WebSGQueryResults results;
+  WebSGQueryResults entered;
+  WebSGQueryResults exited;
 } WebSGQueryData;
 
 
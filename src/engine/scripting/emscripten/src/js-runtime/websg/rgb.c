@@ -115,6 +115,12 @@ void js_websg_define_rgb(JSContext *ctx, JSValue websg) {
 JSValue js_websg_create_rgb(JSContext *ctx, float* elements) {
   JSValue rgb = JS_NewObjectClass(ctx, js_websg_rgb_class_id);
   WebSGRGBData *rgb_data = js_mallocz(ctx, sizeof(WebSGRGBData));
+
+  if (rgb_data == NULL) {
+    JS_FreeValue(ctx, rgb);
+    return JS_EXCEPTION;
+  }
+
   rgb_data->elements = elements;
   return rgb;
 }
@@ -129,6 +135,12 @@ JSValue js_websg_new_rgb_get_set(
   JSValue rgb = JS_NewObjectClass(ctx, js_websg_rgb_class_id);
 
   WebSGRGBData *rgb_data = js_mallocz(ctx, sizeof(WebSGRGBData));
+
+  if (rgb_data == NULL) {
+    JS_FreeValue(ctx, rgb);
+    return JS_EXCEPTION;
+  }
+
   rgb_data->elements = js_mallocz(ctx, sizeof(float_t) * 3);
   rgb_data->get = get;
   rgb_data->set = set;
@@ -117,6 +117,12 @@ void js_websg_define_rgba(JSContext *ctx, JSValue websg) {
 JSValue js_websg_create_rgba(JSContext *ctx, float* elements) {
   JSValue rgba = JS_NewObjectClass(ctx, js_websg_rgba_class_id);
   WebSGRGBAData *rgba_data = js_mallocz(ctx, sizeof(WebSGRGBAData));
+
+  if (rgba_data == NULL) {
+    JS_FreeValue(ctx, rgba);
+    return JS_EXCEPTION;
+  }
+
   rgba_data->elements = elements;
   return rgba;
 }
@@ -131,6 +137,12 @@ JSValue js_websg_new_rgba_get_set(
   JSValue rgb = JS_NewObjectClass(ctx, js_websg_rgba_class_id);
 
   WebSGRGBAData *rgba_data = js_mallocz(ctx, sizeof(WebSGRGBAData));
+
+  if (rgba_data == NULL) {
+    JS_FreeValue(ctx, rgb);
+    return JS_EXCEPTION;
+  }
+
   rgba_data->elements = js_mallocz(ctx, sizeof(float_t) * 4);
   rgba_data->get = get;
   rgba_data->set = set;
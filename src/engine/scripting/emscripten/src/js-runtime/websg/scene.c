@@ -79,7 +79,7 @@ static JSValue js_websg_scene_nodes(JSContext *ctx, JSValueConst this_val, int a
     return JS_EXCEPTION;
   }
 
-  node_id_t *nodes = js_mallocz(ctx, sizeof(node_id_t) * count);
+  node_id_t *nodes = count == 0 ? NULL : js_mallocz(ctx, sizeof(node_id_t) * count);
 
   if (websg_scene_get_nodes(scene_data->scene_id, nodes, count) == -1) {
     JS_ThrowInternalError(ctx, "WebSG: Error getting scene nodes.");
@@ -151,12 +151,18 @@ JSValue js_websg_new_scene_instance(JSContext *ctx, WebSGWorldData *world_data,
   }
 
   WebSGSceneData *scene_data = js_mallocz(ctx, sizeof(WebSGSceneData));
+
+  if (scene_data == NULL) {
+    JS_FreeValue(ctx, scene);
+    return JS_EXCEPTION;
+  }
+
   scene_data->world_data = world_data;
   scene_data->scene_id = scene_id;
 
   JS_SetOpaque(scene, scene_data);
 
-  JS_SetPropertyUint32(ctx, world_data->scenes, scene_id, JS_DupValue(ctx, scene));
+  js_handle_table_set(ctx, &world_data->scenes, scene_id, JS_DupValue(ctx, scene));
   
   return scene;
 }
@@ -166,7 +172,7 @@ JSValue js_websg_new_scene_instance(JSContext *ctx, WebSGWorldData *world_data,
  **/
 
 JSValue js_websg_get_scene_by_id(JSContext *ctx, WebSGWorldData *world_data, scene_id_t scene_id) {
-  JSValue scene = JS_GetPropertyUint32(ctx, world_data->scenes, scene_id);
+  JSValueConst scene = js_handle_table_get(&world_data->scenes, scene_id);
 
   if (!JS_IsUndefined(scene)) {
     return JS_DupValue(ctx, scene);
@@ -0,0 +1,1641 @@
+#include <math.h>
+#include <string.h>
+#include "../quickjs/cutils.h"
+#include "../quickjs/quickjs.h"
+#include "../../websg.h"
+#include "../utils/array.h"
+#include "../utils/typedarray.h"
+#include "./websg-js.h"
+#include "./world.h"
+#include "./node.h"
+#include "./spatial-index.h"
+
+JSClassID js_websg_spatial_index_class_id;
+
+/**
+ * Storage
+ **/
+
+static int js_websg_spatial_index_reserve(
+  JSContext *ctx,
+  void **data,
+  uint32_t *capacity,
+  uint32_t required,
+  size_t element_size
+) {
+  if (required <= *capacity) {
+    return 0;
+  }
+
+  uint32_t new_capacity = *capacity == 0 ? 16 : *capacity;
+
+  while (new_capacity < required) {
+    new_capacity *= 2;
+  }
+
+  void *new_data = js_realloc(ctx, *data, element_size * new_capacity);
+
+  if (new_data == NULL) {
+    return -1;
+  }
+
+  *data = new_data;
+  *capacity = new_capacity;
+
+  return 0;
+}
+
+static void js_websg_spatial_index_free(JSRuntime *rt, WebSGSpatialIndexData *data) {
+  js_free_rt(rt, data->entries);
+  js_free_rt(rt, data->slots);
+  js_free_rt(rt, data->grid_order);
+  js_free_rt(rt, data->cells);
+  js_free_rt(rt, data->tree_nodes);
+  js_free_rt(rt, data->node_ids);
+  js_free_rt(rt, data->matrices);
+  js_free_rt(rt, data->results);
+  js_free_rt(rt, data->distances);
+  js_free_rt(rt, data->stack);
+}
+
+static uint32_t js_websg_spatial_index_find_entry(WebSGSpatialIndexData *data, node_id_t node_id) {
+  if (node_id >= data->slot_capacity || data->slots[node_id] == 0) {
+    return WEBSG_SPATIAL_NULL;
+  }
+
+  return data->slots[node_id] - 1;
+}
+
+static int js_websg_spatial_index_push_result(JSContext *ctx, WebSGSpatialIndexData *data, uint32_t *count, uint32_t i) {
+  if (js_websg_spatial_index_reserve(ctx, (void **)&data->results, &data->result_capacity, *count + 1, sizeof(uint32_t))) {
+    return -1;
+  }
+
+  data->results[(*count)++] = i;
+
+  return 0;
+}
+
+// Reads the world positions of count nodes into data->matrices, the position of node i starts at i * 16 + 12.
+static int js_websg_spatial_index_read_positions(
+  JSContext *ctx,
+  WebSGSpatialIndexData *data,
+  node_id_t *node_ids,
+  uint32_t count
+) {
+  if (count == 0) {
+    return 0;
+  }
+
+  if (js_websg_spatial_index_reserve(ctx, (void **)&data->matrices, &data->matrix_capacity, count * 16, sizeof(float_t))) {
+    return -1;
+  }
+
+  if (websg_nodes_get_world_matrices(node_ids, count, data->matrices) == -1) {
+    JS_ThrowInternalError(ctx, "WebSG: Couldn't read the positions of the spatial index's nodes.");
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * Geometry
+ **/
+
+static float_t js_websg_aabb_area(const float_t *min, const float_t *max) {
+  float_t dx = max[0] - min[0];
+  float_t dy = max[1] - min[1];
+  float_t dz = max[2] - min[2];
+  return 2 * (dx * dy + dy * dz + dz * dx);
+}
+
+static float_t js_websg_aabb_combined_area(
+  const float_t *min_a,
+  const float_t *max_a,
+  const float_t *min_b,
+  const float_t *max_b
+) {
+  float_t min[3];
+  float_t max[3];
+
+  for (int i = 0; i < 3; i++) {
+    min[i] = fminf(min_a[i], min_b[i]);
+    max[i] = fmaxf(max_a[i], max_b[i]);
+  }
+
+  return js_websg_aabb_area(min, max);
+}
+
+static float_t js_websg_aabb_distance_squared(const float_t *min, const float_t *max, const float_t *point) {
+  float_t distance_squared = 0;
+
+  for (int i = 0; i < 3; i++) {
+    float_t d = fmaxf(fmaxf(min[i] - point[i], point[i] - max[i]), 0);
+    distance_squared += d * d;
+  }
+
+  return distance_squared;
+}
+
+static float_t js_websg_distance_squared(const float_t *a, const float_t *b) {
+  float_t dx = a[0] - b[0];
+  float_t dy = a[1] - b[1];
+  float_t dz = a[2] - b[2];
+  return dx * dx + dy * dy + dz * dz;
+}
+
+// Extracts the 6 normalized planes of a column major view projection matrix, points inside have a positive distance.
+static void js_websg_get_frustum_planes(const float_t *m, float_t planes[6][4]) {
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 4; j++) {
+      planes[i * 2][j] = m[j * 4 + 3] + m[j * 4 + i];
+      planes[i * 2 + 1][j] = m[j * 4 + 3] - m[j * 4 + i];
+    }
+  }
+
+  for (int i = 0; i < 6; i++) {
+    float_t length = sqrtf(planes[i][0] * planes[i][0] + planes[i][1] * planes[i][1] + planes[i][2] * planes[i][2]);
+
+    if (length > 0) {
+      for (int j = 0; j < 4; j++) {
+        planes[i][j] /= length;
+      }
+    }
+  }
+}
+
+static bool js_websg_frustum_intersects_sphere(float_t planes[6][4], const float_t *center, float_t radius) {
+  for (int i = 0; i < 6; i++) {
+    float_t *p = planes[i];
+
+    if (p[0] * center[0] + p[1] * center[1] + p[2] * center[2] + p[3] < -radius) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool js_websg_frustum_intersects_aabb(float_t planes[6][4], const float_t *min, const float_t *max) {
+  for (int i = 0; i < 6; i++) {
+    float_t *p = planes[i];
+    float_t x = p[0] > 0 ? max[0] : min[0];
+    float_t y = p[1] > 0 ? max[1] : min[1];
+    float_t z = p[2] > 0 ? max[2] : min[2];
+
+    if (p[0] * x + p[1] * y + p[2] * z + p[3] < 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Nearest Results
+ *
+ * The k nearest candidates are kept in a max heap of squared distances, so the farthest candidate is replaced first.
+ **/
+
+static void js_websg_nearest_sift_down(WebSGSpatialIndexData *data, uint32_t i, uint32_t count) {
+  uint32_t *results = data->results;
+  float_t *distances = data->distances;
+
+  while (true) {
+    uint32_t largest = i;
+    uint32_t left = i * 2 + 1;
+    uint32_t right = left + 1;
+
+    if (left < count && distances[left] > distances[largest]) {
+      largest = left;
+    }
+
+    if (right < count && distances[right] > distances[largest]) {
+      largest = right;
+    }
+
+    if (largest == i) {
+      return;
+    }
+
+    float_t distance = distances[i];
+    distances[i] = distances[largest];
+    distances[largest] = distance;
+
+    uint32_t result = results[i];
+    results[i] = results[largest];
+    results[largest] = result;
+
+    i = largest;
+  }
+}
+
+static void js_websg_nearest_push(
+  WebSGSpatialIndexData *data,
+  uint32_t *count,
+  uint32_t k,
+  uint32_t entry_index,
+  float_t distance_squared
+) {
+  uint32_t *results = data->results;
+  float_t *distances = data->distances;
+
+  if (*count < k) {
+    uint32_t i = (*count)++;
+
+    while (i > 0) {
+      uint32_t parent = (i - 1) / 2;
+
+      if (distances[parent] >= distance_squared) {
+        break;
+      }
+
+      distances[i] = distances[parent];
+      results[i] = results[parent];
+      i = parent;
+    }
+
+    distances[i] = distance_squared;
+    results[i] = entry_index;
+  } else if (distance_squared < distances[0]) {
+    distances[0] = distance_squared;
+    results[0] = entry_index;
+    js_websg_nearest_sift_down(data, 0, k);
+  }
+}
+
+// Sorts the heap in place, nearest first.
+static void js_websg_nearest_sort(WebSGSpatialIndexData *data, uint32_t count) {
+  for (uint32_t end = count; end > 1; end--) {
+    float_t distance = data->distances[0];
+    data->distances[0] = data->distances[end - 1];
+    data->distances[end - 1] = distance;
+
+    uint32_t result = data->results[0];
+    data->results[0] = data->results[end - 1];
+    data->results[end - 1] = result;
+
+    js_websg_nearest_sift_down(data, 0, end - 1);
+  }
+}
+
+/**
+ * Grid
+ **/
+
+static int32_t js_websg_spatial_cell_coord(float_t value, float_t cell_size) {
+  float_t cell = floorf(value / cell_size);
+
+  if (!(cell > -1073741824.0f)) {
+    return -1073741824;
+  } else if (cell > 1073741824.0f) {
+    return 1073741824;
+  }
+
+  return (int32_t)cell;
+}
+
+static uint32_t js_websg_spatial_hash_cell(const int32_t *cell) {
+  return ((uint32_t)cell[0] * 73856093u) ^ ((uint32_t)cell[1] * 19349663u) ^ ((uint32_t)cell[2] * 83492791u);
+}
+
+static WebSGSpatialGridCell *js_websg_spatial_grid_find_cell(WebSGSpatialIndexData *data, const int32_t *cell) {
+  uint32_t mask = data->cell_capacity - 1;
+  uint32_t i = js_websg_spatial_hash_cell(cell) & mask;
+
+  while (data->cells[i].count != 0) {
+    if (memcmp(data->cells[i].cell, cell, sizeof(int32_t) * 3) == 0) {
+      break;
+    }
+
+    i = (i + 1) & mask;
+  }
+
+  return &data->cells[i];
+}
+
+// Counting sort of the entries by cell: count the entries per cell, turn the counts into run starts, then scatter.
+static int js_websg_spatial_grid_rebuild(JSContext *ctx, WebSGSpatialIndexData *data) {
+  if (data->grid_valid) {
+    return 0;
+  }
+
+  uint32_t entry_count = data->entry_count;
+
+  if (js_websg_spatial_index_reserve(
+    ctx,
+    (void **)&data->grid_order,
+    &data->grid_order_capacity,
+    entry_count,
+    sizeof(uint32_t)
+  )) {
+    return -1;
+  }
+
+  uint32_t capacity = 16;
+
+  while (capacity < entry_count * 2) {
+    capacity *= 2;
+  }
+
+  if (capacity != data->cell_capacity) {
+    WebSGSpatialGridCell *cells = js_realloc(ctx, data->cells, sizeof(WebSGSpatialGridCell) * capacity);
+
+    if (cells == NULL) {
+      return -1;
+    }
+
+    data->cells = cells;
+    data->cell_capacity = capacity;
+  }
+
+  memset(data->cells, 0, sizeof(WebSGSpatialGridCell) * data->cell_capacity);
+
+  data->max_radius = 0;
+
+  for (int j = 0; j < 3; j++) {
+    data->cell_min[j] = INT32_MAX;
+    data->cell_max[j] = INT32_MIN;
+  }
+
+  for (uint32_t i = 0; i < entry_count; i++) {
+    WebSGSpatialEntry *entry = &data->entries[i];
+    WebSGSpatialGridCell *cell = js_websg_spatial_grid_find_cell(data, entry->cell);
+
+    if (cell->count == 0) {
+      memcpy(cell->cell, entry->cell, sizeof(int32_t) * 3);
+    }
+
+    cell->count++;
+    data->max_radius = fmaxf(data->max_radius, entry->radius);
+
+    for (int j = 0; j < 3; j++) {
+      data->cell_min[j] = entry->cell[j] < data->cell_min[j] ? entry->cell[j] : data->cell_min[j];
+      data->cell_max[j] = entry->cell[j] > data->cell_max[j] ? entry->cell[j] : data->cell_max[j];
+    }
+  }
+
+  // start is used as the write cursor while scattering, and ends up one run past the real start.
+  uint32_t offset = 0;
+
+  for (uint32_t i = 0; i < data->cell_capacity; i++) {
+    WebSGSpatialGridCell *cell = &data->cells[i];
+
+    if (cell->count != 0) {
+      cell->start = offset;
+      offset += cell->count;
+    }
+  }
+
+  for (uint32_t i = 0; i < entry_count; i++) {
+    WebSGSpatialGridCell *cell = js_websg_spatial_grid_find_cell(data, data->entries[i].cell);
+    data->grid_order[cell->start++] = i;
+  }
+
+  for (uint32_t i = 0; i < data->cell_capacity; i++) {
+    data->cells[i].start -= data->cells[i].count;
+  }
+
+  data->grid_valid = true;
+
+  return 0;
+}
+
+static int js_websg_spatial_grid_query_run(
+  JSContext *ctx,
+  WebSGSpatialIndexData *data,
+  WebSGSpatialGridCell *run,
+  const float_t *position,
+  float_t radius,
+  uint32_t *count
+) {
+  for (uint32_t i = run->start; i < run->start + run->count; i++) {
+    uint32_t entry_index = data->grid_order[i];
+    WebSGSpatialEntry *entry = &data->entries[entry_index];
+    float_t max_distance = radius + entry->radius;
+
+    if (js_websg_distance_squared(entry->position, position) <= max_distance * max_distance) {
+      if (js_websg_spatial_index_push_result(ctx, data, count, entry_index)) {
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
+
+static int32_t js_websg_spatial_grid_query_radius(
+  JSContext *ctx,
+  WebSGSpatialIndexData *data,
+  const float_t *position,
+  float_t radius
+) {
+  if (js_websg_spatial_grid_rebuild(ctx, data)) {
+    return -1;
+  }
+
+  // Entries are bucketed by their center, so the search is expanded by the largest radius.
+  float_t search_radius = radius + data->max_radius;
+  int32_t min[3];
+  int32_t max[3];
+  double cell_count = 1;
+
+  for (int i = 0; i < 3; i++) {
+    min[i] = js_websg_spatial_cell_coord(position[i] - search_radius, data->cell_size);
+    max[i] = js_websg_spatial_cell_coord(position[i] + search_radius, data->cell_size);
+    min[i] = min[i] > data->cell_min[i] ? min[i] : data->cell_min[i];
+    max[i] = max[i] < data->cell_max[i] ? max[i] : data->cell_max[i];
+    cell_count *= max[i] < min[i] ? 0 : (double)max[i] - min[i] + 1;
+  }
+
+  uint32_t count = 0;
+
+  // Scanning every run is cheaper than visiting more cells than there are entries.
+  if (cell_count > data->entry_count) {
+    for (uint32_t i = 0; i < data->cell_capacity; i++) {
+      if (data->cells[i].count != 0 &&
+          js_websg_spatial_grid_query_run(ctx, data, &data->cells[i], position, radius, &count)) {
+        return -1;
+      }
+    }
+
+    return count;
+  }
+
+  int32_t cell[3];
+
+  for (cell[0] = min[0]; cell[0] <= max[0]; cell[0]++) {
+    for (cell[1] = min[1]; cell[1] <= max[1]; cell[1]++) {
+      for (cell[2] = min[2]; cell[2] <= max[2]; cell[2]++) {
+        WebSGSpatialGridCell *run = js_websg_spatial_grid_find_cell(data, cell);
+
+        if (run->count != 0 && js_websg_spatial_grid_query_run(ctx, data, run, position, radius, &count)) {
+          return -1;
+        }
+      }
+    }
+  }
+
+  return count;
+}
+
+static void js_websg_spatial_grid_nearest_cell(
+  WebSGSpatialIndexData *data,
+  const int32_t *cell,
+  const float_t *position,
+  uint32_t *count,
+  uint32_t k
+) {
+  WebSGSpatialGridCell *run = js_websg_spatial_grid_find_cell(data, cell);
+
+  for (uint32_t i = run->start; i < run->start + run->count; i++) {
+    uint32_t entry_index = data->grid_order[i];
+    float_t distance_squared = js_websg_distance_squared(data->entries[entry_index].position, position);
+    js_websg_nearest_push(data, count, k, entry_index, distance_squared);
+  }
+}
+
+// Visits shells of cells around the query's cell, nearest first. Entries in shell s + 1 are at least s cells away, so
+// the search stops once the k nearest so far are all closer than that or every occupied cell was visited.
+static uint32_t js_websg_spatial_grid_query_nearest(WebSGSpatialIndexData *data, const float_t *position, uint32_t k) {
+  int32_t center[3];
+  int32_t max_shell = 0;
+
+  for (int i = 0; i < 3; i++) {
+    center[i] = js_websg_spatial_cell_coord(position[i], data->cell_size);
+    int32_t to_min = center[i] - data->cell_min[i];
+    int32_t to_max = data->cell_max[i] - center[i];
+    max_shell = to_min > max_shell ? to_min : max_shell;
+    max_shell = to_max > max_shell ? to_max : max_shell;
+  }
+
+  uint32_t count = 0;
+  double visited_cells = 0;
+
+  for (int32_t s = 0; s <= max_shell; s++) {
+    // Once the shells are sparser than the entries, finish with a scan of the occupied runs.
+    visited_cells += s == 0 ? 1 : 24.0 * s * s + 2;
+
+    if (visited_cells > data->entry_count) {
+      count = 0;
+
+      for (uint32_t i = 0; i < data->entry_count; i++) {
+        float_t distance_squared = js_websg_distance_squared(data->entries[i].position, position);
+        js_websg_nearest_push(data, &count, k, i, distance_squared);
+      }
+
+      return count;
+    }
+
+    int32_t cell[3];
+
+    for (int32_t x = -s; x <= s; x++) {
+      for (int32_t y = -s; y <= s; y++) {
+        bool on_face = x == -s || x == s || y == -s || y == s;
+        int32_t z_step = on_face || s == 0 ? 1 : 2 * s;
+
+        for (int32_t z = -s; z <= s; z += z_step) {
+          cell[0] = center[0] + x;
+          cell[1] = center[1] + y;
+          cell[2] = center[2] + z;
+          js_websg_spatial_grid_nearest_cell(data, cell, position, &count, k);
+        }
+      }
+    }
+
+    float_t shell_distance = s * data->cell_size;
+
+    if (count == k && data->distances[0] <= shell_distance * shell_distance) {
+      break;
+    }
+  }
+
+  return count;
+}
+
+static int32_t js_websg_spatial_grid_query_frustum(JSContext *ctx, WebSGSpatialIndexData *data, float_t planes[6][4]) {
+  if (js_websg_spatial_grid_rebuild(ctx, data)) {
+    return -1;
+  }
+
+  uint32_t count = 0;
+
+  for (uint32_t i = 0; i < data->cell_capacity; i++) {
+    WebSGSpatialGridCell *run = &data->cells[i];
+
+    if (run->count == 0) {
+      continue;
+    }
+
+    float_t min[3];
+    float_t max[3];
+
+    for (int j = 0; j < 3; j++) {
+      min[j] = run->cell[j] * data->cell_size - data->max_radius;
+      max[j] = (run->cell[j] + 1) * data->cell_size + data->max_radius;
+    }
+
+    if (!js_websg_frustum_intersects_aabb(planes, min, max)) {
+      continue;
+    }
+
+    for (uint32_t j = run->start; j < run->start + run->count; j++) {
+      uint32_t entry_index = data->grid_order[j];
+      WebSGSpatialEntry *entry = &data->entries[entry_index];
+
+      if (js_websg_frustum_intersects_sphere(planes, entry->position, entry->radius) &&
+          js_websg_spatial_index_push_result(ctx, data, &count, entry_index)) {
+        return -1;
+      }
+    }
+  }
+
+  return count;
+}
+
+/**
+ * Tree
+ **/
+
+static bool js_websg_tree_is_leaf(WebSGSpatialTreeNode *node) {
+  return node->children[0] == WEBSG_SPATIAL_NULL;
+}
+
+static void js_websg_tree_combine(WebSGSpatialTreeNode *node, WebSGSpatialTreeNode *a, WebSGSpatialTreeNode *b) {
+  for (int i = 0; i < 3; i++) {
+    node->min[i] = fminf(a->min[i], b->min[i]);
+    node->max[i] = fmaxf(a->max[i], b->max[i]);
+  }
+}
+
+static int js_websg_tree_allocate_node(JSContext *ctx, WebSGSpatialIndexData *data, uint32_t *node_index) {
+  if (data->free_node == WEBSG_SPATIAL_NULL) {
+    uint32_t old_capacity = data->tree_node_capacity;
+
+    if (js_websg_spatial_index_reserve(
+      ctx,
+      (void **)&data->tree_nodes,
+      &data->tree_node_capacity,
+      old_capacity + 1,
+      sizeof(WebSGSpatialTreeNode)
+    )) {
+      return -1;
+    }
+
+    for (uint32_t i = old_capacity; i < data->tree_node_capacity; i++) {
+      data->tree_nodes[i].parent = i + 1 < data->tree_node_capacity ? i + 1 : WEBSG_SPATIAL_NULL;
+      data->tree_nodes[i].height = -1;
+    }
+
+    data->free_node = old_capacity;
+  }
+
+  uint32_t i = data->free_node;
+  WebSGSpatialTreeNode *node = &data->tree_nodes[i];
+  data->free_node = node->parent;
+  node->parent = WEBSG_SPATIAL_NULL;
+  node->children[0] = WEBSG_SPATIAL_NULL;
+  node->children[1] = WEBSG_SPATIAL_NULL;
+  node->height = 0;
+  *node_index = i;
+
+  return 0;
+}
+
+static void js_websg_tree_free_node(WebSGSpatialIndexData *data, uint32_t i) {
+  data->tree_nodes[i].parent = data->free_node;
+  data->tree_nodes[i].height = -1;
+  data->free_node = i;
+}
+
+static void js_websg_tree_replace_child(WebSGSpatialIndexData *data, uint32_t parent, uint32_t old_child, uint32_t new_child) {
+  if (parent == WEBSG_SPATIAL_NULL) {
+    data->root = new_child;
+  } else if (data->tree_nodes[parent].children[0] == old_child) {
+    data->tree_nodes[parent].children[0] = new_child;
+  } else {
+    data->tree_nodes[parent].children[1] = new_child;
+  }
+}
+
+// Rotates the taller grandchild of node a up when a's children differ in height by more than one, returns the root of
+// the rotated subtree.
+static uint32_t js_websg_tree_balance(WebSGSpatialIndexData *data, uint32_t ia) {
+  WebSGSpatialTreeNode *nodes = data->tree_nodes;
+  WebSGSpatialTreeNode *a = &nodes[ia];
+
+  if (js_websg_tree_is_leaf(a) || a->height < 2) {
+    return ia;
+  }
+
+  int side = nodes[a->children[1]].height - nodes[a->children[0]].height > 1 ? 1
+    : nodes[a->children[0]].height - nodes[a->children[1]].height > 1 ? 0
+    : -1;
+
+  if (side == -1) {
+    return ia;
+  }
+
+  // b is rotated up into a's place, c is a's other child.
+  uint32_t ib = a->children[side];
+  uint32_t ic = a->children[1 - side];
+  WebSGSpatialTreeNode *b = &nodes[ib];
+  WebSGSpatialTreeNode *c = &nodes[ic];
+  uint32_t i_f = b->children[0];
+  uint32_t i_g = b->children[1];
+  WebSGSpatialTreeNode *f = &nodes[i_f];
+  WebSGSpatialTreeNode *g = &nodes[i_g];
+
+  b->children[0] = ia;
+  b->parent = a->parent;
+  a->parent = ib;
+  js_websg_tree_replace_child(data, b->parent, ia, ib);
+
+  // The taller of b's children stays under b, the other one takes b's place under a.
+  uint32_t i_keep = f->height > g->height ? i_f : i_g;
+  uint32_t i_move = f->height > g->height ? i_g : i_f;
+  WebSGSpatialTreeNode *keep = &nodes[i_keep];
+  WebSGSpatialTreeNode *move = &nodes[i_move];
+
+  b->children[1] = i_keep;
+  a->children[side] = i_move;
+  move->parent = ia;
+
+  js_websg_tree_combine(a, c, move);
+  js_websg_tree_combine(b, a, keep);
+  a->height = 1 + (c->height > move->height ? c->height : move->height);
+  b->height = 1 + (a->height > keep->height ? a->height : keep->height);
+
+  return ib;
+}
+
+static void js_websg_tree_refit_ancestors(WebSGSpatialIndexData *data, uint32_t i) {
+  while (i != WEBSG_SPATIAL_NULL) {
+    i = js_websg_tree_balance(data, i);
+
+    WebSGSpatialTreeNode *node = &data->tree_nodes[i];
+    WebSGSpatialTreeNode *child_a = &data->tree_nodes[node->children[0]];
+    WebSGSpatialTreeNode *child_b = &data->tree_nodes[node->children[1]];
+
+    node->height = 1 + (child_a->height > child_b->height ? child_a->height : child_b->height);
+    js_websg_tree_combine(node, child_a, child_b);
+
+    i = node->parent;
+  }
+}
+
+// Descends to the sibling that increases the tree's surface area the least, see Box2D's b2DynamicTree.
+static int js_websg_tree_insert_leaf(JSContext *ctx, WebSGSpatialIndexData *data, uint32_t leaf) {
+  if (data->root == WEBSG_SPATIAL_NULL) {
+    data->root = leaf;
+    data->tree_nodes[leaf].parent = WEBSG_SPATIAL_NULL;
+    return 0;
+  }
+
+  uint32_t parent;
+
+  // Allocated first, growing the node array invalidates pointers.
+  if (js_websg_tree_allocate_node(ctx, data, &parent)) {
+    return -1;
+  }
+
+  WebSGSpatialTreeNode *nodes = data->tree_nodes;
+  float_t *leaf_min = nodes[leaf].min;
+  float_t *leaf_max = nodes[leaf].max;
+  uint32_t i = data->root;
+
+  while (!js_websg_tree_is_leaf(&nodes[i])) {
+    WebSGSpatialTreeNode *node = &nodes[i];
+    float_t area = js_websg_aabb_area(node->min, node->max);
+    float_t combined_area = js_websg_aabb_combined_area(node->min, node->max, leaf_min, leaf_max);
+
+    // Cost of making a new parent for this node and the leaf, and the cost pushed down to the children.
+    float_t cost = 2 * combined_area;
+    float_t inheritance_cost = 2 * (combined_area - area);
+    float_t child_costs[2];
+
+    for (int j = 0; j < 2; j++) {
+      WebSGSpatialTreeNode *child = &nodes[node->children[j]];
+      float_t child_area = js_websg_aabb_combined_area(child->min, child->max, leaf_min, leaf_max);
+
+      if (!js_websg_tree_is_leaf(child)) {
+        child_area -= js_websg_aabb_area(child->min, child->max);
+      }
+
+      child_costs[j] = child_area + inheritance_cost;
+    }
+
+    if (cost < child_costs[0] && cost < child_costs[1]) {
+      break;
+    }
+
+    i = child_costs[0] < child_costs[1] ? node->children[0] : node->children[1];
+  }
+
+  uint32_t sibling = i;
+  uint32_t old_parent = nodes[sibling].parent;
+
+  nodes[parent].parent = old_parent;
+  nodes[parent].children[0] = sibling;
+  nodes[parent].children[1] = leaf;
+  nodes[parent].height = nodes[sibling].height + 1;
+  js_websg_tree_combine(&nodes[parent], &nodes[sibling], &nodes[leaf]);
+  nodes[sibling].parent = parent;
+  nodes[leaf].parent = parent;
+  js_websg_tree_replace_child(data, old_parent, sibling, parent);
+
+  js_websg_tree_refit_ancestors(data, old_parent);
+
+  return 0;
+}
+
+static void js_websg_tree_remove_leaf(WebSGSpatialIndexData *data, uint32_t leaf) {
+  WebSGSpatialTreeNode *nodes = data->tree_nodes;
+
+  if (leaf == data->root) {
+    data->root = WEBSG_SPATIAL_NULL;
+    return;
+  }
+
+  uint32_t parent = nodes[leaf].parent;
+  uint32_t grandparent = nodes[parent].parent;
+  uint32_t sibling = nodes[parent].children[0] == leaf ? nodes[parent].children[1] : nodes[parent].children[0];
+
+  js_websg_tree_replace_child(data, grandparent, parent, sibling);
+  nodes[sibling].parent = grandparent;
+  js_websg_tree_free_node(data, parent);
+
+  js_websg_tree_refit_ancestors(data, grandparent);
+}
+
+static void js_websg_tree_set_fat_bounds(WebSGSpatialIndexData *data, WebSGSpatialEntry *entry) {
+  WebSGSpatialTreeNode *leaf = &data->tree_nodes[entry->leaf];
+  float_t extent = entry->radius + data->margin;
+
+  for (int i = 0; i < 3; i++) {
+    leaf->min[i] = entry->position[i] - extent;
+    leaf->max[i] = entry->position[i] + extent;
+  }
+}
+
+static bool js_websg_tree_leaf_contains(WebSGSpatialIndexData *data, WebSGSpatialEntry *entry) {
+  WebSGSpatialTreeNode *leaf = &data->tree_nodes[entry->leaf];
+
+  for (int i = 0; i < 3; i++) {
+    if (entry->position[i] - entry->radius < leaf->min[i] || entry->position[i] + entry->radius > leaf->max[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static int js_websg_tree_reserve_stack(JSContext *ctx, WebSGSpatialIndexData *data) {
+  return js_websg_spatial_index_reserve(
+    ctx,
+    (void **)&data->stack,
+    &data->stack_capacity,
+    data->tree_node_capacity + 1,
+    sizeof(uint32_t)
+  );
+}
+
+static int32_t js_websg_spatial_tree_query_radius(
+  JSContext *ctx,
+  WebSGSpatialIndexData *data,
+  const float_t *position,
+  float_t radius
+) {
+  if (data->root == WEBSG_SPATIAL_NULL) {
+    return 0;
+  }
+
+  if (js_websg_tree_reserve_stack(ctx, data)) {
+    return -1;
+  }
+
+  uint32_t count = 0;
+  uint32_t stack_size = 0;
+  uint32_t *stack = data->stack;
+  stack[stack_size++] = data->root;
+
+  while (stack_size > 0) {
+    WebSGSpatialTreeNode *node = &data->tree_nodes[stack[--stack_size]];
+
+    if (js_websg_aabb_distance_squared(node->min, node->max, position) > radius * radius) {
+      continue;
+    }
+
+    if (!js_websg_tree_is_leaf(node)) {
+      stack[stack_size++] = node->children[0];
+      stack[stack_size++] = node->children[1];
+      continue;
+    }
+
+    uint32_t entry_index = node->children[1];
+    WebSGSpatialEntry *entry = &data->entries[entry_index];
+    float_t max_distance = radius + entry->radius;
+
+    if (js_websg_distance_squared(entry->position, position) <= max_distance * max_distance &&
+        js_websg_spatial_index_push_result(ctx, data, &count, entry_index)) {
+      return -1;
+    }
+  }
+
+  return count;
+}
+
+// Depth first with the nearer child visited first, subtrees farther than the current k-th candidate are skipped.
+static int32_t js_websg_spatial_tree_query_nearest(
+  JSContext *ctx,
+  WebSGSpatialIndexData *data,
+  const float_t *position,
+  uint32_t k
+) {
+  if (data->root == WEBSG_SPATIAL_NULL) {
+    return 0;
+  }
+
+  if (js_websg_tree_reserve_stack(ctx, data)) {
+    return -1;
+  }
+
+  uint32_t count = 0;
+  uint32_t stack_size = 0;
+  uint32_t *stack = data->stack;
+  WebSGSpatialTreeNode *nodes = data->tree_nodes;
+  stack[stack_size++] = data->root;
+
+  while (stack_size > 0) {
+    WebSGSpatialTreeNode *node = &nodes[stack[--stack_size]];
+
+    if (count == k && js_websg_aabb_distance_squared(node->min, node->max, position) >= data->distances[0]) {
+      continue;
+    }
+
+    if (js_websg_tree_is_leaf(node)) {
+      uint32_t entry_index = node->children[1];
+      float_t distance_squared = js_websg_distance_squared(data->entries[entry_index].position, position);
+      js_websg_nearest_push(data, &count, k, entry_index, distance_squared);
+      continue;
+    }
+
+    uint32_t near = node->children[0];
+    uint32_t far = node->children[1];
+
+    if (js_websg_aabb_distance_squared(nodes[far].min, nodes[far].max, position) <
+        js_websg_aabb_distance_squared(nodes[near].min, nodes[near].max, position)) {
+      near = node->children[1];
+      far = node->children[0];
+    }
+
+    stack[stack_size++] = far;
+    stack[stack_size++] = near;
+  }
+
+  return count;
+}
+
+static int32_t js_websg_spatial_tree_query_frustum(JSContext *ctx, WebSGSpatialIndexData *data, float_t planes[6][4]) {
+  if (data->root == WEBSG_SPATIAL_NULL) {
+    return 0;
+  }
+
+  if (js_websg_tree_reserve_stack(ctx, data)) {
+    return -1;
+  }
+
+  uint32_t count = 0;
+  uint32_t stack_size = 0;
+  uint32_t *stack = data->stack;
+  stack[stack_size++] = data->root;
+
+  while (stack_size > 0) {
+    WebSGSpatialTreeNode *node = &data->tree_nodes[stack[--stack_size]];
+
+    if (!js_websg_frustum_intersects_aabb(planes, node->min, node->max)) {
+      continue;
+    }
+
+    if (!js_websg_tree_is_leaf(node)) {
+      stack[stack_size++] = node->children[0];
+      stack[stack_size++] = node->children[1];
+      continue;
+    }
+
+    uint32_t entry_index = node->children[1];
+    WebSGSpatialEntry *entry = &data->entries[entry_index];
+
+    if (js_websg_frustum_intersects_sphere(planes, entry->position, entry->radius) &&
+        js_websg_spatial_index_push_result(ctx, data, &count, entry_index)) {
+      return -1;
+    }
+  }
+
+  return count;
+}
+
+/**
+ * Entries
+ **/
+
+// Moves an entry to position, restructuring the index only when the entry left its cell or fat bounds.
+static int js_websg_spatial_index_move_entry(
+  JSContext *ctx,
+  WebSGSpatialIndexData *data,
+  uint32_t entry_index,
+  const float_t *position
+) {
+  WebSGSpatialEntry *entry = &data->entries[entry_index];
+  memcpy(entry->position, position, sizeof(float_t) * 3);
+
+  if (data->type == WebSGSpatialIndexType_Grid) {
+    for (int i = 0; i < 3; i++) {
+      int32_t cell = js_websg_spatial_cell_coord(position[i], data->cell_size);
+
+      if (cell != entry->cell[i]) {
+        entry->cell[i] = cell;
+        data->grid_valid = false;
+      }
+    }
+
+    return 0;
+  }
+
+  if (js_websg_tree_leaf_contains(data, entry)) {
+    return 0;
+  }
+
+  js_websg_tree_remove_leaf(data, entry->leaf);
+  js_websg_tree_set_fat_bounds(data, entry);
+
+  return js_websg_tree_insert_leaf(ctx, data, entry->leaf);
+}
+
+static int js_websg_spatial_index_add_entry(
+  JSContext *ctx,
+  WebSGSpatialIndexData *data,
+  node_id_t node_id,
+  const float_t *position,
+  float_t radius
+) {
+  uint32_t entry_index = js_websg_spatial_index_find_entry(data, node_id);
+
+  if (entry_index != WEBSG_SPATIAL_NULL) {
+    data->entries[entry_index].radius = radius;
+    data->max_radius = fmaxf(data->max_radius, radius);
+    return js_websg_spatial_index_move_entry(ctx, data, entry_index, position);
+  }
+
+  if (js_websg_spatial_index_reserve(
+    ctx,
+    (void **)&data->entries,
+    &data->entry_capacity,
+    data->entry_count + 1,
+    sizeof(WebSGSpatialEntry)
+  )) {
+    return -1;
+  }
+
+  uint32_t old_slot_capacity = data->slot_capacity;
+
+  if (js_websg_spatial_index_reserve(ctx, (void **)&data->slots, &data->slot_capacity, node_id + 1, sizeof(uint32_t))) {
+    return -1;
+  }
+
+  memset(data->slots + old_slot_capacity, 0, sizeof(uint32_t) * (data->slot_capacity - old_slot_capacity));
+
+  entry_index = data->entry_count;
+  WebSGSpatialEntry *entry = &data->entries[entry_index];
+  memset(entry, 0, sizeof(WebSGSpatialEntry));
+  entry->node_id = node_id;
+  entry->radius = radius;
+  memcpy(entry->position, position, sizeof(float_t) * 3);
+  entry->leaf = WEBSG_SPATIAL_NULL;
+
+  if (data->type == WebSGSpatialIndexType_Grid) {
+    for (int i = 0; i < 3; i++) {
+      entry->cell[i] = js_websg_spatial_cell_coord(position[i], data->cell_size);
+    }
+
+    data->max_radius = fmaxf(data->max_radius, radius);
+    data->grid_valid = false;
+  } else {
+    uint32_t leaf;
+
+    if (js_websg_tree_allocate_node(ctx, data, &leaf)) {
+      return -1;
+    }
+
+    // The allocation may have moved the entries' leaves, but not the entries.
+    entry->leaf = leaf;
+    data->tree_nodes[leaf].children[1] = entry_index;
+    js_websg_tree_set_fat_bounds(data, entry);
+
+    if (js_websg_tree_insert_leaf(ctx, data, leaf)) {
+      js_websg_tree_free_node(data, leaf);
+      return -1;
+    }
+  }
+
+  data->slots[node_id] = entry_index + 1;
+  data->entry_count++;
+
+  return 0;
+}
+
+static void js_websg_spatial_index_remove_entry(WebSGSpatialIndexData *data, node_id_t node_id) {
+  uint32_t entry_index = js_websg_spatial_index_find_entry(data, node_id);
+
+  if (entry_index == WEBSG_SPATIAL_NULL) {
+    return;
+  }
+
+  if (data->type == WebSGSpatialIndexType_Tree) {
+    uint32_t leaf = data->entries[entry_index].leaf;
+    js_websg_tree_remove_leaf(data, leaf);
+    js_websg_tree_free_node(data, leaf);
+  }
+
+  data->slots[node_id] = 0;
+
+  uint32_t last_index = --data->entry_count;
+
+  if (entry_index != last_index) {
+    WebSGSpatialEntry *moved = &data->entries[entry_index];
+    *moved = data->entries[last_index];
+    data->slots[moved->node_id] = entry_index + 1;
+
+    if (data->type == WebSGSpatialIndexType_Tree) {
+      data->tree_nodes[moved->leaf].children[1] = entry_index;
+    }
+  }
+
+  data->grid_valid = false;
+}
+
+/**
+ * Class Definition
+ **/
+
+static void js_websg_spatial_index_finalizer(JSRuntime *rt, JSValue val) {
+  WebSGSpatialIndexData *data = JS_GetOpaque(val, js_websg_spatial_index_class_id);
+
+  if (data) {
+    js_websg_spatial_index_free(rt, data);
+    js_free_rt(rt, data);
+  }
+}
+
+static JSClassDef js_websg_spatial_index_class = {
+  "SpatialIndex",
+  .finalizer = js_websg_spatial_index_finalizer
+};
+
+// A node's world position or an array-like of 3 numbers.
+static int js_websg_spatial_index_get_position(JSContext *ctx, JSValueConst value, float_t *position) {
+  WebSGNodeData *node_data = JS_GetOpaque(value, js_websg_node_class_id);
+
+  if (node_data == NULL) {
+    return js_get_float_array_like(ctx, value, position, 3);
+  }
+
+  float_t world_matrix[16];
+
+  if (websg_node_get_world_matrix(node_data->node_id, world_matrix) == -1) {
+    JS_ThrowInternalError(ctx, "WebSG: Error getting node's world matrix.");
+    return -1;
+  }
+
+  memcpy(position, &world_matrix[12], sizeof(float_t) * 3);
+
+  return 0;
+}
+
+// Writes the results' node ids to out and returns the number of results, or returns an array of nodes without out.
+static JSValue js_websg_spatial_index_return_results(
+  JSContext *ctx,
+  WebSGSpatialIndexData *data,
+  int32_t count,
+  JSValueConst out
+) {
+  if (count < 0) {
+    return JS_EXCEPTION;
+  }
+
+  if (!JS_IsUndefined(out)) {
+    uint32_t length;
+    node_id_t *node_ids = get_typed_array_elements(ctx, (JSValue *)&out, sizeof(node_id_t), &length);
+
+    if (node_ids == NULL) {
+      return JS_EXCEPTION;
+    }
+
+    uint32_t written = (uint32_t)count < length ? (uint32_t)count : length;
+
+    for (uint32_t i = 0; i < written; i++) {
+      node_ids[i] = data->entries[data->results[i]].node_id;
+    }
+
+    return JS_NewUint32(ctx, count);
+  }
+
+  JSValue nodes = JS_NewArray(ctx);
+
+  if (JS_IsException(nodes)) {
+    return nodes;
+  }
+
+  for (int32_t i = 0; i < count; i++) {
+    JSValue node = js_websg_get_node_by_id(ctx, data->world_data, data->entries[data->results[i]].node_id);
+
+    if (JS_IsException(node)) {
+      JS_FreeValue(ctx, nodes);
+      return node;
+    }
+
+    JS_SetPropertyUint32(ctx, nodes, i, node);
+  }
+
+  return nodes;
+}
+
+static JSValue js_websg_spatial_index_add(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGSpatialIndexData *data = JS_GetOpaque(this_val, js_websg_spatial_index_class_id);
+
+  node_id_t *node_ids;
+  uint32_t count;
+
+  int owned = js_websg_get_node_ids(ctx, argv[0], &node_ids, &count);
+
+  if (owned < 0) {
+    return JS_EXCEPTION;
+  }
+
+  float_t radius = 0;
+  float_t *radii = NULL;
+
+  if (JS_IsNumber(argv[1])) {
+    double value;
+    JS_ToFloat64(ctx, &value, argv[1]);
+    radius = value;
+  } else if (!JS_IsUndefined(argv[1])) {
+    radii = get_typed_array_data(ctx, &argv[1], sizeof(float_t) * count);
+
+    if (radii == NULL) {
+      if (owned) {
+        js_free(ctx, node_ids);
+      }
+      return JS_EXCEPTION;
+    }
+  }
+
+  if (!(radius >= 0)) {
+    if (owned) {
+      js_free(ctx, node_ids);
+    }
+    return JS_ThrowRangeError(ctx, "WebSG: Spatial index radius must be a positive number.");
+  }
+
+  if (js_websg_spatial_index_read_positions(ctx, data, node_ids, count)) {
+    if (owned) {
+      js_free(ctx, node_ids);
+    }
+    return JS_EXCEPTION;
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    float_t entry_radius = radii ? fmaxf(radii[i], 0) : radius;
+
+    if (js_websg_spatial_index_add_entry(ctx, data, node_ids[i], &data->matrices[i * 16 + 12], entry_radius)) {
+      if (owned) {
+        js_free(ctx, node_ids);
+      }
+      return JS_EXCEPTION;
+    }
+  }
+
+  if (owned) {
+    js_free(ctx, node_ids);
+  }
+
+  return JS_UNDEFINED;
+}
+
+static JSValue js_websg_spatial_index_remove(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGSpatialIndexData *data = JS_GetOpaque(this_val, js_websg_spatial_index_class_id);
+
+  node_id_t *node_ids;
+  uint32_t count;
+
+  int owned = js_websg_get_node_ids(ctx, argv[0], &node_ids, &count);
+
+  if (owned < 0) {
+    return JS_EXCEPTION;
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    js_websg_spatial_index_remove_entry(data, node_ids[i]);
+  }
+
+  if (owned) {
+    js_free(ctx, node_ids);
+  }
+
+  return JS_UNDEFINED;
+}
+
+static JSValue js_websg_spatial_index_update(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGSpatialIndexData *data = JS_GetOpaque(this_val, js_websg_spatial_index_class_id);
+
+  uint32_t count = 0;
+
+  if (JS_IsUndefined(argv[0])) {
+    if (js_websg_spatial_index_reserve(
+      ctx,
+      (void **)&data->node_ids,
+      &data->node_id_capacity,
+      data->entry_count,
+      sizeof(node_id_t)
+    )) {
+      return JS_EXCEPTION;
+    }
+
+    for (uint32_t i = 0; i < data->entry_count; i++) {
+      data->node_ids[i] = data->entries[i].node_id;
+    }
+
+    count = data->entry_count;
+  } else {
+    node_id_t *node_ids;
+    uint32_t node_count;
+
+    int owned = js_websg_get_node_ids(ctx, argv[0], &node_ids, &node_count);
+
+    if (owned < 0) {
+      return JS_EXCEPTION;
+    }
+
+    if (js_websg_spatial_index_reserve(
+      ctx,
+      (void **)&data->node_ids,
+      &data->node_id_capacity,
+      node_count,
+      sizeof(node_id_t)
+    )) {
+      if (owned) {
+        js_free(ctx, node_ids);
+      }
+      return JS_EXCEPTION;
+    }
+
+    // Nodes that aren't in the index are ignored.
+    for (uint32_t i = 0; i < node_count; i++) {
+      if (js_websg_spatial_index_find_entry(data, node_ids[i]) != WEBSG_SPATIAL_NULL) {
+        data->node_ids[count++] = node_ids[i];
+      }
+    }
+
+    if (owned) {
+      js_free(ctx, node_ids);
+    }
+  }
+
+  if (js_websg_spatial_index_read_positions(ctx, data, data->node_ids, count)) {
+    return JS_EXCEPTION;
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t entry_index = js_websg_spatial_index_find_entry(data, data->node_ids[i]);
+
+    if (js_websg_spatial_index_move_entry(ctx, data, entry_index, &data->matrices[i * 16 + 12])) {
+      return JS_EXCEPTION;
+    }
+  }
+
+  return JS_UNDEFINED;
+}
+
+static JSValue js_websg_spatial_index_query_radius(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  WebSGSpatialIndexData *data = JS_GetOpaque(this_val, js_websg_spatial_index_class_id);
+
+  float_t position[3];
+
+  if (js_websg_spatial_index_get_position(ctx, argv[0], position)) {
+    return JS_EXCEPTION;
+  }
+
+  double radius;
+
+  if (JS_ToFloat64(ctx, &radius, argv[1]) == -1) {
+    return JS_EXCEPTION;
+  }
+
+  if (!(radius >= 0)) {
+    return JS_ThrowRangeError(ctx, "WebSG: Query radius must be a positive number.");
+  }
+
+  int32_t count = data->type == WebSGSpatialIndexType_Grid
+    ? js_websg_spatial_grid_query_radius(ctx, data, position, radius)
+    : js_websg_spatial_tree_query_radius(ctx, data, position, radius);
+
+  return js_websg_spatial_index_return_results(ctx, data, count, argv[2]);
+}
+
+static JSValue js_websg_spatial_index_query_nearest(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  WebSGSpatialIndexData *data = JS_GetOpaque(this_val, js_websg_spatial_index_class_id);
+
+  float_t position[3];
+
+  if (js_websg_spatial_index_get_position(ctx, argv[0], position)) {
+    return JS_EXCEPTION;
+  }
+
+  uint32_t k;
+
+  if (JS_ToUint32(ctx, &k, argv[1]) == -1) {
+    return JS_EXCEPTION;
+  }
+
+  k = k < data->entry_count ? k : data->entry_count;
+
+  if (k == 0) {
+    return js_websg_spatial_index_return_results(ctx, data, 0, argv[2]);
+  }
+
+  if (js_websg_spatial_index_reserve(ctx, (void **)&data->results, &data->result_capacity, k, sizeof(uint32_t)) ||
+      js_websg_spatial_index_reserve(ctx, (void **)&data->distances, &data->distance_capacity, k, sizeof(float_t))) {
+    return JS_EXCEPTION;
+  }
+
+  int32_t count;
+
+  if (data->type == WebSGSpatialIndexType_Grid) {
+    count = js_websg_spatial_grid_rebuild(ctx, data) ? -1 : (int32_t)js_websg_spatial_grid_query_nearest(data, position, k);
+  } else {
+    count = js_websg_spatial_tree_query_nearest(ctx, data, position, k);
+  }
+
+  if (count > 0) {
+    js_websg_nearest_sort(data, count);
+  }
+
+  return js_websg_spatial_index_return_results(ctx, data, count, argv[2]);
+}
+
+static JSValue js_websg_spatial_index_query_frustum(
+  JSContext *ctx,
+  JSValueConst this_val,
+  int argc,
+  JSValueConst *argv
+) {
+  WebSGSpatialIndexData *data = JS_GetOpaque(this_val, js_websg_spatial_index_class_id);
+
+  float_t view_projection[16];
+
+  if (js_get_float_array_like(ctx, argv[0], view_projection, 16) == -1) {
+    return JS_EXCEPTION;
+  }
+
+  float_t planes[6][4];
+  js_websg_get_frustum_planes(view_projection, planes);
+
+  int32_t count = data->type == WebSGSpatialIndexType_Grid
+    ? js_websg_spatial_grid_query_frustum(ctx, data, planes)
+    : js_websg_spatial_tree_query_frustum(ctx, data, planes);
+
+  return js_websg_spatial_index_return_results(ctx, data, count, argv[1]);
+}
+
+static JSValue js_websg_spatial_index_get_size(JSContext *ctx, JSValueConst this_val) {
+  WebSGSpatialIndexData *data = JS_GetOpaque(this_val, js_websg_spatial_index_class_id);
+  return JS_NewUint32(ctx, data->entry_count);
+}
+
+static JSValue js_websg_spatial_index_dispose(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGSpatialIndexData *data = JS_GetOpaque(this_val, js_websg_spatial_index_class_id);
+
+  js_websg_spatial_index_free(JS_GetRuntime(ctx), data);
+
+  WebSGSpatialIndexData empty = {
+    .world_data = data->world_data,
+    .type = data->type,
+    .cell_size = data->cell_size,
+    .margin = data->margin,
+    .root = WEBSG_SPATIAL_NULL,
+    .free_node = WEBSG_SPATIAL_NULL,
+  };
+
+  *data = empty;
+
+  return JS_UNDEFINED;
+}
+
+static const JSCFunctionListEntry js_websg_spatial_index_proto_funcs[] = {
+  JS_CFUNC_DEF("add", 2, js_websg_spatial_index_add),
+  JS_CFUNC_DEF("remove", 1, js_websg_spatial_index_remove),
+  JS_CFUNC_DEF("update", 1, js_websg_spatial_index_update),
+  JS_CFUNC_DEF("queryRadius", 3, js_websg_spatial_index_query_radius),
+  JS_CFUNC_DEF("queryNearest", 3, js_websg_spatial_index_query_nearest),
+  JS_CFUNC_DEF("queryFrustum", 2, js_websg_spatial_index_query_frustum),
+  JS_CGETSET_DEF("size", js_websg_spatial_index_get_size, NULL),
+  JS_CFUNC_DEF("dispose", 0, js_websg_spatial_index_dispose),
+  JS_PROP_STRING_DEF("[Symbol.toStringTag]", "SpatialIndex", JS_PROP_CONFIGURABLE),
+};
+
+static JSValue js_websg_spatial_index_constructor(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  return JS_ThrowTypeError(ctx, "Illegal Constructor.");
+}
+
+void js_websg_define_spatial_index(JSContext *ctx, JSValue websg) {
+  JS_NewClassID(&js_websg_spatial_index_class_id);
+  JS_NewClass(JS_GetRuntime(ctx), js_websg_spatial_index_class_id, &js_websg_spatial_index_class);
+  JSValue spatial_index_proto = JS_NewObject(ctx);
+  JS_SetPropertyFunctionList(
+    ctx,
+    spatial_index_proto,
+    js_websg_spatial_index_proto_funcs,
+    countof(js_websg_spatial_index_proto_funcs)
+  );
+  JS_SetClassProto(ctx, js_websg_spatial_index_class_id, spatial_index_proto);
+
+  JSValue constructor = JS_NewCFunction2(
+    ctx,
+    js_websg_spatial_index_constructor,
+    "SpatialIndex",
+    0,
+    JS_CFUNC_constructor,
+    0
+  );
+  JS_SetConstructor(ctx, constructor, spatial_index_proto);
+  JS_SetPropertyStr(
+    ctx,
+    websg,
+    "SpatialIndex",
+    constructor
+  );
+}
+
+/**
+ * World Methods
+ **/
+
+#define WEBSG_DEFAULT_SPATIAL_INDEX_CELL_SIZE 4
+#define WEBSG_DEFAULT_SPATIAL_INDEX_MARGIN 0.5
+
+static int js_websg_parse_spatial_index_options(JSContext *ctx, JSValueConst options, WebSGSpatialIndexData *data) {
+  data->type = WebSGSpatialIndexType_Tree;
+  data->cell_size = WEBSG_DEFAULT_SPATIAL_INDEX_CELL_SIZE;
+  data->margin = WEBSG_DEFAULT_SPATIAL_INDEX_MARGIN;
+
+  if (JS_IsUndefined(options)) {
+    return 0;
+  }
+
+  JSValue type_val = JS_GetPropertyStr(ctx, options, "type");
+
+  if (!JS_IsUndefined(type_val)) {
+    const char *type = JS_ToCString(ctx, type_val);
+    JS_FreeValue(ctx, type_val);
+
+    if (type == NULL) {
+      return -1;
+    }
+
+    bool valid = true;
+
+    if (strcmp(type, "grid") == 0) {
+      data->type = WebSGSpatialIndexType_Grid;
+    } else if (strcmp(type, "tree") != 0) {
+      valid = false;
+    }
+
+    JS_FreeCString(ctx, type);
+
+    if (!valid) {
+      JS_ThrowTypeError(ctx, "WebSG: Spatial index type must be \"grid\" or \"tree\".");
+      return -1;
+    }
+  }
+
+  JSValue cell_size_val = JS_GetPropertyStr(ctx, options, "cellSize");
+
+  if (!JS_IsUndefined(cell_size_val)) {
+    double cell_size;
+    int result = JS_ToFloat64(ctx, &cell_size, cell_size_val);
+    JS_FreeValue(ctx, cell_size_val);
+
+    if (result == -1) {
+      return -1;
+    }
+
+    if (!(cell_size > 0)) {
+      JS_ThrowRangeError(ctx, "WebSG: cellSize must be greater than 0.");
+      return -1;
+    }
+
+    data->cell_size = cell_size;
+  }
+
+  JSValue margin_val = JS_GetPropertyStr(ctx, options, "margin");
+
+  if (!JS_IsUndefined(margin_val)) {
+    double margin;
+    int result = JS_ToFloat64(ctx, &margin, margin_val);
+    JS_FreeValue(ctx, margin_val);
+
+    if (result == -1) {
+      return -1;
+    }
+
+    if (!(margin >= 0)) {
+      JS_ThrowRangeError(ctx, "WebSG: margin must be a positive number.");
+      return -1;
+    }
+
+    data->margin = margin;
+  }
+
+  return 0;
+}
+
+JSValue js_websg_world_create_spatial_index(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
+  WebSGWorldData *world_data = JS_GetOpaque(this_val, js_websg_world_class_id);
+
+  WebSGSpatialIndexData *data = js_mallocz(ctx, sizeof(WebSGSpatialIndexData));
+
+  if (data == NULL) {
+    return JS_EXCEPTION;
+  }
+
+  data->world_data = world_data;
+  data->root = WEBSG_SPATIAL_NULL;
+  data->free_node = WEBSG_SPATIAL_NULL;
+
+  if (js_websg_parse_spatial_index_options(ctx, argv[0], data)) {
+    js_free(ctx, data);
+    return JS_EXCEPTION;
+  }
+
+  JSValue spatial_index = JS_NewObjectClass(ctx, js_websg_spatial_index_class_id);
+
+  if (JS_IsException(spatial_index)) {
+    js_free(ctx, data);
+    return spatial_index;
+  }
+
+  JS_SetOpaque(spatial_index, data);
+
+  return spatial_index;
+}
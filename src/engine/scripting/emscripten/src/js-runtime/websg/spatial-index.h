@@ -0,0 +1,106 @@
+#ifndef __websg_spatial_index_js_h
+#define __websg_spatial_index_js_h
+#include <math.h>
+#include <stdbool.h>
+#include "../quickjs/quickjs.h"
+#include "../../websg.h"
+#include "./world.h"
+
+/**
+ * Spatial Index
+ *
+ * world.createSpatialIndex({ type }) indexes nodes by their world position and a bounding radius, so that scripts
+ * can run radius, k-nearest and frustum queries in native code instead of comparing every pair of nodes in JS.
+ *
+ * Positions are read from the host with a single bulk import when nodes are added and when the script calls
+ * update(), either for every indexed node or only for the nodes it knows moved. Only entries that moved far enough
+ * are restructured:
+ * - grid: a loose uniform grid. Entries are bucketed by the cell of their center and queries are expanded by the
+ *   largest radius in the index. The cell runs are rebuilt lazily, only after an entry changed cells.
+ * - tree: a dynamic AABB tree with fattened leaf bounds, balanced with rotations. A leaf is only reinserted once its
+ *   sphere leaves its fat bounds.
+ **/
+
+#define WEBSG_SPATIAL_NULL UINT32_MAX
+
+typedef enum WebSGSpatialIndexType {
+  WebSGSpatialIndexType_Grid,
+  WebSGSpatialIndexType_Tree,
+} WebSGSpatialIndexType;
+
+typedef struct WebSGSpatialEntry {
+  node_id_t node_id;
+  float_t position[3];
+  float_t radius;
+  // Grid: the cell of position.
+  int32_t cell[3];
+  // Tree: the entry's leaf.
+  uint32_t leaf;
+} WebSGSpatialEntry;
+
+typedef struct WebSGSpatialTreeNode {
+  float_t min[3];
+  float_t max[3];
+  // The next free node for nodes in the free list.
+  uint32_t parent;
+  // Leaves have no first child, their second child is the entry index.
+  uint32_t children[2];
+  // 0 for leaves, -1 for free nodes.
+  int32_t height;
+} WebSGSpatialTreeNode;
+
+// Open addressing table entry for the run of entries in a grid cell, count is 0 for empty slots.
+typedef struct WebSGSpatialGridCell {
+  int32_t cell[3];
+  uint32_t start;
+  uint32_t count;
+} WebSGSpatialGridCell;
+
+typedef struct WebSGSpatialIndexData {
+  WebSGWorldData *world_data;
+  WebSGSpatialIndexType type;
+  WebSGSpatialEntry *entries;
+  uint32_t entry_count;
+  uint32_t entry_capacity;
+  // Node id to entry index + 1, node ids are dense.
+  uint32_t *slots;
+  uint32_t slot_capacity;
+  // Grid
+  float_t cell_size;
+  // Queries are expanded by the largest radius, only shrinks when the grid is rebuilt.
+  float_t max_radius;
+  bool grid_valid;
+  // Entry indices sorted by cell.
+  uint32_t *grid_order;
+  uint32_t grid_order_capacity;
+  WebSGSpatialGridCell *cells;
+  uint32_t cell_capacity;
+  int32_t cell_min[3];
+  int32_t cell_max[3];
+  // Tree
+  float_t margin;
+  WebSGSpatialTreeNode *tree_nodes;
+  uint32_t tree_node_capacity;
+  uint32_t root;
+  uint32_t free_node;
+  // Reused between calls.
+  node_id_t *node_ids;
+  uint32_t node_id_capacity;
+  float_t *matrices;
+  uint32_t matrix_capacity;
+  uint32_t *results;
+  uint32_t result_capacity;
+  float_t *distances;
+  uint32_t distance_capacity;
+  uint32_t *stack;
+  uint32_t stack_capacity;
+} WebSGSpatialIndexData;
+
+extern JSClassID js_websg_spatial_index_class_id;
+
+void js_websg_define_spatial_index(JSContext *ctx, JSValue websg);
+
+// Parses an optional { type: "grid" | "tree", cellSize, margin } object.
+JSValue js_websg_world_create_spatial_index(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv);
+
+#endif
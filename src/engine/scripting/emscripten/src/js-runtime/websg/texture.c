@@ -64,11 +64,17 @@ JSValue js_websg_new_texture_instance(JSContext *ctx, WebSGWorldData *world_data
   }
 
   WebSGTextureData *texture_data = js_mallocz(ctx, sizeof(WebSGTextureData));
+
+  if (texture_data == NULL) {
+    JS_FreeValue(ctx, texture);
+    return JS_EXCEPTION;
+  }
+
   texture_data->world_data = world_data;
   texture_data->texture_id = texture_id;
   JS_SetOpaque(texture, texture_data);
 
-  JS_SetPropertyUint32(ctx, world_data->textures, texture_id, JS_DupValue(ctx, texture));
+  js_handle_table_set(ctx, &world_data->textures, texture_id, JS_DupValue(ctx, texture));
   
   return texture;
 }
@@ -78,7 +84,7 @@ JSValue js_websg_new_texture_instance(JSContext *ctx, WebSGWorldData *world_data
  **/
 
 JSValue js_websg_get_texture_by_id(JSContext *ctx, WebSGWorldData *world_data, texture_id_t texture_id) {
-  JSValue texture = JS_GetPropertyUint32(ctx, world_data->textures, texture_id);
+  JSValueConst texture = js_handle_table_get(&world_data->textures, texture_id);
 
   if (!JS_IsUndefined(texture)) {
     return JS_DupValue(ctx, texture);
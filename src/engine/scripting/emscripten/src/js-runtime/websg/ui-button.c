@@ -162,11 +162,17 @@ JSValue js_websg_new_ui_button_instance(JSContext *ctx, WebSGWorldData *world_da
   js_define_ui_text_props(ctx, world_data, ui_element_id, ui_button);
 
   WebSGUIElementData *element_data = js_mallocz(ctx, sizeof(WebSGUIElementData));
+
+  if (element_data == NULL) {
+    JS_FreeValue(ctx, ui_button);
+    return JS_EXCEPTION;
+  }
+
   element_data->world_data = world_data;
   element_data->ui_element_id = ui_element_id;
   JS_SetOpaque(ui_button, element_data);
 
-  JS_SetPropertyUint32(ctx, world_data->ui_elements, ui_element_id, JS_DupValue(ctx, ui_button));
+  js_handle_table_set(ctx, &world_data->ui_elements, ui_element_id, JS_DupValue(ctx, ui_button));
 
   return ui_button;
 }
@@ -179,11 +179,17 @@ JSValue js_websg_new_ui_canvas_instance(JSContext *ctx, WebSGWorldData *world_da
   );
 
   WebSGUICanvasData *ui_canvas_data = js_mallocz(ctx, sizeof(WebSGUICanvasData));
+
+  if (ui_canvas_data == NULL) {
+    JS_FreeValue(ctx, ui_canvas);
+    return JS_EXCEPTION;
+  }
+
   ui_canvas_data->world_data = world_data;
   ui_canvas_data->ui_canvas_id = ui_canvas_id;
   JS_SetOpaque(ui_canvas, ui_canvas_data);
 
-  JS_SetPropertyUint32(ctx, world_data->ui_canvases, ui_canvas_id, JS_DupValue(ctx, ui_canvas));
+  js_handle_table_set(ctx, &world_data->ui_canvases, ui_canvas_id, JS_DupValue(ctx, ui_canvas));
   
   return ui_canvas;
 }
@@ -193,7 +199,7 @@ JSValue js_websg_new_ui_canvas_instance(JSContext *ctx, WebSGWorldData *world_da
  **/
 
 JSValue js_websg_get_ui_canvas_by_id(JSContext *ctx, WebSGWorldData *world_data, ui_canvas_id_t ui_canvas_id) {
-  JSValue ui_canvas = JS_GetPropertyUint32(ctx, world_data->ui_canvases, ui_canvas_id);
+  JSValueConst ui_canvas = js_handle_table_get(&world_data->ui_canvases, ui_canvas_id);
 
   if (!JS_IsUndefined(ui_canvas)) {
     return JS_DupValue(ctx, ui_canvas);
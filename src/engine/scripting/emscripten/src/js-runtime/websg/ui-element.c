@@ -805,7 +805,7 @@ JSValue js_websg_ui_element_children(JSContext *ctx, JSValueConst this_val, int
     return JS_EXCEPTION;
   }
 
-  ui_element_id_t *children = js_mallocz(ctx, sizeof(ui_element_id_t) * count);
+  ui_element_id_t *children = count == 0 ? NULL : js_mallocz(ctx, sizeof(ui_element_id_t) * count);
 
   if (websg_ui_element_get_children(ui_element_data->ui_element_id, children, count) == -1) {
     JS_ThrowInternalError(ctx, "WebSG: Error getting UIElement children.");
@@ -1002,11 +1002,17 @@ JSValue js_websg_new_ui_element_instance(JSContext *ctx, WebSGWorldData *world_d
   js_define_ui_element_props(ctx, world_data, ui_element_id, ui_element);
 
   WebSGUIElementData *element_data = js_mallocz(ctx, sizeof(WebSGUIElementData));
+
+  if (element_data == NULL) {
+    JS_FreeValue(ctx, ui_element);
+    return JS_EXCEPTION;
+  }
+
   element_data->world_data = world_data;
   element_data->ui_element_id = ui_element_id;
   JS_SetOpaque(ui_element, element_data);
 
-  JS_SetPropertyUint32(ctx, world_data->ui_elements, ui_element_id, JS_DupValue(ctx, ui_element));
+  js_handle_table_set(ctx, &world_data->ui_elements, ui_element_id, JS_DupValue(ctx, ui_element));
   
   return ui_element;
 }
@@ -1016,7 +1022,7 @@ JSValue js_websg_new_ui_element_instance(JSContext *ctx, WebSGWorldData *world_d
  **/
 
 JSValue js_websg_get_ui_element_by_id(JSContext *ctx, WebSGWorldData *world_data, ui_element_id_t ui_element_id) {
-  JSValue ui_element = JS_GetPropertyUint32(ctx, world_data->ui_elements, ui_element_id);
+  JSValueConst ui_element = js_handle_table_get(&world_data->ui_elements, ui_element_id);
 
   if (!JS_IsUndefined(ui_element)) {
     return JS_DupValue(ctx, ui_element);
@@ -282,11 +282,17 @@ JSValue js_websg_new_ui_text_instance(JSContext *ctx, WebSGWorldData *world_data
   js_define_ui_text_props(ctx, world_data, ui_element_id, ui_text);
 
   WebSGUIElementData *element_data = js_mallocz(ctx, sizeof(WebSGUIElementData));
+
+  if (element_data == NULL) {
+    JS_FreeValue(ctx, ui_text);
+    return JS_EXCEPTION;
+  }
+
   element_data->world_data = world_data;
   element_data->ui_element_id = ui_element_id;
   JS_SetOpaque(ui_text, element_data);
 
-  JS_SetPropertyUint32(ctx, world_data->ui_elements, ui_element_id, JS_DupValue(ctx, ui_text));
+  js_handle_table_set(ctx, &world_data->ui_elements, ui_element_id, JS_DupValue(ctx, ui_text));
   
   return ui_text;
 }
@@ -539,6 +539,12 @@ void js_websg_define_vector2(JSContext *ctx, JSValue websg) {
 JSValue js_websg_create_vector2(JSContext *ctx, float* elements) {
   JSValue vector2 = JS_NewObjectClass(ctx, js_websg_vector2_class_id);
   WebSGVector2Data *vec2_data = js_mallocz(ctx, sizeof(WebSGVector2Data));
+
+  if (vec2_data == NULL) {
+    JS_FreeValue(ctx, vector2);
+    return JS_EXCEPTION;
+  }
+
   vec2_data->elements = elements;
   return vector2;
 }
@@ -553,6 +559,12 @@ JSValue js_websg_new_vector2_get_set(
   JSValue vector2 = JS_NewObjectClass(ctx, js_websg_vector2_class_id);
 
   WebSGVector2Data *vec2_data = js_mallocz(ctx, sizeof(WebSGVector2Data));
+
+  if (vec2_data == NULL) {
+    JS_FreeValue(ctx, vector2);
+    return JS_EXCEPTION;
+  }
+
   vec2_data->elements = js_mallocz(ctx, sizeof(float_t) * 2);
   vec2_data->get = get;
   vec2_data->set = set;
@@ -610,6 +610,12 @@ void js_websg_define_vector3(JSContext *ctx, JSValue websg) {
 JSValue js_websg_create_vector3(JSContext *ctx, float* elements) {
   JSValue vector3 = JS_NewObjectClass(ctx, js_websg_vector3_class_id);
   WebSGVector3Data *vector3_data = js_mallocz(ctx, sizeof(WebSGVector3Data));
+
+  if (vector3_data == NULL) {
+    JS_FreeValue(ctx, vector3);
+    return JS_EXCEPTION;
+  }
+
   vector3_data->elements = elements;
   JS_SetOpaque(vector3, vector3_data);
   return vector3;
@@ -626,6 +632,12 @@ JSValue js_websg_new_vector3_get_set(
   JSValue vector3 = JS_NewObjectClass(ctx, js_websg_vector3_class_id);
 
   WebSGVector3Data *vec3_data = js_mallocz(ctx, sizeof(WebSGVector3Data));
+
+  if (vec3_data == NULL) {
+    JS_FreeValue(ctx, vector3);
+    return JS_EXCEPTION;
+  }
+
   vec3_data->elements = js_mallocz(ctx, sizeof(float_t) * 3);
   vec3_data->get = get;
   vec3_data->set = set;
@@ -18,6 +18,15 @@ void js_websg_define_vector3(JSContext *ctx, JSValue websg);
 
 JSValue js_websg_create_vector3(JSContext *ctx, float* elements);
 
+JSValue js_websg_new_vector3_get_set(
+  JSContext *ctx,
+  uint32_t resource_id,
+  float_t (*get)(uint32_t resource_id, uint32_t index),
+  int32_t (*set)(uint32_t resource_id, uint32_t index, float_t value),
+  int32_t (*set_array)(uint32_t resource_id, float_t *array),
+  int read_only
+);
+
 int js_websg_define_vector3_prop(
   JSContext *ctx,
   JSValue obj,
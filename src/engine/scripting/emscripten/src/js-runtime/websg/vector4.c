@@ -577,6 +577,12 @@ void js_websg_define_vector4(JSContext *ctx, JSValue websg) {
 JSValue js_websg_create_vector4(JSContext *ctx, float* elements) {
   JSValue vector4 = JS_NewObjectClass(ctx, js_websg_vector4_class_id);
   WebSGVector4Data *vector4_data = js_mallocz(ctx, sizeof(WebSGVector4Data));
+
+  if (vector4_data == NULL) {
+    JS_FreeValue(ctx, vector4);
+    return JS_EXCEPTION;
+  }
+
   vector4_data->elements = elements;
   return vector4;
 }
@@ -591,6 +597,12 @@ JSValue js_websg_new_vector4_get_set(
   JSValue vector4 = JS_NewObjectClass(ctx, js_websg_vector4_class_id);
 
   WebSGVector4Data *vec4_data = js_mallocz(ctx, sizeof(WebSGVector4Data));
+
+  if (vec4_data == NULL) {
+    JS_FreeValue(ctx, vector4);
+    return JS_EXCEPTION;
+  }
+
   vec4_data->elements = js_mallocz(ctx, sizeof(float_t) * 4);
   vec4_data->get = get;
   vec4_data->set = set;
@@ -35,8 +35,10 @@
 #include "./component-store.h"
 #include "./component.h"
 #include "./query.h"
+#include "./query-iterator.h"
 #include "./collision-iterator.h"
 #include "./collision-listener.h"
+#include "./spatial-index.h"
 #include "./collision.h"
 
 void js_define_websg_api(JSContext *ctx) {
@@ -54,6 +56,7 @@ void js_define_websg_api(JSContext *ctx) {
   js_websg_define_mesh(ctx, websg);
   js_websg_define_node(ctx, websg);
   js_websg_define_node_iterator(ctx);
+  js_websg_define_query_iterator(ctx);
   js_websg_define_physics_body(ctx, websg);
   js_websg_define_quaternion(ctx, websg);
   js_websg_define_rgb(ctx, websg);
@@ -73,6 +76,7 @@ void js_define_websg_api(JSContext *ctx) {
   js_websg_define_component(ctx, websg);
   js_websg_define_component_store(ctx, websg);
   js_websg_define_collision_listener(ctx, websg);
+  js_websg_define_spatial_index(ctx, websg);
   js_websg_define_collision_iterator(ctx);
   js_websg_define_collision(ctx, websg);
   JS_SetPropertyStr(ctx, global, "WebSG", websg);
@@ -4,6 +4,7 @@
 #include "../quickjs/quickjs.h"
 
 #include "../../websg.h"
+#include "../utils/hooks.h"
 
 #include "./world.h"
 
@@ -15,6 +16,7 @@
 #include "./image.h"
 #include "./mesh.h"
 #include "./node.h"
+#include "./physics-body.h"
 #include "./scene.h"
 #include "./ui-canvas.h"
 #include "./ui-element.h"
@@ -23,6 +25,7 @@
 #include "./component-store.h"
 #include "./query.h"
 #include "./collision-listener.h"
+#include "./spatial-index.h"
 #include "./vector3.h"
 
 JSClassID js_websg_world_class_id;
@@ -87,6 +90,14 @@ static JSValue js_websg_world_set_component_store_size(JSContext *ctx, JSValueCo
   return JS_UNDEFINED;
 }
 
+static JSValue js_websg_world_get_hook(JSContext *ctx, JSValueConst this_val, int hook) {
+  return js_get_hook(ctx, hook);
+}
+
+static JSValue js_websg_world_set_hook(JSContext *ctx, JSValueConst this_val, JSValueConst arg, int hook) {
+  return js_set_hook(ctx, hook, arg);
+}
+
 static const JSCFunctionListEntry js_websg_world_proto_funcs[] = {
   JS_CGETSET_DEF("environment", js_websg_world_get_environment, js_websg_world_set_environment),
   JS_CFUNC_DEF("createAccessorFrom", 1, js_websg_world_create_accessor_from),
@@ -119,9 +130,62 @@ static const JSCFunctionListEntry js_websg_world_proto_funcs[] = {
     js_websg_world_get_component_store_size,
     js_websg_world_set_component_store_size
   ),
-  JS_CFUNC_DEF("createCollisionListener", 0, js_websg_world_create_collision_listener),
+  JS_CFUNC_DEF("createCollisionListener", 1, js_websg_world_create_collision_listener),
+  JS_CFUNC_DEF("castRays", 4, js_websg_world_cast_rays),
+  JS_CFUNC_DEF("createSpatialIndex", 1, js_websg_world_create_spatial_index),
   JS_CFUNC_DEF("stopOrbit", 0, js_websg_world_stop_orbit),
   JS_CFUNC_DEF("createQuery", 1, js_websg_world_create_query),
+  JS_CFUNC_MAGIC_DEF("getNodeTranslations", 2, js_websg_world_get_node_transforms, WebSGNodeTransformProp_Translation),
+  JS_CFUNC_MAGIC_DEF("setNodeTranslations", 2, js_websg_world_set_node_transforms, WebSGNodeTransformProp_Translation),
+  JS_CFUNC_MAGIC_DEF("getNodeRotations", 2, js_websg_world_get_node_transforms, WebSGNodeTransformProp_Rotation),
+  JS_CFUNC_MAGIC_DEF("setNodeRotations", 2, js_websg_world_set_node_transforms, WebSGNodeTransformProp_Rotation),
+  JS_CFUNC_MAGIC_DEF("getNodeScales", 2, js_websg_world_get_node_transforms, WebSGNodeTransformProp_Scale),
+  JS_CFUNC_MAGIC_DEF("setNodeScales", 2, js_websg_world_set_node_transforms, WebSGNodeTransformProp_Scale),
+  JS_CFUNC_MAGIC_DEF("getNodeMatrices", 2, js_websg_world_get_node_transforms, WebSGNodeTransformProp_Matrix),
+  JS_CFUNC_MAGIC_DEF("setNodeMatrices", 2, js_websg_world_set_node_transforms, WebSGNodeTransformProp_Matrix),
+  JS_CFUNC_MAGIC_DEF(
+    "getNodeWorldMatrices",
+    2,
+    js_websg_world_get_node_transforms,
+    WebSGNodeTransformProp_WorldMatrix
+  ),
+  JS_CFUNC_MAGIC_DEF(
+    "setNodeWorldMatrices",
+    2,
+    js_websg_world_set_node_transforms,
+    WebSGNodeTransformProp_WorldMatrix
+  ),
+  JS_CFUNC_MAGIC_DEF(
+    "getNodeLinearVelocities",
+    2,
+    js_websg_world_get_physics_body_states,
+    WebSGPhysicsBodyStateProp_LinearVelocity
+  ),
+  JS_CFUNC_MAGIC_DEF(
+    "setNodeLinearVelocities",
+    2,
+    js_websg_world_set_physics_body_states,
+    WebSGPhysicsBodyStateProp_LinearVelocity
+  ),
+  JS_CFUNC_MAGIC_DEF(
+    "getNodeAngularVelocities",
+    2,
+    js_websg_world_get_physics_body_states,
+    WebSGPhysicsBodyStateProp_AngularVelocity
+  ),
+  JS_CFUNC_MAGIC_DEF(
+    "setNodeAngularVelocities",
+    2,
+    js_websg_world_set_physics_body_states,
+    WebSGPhysicsBodyStateProp_AngularVelocity
+  ),
+  JS_CFUNC_MAGIC_DEF("getNodeSleeping", 2, js_websg_world_get_physics_body_states, WebSGPhysicsBodyStateProp_Sleeping),
+  JS_CFUNC_MAGIC_DEF("setNodeSleeping", 2, js_websg_world_set_physics_body_states, WebSGPhysicsBodyStateProp_Sleeping),
+  JS_CFUNC_MAGIC_DEF("applyNodeForces", 2, js_websg_world_set_physics_body_states, WebSGPhysicsBodyStateProp_Force),
+  JS_CFUNC_MAGIC_DEF("applyNodeImpulses", 2, js_websg_world_set_physics_body_states, WebSGPhysicsBodyStateProp_Impulse),
+  JS_CGETSET_MAGIC_DEF("onload", js_websg_world_get_hook, js_websg_world_set_hook, JSHook_WorldLoad),
+  JS_CGETSET_MAGIC_DEF("onenter", js_websg_world_get_hook, js_websg_world_set_hook, JSHook_WorldEnter),
+  JS_CGETSET_MAGIC_DEF("onupdate", js_websg_world_get_hook, js_websg_world_set_hook, JSHook_WorldUpdate),
   JS_PROP_STRING_DEF("[Symbol.toStringTag]", "World", JS_PROP_CONFIGURABLE),
 };
 
@@ -129,10 +193,6 @@ static JSValue js_websg_world_constructor(JSContext *ctx, JSValueConst this_val,
   return JS_ThrowTypeError(ctx, "Illegal Constructor.");
 }
 
-static JSValue js_default_callback(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv) {
-    return JS_UNDEFINED;
-}
-
 void js_websg_define_world(JSContext *ctx, JSValue websg) {
   JS_NewClassID(&js_websg_world_class_id);
   JS_NewClass(JS_GetRuntime(ctx), js_websg_world_class_id, &js_websg_world_class);
@@ -155,11 +215,6 @@ void js_websg_define_world(JSContext *ctx, JSValue websg) {
     "World",
     constructor
   );
-
-  JS_SetPropertyStr(ctx, world_proto, "onload", JS_NewCFunction(ctx, js_default_callback, "onload", 0));
-  JS_SetPropertyStr(ctx, world_proto, "onenter", JS_NewCFunction(ctx, js_default_callback, "onenter", 0));
-  JS_SetPropertyStr(ctx, world_proto, "onupdate", JS_NewCFunction(ctx, js_default_callback, "onupdate", 2));
-
 }
 
 static float_t js_get_primary_input_source_origin_element(uint32_t resource_id, uint32_t index) {
@@ -178,18 +233,12 @@ JSValue js_websg_new_world(JSContext *ctx) {
   }
 
   WebSGWorldData *world_data = js_mallocz(ctx, sizeof(WebSGWorldData));
-  world_data->accessors = JS_NewObject(ctx);
-  world_data->colliders = JS_NewObject(ctx);
-  world_data->lights = JS_NewObject(ctx);
-  world_data->materials = JS_NewObject(ctx);
-  world_data->meshes = JS_NewObject(ctx);
-  world_data->nodes = JS_NewObject(ctx);
-  world_data->scenes = JS_NewObject(ctx);
-  world_data->textures = JS_NewObject(ctx);
-  world_data->images = JS_NewObject(ctx);
-  world_data->ui_canvases = JS_NewObject(ctx);
-  world_data->ui_elements = JS_NewObject(ctx);
-  world_data->component_stores = JS_NewObject(ctx);
+
+  if (world_data == NULL) {
+    JS_FreeValue(ctx, world);
+    return JS_EXCEPTION;
+  }
+
   JS_SetOpaque(world, world_data);
 
   js_websg_define_vector3_prop_read_only(
@@ -1,20 +1,21 @@
 #ifndef __js_websg_world_h
 #define __js_websg_world_h
 #include "../quickjs/quickjs.h"
+#include "../utils/handle-table.h"
 
 typedef struct WebSGWorldData {
-  JSValue accessors;
-  JSValue colliders;
-  JSValue lights;
-  JSValue materials;
-  JSValue meshes;
-  JSValue nodes;
-  JSValue scenes;
-  JSValue textures;
-  JSValue images;
-  JSValue ui_canvases;
-  JSValue ui_elements;
-  JSValue component_stores;
+  JSHandleTable accessors;
+  JSHandleTable colliders;
+  JSHandleTable lights;
+  JSHandleTable materials;
+  JSHandleTable meshes;
+  JSHandleTable nodes;
+  JSHandleTable scenes;
+  JSHandleTable textures;
+  JSHandleTable images;
+  JSHandleTable ui_canvases;
+  JSHandleTable ui_elements;
+  JSHandleTable component_stores;
 } WebSGWorldData;
 
 extern JSClassID js_websg_world_class_id;
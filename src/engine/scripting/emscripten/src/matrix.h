@@ -27,4 +27,25 @@ import_matrix(receive) int32_t matrix_receive(
   uint32_t max_byte_length
 );
 
+// One entry in the header table written by receive_batch. Offsets are relative to the start of the arena.
+// action is the message's action, type and sender are those of the Matrix event in its data, if it has one.
+// Strings that are missing have a length of 0.
+typedef struct MatrixEventHeader {
+  uint32_t byte_offset;
+  uint32_t byte_length;
+  uint32_t action_offset;
+  uint32_t action_length;
+  uint32_t type_offset;
+  uint32_t type_length;
+  uint32_t sender_offset;
+  uint32_t sender_length;
+} MatrixEventHeader;
+
+// Drains as many queued events as fit into the arena in one call, oldest first. The arena starts with a
+// MatrixEventHeader table with one entry per event, followed by each event's JSON, action, type and sender. The
+// JSON is followed by a NUL byte that isn't included in its byte length. Events that don't fit stay in the queue.
+// Returns the number of events written, 0 if the queue was empty and -1 if there was an error or the next event
+// can't fit in the arena on its own.
+import_matrix(receive_batch) int32_t matrix_receive_batch(uint8_t *arena, uint32_t arena_byte_length);
+
 #endif
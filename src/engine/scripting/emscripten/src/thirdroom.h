@@ -10,6 +10,15 @@ typedef uint32_t action_bar_listener_id_t;
 
 import_thirdroom(get_js_source_size) int32_t thirdroom_get_js_source_size();
 import_thirdroom(get_js_source) int32_t thirdroom_get_js_source(char *ptr);
+// Precompiled bytecode for the script (see js-runtime/utils/bytecode.h), size is 0 if there is none. Bytecode isn't
+// validated when it is loaded, so it must come from the runtime itself or another trusted source.
+import_thirdroom(get_js_bytecode_size) int32_t thirdroom_get_js_bytecode_size();
+import_thirdroom(get_js_bytecode) int32_t thirdroom_get_js_bytecode(uint8_t *ptr);
+// Called with the bytecode after the script source is compiled so the host can cache it for the next load.
+import_thirdroom(set_js_bytecode) int32_t thirdroom_set_js_bytecode(uint8_t *ptr, uint32_t size);
+// QuickJS heap limit and GC threshold for the script in bytes, 0 uses the QuickJS defaults.
+import_thirdroom(get_memory_limit) uint32_t thirdroom_get_memory_limit();
+import_thirdroom(get_gc_threshold) uint32_t thirdroom_get_gc_threshold();
 
 import_thirdroom(enable_matrix_material) void thirdroom_enable_matrix_material(int enabled);
 
@@ -19,14 +19,57 @@ import_websg_networking(peer_get_translation_element) float_t websg_peer_get_tra
 import_websg_networking(peer_get_translation) int32_t websg_peer_get_translation(uint32_t peer_index, float_t *translation);
 import_websg_networking(peer_get_rotation_element) float_t websg_peer_get_rotation_element(uint32_t peer_index, uint32_t index);
 import_websg_networking(peer_get_rotation) int32_t websg_peer_get_rotation(uint32_t peer_index, float_t *rotation);
+// Reads the pose of every peer in the world with one call. Writes up to max_count peer indices to peer_indices and
+// their poses to poses, packed as count translations (3 floats each) followed by count rotations (4 floats each),
+// where count is the number of poses written.
+// Returns the number of peers in the world, which can be larger than max_count, and -1 on error.
+import_websg_networking(network_get_peer_poses) int32_t websg_network_get_peer_poses(
+  uint32_t *peer_indices,
+  float_t *poses,
+  uint32_t max_count
+);
 import_websg_networking(peer_is_host) int32_t websg_peer_is_host(uint32_t peer_index);
 import_websg_networking(peer_is_local) int32_t websg_peer_is_local(uint32_t peer_index);
+typedef struct NetworkPeerStats {
+  // Bytes buffered for the peer by the host's transport and not sent yet.
+  uint32_t backlog;
+  // Smoothed round trip time in milliseconds, 0 until it has been measured.
+  float_t rtt;
+} NetworkPeerStats;
+
+// Returns 0 if successful and -1 if the peer doesn't exist.
+import_websg_networking(peer_get_stats) int32_t websg_peer_get_stats(uint32_t peer_index, NetworkPeerStats *stats);
 import_websg_networking(peer_send) int32_t websg_peer_send(uint32_t peer_index, uint8_t *packet, uint32_t byte_length, uint32_t binary, uint32_t reliable);
 
 import_websg_networking(network_get_host_peer_index) uint32_t websg_network_get_host_peer_index();
 import_websg_networking(network_get_local_peer_index) uint32_t websg_network_get_local_peer_index();
 import_websg_networking(network_broadcast) int32_t websg_network_broadcast(uint8_t *packet, uint32_t byte_length, uint32_t binary, uint32_t reliable);
 
+// Peer index used by NetworkOutboundMessageHeader for messages sent to every peer.
+#define NETWORK_BROADCAST_PEER_INDEX 0xFFFFFFFF
+
+// Largest payload network_send_batch can pack into a packet. Must match ScriptMessageMaxByteLength in
+// scripting.game.ts.
+#define NETWORK_MAX_MESSAGE_BYTE_LENGTH 9978
+
+typedef struct NetworkOutboundMessageHeader {
+  uint32_t peer_index;
+  uint32_t byte_offset;
+  uint32_t byte_length;
+  uint16_t binary;
+  uint16_t reliable;
+} NetworkOutboundMessageHeader;
+
+// Sends every message queued during the tick in one call. byte_offset in each header is relative to payloads.
+// The host packs messages with the same peer and reliability into as few packets as possible, in order.
+// Returns 0 if successful and -1 on error.
+import_websg_networking(network_send_batch) int32_t websg_network_send_batch(
+  NetworkOutboundMessageHeader *headers,
+  uint32_t message_count,
+  uint8_t *payloads,
+  uint32_t payloads_byte_length
+);
+
 import_websg_networking(network_listen) network_listener_id_t websg_network_listen();
 import_websg_networking(network_listener_close) int32_t websg_network_listener_close(network_listener_id_t listener_id);
 
@@ -47,6 +90,25 @@ import_websg_networking(network_listener_receive) int32_t websg_network_listener
   uint32_t max_byte_length
 );
 
+// One entry in the header table written by network_listener_receive_batch.
+// byte_offset is relative to the start of the arena.
+typedef struct NetworkMessageHeader {
+  uint32_t peer_index;
+  uint32_t byte_offset;
+  uint32_t byte_length;
+  uint32_t binary;
+} NetworkMessageHeader;
+
+// Drains as many queued messages as fit into the arena in one call. The arena starts with a NetworkMessageHeader
+// table with one entry per message, followed by the packed payloads. Messages that don't fit stay in the queue.
+// Returns the number of messages written, 0 if the queue was empty and -1 if there was an error. When the next
+// message can't fit in the arena on its own, returns the negated arena byte length it needs.
+import_websg_networking(network_listener_receive_batch) int32_t websg_network_listener_receive_batch(
+  network_listener_id_t listener_id,
+  uint8_t *arena,
+  uint32_t arena_byte_length
+);
+
 // Returns replicator ID if successful
 // Returns -1 on error
 import_websg_networking(define_replicator) replicator_id_t websg_network_define_replicator();
@@ -82,6 +144,60 @@ import_websg_networking(replicator_despawn_receive) uint32_t websg_replicator_de
   uint32_t max_byte_length
 );
 
+// One entry in the header table written by replicator_spawned_receive_batch and
+// replicator_despawned_receive_batch. byte_offset is relative to the start of the arena.
+typedef struct ReplicationHeader {
+  node_id_t node_id; // 0 for remote spawns, the script creates their nodes.
+  network_id_t network_id;
+  uint32_t peer_index;
+  uint32_t byte_offset;
+  uint32_t byte_length;
+} ReplicationHeader;
+
+// Drain as many queued replications as fit into the arena in one call. The arena starts with a ReplicationHeader
+// table with one entry per replication, followed by the packed payloads. Replications that don't fit stay queued.
+// Returns the number of replications written, 0 if the queue was empty and -1 if there was an error or the next
+// replication can't fit in the arena on its own.
+import_websg_networking(replicator_spawned_receive_batch) int32_t websg_replicator_spawned_receive_batch(
+  replicator_id_t replicator_id,
+  uint8_t *arena,
+  uint32_t arena_byte_length
+);
+import_websg_networking(replicator_despawned_receive_batch) int32_t websg_replicator_despawned_receive_batch(
+  replicator_id_t replicator_id,
+  uint8_t *arena,
+  uint32_t arena_byte_length
+);
+
+// Returns the network ID the host assigned to a networked node, 0 if it hasn't been assigned one yet.
+import_websg_networking(node_get_network_id) network_id_t websg_node_get_network_id(node_id_t node_id);
+
+// Returns the node ID of the networked node with the network ID, 0 if there is none.
+import_websg_networking(network_get_node_id) node_id_t websg_network_get_node_id(network_id_t network_id);
+
+// Sends a replicator state snapshot to a peer or to NETWORK_BROADCAST_PEER_INDEX. Snapshots are delta encoded
+// against the previous one, so they are always sent reliably and in order.
+// Returns 0 if successful and -1 on error.
+import_websg_networking(replicator_send_state) int32_t websg_replicator_send_state(
+  replicator_id_t replicator_id,
+  uint32_t peer_index,
+  uint8_t *packet,
+  uint32_t byte_length
+);
+
+// Returns the byte length of the next received state snapshot, 0 if there is none and -1 on error.
+import_websg_networking(replicator_get_state_byte_length) int32_t websg_replicator_get_state_byte_length(
+  replicator_id_t replicator_id
+);
+
+// Pops the next received state snapshot off the queue into the buffer.
+// Returns the bytes written, 0 if there was no snapshot and -1 if it was larger than max_byte_length.
+import_websg_networking(replicator_receive_state) int32_t websg_replicator_receive_state(
+  replicator_id_t replicator_id,
+  uint8_t *buffer,
+  uint32_t max_byte_length
+);
+
 typedef struct NetworkSynchronizerProps {
   Extensions extensions;
   void *extras;
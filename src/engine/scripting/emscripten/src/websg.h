@@ -84,7 +84,13 @@ typedef struct QueryList {
 
 import_websg(world_create_query) query_id_t websg_world_create_query(QueryList *query);
 import_websg(query_get_results_count) int32_t websg_query_get_results_count(query_id_t query_id);
+// Writes the query's results if they fit in max_count. Returns the total number of results either way, so the
+// caller can grow its buffer and call again, or -1 if the query doesn't exist.
 import_websg(query_get_results) int32_t websg_query_get_results(query_id_t query_id, node_id_t *results, uint32_t max_count);
+// Nodes that started / stopped matching the query since the previous call. Same contract as
+// websg_query_get_results, the changes are only consumed once they have been written.
+import_websg(query_get_entered) int32_t websg_query_get_entered(query_id_t query_id, node_id_t *results, uint32_t max_count);
+import_websg(query_get_exited) int32_t websg_query_get_exited(query_id_t query_id, node_id_t *results, uint32_t max_count);
 // Possible future API for a fast path to get component indices
 // import_websg(websg_query_get_component_indices) int32_t websg_query_get_component_indices(query_id_t query_id, uint32_t *indices, uint32_t max_count);
 
@@ -182,6 +188,19 @@ import_websg(node_get_matrix) int32_t websg_node_get_matrix(node_id_t node_id, f
 import_websg(node_set_matrix) int32_t websg_node_set_matrix(node_id_t node_id, float_t *matrix);
 import_websg(node_get_world_matrix_element) float_t websg_node_get_world_matrix_element(node_id_t node_id, uint32_t index);
 import_websg(node_get_world_matrix) int32_t websg_node_get_world_matrix(node_id_t node_id, float_t *world_matrix);
+// Bulk transform access: node_ids holds count nodes and the float array holds their values packed back to back
+// (3 floats per translation/scale, 4 per rotation, 16 per matrix). Nodes that can't be found are skipped and
+// the call returns -1 after processing the rest.
+import_websg(nodes_get_translations) int32_t websg_nodes_get_translations(node_id_t *node_ids, uint32_t count, float_t *translations);
+import_websg(nodes_set_translations) int32_t websg_nodes_set_translations(node_id_t *node_ids, uint32_t count, float_t *translations);
+import_websg(nodes_get_rotations) int32_t websg_nodes_get_rotations(node_id_t *node_ids, uint32_t count, float_t *rotations);
+import_websg(nodes_set_rotations) int32_t websg_nodes_set_rotations(node_id_t *node_ids, uint32_t count, float_t *rotations);
+import_websg(nodes_get_scales) int32_t websg_nodes_get_scales(node_id_t *node_ids, uint32_t count, float_t *scales);
+import_websg(nodes_set_scales) int32_t websg_nodes_set_scales(node_id_t *node_ids, uint32_t count, float_t *scales);
+import_websg(nodes_get_matrices) int32_t websg_nodes_get_matrices(node_id_t *node_ids, uint32_t count, float_t *matrices);
+import_websg(nodes_set_matrices) int32_t websg_nodes_set_matrices(node_id_t *node_ids, uint32_t count, float_t *matrices);
+import_websg(nodes_get_world_matrices) int32_t websg_nodes_get_world_matrices(node_id_t *node_ids, uint32_t count, float_t *world_matrices);
+import_websg(nodes_set_world_matrices) int32_t websg_nodes_set_world_matrices(node_id_t *node_ids, uint32_t count, float_t *world_matrices);
 import_websg(node_get_visible) uint32_t websg_node_get_visible(node_id_t node_id);
 import_websg(node_set_visible) int32_t websg_node_set_visible(node_id_t node_id, uint32_t visible);
 import_websg(node_get_is_static) uint32_t websg_node_get_is_static(node_id_t node_id);
@@ -556,6 +575,74 @@ import_websg(node_remove_physics_body) int32_t websg_node_remove_physics_body(no
 import_websg(node_has_physics_body) int32_t websg_node_has_physics_body(node_id_t node_id);
 import_websg(physics_body_apply_impulse) int32_t websg_physics_body_apply_impulse(node_id_t node_id, float_t *impulse);
 
+/**
+ * Bulk physics body state. Values are packed back to back, 3 floats per node for vectors and a uint32 per node for
+ * sleeping. Nodes without a physics body make the call return -1, the other nodes are still processed.
+ **/
+
+import_websg(physics_bodies_get_linear_velocities) int32_t websg_physics_bodies_get_linear_velocities(node_id_t *node_ids, uint32_t count, float_t *velocities);
+import_websg(physics_bodies_set_linear_velocities) int32_t websg_physics_bodies_set_linear_velocities(node_id_t *node_ids, uint32_t count, float_t *velocities);
+import_websg(physics_bodies_get_angular_velocities) int32_t websg_physics_bodies_get_angular_velocities(node_id_t *node_ids, uint32_t count, float_t *velocities);
+import_websg(physics_bodies_set_angular_velocities) int32_t websg_physics_bodies_set_angular_velocities(node_id_t *node_ids, uint32_t count, float_t *velocities);
+// Forces only act on the next physics step.
+import_websg(physics_bodies_apply_forces) int32_t websg_physics_bodies_apply_forces(node_id_t *node_ids, uint32_t count, float_t *forces);
+import_websg(physics_bodies_apply_impulses) int32_t websg_physics_bodies_apply_impulses(node_id_t *node_ids, uint32_t count, float_t *impulses);
+// 1 for sleeping bodies, setting 0 wakes a body up.
+import_websg(physics_bodies_get_sleeping) int32_t websg_physics_bodies_get_sleeping(node_id_t *node_ids, uint32_t count, uint32_t *sleeping);
+import_websg(physics_bodies_set_sleeping) int32_t websg_physics_bodies_set_sleeping(node_id_t *node_ids, uint32_t count, uint32_t *sleeping);
+
+/**
+ * Physics Queries
+ *
+ * Batched queries against the host's physics world. Queries with exclude_node_id set skip the colliders of that node.
+ * Hits on colliders of nodes the script doesn't own have a node_id of 0.
+ **/
+
+typedef struct PhysicsHit {
+  node_id_t node_id;
+  int32_t hit;
+  // In multiples of the direction's length.
+  float_t distance;
+  // Where the ray hit, or the shape's position when it hit.
+  float_t position[3];
+  float_t normal[3];
+} PhysicsHit;
+
+// Writes a hit for each of the count rays and returns the number of rays that hit something.
+import_websg(world_cast_rays) int32_t websg_world_cast_rays(
+  const float_t *origins,
+  const float_t *directions,
+  uint32_t count,
+  float_t max_distance,
+  node_id_t exclude_node_id,
+  PhysicsHit *hits
+);
+
+// Sweeps a box, sphere or capsule collider's shape. rotations can be NULL to cast the shapes unrotated.
+import_websg(world_cast_shapes) int32_t websg_world_cast_shapes(
+  collider_id_t collider_id,
+  const float_t *origins,
+  const float_t *rotations,
+  const float_t *directions,
+  uint32_t count,
+  float_t max_distance,
+  node_id_t exclude_node_id,
+  PhysicsHit *hits
+);
+
+// Writes the script owned nodes overlapping each of the count shapes to node_ids, and how many were written for
+// each shape to overlap_counts. Returns the total number of overlaps, overlaps past max_node_count aren't written.
+import_websg(world_overlap_shapes) int32_t websg_world_overlap_shapes(
+  collider_id_t collider_id,
+  const float_t *positions,
+  const float_t *rotations,
+  uint32_t count,
+  node_id_t exclude_node_id,
+  uint32_t *overlap_counts,
+  node_id_t *node_ids,
+  uint32_t max_node_count
+);
+
 /**
  * CollisionListener
  **/
@@ -577,6 +664,44 @@ import_websg(collisions_listener_get_collisions) int32_t websg_collisions_listen
   uint32_t max_count
 );
 
+typedef struct CollisionListenerProps {
+  // Only collisions involving at least one of these nodes are reported. All nodes when node_count is 0.
+  node_id_t *nodes;
+  uint32_t node_count;
+  // Only collisions involving a collider that is a member of one of these groups are reported. 0 for any group.
+  uint32_t collision_groups;
+  // Pending collisions are kept in a ring buffer of this size, once it's full the oldest collision is dropped.
+  uint32_t capacity;
+} CollisionListenerProps;
+
+import_websg(world_create_filtered_collision_listener) collision_listener_id_t websg_world_create_filtered_collision_listener(
+  CollisionListenerProps *props
+);
+
+// Contact data is only available for started collisions between solid colliders, it is zeroed otherwise.
+typedef struct CollisionContact {
+  node_id_t node_a;
+  node_id_t node_b;
+  int32_t started;
+  float_t position[3];
+  // Points from node_a to node_b.
+  float_t normal[3];
+  float_t impulse;
+} CollisionContact;
+
+// Moves up to max_count of the oldest pending collisions into contacts and returns how many were moved.
+// Unlike websg_collisions_listener_get_collisions, collisions that don't fit stay pending.
+import_websg(collision_listener_get_contacts) int32_t websg_collision_listener_get_contacts(
+  collision_listener_id_t listener_id,
+  CollisionContact *contacts,
+  uint32_t max_count
+);
+
+// The number of collisions dropped because the listener's ring buffer was full.
+import_websg(collision_listener_get_dropped_count) int32_t websg_collision_listener_get_dropped_count(
+  collision_listener_id_t listener_id
+);
+
 /**
  * UI Canvas
  **/
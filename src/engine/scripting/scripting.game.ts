@@ -1,14 +1,13 @@
 import { addComponent, defineQuery, exitQuery } from "bitecs";
 
 import scriptingRuntimeWASMUrl from "./emscripten/build/scripting-runtime.wasm?url";
-import { createCursorView } from "../allocator/CursorView";
 import { GameContext, RemoteResourceManager } from "../GameTypes";
 import { createMatrixWASMModule } from "../matrix/matrix.game";
 import { createWebSGNetworkModule } from "../network/scripting.game";
 import { RemoteScene } from "../resource/RemoteResources";
 import { createThirdroomModule } from "./thirdroom";
 import { createWASIModule } from "./wasi";
-import { WASMModuleContext } from "./WASMModuleContext";
+import { createWASMModuleContext, WASMModuleContext } from "./WASMModuleContext";
 import { createWebSGModule } from "./websg";
 
 export enum ScriptState {
@@ -21,6 +20,7 @@ export enum ScriptState {
 
 export interface Script {
   wasmCtx: WASMModuleContext;
+  getMemoryUsage: () => ScriptMemoryUsage | undefined;
   state: ScriptState;
   initialize: () => void;
   loaded: () => void;
@@ -31,8 +31,132 @@ export interface Script {
   peerExited: (peerIndex: number) => void;
 }
 
+export interface ScriptMemoryBudget {
+  // Maximum size of the script's WebAssembly memory in bytes, it starts at the runtime's initial memory size.
+  maxMemory: number;
+  // Maximum size of the QuickJS heap in bytes (JS_SetMemoryLimit), must leave room for the runtime's stack.
+  heapLimit: number;
+  // Bytes allocated between garbage collections (JS_SetGCThreshold)
+  gcThreshold: number;
+}
+
+export const DEFAULT_SCRIPT_MEMORY_BUDGET: ScriptMemoryBudget = {
+  maxMemory: 64 * 1024 * 1024,
+  heapLimit: 48 * 1024 * 1024,
+  gcThreshold: 256 * 1024,
+};
+
+// Must match INITIAL_MEMORY and MAXIMUM_MEMORY in emscripten/build.sh
+const WASM_PAGE_SIZE = 64 * 1024;
+const SCRIPT_INITIAL_MEMORY = 16 * 1024 * 1024;
+const SCRIPT_MAXIMUM_MEMORY = 256 * 1024 * 1024;
+
+// Subset of QuickJS's JSMemoryUsage, see websg_get_memory_usage
+export interface ScriptMemoryUsage {
+  wasmMemorySize: number;
+  mallocSize: number;
+  mallocLimit: number;
+  memoryUsedSize: number;
+  mallocCount: number;
+  memoryUsedCount: number;
+  atomCount: number;
+  atomSize: number;
+  strCount: number;
+  strSize: number;
+  objCount: number;
+  objSize: number;
+  propCount: number;
+  propSize: number;
+  shapeCount: number;
+  shapeSize: number;
+  jsFuncCount: number;
+  jsFuncSize: number;
+  jsFuncCodeSize: number;
+}
+
+// Field order of JSMemoryUsage in quickjs.h, every field is an int64_t.
+const JSMemoryUsageFields: (keyof ScriptMemoryUsage)[] = [
+  "mallocSize",
+  "mallocLimit",
+  "memoryUsedSize",
+  "mallocCount",
+  "memoryUsedCount",
+  "atomCount",
+  "atomSize",
+  "strCount",
+  "strSize",
+  "objCount",
+  "objSize",
+  "propCount",
+  "propSize",
+  "shapeCount",
+  "shapeSize",
+  "jsFuncCount",
+  "jsFuncSize",
+  "jsFuncCodeSize",
+];
+
 export const ScriptComponent = new Map<number, Script>();
 
+// QuickJS bytecode for scripts compiled by the runtime, keyed by script source. Reusing it skips parsing the
+// script the next time it is loaded. The runtime ignores bytecode written by a different QuickJS version.
+// Map iteration order is the recency order, the least recently used scripts are evicted first.
+const compiledScriptCache = new Map<string, Uint8Array>();
+let compiledScriptCacheByteLength = 0;
+const MAX_COMPILED_SCRIPT_CACHE_BYTE_LENGTH = 32 * 1024 * 1024;
+
+// Scripts are cached by their source, so the key is counted too (UTF-16).
+function getCompiledScriptByteLength(scriptSource: string, bytecode: Uint8Array) {
+  return scriptSource.length * 2 + bytecode.byteLength;
+}
+
+function getCompiledScript(scriptSource: string): Uint8Array | undefined {
+  const bytecode = compiledScriptCache.get(scriptSource);
+
+  if (bytecode) {
+    compiledScriptCache.delete(scriptSource);
+    compiledScriptCache.set(scriptSource, bytecode);
+  }
+
+  return bytecode;
+}
+
+function setCompiledScript(scriptSource: string, bytecode: Uint8Array) {
+  const byteLength = getCompiledScriptByteLength(scriptSource, bytecode);
+
+  if (byteLength > MAX_COMPILED_SCRIPT_CACHE_BYTE_LENGTH) {
+    return;
+  }
+
+  const existing = compiledScriptCache.get(scriptSource);
+
+  if (existing) {
+    compiledScriptCacheByteLength -= getCompiledScriptByteLength(scriptSource, existing);
+    compiledScriptCache.delete(scriptSource);
+  }
+
+  for (const [oldestSource, oldestBytecode] of compiledScriptCache) {
+    if (compiledScriptCacheByteLength + byteLength <= MAX_COMPILED_SCRIPT_CACHE_BYTE_LENGTH) {
+      break;
+    }
+
+    compiledScriptCacheByteLength -= getCompiledScriptByteLength(oldestSource, oldestBytecode);
+    compiledScriptCache.delete(oldestSource);
+  }
+
+  compiledScriptCache.set(scriptSource, bytecode);
+  compiledScriptCacheByteLength += byteLength;
+}
+
+// Content type for scripts precompiled with native/compile (scripting-compile).
+const QUICKJS_BYTECODE_CONTENT_TYPE = "application/x-quickjs-bytecode";
+
+// QuickJS doesn't validate bytecode, malformed bytecode can read and write outside of the runtime's objects. Only
+// bytecode deployed with the client is trusted, scripts from anywhere else have to be served as source.
+function isTrustedBytecodeUrl(url: string) {
+  return new URL(url, self.location.href).origin === self.location.origin;
+}
+
 export const scriptQuery = defineQuery([ScriptComponent]);
 const scriptExitQuery = exitQuery(scriptQuery);
 
@@ -70,21 +194,19 @@ export async function loadScript(
   ctx: GameContext,
   resourceManager: RemoteResourceManager,
   scriptUrl: string,
-  signal?: AbortSignal
+  signal?: AbortSignal,
+  memoryBudget: ScriptMemoryBudget = DEFAULT_SCRIPT_MEMORY_BUDGET
 ): Promise<Script> {
-  const memory = new WebAssembly.Memory({ initial: 1024, maximum: 1024 });
-
-  const wasmCtx: WASMModuleContext = {
-    resourceManager,
-    memory,
-    U8Heap: new Uint8Array(memory.buffer),
-    I32Heap: new Int32Array(memory.buffer),
-    U32Heap: new Uint32Array(memory.buffer),
-    F32Heap: new Float32Array(memory.buffer),
-    cursorView: createCursorView(memory.buffer, true),
-    textDecoder: new TextDecoder(),
-    textEncoder: new TextEncoder(),
-  };
+  const maxMemory = Math.min(Math.max(memoryBudget.maxMemory, SCRIPT_INITIAL_MEMORY), SCRIPT_MAXIMUM_MEMORY);
+
+  const memory = new WebAssembly.Memory({
+    initial: SCRIPT_INITIAL_MEMORY / WASM_PAGE_SIZE,
+    maximum: Math.floor(maxMemory / WASM_PAGE_SIZE),
+  });
+
+  const wasmCtx = createWASMModuleContext(resourceManager, memory);
+  wasmCtx.heapLimit = Math.min(memoryBudget.heapLimit, maxMemory);
+  wasmCtx.gcThreshold = memoryBudget.gcThreshold;
 
   let wasmBuffer: ArrayBuffer | undefined;
 
@@ -102,6 +224,17 @@ export async function loadScript(
       const jsWASMResponse = await fetch(scriptingRuntimeWASMUrl, { signal });
       wasmBuffer = await jsWASMResponse.arrayBuffer();
       wasmCtx.encodedJSSource = wasmCtx.textEncoder.encode(scriptSource);
+      wasmCtx.jsBytecode = getCompiledScript(scriptSource);
+      wasmCtx.onCompileJSSource = (bytecode) => setCompiledScript(scriptSource, bytecode);
+    } else if (contentType === QUICKJS_BYTECODE_CONTENT_TYPE) {
+      // Check where the response came from after redirects
+      if (!isTrustedBytecodeUrl(response.url || scriptUrl)) {
+        throw new Error(`Precompiled script "${scriptUrl}" must be served from ${self.location.origin}`);
+      }
+
+      wasmCtx.jsBytecode = new Uint8Array(await response.arrayBuffer());
+      const jsWASMResponse = await fetch(scriptingRuntimeWASMUrl, { signal });
+      wasmBuffer = await jsWASMResponse.arrayBuffer();
     } else if (contentType === "application/wasm") {
       wasmBuffer = await response.arrayBuffer();
     } else {
@@ -149,6 +282,11 @@ export async function loadScript(
       ? exports.websg_peer_entered
       : undefined;
 
+  const websgGetMemoryUsage =
+    exports.websg_get_memory_usage && typeof exports.websg_get_memory_usage === "function"
+      ? exports.websg_get_memory_usage
+      : undefined;
+
   const websgPeerExited =
     exports.websg_peer_exited && typeof exports.websg_peer_exited === "function"
       ? exports.websg_peer_exited
@@ -157,6 +295,21 @@ export async function loadScript(
   const script: Script = {
     state: ScriptState.Uninitialized,
     wasmCtx,
+    getMemoryUsage() {
+      if (!websgGetMemoryUsage || this.state === ScriptState.Uninitialized || this.state === ScriptState.Error) {
+        return undefined;
+      }
+
+      const usagePtr = websgGetMemoryUsage();
+      const view = new DataView(memory.buffer, usagePtr);
+      const usage = { wasmMemorySize: memory.buffer.byteLength } as ScriptMemoryUsage;
+
+      for (let i = 0; i < JSMemoryUsageFields.length; i++) {
+        usage[JSMemoryUsageFields[i]] = Number(view.getBigInt64(i * 8, true));
+      }
+
+      return usage;
+    },
     initialize() {
       if (this.state === ScriptState.Error) {
         return;
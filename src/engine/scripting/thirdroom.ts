@@ -40,6 +40,33 @@ export function createThirdroomModule(ctx: GameContext, wasmCtx: WASMModuleConte
         return -1;
       }
     },
+    get_js_bytecode_size() {
+      return wasmCtx.jsBytecode ? wasmCtx.jsBytecode.byteLength : 0;
+    },
+    get_js_bytecode(destPtr: number) {
+      if (!wasmCtx.jsBytecode) {
+        console.error("Thirdroom: No JS bytecode set.");
+        return -1;
+      }
+
+      return writeUint8Array(wasmCtx, destPtr, wasmCtx.jsBytecode);
+    },
+    set_js_bytecode(bytecodePtr: number, byteLength: number) {
+      // Copy out of the heap so the bytecode outlives this script instance
+      const bytecode = wasmCtx.U8Heap.slice(bytecodePtr, bytecodePtr + byteLength);
+
+      if (wasmCtx.onCompileJSSource) {
+        wasmCtx.onCompileJSSource(bytecode);
+      }
+
+      return 0;
+    },
+    get_memory_limit() {
+      return wasmCtx.heapLimit || 0;
+    },
+    get_gc_threshold() {
+      return wasmCtx.gcThreshold || 0;
+    },
     enable_matrix_material(enabled: number) {
       ctx.sendMessage<EnableMatrixMaterialMessage>(Thread.Render, {
         type: RendererMessageType.EnableMatrixMaterial,
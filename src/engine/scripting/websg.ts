@@ -1,5 +1,7 @@
 import {
   defineQuery,
+  enterQuery,
+  exitQuery,
   hasComponent,
   IComponent,
   QueryModifier as IQueryModifier,
@@ -11,7 +13,7 @@ import { BoxGeometry } from "three";
 import { mat4, vec2, vec3, vec4, quat } from "gl-matrix";
 import RAPIER from "@dimforge/rapier3d-compat";
 
-import { Collision, GameContext } from "../GameTypes";
+import { Collision, CollisionContact, CollisionListener, GameContext, ScriptQuery } from "../GameTypes";
 import {
   getScriptResource,
   getScriptResourceByNamePtr,
@@ -56,7 +58,7 @@ import {
   removeObjectFromWorld,
   RemotePhysicsBody,
 } from "../resource/RemoteResources";
-import { addChild, removeChild, traverse } from "../component/transform";
+import { addChild, removeChild, setFromLocalMatrix, traverse } from "../component/transform";
 import {
   AccessorComponentType,
   AccessorType,
@@ -89,7 +91,13 @@ import {
   writeUint32,
 } from "../allocator/CursorView";
 import { AccessorComponentTypeToTypedArray, AccessorTypeToElementSize } from "../common/accessor";
-import { addPhysicsBody, PhysicsModule, registerCollisionHandler, removePhysicsBody } from "../physics/physics.game";
+import {
+  addPhysicsBody,
+  PhysicsModule,
+  PhysicsModuleState,
+  registerCollisionHandler,
+  removePhysicsBody,
+} from "../physics/physics.game";
 import { getModule } from "../module/module.common";
 import { createMesh } from "../mesh/mesh.game";
 import { addInteractableComponent } from "../../plugins/interaction/interaction.game";
@@ -143,6 +151,170 @@ function getScriptChildren(
   return i;
 }
 
+type NodeTransformKey = "position" | "quaternion" | "scale" | "localMatrix" | "worldMatrix";
+
+// Bulk transform access used by the websg_nodes_* imports. Values are packed back to back, `length` floats per node.
+function getScriptNodeTransforms(
+  wasmCtx: WASMModuleContext,
+  nodeIdsPtr: number,
+  count: number,
+  valuesPtr: number,
+  key: NodeTransformKey,
+  length: number
+): number {
+  const U32Heap = wasmCtx.U32Heap;
+  const F32Heap = wasmCtx.F32Heap;
+  let result = 0;
+
+  for (let i = 0; i < count; i++) {
+    const node = getScriptResource(wasmCtx, RemoteNode, U32Heap[nodeIdsPtr / 4 + i]);
+
+    if (!node) {
+      result = -1;
+      continue;
+    }
+
+    F32Heap.set(node[key], valuesPtr / 4 + i * length);
+  }
+
+  return result;
+}
+
+function setScriptNodeTransforms(
+  wasmCtx: WASMModuleContext,
+  nodeIdsPtr: number,
+  count: number,
+  valuesPtr: number,
+  key: NodeTransformKey,
+  length: number
+): number {
+  const U32Heap = wasmCtx.U32Heap;
+  const F32Heap = wasmCtx.F32Heap;
+  let result = 0;
+
+  for (let i = 0; i < count; i++) {
+    const node = getScriptResource(wasmCtx, RemoteNode, U32Heap[nodeIdsPtr / 4 + i]);
+
+    if (!node) {
+      result = -1;
+      continue;
+    }
+
+    const offset = valuesPtr / 4 + i * length;
+    node[key].set(F32Heap.subarray(offset, offset + length));
+  }
+
+  return result;
+}
+
+function matchesScriptQueryItems(world: IWorld, scriptQuery: ScriptQuery, eid: number): boolean {
+  for (let i = 0; i < scriptQuery.anyComponents.length; i++) {
+    const group = scriptQuery.anyComponents[i];
+    let matched = false;
+
+    for (let j = 0; j < group.length; j++) {
+      if (hasComponent(world, group[j], eid)) {
+        matched = true;
+        break;
+      }
+    }
+
+    if (!matched) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+function getScriptQueryResults(world: IWorld, scriptQuery: ScriptQuery): ArrayLike<number> {
+  if (scriptQuery.anyComponents.length === 0) {
+    return scriptQuery.query(world);
+  }
+
+  const results = scriptQuery.results;
+  results.length = 0;
+
+  if (scriptQuery.anyQueries.length === 0) {
+    const queryResults = scriptQuery.query(world);
+
+    for (let i = 0; i < queryResults.length; i++) {
+      const eid = queryResults[i];
+
+      if (matchesScriptQueryItems(world, scriptQuery, eid)) {
+        results.push(eid);
+      }
+    }
+
+    return results;
+  }
+
+  // Any-only queries take the union of the first Any group's queries, an entity with several of the group's
+  // components is only added by the first query it is found in.
+  const anyQueries = scriptQuery.anyQueries;
+  const firstGroup = scriptQuery.anyComponents[0];
+
+  for (let i = 0; i < anyQueries.length; i++) {
+    const queryResults = anyQueries[i](world);
+
+    for (let j = 0; j < queryResults.length; j++) {
+      const eid = queryResults[j];
+      let seen = false;
+
+      for (let k = 0; k < i; k++) {
+        if (hasComponent(world, firstGroup[k], eid)) {
+          seen = true;
+          break;
+        }
+      }
+
+      if (
+        !seen &&
+        matchesScriptQueryItems(world, scriptQuery, eid) &&
+        !scriptQuery.noneComponents.some((component) => hasComponent(world, component, eid))
+      ) {
+        results.push(eid);
+      }
+    }
+  }
+
+  return results;
+}
+
+// bitECS tracks entered / exited entities for the query, but that doesn't account for Any items so those queries
+// diff the filtered results against the results at the time of the last call instead.
+function getScriptQueryChanges(world: IWorld, scriptQuery: ScriptQuery, entered: boolean): number[] {
+  if (scriptQuery.anyComponents.length === 0) {
+    return entered ? scriptQuery.enter(world) : scriptQuery.exit(world);
+  }
+
+  const snapshot = entered ? scriptQuery.enteredSnapshot : scriptQuery.exitedSnapshot;
+  const results = new Set(getScriptQueryResults(world, scriptQuery) as number[]);
+  const changes: number[] = [];
+
+  if (entered) {
+    for (const eid of results) {
+      if (!snapshot.has(eid)) {
+        changes.push(eid);
+      }
+    }
+  } else {
+    for (const eid of snapshot) {
+      if (!results.has(eid)) {
+        changes.push(eid);
+      }
+    }
+  }
+
+  snapshot.clear();
+
+  for (const eid of results) {
+    snapshot.add(eid);
+  }
+
+  return changes;
+}
+
 function scriptGetChildAt(wasmCtx: WASMModuleContext, parent: RemoteNode | RemoteScene, index: number): number {
   const resourceIds = wasmCtx.resourceManager.resourceIds;
 
@@ -368,10 +540,233 @@ interface MeshPrimitiveProps {
 }
 
 const tempRapierVec3 = new RAPIER.Vector3(0, 0, 0);
+const tempRapierQuat = new RAPIER.Quaternion(0, 0, 0, 1);
+// The nodes overlapping the current shape in world_overlap_shapes.
+const overlapShapeNodeIds = new Set<number>();
+const tempRapierRay = new RAPIER.Ray(new RAPIER.Vector3(0, 0, 0), new RAPIER.Vector3(0, 0, 1));
 
 const tempVec3 = vec3.create();
 const tempDirection = vec3.create();
 const tempQuat = quat.create();
+const tempMat4 = mat4.create();
+
+// The shapes that scripts can cast and test for overlaps, in the same units as createNodeColliderDescriptions.
+function createColliderQueryShape(collider: RemoteCollider): RAPIER.Shape | undefined {
+  if (collider.type === ColliderType.Box) {
+    return new RAPIER.Cuboid(collider.size[0] / 2, collider.size[1] / 2, collider.size[2] / 2);
+  } else if (collider.type === ColliderType.Sphere) {
+    return new RAPIER.Ball(collider.radius);
+  } else if (collider.type === ColliderType.Capsule) {
+    return new RAPIER.Capsule(collider.height / 2, collider.radius);
+  }
+
+  return undefined;
+}
+
+// Only nodes owned by the script are reported, hits on anything else have a node id of 0.
+function getScriptColliderNodeId(wasmCtx: WASMModuleContext, physics: PhysicsModuleState, collider: RAPIER.Collider) {
+  const eid = physics.handleToEid.get(collider.handle);
+  return eid !== undefined && wasmCtx.resourceManager.resourceIds.has(eid) ? eid : 0;
+}
+
+function createPhysicsQueryFilter(physics: PhysicsModuleState, excludeNodeId: number) {
+  if (excludeNodeId === 0) {
+    return undefined;
+  }
+
+  return (collider: RAPIER.Collider) => physics.handleToEid.get(collider.handle) !== excludeNodeId;
+}
+
+// See PhysicsHit in websg.h, hits are 9 words long.
+function writePhysicsHit(
+  wasmCtx: WASMModuleContext,
+  hitsPtr: number,
+  index: number,
+  nodeId: number,
+  distance: number,
+  position: RAPIER.Vector,
+  normal: RAPIER.Vector
+) {
+  const offset = (hitsPtr >> 2) + index * 9;
+  const F32Heap = wasmCtx.F32Heap;
+  wasmCtx.U32Heap[offset] = nodeId;
+  wasmCtx.I32Heap[offset + 1] = 1;
+  F32Heap[offset + 2] = distance;
+  F32Heap[offset + 3] = position.x;
+  F32Heap[offset + 4] = position.y;
+  F32Heap[offset + 5] = position.z;
+  F32Heap[offset + 6] = normal.x;
+  F32Heap[offset + 7] = normal.y;
+  F32Heap[offset + 8] = normal.z;
+}
+
+// Bulk physics body access used by the websg_physics_bodies_* imports. Calls fn with each node's body and index,
+// returns -1 if any of the nodes has no physics body.
+function forEachScriptPhysicsBody(
+  wasmCtx: WASMModuleContext,
+  nodeIdsPtr: number,
+  count: number,
+  fn: (body: RAPIER.RigidBody, index: number) => void
+): number {
+  const U32Heap = wasmCtx.U32Heap;
+  let result = 0;
+
+  for (let i = 0; i < count; i++) {
+    const node = getScriptResource(wasmCtx, RemoteNode, U32Heap[(nodeIdsPtr >> 2) + i]);
+    const body = node?.physicsBody?.body;
+
+    if (!body) {
+      result = -1;
+      continue;
+    }
+
+    fn(body, i);
+  }
+
+  return result;
+}
+
+function readRapierVector(F32Heap: Float32Array, valuesPtr: number, index: number) {
+  const offset = (valuesPtr >> 2) + index * 3;
+  tempRapierVec3.x = F32Heap[offset];
+  tempRapierVec3.y = F32Heap[offset + 1];
+  tempRapierVec3.z = F32Heap[offset + 2];
+  return tempRapierVec3;
+}
+
+function writeRapierVector(F32Heap: Float32Array, valuesPtr: number, index: number, vector: RAPIER.Vector) {
+  const offset = (valuesPtr >> 2) + index * 3;
+  F32Heap[offset] = vector.x;
+  F32Heap[offset + 1] = vector.y;
+  F32Heap[offset + 2] = vector.z;
+}
+
+const emptyCollisionContact: CollisionContact = {
+  position: [0, 0, 0],
+  normal: [0, 0, 0],
+  impulse: 0,
+};
+
+function getCollisionContact(physics: PhysicsModuleState, handleA: number, handleB: number, started: boolean) {
+  if (!started) {
+    return emptyCollisionContact;
+  }
+
+  const { physicsWorld } = physics;
+  const colliderA = physicsWorld.getCollider(handleA);
+  const colliderB = physicsWorld.getCollider(handleB);
+
+  if (!colliderA || !colliderB) {
+    return emptyCollisionContact;
+  }
+
+  let contact = emptyCollisionContact;
+
+  physicsWorld.contactPair(colliderA, colliderB, (manifold, flipped) => {
+    if (contact !== emptyCollisionContact || manifold.numSolverContacts() === 0) {
+      return;
+    }
+
+    const point = manifold.solverContactPoint(0);
+    const normal = manifold.normal();
+    const sign = flipped ? -1 : 1;
+
+    let impulse = 0;
+
+    for (let i = 0; i < manifold.numContacts(); i++) {
+      impulse += manifold.contactImpulse(i);
+    }
+
+    contact = {
+      position: [point.x, point.y, point.z],
+      normal: [normal.x * sign, normal.y * sign, normal.z * sign],
+      impulse,
+    };
+  });
+
+  return contact;
+}
+
+function isCollisionListenerInterested(
+  physics: PhysicsModuleState,
+  listener: CollisionListener,
+  collision: Collision,
+  handleA: number,
+  handleB: number
+) {
+  if (listener.nodes && !listener.nodes.has(collision.nodeA) && !listener.nodes.has(collision.nodeB)) {
+    return false;
+  }
+
+  if (listener.collisionGroups !== 0) {
+    const colliderA = physics.physicsWorld.getCollider(handleA);
+    const colliderB = physics.physicsWorld.getCollider(handleB);
+    // Collision group memberships are the upper 16 bits.
+    const memberships = ((colliderA?.collisionGroups() ?? 0) | (colliderB?.collisionGroups() ?? 0)) >>> 16;
+
+    if ((memberships & listener.collisionGroups) === 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Once a filtered listener is full, the oldest collision is overwritten.
+function pushCollision(listener: CollisionListener, collision: Collision) {
+  const { collisions, capacity } = listener;
+
+  if (capacity === undefined || collisions.length < capacity) {
+    collisions.push(collision);
+    return;
+  }
+
+  collisions[listener.head] = collision;
+  listener.head = (listener.head + 1) % capacity;
+  listener.droppedCount++;
+}
+
+// Removes and returns up to maxCount of the oldest collisions.
+function shiftCollisions(listener: CollisionListener, maxCount: number) {
+  const { collisions, head } = listener;
+  const count = Math.min(collisions.length, maxCount);
+  const shifted: Collision[] = [];
+
+  for (let i = 0; i < count; i++) {
+    shifted.push(collisions[(head + i) % collisions.length]);
+  }
+
+  if (count === collisions.length) {
+    collisions.length = 0;
+  } else {
+    const remaining: Collision[] = [];
+
+    for (let i = count; i < collisions.length; i++) {
+      remaining.push(collisions[(head + i) % collisions.length]);
+    }
+
+    listener.collisions = remaining;
+  }
+
+  listener.head = 0;
+
+  return shifted;
+}
+
+function getCollisionListener(wasmCtx: WASMModuleContext, listenerId: number) {
+  const listener = wasmCtx.resourceManager.collisionListeners.find((l) => l.id === listenerId);
+
+  if (!listener) {
+    console.error(`WebSG: collision listener ${listenerId} not found.`);
+  }
+
+  return listener;
+}
+
+function writePhysicsMiss(wasmCtx: WASMModuleContext, hitsPtr: number, index: number) {
+  const offset = (hitsPtr >> 2) + index * 9;
+  wasmCtx.U32Heap.fill(0, offset, offset + 9);
+}
 
 // TODO: ResourceManager should have a resourceMap that corresponds to just its owned resources
 // TODO: ResourceManager should have a resourceByType that corresponds to just its owned resources
@@ -384,7 +779,7 @@ export function createWebSGModule(ctx: GameContext, wasmCtx: WASMModuleContext)
 
   const disposeCollisionHandler = registerCollisionHandler(
     ctx,
-    (nodeA: number, nodeB: number, _handleA: number, _handleB: number, started: boolean) => {
+    (nodeA: number, nodeB: number, handleA: number, handleB: number, started: boolean) => {
       const resourceManager = wasmCtx.resourceManager;
       const resourceIds = resourceManager.resourceIds;
       const collisionListeners = resourceManager.collisionListeners;
@@ -396,9 +791,29 @@ export function createWebSGModule(ctx: GameContext, wasmCtx: WASMModuleContext)
           started,
         };
 
+        // Shared by all filtered listeners, only looked up when one of them wants the collision.
+        let contactCollision: Collision | undefined;
+
         for (let i = 0; i < collisionListeners.length; i++) {
           const listener = collisionListeners[i];
-          listener.collisions.push(collision);
+
+          if (listener.capacity === undefined) {
+            listener.collisions.push(collision);
+            continue;
+          }
+
+          if (!isCollisionListenerInterested(physics, listener, collision, handleA, handleB)) {
+            continue;
+          }
+
+          if (!contactCollision) {
+            contactCollision = {
+              ...collision,
+              contact: getCollisionContact(physics, handleA, handleB, started),
+            };
+          }
+
+          pushCollision(listener, contactCollision);
         }
       }
     }
@@ -427,10 +842,14 @@ export function createWebSGModule(ctx: GameContext, wasmCtx: WASMModuleContext)
       try {
         const resourceManager = wasmCtx.resourceManager;
         const components: (IComponent | IQueryModifier<IWorld>)[] = [];
+        const noneComponents: IComponent[] = [];
+        const anyComponents: IComponent[][] = [];
+        let hasAllComponents = false;
         moveCursorView(wasmCtx.cursorView, queryPtr);
         readList(wasmCtx, () => {
           const componentIds = readUint32List(wasmCtx.cursorView);
           const modifier = readEnum(wasmCtx, QueryModifier, "QueryModifier");
+          const anyGroup: IComponent[] = [];
 
           for (let i = 0; i < componentIds.length; i++) {
             const componentId = componentIds[i];
@@ -438,19 +857,39 @@ export function createWebSGModule(ctx: GameContext, wasmCtx: WASMModuleContext)
             if (component) {
               if (modifier == QueryModifier.All) {
                 components.push(component);
+                hasAllComponents = true;
               } else if (modifier == QueryModifier.None) {
                 components.push(Not(component));
+                noneComponents.push(component);
               } else if (modifier == QueryModifier.Any) {
-                throw new Error(`WebSG: QueryModifier.Any not supported`);
+                anyGroup.push(component);
               }
             } else {
               console.error(`WebSG: component not registered`);
             }
           }
+
+          if (anyGroup.length > 0) {
+            anyComponents.push(anyGroup);
+          }
         });
         const query = defineQuery(components);
+        const anyQueries =
+          !hasAllComponents && anyComponents.length > 0
+            ? anyComponents[0].map((component) => defineQuery([component]))
+            : [];
         const queryId = resourceManager.nextQueryId++;
-        resourceManager.registeredQueries.set(queryId, query);
+        resourceManager.registeredQueries.set(queryId, {
+          query,
+          anyComponents,
+          noneComponents,
+          anyQueries,
+          results: [],
+          enter: enterQuery(query),
+          exit: exitQuery(query),
+          enteredSnapshot: new Set(),
+          exitedSnapshot: new Set(),
+        });
         return queryId;
       } catch (e) {
         console.error(e);
@@ -458,34 +897,74 @@ export function createWebSGModule(ctx: GameContext, wasmCtx: WASMModuleContext)
       }
     },
     query_get_results_count(queryId: number) {
-      const query = wasmCtx.resourceManager.registeredQueries.get(queryId);
+      const scriptQuery = wasmCtx.resourceManager.registeredQueries.get(queryId);
 
-      if (query) {
-        return query(ctx.world).length;
+      if (scriptQuery) {
+        return getScriptQueryResults(ctx.world, scriptQuery).length;
       } else {
         console.error(`WebSG: query not registered`);
         return -1;
       }
     },
     query_get_results(queryId: number, resultsPtr: number, maxCount: number) {
-      const query = wasmCtx.resourceManager.registeredQueries.get(queryId);
+      const scriptQuery = wasmCtx.resourceManager.registeredQueries.get(queryId);
 
-      if (query) {
-        const results = query(ctx.world);
+      if (scriptQuery) {
+        const results = getScriptQueryResults(ctx.world, scriptQuery);
 
-        if (results.length > maxCount) {
-          console.error(`WebSG: query results array larger than maxCount`);
-          return -1;
+        // The script grows its buffer and calls again when the results don't fit
+        if (results.length <= maxCount) {
+          writeNumberArray(wasmCtx, resultsPtr, results);
         }
 
-        writeNumberArray(wasmCtx, resultsPtr, results);
-
         return results.length;
       } else {
         console.error(`WebSG: query not registered`);
         return -1;
       }
     },
+    query_get_entered(queryId: number, resultsPtr: number, maxCount: number) {
+      const scriptQuery = wasmCtx.resourceManager.registeredQueries.get(queryId);
+
+      if (scriptQuery) {
+        if (!scriptQuery.pendingEntered) {
+          scriptQuery.pendingEntered = getScriptQueryChanges(ctx.world, scriptQuery, true);
+        }
+
+        const entered = scriptQuery.pendingEntered;
+
+        if (entered.length <= maxCount) {
+          writeNumberArray(wasmCtx, resultsPtr, entered);
+          scriptQuery.pendingEntered = undefined;
+        }
+
+        return entered.length;
+      } else {
+        console.error(`WebSG: query not registered`);
+        return -1;
+      }
+    },
+    query_get_exited(queryId: number, resultsPtr: number, maxCount: number) {
+      const scriptQuery = wasmCtx.resourceManager.registeredQueries.get(queryId);
+
+      if (scriptQuery) {
+        if (!scriptQuery.pendingExited) {
+          scriptQuery.pendingExited = getScriptQueryChanges(ctx.world, scriptQuery, false);
+        }
+
+        const exited = scriptQuery.pendingExited;
+
+        if (exited.length <= maxCount) {
+          writeNumberArray(wasmCtx, resultsPtr, exited);
+          scriptQuery.pendingExited = undefined;
+        }
+
+        return exited.length;
+      } else {
+        console.error(`WebSG: query not registered`);
+        return -1;
+      }
+    },
     world_find_component_definition_by_name(namePtr: number, byteLength: number) {
       const name = readString(wasmCtx, namePtr, byteLength);
       const componentId = wasmCtx.resourceManager.componentIdsByName.get(name);
@@ -699,7 +1178,7 @@ export function createWebSGModule(ctx: GameContext, wasmCtx: WASMModuleContext)
     },
     world_set_component_store(componentId: number, storePtr: number) {
       try {
-        setComponentStore(wasmCtx.resourceManager, componentId, wasmCtx.memory.buffer, storePtr);
+        setComponentStore(wasmCtx.resourceManager, componentId, wasmCtx.memory, storePtr);
       } catch (error) {
         console.error(error);
         return -1;
@@ -1214,6 +1693,64 @@ export function createWebSGModule(ctx: GameContext, wasmCtx: WASMModuleContext)
 
       return 0;
     },
+    nodes_get_translations(nodeIdsPtr: number, count: number, translationsPtr: number) {
+      return getScriptNodeTransforms(wasmCtx, nodeIdsPtr, count, translationsPtr, "position", 3);
+    },
+    nodes_set_translations(nodeIdsPtr: number, count: number, translationsPtr: number) {
+      return setScriptNodeTransforms(wasmCtx, nodeIdsPtr, count, translationsPtr, "position", 3);
+    },
+    nodes_get_rotations(nodeIdsPtr: number, count: number, rotationsPtr: number) {
+      return getScriptNodeTransforms(wasmCtx, nodeIdsPtr, count, rotationsPtr, "quaternion", 4);
+    },
+    nodes_set_rotations(nodeIdsPtr: number, count: number, rotationsPtr: number) {
+      return setScriptNodeTransforms(wasmCtx, nodeIdsPtr, count, rotationsPtr, "quaternion", 4);
+    },
+    nodes_get_scales(nodeIdsPtr: number, count: number, scalesPtr: number) {
+      return getScriptNodeTransforms(wasmCtx, nodeIdsPtr, count, scalesPtr, "scale", 3);
+    },
+    nodes_set_scales(nodeIdsPtr: number, count: number, scalesPtr: number) {
+      return setScriptNodeTransforms(wasmCtx, nodeIdsPtr, count, scalesPtr, "scale", 3);
+    },
+    nodes_get_matrices(nodeIdsPtr: number, count: number, matricesPtr: number) {
+      return getScriptNodeTransforms(wasmCtx, nodeIdsPtr, count, matricesPtr, "localMatrix", 16);
+    },
+    nodes_set_matrices(nodeIdsPtr: number, count: number, matricesPtr: number) {
+      return setScriptNodeTransforms(wasmCtx, nodeIdsPtr, count, matricesPtr, "localMatrix", 16);
+    },
+    nodes_get_world_matrices(nodeIdsPtr: number, count: number, worldMatricesPtr: number) {
+      return getScriptNodeTransforms(wasmCtx, nodeIdsPtr, count, worldMatricesPtr, "worldMatrix", 16);
+    },
+    nodes_set_world_matrices(nodeIdsPtr: number, count: number, worldMatricesPtr: number) {
+      const U32Heap = wasmCtx.U32Heap;
+      const F32Heap = wasmCtx.F32Heap;
+      let result = 0;
+
+      for (let i = 0; i < count; i++) {
+        const node = getScriptResource(wasmCtx, RemoteNode, U32Heap[nodeIdsPtr / 4 + i]);
+
+        if (!node) {
+          result = -1;
+          continue;
+        }
+
+        const offset = worldMatricesPtr / 4 + i * 16;
+        const worldMatrix = F32Heap.subarray(offset, offset + 16);
+        const parent = node.parent;
+
+        // Convert to a local matrix and decompose it so that the next transform update doesn't overwrite it.
+        if (parent) {
+          mat4.invert(tempMat4, parent.worldMatrix);
+          mat4.multiply(tempMat4, tempMat4, worldMatrix);
+        } else {
+          tempMat4.set(worldMatrix);
+        }
+
+        setFromLocalMatrix(node, tempMat4);
+        node.worldMatrix.set(worldMatrix);
+      }
+
+      return result;
+    },
     node_get_visible(nodeId: number) {
       const node = getScriptResource(wasmCtx, RemoteNode, nodeId);
       return node && node.visible ? 1 : 0;
@@ -2136,12 +2673,317 @@ export function createWebSGModule(ctx: GameContext, wasmCtx: WASMModuleContext)
 
       return 0;
     },
+    physics_bodies_get_linear_velocities(nodeIdsPtr: number, count: number, velocitiesPtr: number) {
+      const F32Heap = wasmCtx.F32Heap;
+      return forEachScriptPhysicsBody(wasmCtx, nodeIdsPtr, count, (body, i) =>
+        writeRapierVector(F32Heap, velocitiesPtr, i, body.linvel())
+      );
+    },
+    physics_bodies_set_linear_velocities(nodeIdsPtr: number, count: number, velocitiesPtr: number) {
+      const F32Heap = wasmCtx.F32Heap;
+      return forEachScriptPhysicsBody(wasmCtx, nodeIdsPtr, count, (body, i) =>
+        body.setLinvel(readRapierVector(F32Heap, velocitiesPtr, i), true)
+      );
+    },
+    physics_bodies_get_angular_velocities(nodeIdsPtr: number, count: number, velocitiesPtr: number) {
+      const F32Heap = wasmCtx.F32Heap;
+      return forEachScriptPhysicsBody(wasmCtx, nodeIdsPtr, count, (body, i) =>
+        writeRapierVector(F32Heap, velocitiesPtr, i, body.angvel())
+      );
+    },
+    physics_bodies_set_angular_velocities(nodeIdsPtr: number, count: number, velocitiesPtr: number) {
+      const F32Heap = wasmCtx.F32Heap;
+      return forEachScriptPhysicsBody(wasmCtx, nodeIdsPtr, count, (body, i) =>
+        body.setAngvel(readRapierVector(F32Heap, velocitiesPtr, i), true)
+      );
+    },
+    physics_bodies_apply_forces(nodeIdsPtr: number, count: number, forcesPtr: number) {
+      // Rapier forces persist until they are reset, applying force * dt as an impulse has the same effect on the
+      // next step without having to clear the forces afterwards.
+      const F32Heap = wasmCtx.F32Heap;
+      const dt = ctx.dt;
+      return forEachScriptPhysicsBody(wasmCtx, nodeIdsPtr, count, (body, i) => {
+        const force = readRapierVector(F32Heap, forcesPtr, i);
+        force.x *= dt;
+        force.y *= dt;
+        force.z *= dt;
+        body.applyImpulse(force, true);
+      });
+    },
+    physics_bodies_apply_impulses(nodeIdsPtr: number, count: number, impulsesPtr: number) {
+      const F32Heap = wasmCtx.F32Heap;
+      return forEachScriptPhysicsBody(wasmCtx, nodeIdsPtr, count, (body, i) =>
+        body.applyImpulse(readRapierVector(F32Heap, impulsesPtr, i), true)
+      );
+    },
+    physics_bodies_get_sleeping(nodeIdsPtr: number, count: number, sleepingPtr: number) {
+      const U32Heap = wasmCtx.U32Heap;
+      return forEachScriptPhysicsBody(wasmCtx, nodeIdsPtr, count, (body, i) => {
+        U32Heap[(sleepingPtr >> 2) + i] = body.isSleeping() ? 1 : 0;
+      });
+    },
+    physics_bodies_set_sleeping(nodeIdsPtr: number, count: number, sleepingPtr: number) {
+      const U32Heap = wasmCtx.U32Heap;
+      return forEachScriptPhysicsBody(wasmCtx, nodeIdsPtr, count, (body, i) => {
+        if (U32Heap[(sleepingPtr >> 2) + i]) {
+          body.sleep();
+        } else {
+          body.wakeUp();
+        }
+      });
+    },
+    world_cast_rays(
+      originsPtr: number,
+      directionsPtr: number,
+      count: number,
+      maxDistance: number,
+      excludeNodeId: number,
+      hitsPtr: number
+    ) {
+      const F32Heap = wasmCtx.F32Heap;
+      const filter = createPhysicsQueryFilter(physics, excludeNodeId);
+      const ray = tempRapierRay;
+      let hitCount = 0;
+
+      for (let i = 0; i < count; i++) {
+        const origin = (originsPtr >> 2) + i * 3;
+        const direction = (directionsPtr >> 2) + i * 3;
+        ray.origin.x = F32Heap[origin];
+        ray.origin.y = F32Heap[origin + 1];
+        ray.origin.z = F32Heap[origin + 2];
+        ray.dir.x = F32Heap[direction];
+        ray.dir.y = F32Heap[direction + 1];
+        ray.dir.z = F32Heap[direction + 2];
+
+        const hit = physics.physicsWorld.castRayAndGetNormal(
+          ray,
+          maxDistance,
+          true,
+          undefined,
+          undefined,
+          undefined,
+          undefined,
+          filter
+        );
+
+        if (hit) {
+          const nodeId = getScriptColliderNodeId(wasmCtx, physics, hit.collider);
+          writePhysicsHit(wasmCtx, hitsPtr, i, nodeId, hit.toi, ray.pointAt(hit.toi), hit.normal);
+          hitCount++;
+        } else {
+          writePhysicsMiss(wasmCtx, hitsPtr, i);
+        }
+      }
+
+      return hitCount;
+    },
+    world_cast_shapes(
+      colliderId: number,
+      originsPtr: number,
+      rotationsPtr: number,
+      directionsPtr: number,
+      count: number,
+      maxDistance: number,
+      excludeNodeId: number,
+      hitsPtr: number
+    ) {
+      const collider = getScriptResource(wasmCtx, RemoteCollider, colliderId);
+      const shape = collider && createColliderQueryShape(collider);
+
+      if (!shape) {
+        console.error("WebSG: only box, sphere and capsule colliders can be cast.");
+        return -1;
+      }
+
+      const F32Heap = wasmCtx.F32Heap;
+      const filter = createPhysicsQueryFilter(physics, excludeNodeId);
+      const position = tempRapierRay.origin;
+      const velocity = tempRapierRay.dir;
+      const rotation = tempRapierQuat;
+      let hitCount = 0;
+
+      for (let i = 0; i < count; i++) {
+        const origin = (originsPtr >> 2) + i * 3;
+        const direction = (directionsPtr >> 2) + i * 3;
+        position.x = F32Heap[origin];
+        position.y = F32Heap[origin + 1];
+        position.z = F32Heap[origin + 2];
+        velocity.x = F32Heap[direction];
+        velocity.y = F32Heap[direction + 1];
+        velocity.z = F32Heap[direction + 2];
+
+        if (rotationsPtr) {
+          const offset = (rotationsPtr >> 2) + i * 4;
+          rotation.x = F32Heap[offset];
+          rotation.y = F32Heap[offset + 1];
+          rotation.z = F32Heap[offset + 2];
+          rotation.w = F32Heap[offset + 3];
+        } else {
+          rotation.x = rotation.y = rotation.z = 0;
+          rotation.w = 1;
+        }
+
+        const hit = physics.physicsWorld.castShape(
+          position,
+          rotation,
+          velocity,
+          shape,
+          maxDistance,
+          true,
+          undefined,
+          undefined,
+          undefined,
+          undefined,
+          filter
+        );
+
+        if (hit) {
+          // The shape's position at the time of impact, the normal is in the hit collider's space.
+          const nodeId = getScriptColliderNodeId(wasmCtx, physics, hit.collider);
+          tempRapierVec3.x = position.x + velocity.x * hit.toi;
+          tempRapierVec3.y = position.y + velocity.y * hit.toi;
+          tempRapierVec3.z = position.z + velocity.z * hit.toi;
+          const colliderRotation = hit.collider.rotation();
+          quat.set(tempQuat, colliderRotation.x, colliderRotation.y, colliderRotation.z, colliderRotation.w);
+          vec3.transformQuat(tempVec3, vec3.set(tempVec3, hit.normal1.x, hit.normal1.y, hit.normal1.z), tempQuat);
+          const normal = { x: tempVec3[0], y: tempVec3[1], z: tempVec3[2] };
+          writePhysicsHit(wasmCtx, hitsPtr, i, nodeId, hit.toi, tempRapierVec3, normal);
+          hitCount++;
+        } else {
+          writePhysicsMiss(wasmCtx, hitsPtr, i);
+        }
+      }
+
+      return hitCount;
+    },
+    world_overlap_shapes(
+      colliderId: number,
+      positionsPtr: number,
+      rotationsPtr: number,
+      count: number,
+      excludeNodeId: number,
+      overlapCountsPtr: number,
+      nodeIdsPtr: number,
+      maxNodeCount: number
+    ) {
+      const collider = getScriptResource(wasmCtx, RemoteCollider, colliderId);
+      const shape = collider && createColliderQueryShape(collider);
+
+      if (!shape) {
+        console.error("WebSG: only box, sphere and capsule colliders can be tested for overlaps.");
+        return -1;
+      }
+
+      const F32Heap = wasmCtx.F32Heap;
+      const U32Heap = wasmCtx.U32Heap;
+      const filter = createPhysicsQueryFilter(physics, excludeNodeId);
+      const position = tempRapierVec3;
+      const rotation = tempRapierQuat;
+      const nodeIdsOffset = nodeIdsPtr >> 2;
+      // Nodes can have several colliders, every hit is deduplicated, including the ones past maxNodeCount.
+      const shapeNodeIds = overlapShapeNodeIds;
+      let total = 0;
+      let written = 0;
+      let queryStart = 0;
+
+      const onIntersection = (intersection: RAPIER.Collider) => {
+        const nodeId = getScriptColliderNodeId(wasmCtx, physics, intersection);
+
+        if (nodeId === 0 || shapeNodeIds.has(nodeId)) {
+          return true;
+        }
+
+        shapeNodeIds.add(nodeId);
+
+        if (written < maxNodeCount) {
+          U32Heap[nodeIdsOffset + written++] = nodeId;
+        }
+
+        total++;
+
+        return true;
+      };
+
+      for (let i = 0; i < count; i++) {
+        const offset = (positionsPtr >> 2) + i * 3;
+        position.x = F32Heap[offset];
+        position.y = F32Heap[offset + 1];
+        position.z = F32Heap[offset + 2];
+
+        if (rotationsPtr) {
+          const rotationOffset = (rotationsPtr >> 2) + i * 4;
+          rotation.x = F32Heap[rotationOffset];
+          rotation.y = F32Heap[rotationOffset + 1];
+          rotation.z = F32Heap[rotationOffset + 2];
+          rotation.w = F32Heap[rotationOffset + 3];
+        } else {
+          rotation.x = rotation.y = rotation.z = 0;
+          rotation.w = 1;
+        }
+
+        queryStart = written;
+        shapeNodeIds.clear();
+
+        physics.physicsWorld.intersectionsWithShape(
+          position,
+          rotation,
+          shape,
+          onIntersection,
+          undefined,
+          undefined,
+          undefined,
+          undefined,
+          filter
+        );
+
+        U32Heap[(overlapCountsPtr >> 2) + i] = written - queryStart;
+      }
+
+      shapeNodeIds.clear();
+
+      return total;
+    },
     world_create_collision_listener() {
       const resourceManager = wasmCtx.resourceManager;
       const id = resourceManager.nextCollisionListenerId++;
       resourceManager.collisionListeners.push({
         id,
         collisions: [],
+        head: 0,
+        droppedCount: 0,
+        collisionGroups: 0,
+      });
+      return id;
+    },
+    world_create_filtered_collision_listener(propsPtr: number) {
+      const resourceManager = wasmCtx.resourceManager;
+      const U32Heap = wasmCtx.U32Heap;
+      const offset = propsPtr >> 2;
+      const nodesPtr = U32Heap[offset];
+      const nodeCount = U32Heap[offset + 1];
+      const collisionGroups = U32Heap[offset + 2];
+      const capacity = U32Heap[offset + 3];
+
+      if (capacity === 0) {
+        console.error(`WebSG: collision listener capacity must be greater than 0.`);
+        return 0;
+      }
+
+      let nodes: Set<number> | undefined;
+
+      if (nodeCount > 0) {
+        nodes = new Set(U32Heap.subarray(nodesPtr >> 2, (nodesPtr >> 2) + nodeCount));
+      }
+
+      const id = resourceManager.nextCollisionListenerId++;
+      resourceManager.collisionListeners.push({
+        id,
+        collisions: [],
+        capacity,
+        head: 0,
+        droppedCount: 0,
+        nodes,
+        collisionGroups,
       });
       return id;
     },
@@ -2156,30 +2998,28 @@ export function createWebSGModule(ctx: GameContext, wasmCtx: WASMModuleContext)
       return 0;
     },
     collisions_listener_get_collision_count(listenerId: number) {
-      const resourceManager = wasmCtx.resourceManager;
-      const listener = resourceManager.collisionListeners.find((l) => l.id === listenerId);
+      const listener = getCollisionListener(wasmCtx, listenerId);
+
       if (!listener) {
-        console.error(`WebSG: collision listener ${listenerId} not found.`);
         return -1;
       }
+
       return listener.collisions.length;
     },
     collisions_listener_get_collisions(listenerId: number, collisionsPtr: number, maxCollisions: number) {
-      const resourceManager = wasmCtx.resourceManager;
-      const listener = resourceManager.collisionListeners.find((l) => l.id === listenerId);
+      const listener = getCollisionListener(wasmCtx, listenerId);
 
       if (!listener) {
-        console.error(`WebSG: collision listener ${listenerId} not found.`);
         return -1;
       }
 
-      const collisions = listener.collisions;
-
-      if (collisions.length > maxCollisions) {
+      if (listener.collisions.length > maxCollisions) {
         console.error(`WebSG: collision listener ${listenerId} has more collisions than maxCollisions.`);
         return -1;
       }
 
+      const collisions = shiftCollisions(listener, maxCollisions);
+
       moveCursorView(wasmCtx.cursorView, collisionsPtr);
 
       for (let i = 0; i < collisions.length; i++) {
@@ -2189,11 +3029,42 @@ export function createWebSGModule(ctx: GameContext, wasmCtx: WASMModuleContext)
         writeInt32(wasmCtx.cursorView, collision.started ? 1 : 0);
       }
 
-      const count = collisions.length;
+      return collisions.length;
+    },
+    collision_listener_get_contacts(listenerId: number, contactsPtr: number, maxCount: number) {
+      const listener = getCollisionListener(wasmCtx, listenerId);
+
+      if (!listener) {
+        return -1;
+      }
+
+      const collisions = shiftCollisions(listener, maxCount);
+      const U32Heap = wasmCtx.U32Heap;
+      const F32Heap = wasmCtx.F32Heap;
+
+      // See CollisionContact in websg.h, contacts are 10 words long.
+      for (let i = 0; i < collisions.length; i++) {
+        const collision = collisions[i];
+        const contact = collision.contact || emptyCollisionContact;
+        const offset = (contactsPtr >> 2) + i * 10;
+        U32Heap[offset] = collision.nodeA;
+        U32Heap[offset + 1] = collision.nodeB;
+        wasmCtx.I32Heap[offset + 2] = collision.started ? 1 : 0;
+        F32Heap.set(contact.position, offset + 3);
+        F32Heap.set(contact.normal, offset + 6);
+        F32Heap[offset + 9] = contact.impulse;
+      }
+
+      return collisions.length;
+    },
+    collision_listener_get_dropped_count(listenerId: number) {
+      const listener = getCollisionListener(wasmCtx, listenerId);
 
-      collisions.length = 0;
+      if (!listener) {
+        return -1;
+      }
 
-      return count;
+      return listener.droppedCount;
     },
     // UI Canvas
     world_create_ui_canvas(propsPtr: number) {
@@ -3625,8 +4496,12 @@ export function createWebSGModule(ctx: GameContext, wasmCtx: WASMModuleContext)
   };
 
   const disposeWebSGWASMModule = () => {
-    for (const query of wasmCtx.resourceManager.registeredQueries.values()) {
+    for (const { query, anyQueries } of wasmCtx.resourceManager.registeredQueries.values()) {
       removeQuery(ctx.world, query);
+
+      for (const anyQuery of anyQueries) {
+        removeQuery(ctx.world, anyQuery);
+      }
     }
 
     disposeCollisionHandler();